@@ -469,6 +469,15 @@ SPIRV_TOOLS_EXPORT void spvValidatorOptionsSetRelaxStoreStruct(
 SPIRV_TOOLS_EXPORT void spvValidatorOptionsSetRelaxLogicalPointer(
     spv_validator_options options, bool val);
 
+// Records the maximum number of threads the validator may use. Once the whole
+// module has been parsed, the per-function control flow analysis, the
+// dominance checks of the definitions and the ID checks of the instructions
+// in functions are spread over that many threads, which are started once per
+// validation. The diagnostics are the same as with a single thread. A value
+// of 0 or 1 validates on the calling thread only.
+SPIRV_TOOLS_EXPORT void spvValidatorOptionsSetThreadCount(
+    spv_validator_options options, uint32_t thread_count);
+
 // Encodes the given SPIR-V assembly text to its binary representation. The
 // length parameter specifies the number of bytes for text. Encoded binary will
 // be stored into *binary. Any error will be written into *diagnostic if
@@ -503,6 +512,16 @@ SPIRV_TOOLS_EXPORT spv_result_t spvBinaryToText(const spv_const_context context,
                                                 spv_text* text,
                                                 spv_diagnostic* diagnostic);
 
+// Decodes the given SPIR-V binary representation to its assembly text, like
+// spvBinaryToText, using up to thread_count threads. The functions of the
+// module are split into chunks that are disassembled in parallel, and the
+// text is the same as with a single thread. A value of 0 or 1 disassembles
+// on the calling thread only.
+SPIRV_TOOLS_EXPORT spv_result_t spvBinaryToTextWithThreadCount(
+    const spv_const_context context, const uint32_t* binary,
+    const size_t word_count, const uint32_t options,
+    const uint32_t thread_count, spv_text* text, spv_diagnostic* diagnostic);
+
 // Frees a binary stream from memory. This is a no-op if binary is a null
 // pointer.
 SPIRV_TOOLS_EXPORT void spvBinaryDestroy(spv_binary binary);
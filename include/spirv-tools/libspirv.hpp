@@ -91,6 +91,12 @@ class ValidatorOptions {
     spvValidatorOptionsSetRelaxLogicalPointer(options_, val);
   }
 
+  // Records the maximum number of threads the validator may use for the
+  // checks which run per function once the module has been parsed.
+  void SetThreadCount(uint32_t thread_count) {
+    spvValidatorOptionsSetThreadCount(options_, thread_count);
+  }
+
  private:
   spv_validator_options options_;
 };
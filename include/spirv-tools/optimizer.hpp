@@ -15,6 +15,7 @@
 #ifndef SPIRV_TOOLS_OPTIMIZER_HPP_
 #define SPIRV_TOOLS_OPTIMIZER_HPP_
 
+#include <functional>
 #include <memory>
 #include <ostream>
 #include <string>
@@ -109,6 +110,40 @@ class Optimizer {
   bool Run(const uint32_t* original_binary, size_t original_binary_size,
            std::vector<uint32_t>* optimized_binary) const;
 
+  // Receives the next |count| words of an optimized binary.  Returns false if
+  // they could not be taken, e.g. because writing them out failed.
+  using BinaryWriter = std::function<bool(const uint32_t* words, size_t count)>;
+
+  // Optimizes the given SPIR-V module |original_binary| like Run() above, but
+  // passes the optimized binary to |write| in order, a piece at a time, as it
+  // is serialized, rather than building it in memory.  |write| is only called
+  // once every pass has succeeded, so nothing is written if this returns false
+  // because of a pass.  Also returns false, without writing the rest, if
+  // |write| returns false.
+  bool Run(const uint32_t* original_binary, size_t original_binary_size,
+           const BinaryWriter& write) const;
+
+  // Optimizes each module in |original_binaries| with the registered passes
+  // and writes the optimized binary into the corresponding element of
+  // |optimized_binaries|, which is resized to match.  The modules are
+  // distributed over at most |thread_count| threads, including the calling
+  // thread; a value of 0 or 1 optimizes them one after the other on the
+  // calling thread.  Each module is processed by its own instances of the
+  // registered passes, so this may be called on an optimizer that has
+  // already run, and concurrently with itself.
+  //
+  // Returns true if every module was optimized successfully.  Each module for
+  // which Run() would have returned false gets an empty optimized binary.
+  //
+  // With more than one thread, the message consumer may be called
+  // concurrently, and must be safe to use that way.  The options set with
+  // SetPrintAll() and SetTimeReport() are ignored here.
+  //
+  // |optimized_binaries| may be the same vector as |original_binaries|.
+  bool RunBatch(const std::vector<std::vector<uint32_t>>& original_binaries,
+                std::vector<std::vector<uint32_t>>* optimized_binaries,
+                uint32_t thread_count) const;
+
   // Returns a vector of strings with all the pass names added to this
   // optimizer's pass manager. These strings are valid until the associated
   // pass manager is destroyed.
@@ -119,6 +154,44 @@ class Optimizer {
   // output is sent to the |out| output stream.
   Optimizer& SetPrintAll(std::ostream* out);
 
+  // The formats of the report written by SetTimeReport().
+  enum class TimeReportFormat {
+    kText,  // Human readable, one paragraph per pass.
+    kCsv,   // Comma separated values, one header row and one row per pass.
+  };
+
+  // Sets the option to report, for each pass, the wall and CPU time it took,
+  // the number of instructions and the Id bound before and after it, the
+  // analyses it built and invalidated, and how much it grew the peak resident
+  // set size of the process.  If |out| is null, then no report is generated.
+  // Otherwise, the report is written to |out| in the given |format| after the
+  // last pass.
+  Optimizer& SetTimeReport(
+      std::ostream* out, TimeReportFormat format = TimeReportFormat::kText);
+
+  // Sets the number of times the registered passes may be run over a module,
+  // e.g. the -O and -Os pipelines.  After every pass has run once, a pass is
+  // run again if other passes changed the module since it last ran, and then
+  // only on the functions they changed.  This stops once no pass has changes
+  // to look at, or after |max_iterations| rounds.  The default is 1, which
+  // runs each pass once.  If a time report is requested, it ends with the
+  // number of rounds and pass runs, and whether they converged.
+  Optimizer& SetMaxIterations(uint32_t max_iterations);
+
+  // Sets the number of threads, including the calling thread, that Run() may
+  // use to process the functions of a module.  Only the passes that work on
+  // each function on its own make use of them, and the optimized binary is the
+  // same for any thread count.  The default is 1.  RunBatch() ignores this,
+  // and uses its threads for whole modules instead.
+  Optimizer& SetThreadCount(uint32_t thread_count);
+
+  // Sets the budget of the exhaustive inline passes that
+  // RegisterPerformancePasses(), RegisterSizePasses() and
+  // RegisterLegalizationPasses() register after this call.  See
+  // CreateInlineExhaustivePass(uint32_t).  By default they inline every call
+  // they can.
+  Optimizer& SetInlineBudget(uint32_t budget);
+
  private:
   struct Impl;                  // Opaque struct for holding internal data.
   std::unique_ptr<Impl> impl_;  // Unique pointer to internal data.
@@ -253,6 +326,16 @@ Optimizer::PassToken CreateBlockMergePass();
 // that are not in the call tree of an entry point are not changed.
 Optimizer::PassToken CreateInlineExhaustivePass();
 
+// Creates an exhaustive inline pass that adds at most |budget| instructions to
+// the module.  Calls are visited from the entry points down.  A call is only
+// inlined if the instructions it adds, counting those of the calls nested in
+// the callee as if they were inlined too, fit in what is left of the budget.
+// The other calls are left in place, and their callees are processed in turn.
+// Calls with opaque arguments or return type are inlined regardless of the
+// budget.  The number of calls and instructions inlined, and of calls left in
+// place, are reported to the message consumer as info.
+Optimizer::PassToken CreateInlineExhaustivePass(uint32_t budget);
+
 // Creates an opaque inline pass.
 // An opaque inline pass inlines all function calls in all functions in all
 // entry point call trees where the called function contains an opaque type
@@ -425,6 +508,14 @@ Optimizer::PassToken CreateAggressiveDCEPass();
 // The pass remaps result ids to a compact and gapless range starting from %1.
 Optimizer::PassToken CreateCompactIdsPass();
 
+// Creates a compact ids pass that orders the new ids for locality.
+// Like the compact ids pass, this remaps result ids to a compact and gapless
+// range starting from %1.  The ids defined outside of functions come first,
+// the most used ones first, followed by the ids of each function in the order
+// they are defined.  Small ids for frequent operands, and ids that increase
+// through each function, make the module compress better.
+Optimizer::PassToken CreateCompactIdsForLocalityPass();
+
 // Creates a remove duplicate pass.
 // This pass removes various duplicates:
 // * duplicate capabilities;
@@ -19,6 +19,8 @@
 #include <cstring>
 #include <iterator>
 #include <limits>
+#include <memory>
+#include <mutex>
 #include <unordered_map>
 #include <vector>
 
@@ -53,6 +55,146 @@ spv_result_t spvBinaryHeaderGet(const spv_const_binary binary,
 
 namespace {
 
+// The operands of every instance of an opcode whose operands are all single
+// words with no semantics beyond their position: Ids and literal integers,
+// ending in an optional variable-length tail of Ids or literal integers.
+struct OperandLayout {
+  // Is the opcode's operand shape fixed enough to be described here?
+  bool cacheable = false;
+  // The range of valid operand counts.
+  uint16_t min_operands = 0;
+  uint16_t max_operands = 0;
+  // The repeated operand in the tail, if any.  Its offset is unused.
+  spv_parsed_operand_t tail = {};
+  // The parsed operands in order.  For an opcode with a tail, the first tail
+  // entries are included, up to kSharedOperandCount operands.
+  std::vector<spv_parsed_operand_t> operands;
+};
+
+// The number of operands up to which the tail entries of an operand layout
+// are built in advance.  Longer instructions are rare.
+const uint16_t kSharedOperandCount = 32;
+
+// Returns the operand layout of the opcode described by |desc|.
+OperandLayout ComputeOperandLayout(const spv_opcode_desc_t& desc) {
+  OperandLayout layout;
+  layout.cacheable = true;
+  bool seen_optional = false;
+  for (uint16_t i = 0; i < desc.numTypes; ++i) {
+    const spv_operand_type_t type = desc.operandTypes[i];
+    const bool is_last = i + 1 == desc.numTypes;
+    spv_parsed_operand_t operand = {uint16_t(i + 1), 1, type, SPV_NUMBER_NONE,
+                                    0};
+    bool is_tail = false;
+    switch (type) {
+      case SPV_OPERAND_TYPE_TYPE_ID:
+      case SPV_OPERAND_TYPE_RESULT_ID:
+      case SPV_OPERAND_TYPE_ID:
+      case SPV_OPERAND_TYPE_SCOPE_ID:
+      case SPV_OPERAND_TYPE_MEMORY_SEMANTICS_ID:
+        break;
+      case SPV_OPERAND_TYPE_OPTIONAL_ID:
+        operand.type = SPV_OPERAND_TYPE_ID;
+        break;
+      case SPV_OPERAND_TYPE_VARIABLE_ID:
+        operand.type = SPV_OPERAND_TYPE_ID;
+        is_tail = true;
+        break;
+      case SPV_OPERAND_TYPE_LITERAL_INTEGER:
+      case SPV_OPERAND_TYPE_OPTIONAL_LITERAL_INTEGER:
+        operand.type = SPV_OPERAND_TYPE_LITERAL_INTEGER;
+        operand.number_kind = SPV_NUMBER_UNSIGNED_INT;
+        operand.number_bit_width = 32;
+        break;
+      case SPV_OPERAND_TYPE_VARIABLE_LITERAL_INTEGER:
+        operand.type = SPV_OPERAND_TYPE_LITERAL_INTEGER;
+        operand.number_kind = SPV_NUMBER_UNSIGNED_INT;
+        operand.number_bit_width = 32;
+        is_tail = true;
+        break;
+      default:
+        // Any other operand needs the general path.  Instances of the opcode
+        // that stop before an optional operand of this kind can still use
+        // the layout.
+        layout.cacheable = spvOperandIsOptional(type);
+        layout.max_operands = i;
+        return layout;
+    }
+    if (is_tail) {
+      if (!is_last) {
+        layout.cacheable = false;
+        return layout;
+      }
+      layout.tail = operand;
+      layout.max_operands = std::numeric_limits<uint16_t>::max();
+      while (layout.operands.size() < kSharedOperandCount) {
+        layout.operands.push_back(operand);
+        layout.operands.back().offset = uint16_t(layout.operands.size());
+      }
+      return layout;
+    }
+    if (spvOperandIsOptional(type)) {
+      seen_optional = true;
+    } else if (seen_optional) {
+      // A required operand after an optional one can't be placed by position.
+      layout.cacheable = false;
+      return layout;
+    } else {
+      layout.min_operands = uint16_t(i + 1);
+    }
+    layout.operands.push_back(operand);
+  }
+  layout.max_operands = desc.numTypes;
+  return layout;
+}
+
+// The operand layouts of the opcodes of an opcode table.  They are built
+// once per table, i.e. once per SPIR-V version, and are then only read, so
+// any number of parsers can share them, on any thread.
+class OperandLayoutTable {
+ public:
+  // Returns the layouts for |table|, building them on first use.  May be
+  // called concurrently.
+  static const OperandLayoutTable& Get(spv_opcode_table table) {
+    static std::mutex mutex;
+    static std::unordered_map<spv_opcode_table,
+                              std::unique_ptr<OperandLayoutTable>>
+        tables;
+    std::lock_guard<std::mutex> lock(mutex);
+    std::unique_ptr<OperandLayoutTable>& layouts = tables[table];
+    if (!layouts) layouts.reset(new OperandLayoutTable(table));
+    return *layouts;
+  }
+
+  // Returns the operand layout for the given opcode, or nullptr if the
+  // opcode is not in the table.
+  const OperandLayout* Find(SpvOp opcode) const {
+    const size_t op = static_cast<size_t>(opcode);
+    if (op >= index_.size() || index_[op] == kNoLayout) return nullptr;
+    return &layouts_[index_[op]];
+  }
+
+ private:
+  explicit OperandLayoutTable(spv_opcode_table table) {
+    if (!table) return;
+    layouts_.reserve(table->count);
+    for (uint32_t i = 0; i < table->count; ++i) {
+      const spv_opcode_desc_t& desc = table->entries[i];
+      const size_t op = static_cast<size_t>(desc.opcode);
+      if (op >= index_.size()) index_.resize(op + 1, kNoLayout);
+      index_[op] = static_cast<uint16_t>(layouts_.size());
+      layouts_.push_back(ComputeOperandLayout(desc));
+    }
+  }
+
+  // The index in |layouts_| of the layout of each opcode.  Opcodes are
+  // small, so the index is a flat table.  Opcodes that are not in the table
+  // map to kNoLayout.
+  enum : uint16_t { kNoLayout = 0xffff };
+  std::vector<uint16_t> index_;
+  std::vector<OperandLayout> layouts_;
+};
+
 // A SPIR-V binary parser.  A parser instance communicates detailed parse
 // results via callbacks.
 class Parser {
@@ -65,7 +207,8 @@ class Parser {
         consumer_(context->consumer),
         user_data_(user_data),
         parsed_header_fn_(parsed_header_fn),
-        parsed_instruction_fn_(parsed_instruction_fn) {}
+        parsed_instruction_fn_(parsed_instruction_fn),
+        operand_layouts_(OperandLayoutTable::Get(context->opcode_table)) {}
 
   // Parses the specified binary SPIR-V module, issuing callbacks on a parsed
   // header and for each parsed instruction.  Returns SPV_SUCCESS on success.
@@ -87,6 +230,19 @@ class Parser {
   // On failure, returns an error code and issues a diagnostic.
   spv_result_t parseInstruction();
 
+  // Fast path for parseInstruction.  Parses the instruction with the given
+  // opcode and word count at the current position, using the shared operand
+  // layout for the opcode, when the binary has host native endianness and the
+  // instruction has the fixed shape described by the layout.  The parsed
+  // instruction and its operands point directly into the binary and the
+  // layout, so nothing is copied, except for the operands of unusually long
+  // instructions.  Returns true and sets *result if the instruction was
+  // handled.  Returns false without changing the parse state if the
+  // instruction must go through the general path instead, including whenever
+  // it is invalid, so that the general path issues the diagnostic.
+  bool parseInstructionWithLayout(SpvOp opcode, uint16_t inst_word_count,
+                                  spv_result_t* result);
+
   // Parses an instruction operand with the given type, for an instruction
   // starting at inst_offset words into the SPIR-V binary.
   // If the SPIR-V binary is the same endianness as the host, then the
@@ -163,6 +319,10 @@ class Parser {
   const spv_parsed_instruction_fn_t
       parsed_instruction_fn_;  // Parsed instruction callback
 
+  // The operand layouts of the opcodes in the grammar, shared with every
+  // other parser using the same grammar.
+  const OperandLayoutTable& operand_layouts_;
+
   // Describes the format of a typed literal number.
   struct NumberType {
     spv_number_kind_t type;
@@ -291,6 +451,14 @@ spv_result_t Parser::parseInstruction() {
     return diagnostic() << "Invalid instruction word count: "
                         << inst_word_count;
   }
+
+  if (!_.requires_endian_conversion) {
+    spv_result_t result = SPV_SUCCESS;
+    if (parseInstructionWithLayout(static_cast<SpvOp>(inst.opcode),
+                                   inst_word_count, &result))
+      return result;
+  }
+
   spv_opcode_desc opcode_desc;
   if (grammar_.lookupOpcode(static_cast<SpvOp>(inst.opcode), &opcode_desc))
     return diagnostic() << "Invalid opcode: " << inst.opcode;
@@ -386,6 +554,74 @@ spv_result_t Parser::parseInstruction() {
   return SPV_SUCCESS;
 }
 
+bool Parser::parseInstructionWithLayout(SpvOp opcode, uint16_t inst_word_count,
+                                        spv_result_t* result) {
+  const size_t inst_offset = _.word_index;
+  if (_.num_words - inst_offset < inst_word_count) return false;
+
+  const OperandLayout* layout = operand_layouts_.Find(opcode);
+  if (!layout || !layout->cacheable) return false;
+  const uint16_t num_operands = uint16_t(inst_word_count - 1);
+  if (num_operands < layout->min_operands ||
+      num_operands > layout->max_operands)
+    return false;
+  const size_t num_shared = layout->operands.size();
+
+  spv_parsed_instruction_t inst = {};
+  inst.opcode = opcode;
+  const uint32_t* words = _.words + inst_offset;
+  for (uint16_t i = 0; i < num_operands; ++i) {
+    const uint32_t word = words[i + 1];
+    const spv_operand_type_t type =
+        i < num_shared ? layout->operands[i].type : layout->tail.type;
+    switch (type) {
+      case SPV_OPERAND_TYPE_TYPE_ID:
+        if (!word) return false;
+        inst.type_id = word;
+        break;
+      case SPV_OPERAND_TYPE_RESULT_ID:
+        if (!word || _.id_to_type_id.count(word)) return false;
+        inst.result_id = word;
+        break;
+      case SPV_OPERAND_TYPE_ID:
+      case SPV_OPERAND_TYPE_SCOPE_ID:
+      case SPV_OPERAND_TYPE_MEMORY_SEMANTICS_ID:
+        if (!word) return false;
+        break;
+      default:
+        break;
+    }
+  }
+
+  // The instruction is valid, so commit it to the parse state.
+  if (inst.result_id) {
+    _.id_to_type_id[inst.result_id] =
+        spvOpcodeGeneratesType(opcode) ? inst.result_id : inst.type_id;
+  }
+  _.word_index += inst_word_count;
+  recordNumberType(inst_offset, &inst);
+
+  inst.words = words;
+  inst.num_words = inst_word_count;
+  inst.operands = layout->operands.data();
+  if (num_operands > num_shared) {
+    // The shared layout is too short, so the operands of this instruction
+    // are spelled out in the parse state instead.
+    _.operands.assign(layout->operands.begin(), layout->operands.end());
+    while (_.operands.size() < num_operands) {
+      _.operands.push_back(layout->tail);
+      _.operands.back().offset = uint16_t(_.operands.size());
+    }
+    inst.operands = _.operands.data();
+  }
+  inst.num_operands = num_operands;
+
+  *result = parsed_instruction_fn_
+                ? parsed_instruction_fn_(user_data_, &inst)
+                : SPV_SUCCESS;
+  return true;
+}
+
 spv_result_t Parser::parseOperand(size_t inst_offset,
                                   spv_parsed_instruction_t* inst,
                                   const spv_operand_type_t type,
@@ -774,20 +774,6 @@ class MarkvDecoder : public MarkvCodecBase {
                                          : nullptr;
   }
 
-  // Reads a single bit from reader_. The read bit is stored in |bit|.
-  // Returns false iff reader_ fails.
-  bool ReadBit(bool* bit) {
-    uint64_t bits = 0;
-    const bool result = reader_.ReadBits(&bits, 1);
-    if (result) *bit = bits ? true : false;
-    return result;
-  };
-
-  // Returns ReadBit bound to the class object.
-  std::function<bool(bool*)> GetReadBitCallback() {
-    return std::bind(&MarkvDecoder::ReadBit, this, std::placeholders::_1);
-  }
-
   // Reads a single non-id word from bit stream. operand_.type determines if
   // the word needs to be decoded and how.
   spv_result_t DecodeNonIdWord(uint32_t* word);
@@ -1515,7 +1501,7 @@ spv_result_t MarkvDecoder::DecodeNonIdWord(uint32_t* word) {
 
   if (codec) {
     uint64_t decoded_value = 0;
-    if (!codec->DecodeFromStream(GetReadBitCallback(), &decoded_value))
+    if (!codec->DecodeFromStream(&reader_, &decoded_value))
       return Diag(SPV_ERROR_INVALID_BINARY)
              << "Failed to decode non-id word with Huffman";
 
@@ -1596,7 +1582,7 @@ spv_result_t MarkvDecoder::DecodeOpcodeAndNumberOfOperands(
       model_->GetOpcodeAndNumOperandsMarkovHuffmanCodec(GetPrevOpcode());
   if (codec) {
     uint64_t decoded_value = 0;
-    if (!codec->DecodeFromStream(GetReadBitCallback(), &decoded_value))
+    if (!codec->DecodeFromStream(&reader_, &decoded_value))
       return Diag(SPV_ERROR_INTERNAL)
              << "Failed to decode opcode_and_num_operands, previous opcode is "
              << spvOpcodeString(GetPrevOpcode());
@@ -1615,7 +1601,7 @@ spv_result_t MarkvDecoder::DecodeOpcodeAndNumberOfOperands(
   codec = model_->GetOpcodeAndNumOperandsMarkovHuffmanCodec(SpvOpNop);
   assert(codec);
   uint64_t decoded_value = 0;
-  if (!codec->DecodeFromStream(GetReadBitCallback(), &decoded_value))
+  if (!codec->DecodeFromStream(&reader_, &decoded_value))
     return Diag(SPV_ERROR_INTERNAL)
            << "Failed to decode opcode_and_num_operands with global codec";
 
@@ -1673,7 +1659,7 @@ spv_result_t MarkvDecoder::DecodeMtfRankHuffman(uint64_t mtf,
   if (!codec) return Diag(SPV_ERROR_INTERNAL) << "No codec to decode MTF rank";
 
   uint32_t decoded_value = 0;
-  if (!codec->DecodeFromStream(GetReadBitCallback(), &decoded_value))
+  if (!codec->DecodeFromStream(&reader_, &decoded_value))
     return Diag(SPV_ERROR_INTERNAL) << "Failed to decode MTF rank with Huffman";
 
   if (decoded_value == kMtfRankEncodedByValueSignal) {
@@ -1745,7 +1731,7 @@ spv_result_t MarkvDecoder::DecodeIdWithDescriptor(uint32_t* id) {
   uint64_t mtf = kMtfNone;
   if (codec) {
     uint64_t decoded_value = 0;
-    if (!codec->DecodeFromStream(GetReadBitCallback(), &decoded_value))
+    if (!codec->DecodeFromStream(&reader_, &decoded_value))
       return Diag(SPV_ERROR_INTERNAL)
              << "Failed to decode descriptor with Huffman";
 
@@ -2507,7 +2493,7 @@ spv_result_t MarkvDecoder::DecodeOperand(
       if (codec) {
         std::string decoded_string;
         const bool huffman_result =
-            codec->DecodeFromStream(GetReadBitCallback(), &decoded_string);
+            codec->DecodeFromStream(&reader_, &decoded_string);
         assert(huffman_result);
         if (!huffman_result)
           return Diag(SPV_ERROR_INVALID_BINARY)
@@ -18,9 +18,12 @@
 #include <algorithm>
 #include <cassert>
 #include <cstring>
-#include <iomanip>
+#include <iostream>
 #include <memory>
+#include <sstream>
+#include <string>
 #include <unordered_map>
+#include <vector>
 
 #include "assembly_grammar.h"
 #include "binary.h"
@@ -35,15 +38,53 @@
 #include "spirv_constant.h"
 #include "spirv_endian.h"
 #include "util/hex_float.h"
+#include "util/parallel.h"
 
 namespace {
 
+// Appends the decimal representation of |value| to |out|.
+void AppendDecimal(std::string* out, uint64_t value) {
+  char digits[20];
+  int count = 0;
+  do {
+    digits[count++] = static_cast<char>('0' + value % 10);
+    value /= 10;
+  } while (value != 0);
+  while (count > 0) out->push_back(digits[--count]);
+}
+
+// Appends the decimal representation of |value| to |out|.
+void AppendSignedDecimal(std::string* out, int64_t value) {
+  if (value < 0) {
+    out->push_back('-');
+    // Negate in unsigned arithmetic, so that the minimum value works too.
+    AppendDecimal(out, 0 - static_cast<uint64_t>(value));
+  } else {
+    AppendDecimal(out, static_cast<uint64_t>(value));
+  }
+}
+
+// Appends the lower case hexadecimal representation of |value| to |out|,
+// padded with zeros to at least |min_digits| digits.
+void AppendHex(std::string* out, uint64_t value, int min_digits) {
+  char digits[16];
+  int count = 0;
+  do {
+    digits[count++] = "0123456789abcdef"[value & 0xf];
+    value >>= 4;
+  } while (value != 0);
+  for (int i = count; i < min_digits; ++i) out->push_back('0');
+  while (count > 0) out->push_back(digits[--count]);
+}
+
 // A Disassembler instance converts a SPIR-V binary to its assembly
-// representation.
+// representation.  The text is built in a growable buffer, with hand-rolled
+// number formatting, rather than through a std::ostream.
 class Disassembler {
  public:
+  // Ids are named by |friendly_mapper|, or by their number if it is nullptr.
   Disassembler(const libspirv::AssemblyGrammar& grammar, uint32_t options,
-               libspirv::NameMapper name_mapper)
+               const libspirv::FriendlyNameMapper* friendly_mapper)
       : grammar_(grammar),
         print_(spvIsInBitfield(SPV_BINARY_TO_TEXT_OPTION_PRINT, options)),
         color_(spvIsInBitfield(SPV_BINARY_TO_TEXT_OPTION_COLOR, options)),
@@ -51,13 +92,11 @@ class Disassembler {
                     ? kStandardIndent
                     : 0),
         text_(),
-        out_(print_ ? out_stream() : out_stream(text_)),
-        stream_(out_.get()),
         header_(!spvIsInBitfield(SPV_BINARY_TO_TEXT_OPTION_NO_HEADER, options)),
         show_byte_offset_(spvIsInBitfield(
             SPV_BINARY_TO_TEXT_OPTION_SHOW_BYTE_OFFSET, options)),
         byte_offset_(0),
-        name_mapper_(std::move(name_mapper)) {}
+        friendly_mapper_(friendly_mapper) {}
 
   // Emits the assembly header for the module, and sets up internal state
   // so subsequent callbacks can handle the cases where the entire module
@@ -72,11 +111,20 @@ class Disassembler {
   // Returns SPV_SUCCESS on success.
   spv_result_t SaveTextResult(spv_text* text_result) const;
 
+  // Returns the text accumulated so far, and clears it.
+  std::string TakeText() {
+    std::string text;
+    text.swap(text_);
+    return text;
+  }
+
+  // Sets the byte offset shown for the next instruction.  Used when only a
+  // part of the module is disassembled.
+  void set_byte_offset(size_t byte_offset) { byte_offset_ = byte_offset; }
+
  private:
   enum { kStandardIndent = 15 };
 
-  using out_stream = libspirv::out_stream;
-
   // Emits an operand for the given instruction, where the instruction
   // is at offset words from the start of the binary.
   void EmitOperand(const spv_parsed_instruction_t& inst,
@@ -85,29 +133,70 @@ class Disassembler {
   // Emits a mask expression for the given mask word of the specified type.
   void EmitMaskOperand(const spv_operand_type_t type, const uint32_t word);
 
+  // Emits the numeric literal |operand| of |inst|.
+  void EmitNumericLiteral(const spv_parsed_instruction_t& inst,
+                          const spv_parsed_operand_t& operand);
+
+  // Appends text to the output.
+  void Emit(const char* str) { text_.append(str); }
+  void Emit(const std::string& str) { text_.append(str); }
+  void Emit(char c) { text_.push_back(c); }
+
+  // Returns the name of |id|, or nullptr if it should be printed as a number.
+  const std::string* FindIdName(uint32_t id) const {
+    return friendly_mapper_ ? friendly_mapper_->FindNameForId(id) : nullptr;
+  }
+
+  // Emits "%" followed by the name of |id|.
+  void EmitId(uint32_t id) {
+    Emit('%');
+    if (const std::string* name = FindIdName(id)) {
+      Emit(*name);
+    } else {
+      AppendDecimal(&text_, id);
+    }
+  }
+
+  // Writes the text accumulated so far to the standard output, if printing.
+  void Flush() {
+    if (print_ && !text_.empty()) {
+      std::cout.write(text_.data(), text_.size());
+      text_.clear();
+    }
+  }
+
+  // Emits |color|.  When printing, setting the color may act on the console
+  // directly, so the text before it is written out first.
+  template <class Color>
+  void EmitColor(Color color) {
+    Flush();
+    const char* code = color;
+    Emit(code);
+  }
+
   // Resets the output color, if color is turned on.
   void ResetColor() {
-    if (color_) out_.get() << libspirv::clr::reset{print_};
+    if (color_) EmitColor(libspirv::clr::reset{print_});
   }
   // Sets the output to grey, if color is turned on.
   void SetGrey() {
-    if (color_) out_.get() << libspirv::clr::grey{print_};
+    if (color_) EmitColor(libspirv::clr::grey{print_});
   }
   // Sets the output to blue, if color is turned on.
   void SetBlue() {
-    if (color_) out_.get() << libspirv::clr::blue{print_};
+    if (color_) EmitColor(libspirv::clr::blue{print_});
   }
   // Sets the output to yellow, if color is turned on.
   void SetYellow() {
-    if (color_) out_.get() << libspirv::clr::yellow{print_};
+    if (color_) EmitColor(libspirv::clr::yellow{print_});
   }
   // Sets the output to red, if color is turned on.
   void SetRed() {
-    if (color_) out_.get() << libspirv::clr::red{print_};
+    if (color_) EmitColor(libspirv::clr::red{print_});
   }
   // Sets the output to green, if color is turned on.
   void SetGreen() {
-    if (color_) out_.get() << libspirv::clr::green{print_};
+    if (color_) EmitColor(libspirv::clr::green{print_});
   }
 
   const libspirv::AssemblyGrammar& grammar_;
@@ -115,13 +204,14 @@ class Disassembler {
   const bool color_;  // Should we print in colour?
   const int indent_;  // How much to indent. 0 means don't indent
   spv_endianness_t endian_;  // The detected endianness of the binary.
-  std::stringstream text_;   // Captures the text, if not printing.
-  out_stream out_;  // The Output stream.  Either to text_ or standard output.
-  std::ostream& stream_;  // The output std::stream.
+  // The text.  When printing, it only holds the text of the current
+  // instruction.
+  std::string text_;
+  std::ostringstream float_text_;  // Used to format floating point literals.
   const bool header_;     // Should we output header as the leading comment?
   const bool show_byte_offset_;  // Should we print byte offset, in hex?
   size_t byte_offset_;           // The number of bytes processed so far.
-  libspirv::NameMapper name_mapper_;
+  const libspirv::FriendlyNameMapper* friendly_mapper_;
 };
 
 spv_result_t Disassembler::HandleHeader(spv_endianness_t endian,
@@ -133,24 +223,33 @@ spv_result_t Disassembler::HandleHeader(spv_endianness_t endian,
     SetGrey();
     const char* generator_tool =
         spvGeneratorStr(SPV_GENERATOR_TOOL_PART(generator));
-    stream_ << "; SPIR-V\n"
-            << "; Version: " << SPV_SPIRV_VERSION_MAJOR_PART(version) << "."
-            << SPV_SPIRV_VERSION_MINOR_PART(version) << "\n"
-            << "; Generator: " << generator_tool;
+    Emit("; SPIR-V\n; Version: ");
+    AppendDecimal(&text_, SPV_SPIRV_VERSION_MAJOR_PART(version));
+    Emit('.');
+    AppendDecimal(&text_, SPV_SPIRV_VERSION_MINOR_PART(version));
+    Emit("\n; Generator: ");
+    Emit(generator_tool);
     // For unknown tools, print the numeric tool value.
     if (0 == strcmp("Unknown", generator_tool)) {
-      stream_ << "(" << SPV_GENERATOR_TOOL_PART(generator) << ")";
+      Emit('(');
+      AppendDecimal(&text_, SPV_GENERATOR_TOOL_PART(generator));
+      Emit(')');
     }
     // Print the miscellaneous part of the generator word on the same
     // line as the tool name.
-    stream_ << "; " << SPV_GENERATOR_MISC_PART(generator) << "\n"
-            << "; Bound: " << id_bound << "\n"
-            << "; Schema: " << schema << "\n";
+    Emit("; ");
+    AppendDecimal(&text_, SPV_GENERATOR_MISC_PART(generator));
+    Emit("\n; Bound: ");
+    AppendDecimal(&text_, id_bound);
+    Emit("\n; Schema: ");
+    AppendDecimal(&text_, schema);
+    Emit('\n');
     ResetColor();
   }
 
   byte_offset_ = SPV_INDEX_INSTRUCTION * sizeof(uint32_t);
 
+  Flush();
   return SPV_SUCCESS;
 }
 
@@ -158,40 +257,46 @@ spv_result_t Disassembler::HandleInstruction(
     const spv_parsed_instruction_t& inst) {
   if (inst.result_id) {
     SetBlue();
-    const std::string id_name = name_mapper_(inst.result_id);
-    if (indent_)
-      stream_ << std::setw(std::max(0, indent_ - 3 - int(id_name.size())));
-    stream_ << "%" << id_name;
+    if (indent_) {
+      // Right-align the result id so that the opcode starts at the indent.
+      size_t name_size = 0;
+      if (const std::string* name = FindIdName(inst.result_id)) {
+        name_size = name->size();
+      } else {
+        for (uint32_t id = inst.result_id; id != 0; id /= 10) ++name_size;
+      }
+      const int padding = indent_ - 4 - static_cast<int>(name_size);
+      if (padding > 0) text_.append(static_cast<size_t>(padding), ' ');
+    }
+    EmitId(inst.result_id);
     ResetColor();
-    stream_ << " = ";
+    Emit(" = ");
   } else {
-    stream_ << std::string(indent_, ' ');
+    text_.append(static_cast<size_t>(indent_), ' ');
   }
 
-  stream_ << "Op" << spvOpcodeString(static_cast<SpvOp>(inst.opcode));
+  Emit("Op");
+  Emit(spvOpcodeString(static_cast<SpvOp>(inst.opcode)));
 
   for (uint16_t i = 0; i < inst.num_operands; i++) {
     const spv_operand_type_t type = inst.operands[i].type;
     assert(type != SPV_OPERAND_TYPE_NONE);
     if (type == SPV_OPERAND_TYPE_RESULT_ID) continue;
-    stream_ << " ";
+    Emit(' ');
     EmitOperand(inst, i);
   }
 
   if (show_byte_offset_) {
     SetGrey();
-    auto saved_flags = stream_.flags();
-    auto saved_fill = stream_.fill();
-    stream_ << " ; 0x" << std::setw(8) << std::hex << std::setfill('0')
-            << byte_offset_;
-    stream_.flags(saved_flags);
-    stream_.fill(saved_fill);
+    Emit(" ; 0x");
+    AppendHex(&text_, byte_offset_, 8);
     ResetColor();
   }
 
   byte_offset_ += inst.num_words * sizeof(uint32_t);
 
-  stream_ << "\n";
+  Emit('\n');
+  Flush();
   return SPV_SUCCESS;
 }
 
@@ -204,48 +309,48 @@ void Disassembler::EmitOperand(const spv_parsed_instruction_t& inst,
     case SPV_OPERAND_TYPE_RESULT_ID:
       assert(false && "<result-id> is not supposed to be handled here");
       SetBlue();
-      stream_ << "%" << name_mapper_(word);
+      EmitId(word);
       break;
     case SPV_OPERAND_TYPE_ID:
     case SPV_OPERAND_TYPE_TYPE_ID:
     case SPV_OPERAND_TYPE_SCOPE_ID:
     case SPV_OPERAND_TYPE_MEMORY_SEMANTICS_ID:
       SetYellow();
-      stream_ << "%" << name_mapper_(word);
+      EmitId(word);
       break;
     case SPV_OPERAND_TYPE_EXTENSION_INSTRUCTION_NUMBER: {
       spv_ext_inst_desc ext_inst;
       if (grammar_.lookupExtInst(inst.ext_inst_type, word, &ext_inst))
         assert(false && "should have caught this earlier");
       SetRed();
-      stream_ << ext_inst->name;
+      Emit(ext_inst->name);
     } break;
     case SPV_OPERAND_TYPE_SPEC_CONSTANT_OP_NUMBER: {
       spv_opcode_desc opcode_desc;
       if (grammar_.lookupOpcode(SpvOp(word), &opcode_desc))
         assert(false && "should have caught this earlier");
       SetRed();
-      stream_ << opcode_desc->name;
+      Emit(opcode_desc->name);
     } break;
     case SPV_OPERAND_TYPE_LITERAL_INTEGER:
     case SPV_OPERAND_TYPE_TYPED_LITERAL_NUMBER: {
       SetRed();
-      libspirv::EmitNumericLiteral(&stream_, inst, operand);
+      EmitNumericLiteral(inst, operand);
       ResetColor();
     } break;
     case SPV_OPERAND_TYPE_LITERAL_STRING: {
-      stream_ << "\"";
+      Emit('"');
       SetGreen();
       // Strings are always little-endian, and null-terminated.
       // Write out the characters, escaping as needed, and without copying
       // the entire string.
       auto c_str = reinterpret_cast<const char*>(inst.words + operand.offset);
       for (auto p = c_str; *p; ++p) {
-        if (*p == '"' || *p == '\\') stream_ << '\\';
-        stream_ << *p;
+        if (*p == '"' || *p == '\\') Emit('\\');
+        Emit(*p);
       }
       ResetColor();
-      stream_ << '"';
+      Emit('"');
     } break;
     case SPV_OPERAND_TYPE_CAPABILITY:
     case SPV_OPERAND_TYPE_SOURCE_LANGUAGE:
@@ -274,7 +379,7 @@ void Disassembler::EmitOperand(const spv_parsed_instruction_t& inst,
       spv_operand_desc entry;
       if (grammar_.lookupOperand(operand.type, word, &entry))
         assert(false && "should have caught this earlier");
-      stream_ << entry->name;
+      Emit(entry->name);
     } break;
     case SPV_OPERAND_TYPE_FP_FAST_MATH_MODE:
     case SPV_OPERAND_TYPE_FUNCTION_CONTROL:
@@ -304,8 +409,8 @@ void Disassembler::EmitMaskOperand(const spv_operand_type_t type,
       spv_operand_desc entry;
       if (grammar_.lookupOperand(type, mask, &entry))
         assert(false && "should have caught this earlier");
-      if (num_emitted) stream_ << "|";
-      stream_ << entry->name;
+      if (num_emitted) Emit('|');
+      Emit(entry->name);
       num_emitted++;
     }
   }
@@ -314,25 +419,59 @@ void Disassembler::EmitMaskOperand(const spv_operand_type_t type,
     // of the 0 value. In many cases, that's "None".
     spv_operand_desc entry;
     if (SPV_SUCCESS == grammar_.lookupOperand(type, 0, &entry))
-      stream_ << entry->name;
+      Emit(entry->name);
   }
 }
 
-spv_result_t Disassembler::SaveTextResult(spv_text* text_result) const {
-  if (!print_) {
-    size_t length = text_.str().size();
-    char* str = new char[length + 1];
-    if (!str) return SPV_ERROR_OUT_OF_MEMORY;
-    strncpy(str, text_.str().c_str(), length + 1);
-    spv_text text = new spv_text_t();
-    if (!text) {
-      delete[] str;
-      return SPV_ERROR_OUT_OF_MEMORY;
-    }
-    text->str = str;
-    text->length = length;
-    *text_result = text;
+void Disassembler::EmitNumericLiteral(const spv_parsed_instruction_t& inst,
+                                      const spv_parsed_operand_t& operand) {
+  if (operand.number_kind == SPV_NUMBER_FLOATING ||
+      (operand.num_words != 1 && operand.num_words != 2)) {
+    // Floating point numbers need the formatting of the FloatProxy stream
+    // operators.
+    float_text_.str(std::string());
+    libspirv::EmitNumericLiteral(&float_text_, inst, operand);
+    Emit(float_text_.str());
+    return;
+  }
+  // Multi-word numbers are presented with lower order words first.
+  uint64_t bits = inst.words[operand.offset];
+  if (operand.num_words == 2) {
+    bits |= uint64_t(inst.words[operand.offset + 1]) << 32;
   }
+  switch (operand.number_kind) {
+    case SPV_NUMBER_SIGNED_INT:
+      AppendSignedDecimal(&text_, operand.num_words == 1
+                                      ? int64_t(int32_t(uint32_t(bits)))
+                                      : int64_t(bits));
+      break;
+    case SPV_NUMBER_UNSIGNED_INT:
+      AppendDecimal(&text_, bits);
+      break;
+    default:
+      assert(false && "Unreachable");
+  }
+}
+
+// Copies |str| into a new text object, and stores it in |text_result|.
+spv_result_t CreateTextResult(const std::string& str, spv_text* text_result) {
+  size_t length = str.size();
+  char* chars = new char[length + 1];
+  if (!chars) return SPV_ERROR_OUT_OF_MEMORY;
+  memcpy(chars, str.c_str(), length + 1);
+  spv_text text = new spv_text_t();
+  if (!text) {
+    delete[] chars;
+    return SPV_ERROR_OUT_OF_MEMORY;
+  }
+  text->str = chars;
+  text->length = length;
+  *text_result = text;
+  return SPV_SUCCESS;
+}
+
+spv_result_t Disassembler::SaveTextResult(spv_text* text_result) const {
+  if (!print_) return CreateTextResult(text_, text_result);
   return SPV_SUCCESS;
 }
 
@@ -399,12 +538,185 @@ spv_result_t DisassembleTargetInstruction(
   return SPV_SUCCESS;
 }
 
+// A part of a module that is disassembled on its own.  The parser is given
+// the header and the global section of the module, followed by the functions
+// of the chunk, so that it knows the types and the extended instruction
+// imports.  Only the instructions from |first_word| on are disassembled.
+struct DisassemblyChunk {
+  Disassembler* disassembler;
+  size_t first_word;   // The index of the first instruction to disassemble.
+  size_t byte_offset;  // The offset of that instruction in the whole module.
+  size_t word_index;   // The index of the next instruction to be parsed.
+  std::vector<uint32_t> result_ids;  // The ids defined by the chunk.
+};
+
+spv_result_t DisassembleChunkHeader(void* user_data, spv_endianness_t endian,
+                                    uint32_t /* magic */, uint32_t version,
+                                    uint32_t generator, uint32_t id_bound,
+                                    uint32_t schema) {
+  assert(user_data);
+  auto chunk = static_cast<DisassemblyChunk*>(user_data);
+  if (auto error = chunk->disassembler->HandleHeader(endian, version,
+                                                     generator, id_bound,
+                                                     schema)) {
+    return error;
+  }
+  chunk->disassembler->set_byte_offset(chunk->byte_offset);
+  chunk->word_index = SPV_INDEX_INSTRUCTION;
+  return SPV_SUCCESS;
+}
+
+spv_result_t DisassembleChunkInstruction(
+    void* user_data, const spv_parsed_instruction_t* parsed_instruction) {
+  assert(user_data);
+  auto chunk = static_cast<DisassemblyChunk*>(user_data);
+  const size_t word_index = chunk->word_index;
+  chunk->word_index += parsed_instruction->num_words;
+  if (word_index < chunk->first_word) return SPV_SUCCESS;
+  if (parsed_instruction->result_id) {
+    chunk->result_ids.push_back(parsed_instruction->result_id);
+  }
+  return chunk->disassembler->HandleInstruction(*parsed_instruction);
+}
+
+// Returns the word offsets of the OpFunction instructions of the module of
+// |word_count| words at |code|, found by following the word counts of the
+// instructions.  Returns an empty list if the instructions do not exactly
+// cover the module.
+std::vector<size_t> FindFunctionStarts(const uint32_t* code,
+                                       size_t word_count) {
+  std::vector<size_t> starts;
+  spv_const_binary_t binary = {code, word_count};
+  spv_endianness_t endian;
+  if (word_count < SPV_INDEX_INSTRUCTION ||
+      spvBinaryEndianness(&binary, &endian) != SPV_SUCCESS) {
+    return starts;
+  }
+  for (size_t i = SPV_INDEX_INSTRUCTION; i < word_count;) {
+    const uint32_t first_word = spvFixWord(code[i], endian);
+    const size_t inst_word_count = first_word >> 16;
+    if (inst_word_count == 0 || inst_word_count > word_count - i) {
+      starts.clear();
+      break;
+    }
+    if ((first_word & 0xFFFF) == SpvOpFunction) starts.push_back(i);
+    i += inst_word_count;
+  }
+  return starts;
+}
+
+// Disassembles the module of |word_count| words at |code| in chunks of whole
+// functions, using up to |thread_count| threads, and stores the texts of the
+// chunks in order in |texts|.  Returns false if the module is not split, or
+// if a chunk fails to parse, or if two chunks define the same id.  The module
+// should then be disassembled serially, which reports the errors.
+bool DisassembleChunks(const spv_context_t& context,
+                       const libspirv::AssemblyGrammar& grammar,
+                       uint32_t options,
+                       const libspirv::FriendlyNameMapper* friendly_mapper,
+                       const uint32_t* code, size_t word_count,
+                       uint32_t thread_count, std::vector<std::string>* texts) {
+#if defined(SPIRV_WINDOWS)
+  // When printing in color, the console color is set as the text is
+  // written, so the text has to be written as it is produced.
+  if (spvIsInBitfield(SPV_BINARY_TO_TEXT_OPTION_PRINT, options) &&
+      spvIsInBitfield(SPV_BINARY_TO_TEXT_OPTION_COLOR, options)) {
+    return false;
+  }
+#endif
+  const std::vector<size_t> function_starts =
+      FindFunctionStarts(code, word_count);
+  if (function_starts.size() < 2) return false;
+
+  // Start a new chunk at the first function that is at least |chunk_size|
+  // words after the start of the previous one.  The first chunk also holds
+  // the global section.
+  const size_t chunk_size = word_count / thread_count + 1;
+  std::vector<size_t> chunk_starts(1, SPV_INDEX_INSTRUCTION);
+  for (size_t start : function_starts) {
+    if (start - chunk_starts.back() >= chunk_size) {
+      chunk_starts.push_back(start);
+    }
+  }
+  if (chunk_starts.size() < 2) return false;
+  chunk_starts.push_back(word_count);
+  const size_t num_chunks = chunk_starts.size() - 1;
+  const size_t globals_end = function_starts.front();
+
+  // The chunks are parsed quietly.  A failure is reported by the serial
+  // parse instead.
+  spv_context_t quiet_context = context;
+  quiet_context.consumer = nullptr;
+  // The text of the chunks is printed by the caller, in order.
+  options &= ~static_cast<uint32_t>(SPV_BINARY_TO_TEXT_OPTION_PRINT);
+
+  std::vector<DisassemblyChunk> chunks(num_chunks);
+  std::vector<spv_result_t> results(num_chunks, SPV_SUCCESS);
+  texts->assign(num_chunks, std::string());
+  spvutils::ParallelFor(num_chunks, thread_count, [&](size_t i) {
+    const size_t begin = chunk_starts[i];
+    const size_t end = chunk_starts[i + 1];
+    DisassemblyChunk& chunk = chunks[i];
+    chunk.byte_offset = begin * sizeof(uint32_t);
+    uint32_t chunk_options = options;
+    const uint32_t* chunk_code = code;
+    size_t chunk_word_count = end;
+    std::vector<uint32_t> words;
+    if (i == 0) {
+      chunk.first_word = SPV_INDEX_INSTRUCTION;
+    } else {
+      chunk.first_word = globals_end;
+      chunk_options |= SPV_BINARY_TO_TEXT_OPTION_NO_HEADER;
+      words.reserve(globals_end + end - begin);
+      words.assign(code, code + globals_end);
+      words.insert(words.end(), code + begin, code + end);
+      chunk_code = words.data();
+      chunk_word_count = words.size();
+    }
+    Disassembler disassembler(grammar, chunk_options, friendly_mapper);
+    chunk.disassembler = &disassembler;
+    results[i] =
+        spvBinaryParse(&quiet_context, &chunk, chunk_code, chunk_word_count,
+                       DisassembleChunkHeader, DisassembleChunkInstruction,
+                       nullptr);
+    chunk.disassembler = nullptr;
+    (*texts)[i] = disassembler.TakeText();
+  });
+
+  for (spv_result_t result : results) {
+    if (result != SPV_SUCCESS) return false;
+  }
+
+  // Each chunk only sees its own functions, so an id defined in two chunks
+  // is only caught by the serial parse.
+  spv_endianness_t endian;
+  spv_const_binary_t binary = {code, word_count};
+  if (spvBinaryEndianness(&binary, &endian) != SPV_SUCCESS) return false;
+  std::vector<bool> defined(spvFixWord(code[SPV_INDEX_BOUND], endian), false);
+  for (const DisassemblyChunk& chunk : chunks) {
+    for (uint32_t id : chunk.result_ids) {
+      if (id >= defined.size() || defined[id]) return false;
+      defined[id] = true;
+    }
+  }
+  return true;
+}
+
 }  // anonymous namespace
 
 spv_result_t spvBinaryToText(const spv_const_context context,
                              const uint32_t* code, const size_t wordCount,
                              const uint32_t options, spv_text* pText,
                              spv_diagnostic* pDiagnostic) {
+  return spvBinaryToTextWithThreadCount(context, code, wordCount, options, 1,
+                                        pText, pDiagnostic);
+}
+
+spv_result_t spvBinaryToTextWithThreadCount(
+    const spv_const_context context, const uint32_t* code,
+    const size_t wordCount, const uint32_t options,
+    const uint32_t thread_count, spv_text* pText,
+    spv_diagnostic* pDiagnostic) {
   spv_context_t hijack_context = *context;
   if (pDiagnostic) {
     *pDiagnostic = nullptr;
@@ -416,15 +728,34 @@ spv_result_t spvBinaryToText(const spv_const_context context,
 
   // Generate friendly names for Ids if requested.
   std::unique_ptr<libspirv::FriendlyNameMapper> friendly_mapper;
-  libspirv::NameMapper name_mapper = libspirv::GetTrivialNameMapper();
   if (options & SPV_BINARY_TO_TEXT_OPTION_FRIENDLY_NAMES) {
     friendly_mapper.reset(
         new libspirv::FriendlyNameMapper(&hijack_context, code, wordCount));
-    name_mapper = friendly_mapper->GetNameMapper();
+  }
+
+  // Once the names are known, the functions can be disassembled
+  // independently.
+  std::vector<std::string> texts;
+  if (thread_count > 1 &&
+      DisassembleChunks(hijack_context, grammar, options,
+                        friendly_mapper.get(), code, wordCount, thread_count,
+                        &texts)) {
+    if (spvIsInBitfield(SPV_BINARY_TO_TEXT_OPTION_PRINT, options)) {
+      for (const std::string& text : texts) {
+        std::cout.write(text.data(), text.size());
+      }
+      return SPV_SUCCESS;
+    }
+    std::string text;
+    size_t length = 0;
+    for (const std::string& chunk_text : texts) length += chunk_text.size();
+    text.reserve(length);
+    for (const std::string& chunk_text : texts) text += chunk_text;
+    return CreateTextResult(text, pText);
   }
 
   // Now disassemble!
-  Disassembler disassembler(grammar, options, name_mapper);
+  Disassembler disassembler(grammar, options, friendly_mapper.get());
   if (auto error = spvBinaryParse(&hijack_context, &disassembler, code,
                                   wordCount, DisassembleHeader,
                                   DisassembleInstruction, pDiagnostic)) {
@@ -449,15 +780,13 @@ std::string spvtools::spvInstructionBinaryToText(const spv_target_env env,
 
   // Generate friendly names for Ids if requested.
   std::unique_ptr<libspirv::FriendlyNameMapper> friendly_mapper;
-  libspirv::NameMapper name_mapper = libspirv::GetTrivialNameMapper();
   if (options & SPV_BINARY_TO_TEXT_OPTION_FRIENDLY_NAMES) {
     friendly_mapper.reset(
         new libspirv::FriendlyNameMapper(context, code, wordCount));
-    name_mapper = friendly_mapper->GetNameMapper();
   }
 
   // Now disassemble!
-  Disassembler disassembler(grammar, options, name_mapper);
+  Disassembler disassembler(grammar, options, friendly_mapper.get());
   WrappedDisassembler wrapped(&disassembler, instCode, instWordCount);
   spvBinaryParse(context, &wrapped, code, wordCount, DisassembleTargetHeader,
                  DisassembleTargetInstruction, nullptr);
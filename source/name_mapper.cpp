@@ -47,22 +47,22 @@ NameMapper GetTrivialNameMapper() { return to_string; }
 FriendlyNameMapper::FriendlyNameMapper(const spv_const_context context,
                                        const uint32_t* code,
                                        const size_t wordCount)
-    : grammar_(libspirv::AssemblyGrammar(context)) {
+    : word_count_(wordCount), grammar_(libspirv::AssemblyGrammar(context)) {
   spv_diagnostic diag = nullptr;
   // We don't care if the parse fails.
-  spvBinaryParse(context, this, code, wordCount, nullptr,
+  spvBinaryParse(context, this, code, wordCount, ParseHeaderForwarder,
                  ParseInstructionForwarder, &diag);
   spvDiagnosticDestroy(diag);
 }
 
 std::string FriendlyNameMapper::NameForId(uint32_t id) {
-  auto iter = name_for_id_.find(id);
-  if (iter == name_for_id_.end()) {
+  const std::string* name = FindNameForId(id);
+  if (name == nullptr) {
     // It must have been an invalid module, so just return a trivial mapping.
     // We don't care about uniqueness.
     return to_string(id);
   } else {
-    return iter->second;
+    return *name;
   }
 }
 
@@ -83,7 +83,7 @@ std::string FriendlyNameMapper::Sanitize(const std::string& suggested_name) {
 
 void FriendlyNameMapper::SaveName(uint32_t id,
                                   const std::string& suggested_name) {
-  if (name_for_id_.find(id) != name_for_id_.end()) return;
+  if (FindNameForId(id) != nullptr) return;
 
   const std::string sanitized_suggested_name = Sanitize(suggested_name);
   std::string name = sanitized_suggested_name;
@@ -95,7 +95,11 @@ void FriendlyNameMapper::SaveName(uint32_t id,
       inserted = used_names_.insert(name);
     }
   }
-  name_for_id_[id] = name;
+  if (id < name_for_id_.size()) {
+    name_for_id_[id] = name;
+  } else {
+    sparse_name_for_id_[id] = name;
+  }
 }
 
 void FriendlyNameMapper::SaveBuiltInName(uint32_t target_id,
@@ -311,7 +315,7 @@ spv_result_t FriendlyNameMapper::ParseInstruction(
       // string something like "1" that might collide with this result_id.
       // We should only do this if a name hasn't already been registered by some
       // previous forward reference.
-      if (result_id && name_for_id_.find(result_id) == name_for_id_.end())
+      if (result_id && FindNameForId(result_id) == nullptr)
         SaveName(result_id, to_string(result_id));
       break;
   }
@@ -15,10 +15,12 @@
 #ifndef LIBSPIRV_NAME_MAPPER_H_
 #define LIBSPIRV_NAME_MAPPER_H_
 
+#include <algorithm>
 #include <functional>
 #include <string>
 #include <unordered_map>
 #include <unordered_set>
+#include <vector>
 
 #include "assembly_grammar.h"
 #include "spirv-tools/libspirv.h"
@@ -78,6 +80,17 @@ class FriendlyNameMapper {
   // NameMapper.
   std::string NameForId(uint32_t id);
 
+  // Returns a pointer to the friendly name for the given id, or nullptr if
+  // the id is not defined in the module parsed during construction.  The name
+  // is not copied, and stays valid for the lifetime of this mapper.
+  const std::string* FindNameForId(uint32_t id) const {
+    if (id < name_for_id_.size()) {
+      return name_for_id_[id].empty() ? nullptr : &name_for_id_[id];
+    }
+    auto iter = sparse_name_for_id_.find(id);
+    return iter == sparse_name_for_id_.end() ? nullptr : &iter->second;
+  }
+
  private:
   // Transforms the given string so that it is acceptable as an Id name in
   // assembly language.  Two distinct inputs can map to the same output.
@@ -97,6 +110,20 @@ class FriendlyNameMapper {
   // name_for_id_.  Returns SPV_SUCCESS;
   spv_result_t ParseInstruction(const spv_parsed_instruction_t& inst);
 
+  // Forwards a parsed-header callback from the binary parser into the
+  // FriendlyNameMapper hidden inside the user_data parameter.  Sizes the
+  // name table for the id bound of the module.
+  static spv_result_t ParseHeaderForwarder(void* user_data, spv_endianness_t,
+                                           uint32_t, uint32_t, uint32_t,
+                                           uint32_t id_bound, uint32_t) {
+    auto mapper = reinterpret_cast<FriendlyNameMapper*>(user_data);
+    // Ids are not checked against the bound, so a bogus bound must not cause
+    // a huge allocation.  Each defined id takes at least two words.
+    mapper->name_for_id_.resize(
+        std::min<size_t>(id_bound, mapper->word_count_ / 2 + 1));
+    return SPV_SUCCESS;
+  }
+
   // Forwards a parsed-instruction callback from the binary parser into the
   // FriendlyNameMapper hidden inside the user_data parameter.
   static spv_result_t ParseInstructionForwarder(
@@ -108,9 +135,14 @@ class FriendlyNameMapper {
   // Returns the friendly name for an enumerant.
   std::string NameForEnumOperand(spv_operand_type_t type, uint32_t word);
 
-  // Maps an id to its friendly name.  This will have an entry for each Id
-  // defined in the module.
-  std::unordered_map<uint32_t, std::string> name_for_id_;
+  // Maps an id to its friendly name, indexed by id.  This will have a
+  // non-empty entry for each Id defined in the module, except for the ones
+  // past its end, which are in |sparse_name_for_id_|.
+  std::vector<std::string> name_for_id_;
+  // Maps the ids that do not fit in |name_for_id_| to their friendly name.
+  std::unordered_map<uint32_t, std::string> sparse_name_for_id_;
+  // The number of words in the module.
+  const size_t word_count_;
   // The set of names that have a mapping in name_for_id_;
   std::unordered_set<std::string> used_names_;
   // The assembly grammar for the current context.
@@ -37,11 +37,14 @@ struct OpcodeDescPtrLen {
 #include "core.insts-1.2.inc"  // defines kOpcodeTableEntries_1_2
 
 static const spv_opcode_table_t kTable_1_0 = {
-    ARRAY_SIZE(kOpcodeTableEntries_1_0), kOpcodeTableEntries_1_0};
+    ARRAY_SIZE(kOpcodeTableEntries_1_0), kOpcodeTableEntries_1_0,
+    ARRAY_SIZE(kOpcodeNameIndex_1_0), kOpcodeNameIndex_1_0};
 static const spv_opcode_table_t kTable_1_1 = {
-    ARRAY_SIZE(kOpcodeTableEntries_1_1), kOpcodeTableEntries_1_1};
+    ARRAY_SIZE(kOpcodeTableEntries_1_1), kOpcodeTableEntries_1_1,
+    ARRAY_SIZE(kOpcodeNameIndex_1_1), kOpcodeNameIndex_1_1};
 static const spv_opcode_table_t kTable_1_2 = {
-    ARRAY_SIZE(kOpcodeTableEntries_1_2), kOpcodeTableEntries_1_2};
+    ARRAY_SIZE(kOpcodeTableEntries_1_2), kOpcodeTableEntries_1_2,
+    ARRAY_SIZE(kOpcodeNameIndex_1_2), kOpcodeNameIndex_1_2};
 
 // Represents a vendor tool entry in the SPIR-V XML Regsitry.
 struct VendorTool {
@@ -123,21 +126,22 @@ spv_result_t spvOpcodeTableNameLookup(const spv_opcode_table table,
   if (!name || !pEntry) return SPV_ERROR_INVALID_POINTER;
   if (!table) return SPV_ERROR_INVALID_TABLE;
 
-  // TODO: This lookup of the Opcode table is suboptimal! Binary sort would be
-  // preferable but the table requires sorting on the Opcode name, but it's
-  // static
-  // const initialized and matches the order of the spec.
+  // The table is sorted by opcode, so names are looked up through the hash
+  // index generated alongside it.
   const size_t nameLength = strlen(name);
-  for (uint64_t opcodeIndex = 0; opcodeIndex < table->count; ++opcodeIndex) {
-    if (nameLength == strlen(table->entries[opcodeIndex].name) &&
-        !strncmp(name, table->entries[opcodeIndex].name, nameLength)) {
+  const uint32_t mask = table->name_index_size - 1;
+  for (uint32_t slot = spvTableNameHash(name, nameLength) & mask;;
+       slot = (slot + 1) & mask) {
+    const uint16_t opcodeIndex = table->name_index[slot];
+    if (opcodeIndex == kSpvTableIndexEmpty) return SPV_ERROR_INVALID_LOOKUP;
+    const char* entryName = table->entries[opcodeIndex].name;
+    if (nameLength == strlen(entryName) &&
+        !strncmp(name, entryName, nameLength)) {
       // NOTE: Found out Opcode!
       *pEntry = &table->entries[opcodeIndex];
       return SPV_SUCCESS;
     }
   }
-
-  return SPV_ERROR_INVALID_LOOKUP;
 }
 
 spv_result_t spvOpcodeTableValueLookup(const spv_opcode_table table,
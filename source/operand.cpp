@@ -77,10 +77,14 @@ spv_result_t spvOperandTableNameLookup(const spv_operand_table table,
   if (!table) return SPV_ERROR_INVALID_TABLE;
   if (!name || !pEntry) return SPV_ERROR_INVALID_POINTER;
 
+  const uint32_t hash = spvTableNameHash(name, nameLength);
   for (uint64_t typeIndex = 0; typeIndex < table->count; ++typeIndex) {
     const auto& group = table->types[typeIndex];
     if (type != group.type) continue;
-    for (uint64_t index = 0; index < group.count; ++index) {
+    const uint32_t mask = group.index_size - 1;
+    for (uint32_t slot = hash & mask;; slot = (slot + 1) & mask) {
+      const uint16_t index = group.name_index[slot];
+      if (index == kSpvTableIndexEmpty) break;
       const auto& entry = group.entries[index];
       if (nameLength == strlen(entry.name) &&
           !strncmp(entry.name, name, nameLength)) {
@@ -100,10 +104,14 @@ spv_result_t spvOperandTableValueLookup(const spv_operand_table table,
   if (!table) return SPV_ERROR_INVALID_TABLE;
   if (!pEntry) return SPV_ERROR_INVALID_POINTER;
 
+  const uint32_t hash = spvTableValueHash(value);
   for (uint64_t typeIndex = 0; typeIndex < table->count; ++typeIndex) {
     const auto& group = table->types[typeIndex];
     if (type != group.type) continue;
-    for (uint64_t index = 0; index < group.count; ++index) {
+    const uint32_t mask = group.index_size - 1;
+    for (uint32_t slot = hash & mask;; slot = (slot + 1) & mask) {
+      const uint16_t index = group.value_index[slot];
+      if (index == kSpvTableIndexEmpty) break;
       const auto& entry = group.entries[index];
       if (value == entry.value) {
         *pEntry = &entry;
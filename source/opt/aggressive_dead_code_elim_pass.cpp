@@ -87,6 +87,8 @@ struct DecorationLess {
 
 }  // namespace
 
+const uint32_t AggressiveDCEPass::kNoBlock;
+
 bool AggressiveDCEPass::IsVarOfStorage(uint32_t varId, uint32_t storageClass) {
   if (varId == 0) return false;
   const ir::Instruction* varInst = get_def_use_mgr()->GetDef(varId);
@@ -165,11 +167,12 @@ void AggressiveDCEPass::ProcessLoad(uint32_t varId) {
   // Only process locals
   if (!IsLocalVar(varId)) return;
   // Return if already processed
-  if (live_local_vars_.find(varId) != live_local_vars_.end()) return;
+  if (varId >= live_local_vars_.size()) live_local_vars_.resize(varId + 1);
+  if (live_local_vars_[varId]) return;
   // Mark all stores to varId as live
   AddStores(varId);
   // Cache varId as processed
-  live_local_vars_.insert(varId);
+  live_local_vars_[varId] = true;
 }
 
 bool AggressiveDCEPass::IsStructuredHeader(ir::BasicBlock* bp,
@@ -188,42 +191,40 @@ bool AggressiveDCEPass::IsStructuredHeader(ir::BasicBlock* bp,
 
 void AggressiveDCEPass::ComputeBlock2HeaderMaps(
     std::list<ir::BasicBlock*>& structuredOrder) {
-  block2headerBranch_.clear();
-  branch2merge_.clear();
-  structured_order_index_.clear();
-  std::stack<ir::Instruction*> currentHeaderBranch;
-  currentHeaderBranch.push(nullptr);
+  std::stack<uint32_t> currentHeader;
+  currentHeader.push(kNoBlock);
   uint32_t currentMergeBlockId = 0;
-  uint32_t index = 0;
-  for (auto bi = structuredOrder.begin(); bi != structuredOrder.end();
-       ++bi, ++index) {
-    structured_order_index_[*bi] = index;
+  for (ir::BasicBlock* bb : structuredOrder) {
+    const uint32_t index = static_cast<uint32_t>(blocks_.size());
+    bb->ForEachInst([this, index](ir::Instruction* inst) {
+      if (inst->unique_id() >= inst_blocks_.size())
+        inst_blocks_.resize(inst->unique_id() + 1, kNoBlock);
+      inst_blocks_[inst->unique_id()] = index;
+    });
     // If this block is the merge block of the current control construct,
     // we are leaving the current construct so we must update state
-    if ((*bi)->id() == currentMergeBlockId) {
-      currentHeaderBranch.pop();
-      ir::Instruction* chb = currentHeaderBranch.top();
-      if (chb != nullptr)
-        currentMergeBlockId = branch2merge_[chb]->GetSingleWordInOperand(0);
+    if (bb->id() == currentMergeBlockId) {
+      currentHeader.pop();
+      const uint32_t chb = currentHeader.top();
+      if (chb != kNoBlock)
+        currentMergeBlockId = blocks_[chb].merge->GetSingleWordInOperand(0);
     }
     ir::Instruction* mergeInst;
-    ir::Instruction* branchInst;
     uint32_t mergeBlockId;
-    bool is_header =
-        IsStructuredHeader(*bi, &mergeInst, &branchInst, &mergeBlockId);
+    bool is_header = IsStructuredHeader(bb, &mergeInst, nullptr, &mergeBlockId);
+    blocks_.push_back(
+        {bb, is_header ? mergeInst : nullptr, kNoBlock, false, false});
     // If this is a loop header, update state first so the block will map to
     // the loop.
     if (is_header && mergeInst->opcode() == SpvOpLoopMerge) {
-      currentHeaderBranch.push(branchInst);
-      branch2merge_[branchInst] = mergeInst;
+      currentHeader.push(index);
       currentMergeBlockId = mergeBlockId;
     }
     // Map the block to the current construct.
-    block2headerBranch_[*bi] = currentHeaderBranch.top();
+    blocks_[index].header = currentHeader.top();
     // If this is an if header, update state so following blocks map to the if.
     if (is_header && mergeInst->opcode() == SpvOpSelectionMerge) {
-      currentHeaderBranch.push(branchInst);
-      branch2merge_[branchInst] = mergeInst;
+      currentHeader.push(index);
       currentMergeBlockId = mergeBlockId;
     }
   }
@@ -239,22 +240,24 @@ void AggressiveDCEPass::AddBranch(uint32_t labelId, ir::BasicBlock* bp) {
 
 void AggressiveDCEPass::AddBreaksAndContinuesToWorklist(
     ir::Instruction* loopMerge) {
-  ir::BasicBlock* header = context()->get_instr_block(loopMerge);
-  uint32_t headerIndex = structured_order_index_[header];
+  const uint32_t headerIndex = GetBlockIndex(loopMerge);
+  // The breaks and continues only depend on the structure of the function,
+  // so they only need to be added once.
+  if (blocks_[headerIndex].breaks_and_continues_live) return;
+  blocks_[headerIndex].breaks_and_continues_live = true;
   const uint32_t mergeId =
       loopMerge->GetSingleWordInOperand(kLoopMergeMergeBlockIdInIdx);
-  ir::BasicBlock* merge = context()->get_instr_block(mergeId);
-  uint32_t mergeIndex = structured_order_index_[merge];
+  const uint32_t mergeIndex =
+      GetBlockIndex(get_def_use_mgr()->GetDef(mergeId));
   get_def_use_mgr()->ForEachUser(
       mergeId, [headerIndex, mergeIndex, this](ir::Instruction* user) {
         if (!user->IsBranch()) return;
-        ir::BasicBlock* block = context()->get_instr_block(user);
-        uint32_t index = structured_order_index_[block];
+        uint32_t index = GetBlockIndex(user);
         if (headerIndex < index && index < mergeIndex) {
           // This is a break from the loop.
           AddToWorklist(user);
           // Add branch's merge if there is one.
-          ir::Instruction* userMerge = branch2merge_[user];
+          ir::Instruction* userMerge = blocks_[index].merge;
           if (userMerge != nullptr) AddToWorklist(userMerge);
         }
       });
@@ -263,10 +266,12 @@ void AggressiveDCEPass::AddBreaksAndContinuesToWorklist(
   get_def_use_mgr()->ForEachUser(contId, [&contId,
                                           this](ir::Instruction* user) {
     SpvOp op = user->opcode();
+    const uint32_t index = GetBlockIndex(user);
     if (op == SpvOpBranchConditional || op == SpvOpSwitch) {
       // A conditional branch or switch can only be a continue if it does not
       // have a merge instruction or its merge block is not the continue block.
-      ir::Instruction* hdrMerge = branch2merge_[user];
+      ir::Instruction* hdrMerge =
+          index != kNoBlock ? blocks_[index].merge : nullptr;
       if (hdrMerge != nullptr && hdrMerge->opcode() == SpvOpSelectionMerge) {
         uint32_t hdrMergeId =
             hdrMerge->GetSingleWordInOperand(kSelectionMergeMergeBlockIdInIdx);
@@ -277,10 +282,8 @@ void AggressiveDCEPass::AddBreaksAndContinuesToWorklist(
     } else if (op == SpvOpBranch) {
       // An unconditional branch can only be a continue if it is not
       // branching to its own merge block.
-      ir::BasicBlock* blk = context()->get_instr_block(user);
-      ir::Instruction* hdrBranch = block2headerBranch_[blk];
-      if (hdrBranch == nullptr) return;
-      ir::Instruction* hdrMerge = branch2merge_[hdrBranch];
+      if (index == kNoBlock || blocks_[index].header == kNoBlock) return;
+      ir::Instruction* hdrMerge = blocks_[blocks_[index].header].merge;
       if (hdrMerge->opcode() == SpvOpLoopMerge) return;
       uint32_t hdrMergeId =
           hdrMerge->GetSingleWordInOperand(kSelectionMergeMergeBlockIdInIdx);
@@ -292,7 +295,8 @@ void AggressiveDCEPass::AddBreaksAndContinuesToWorklist(
   });
 }
 
-bool AggressiveDCEPass::AggressiveDCE(ir::Function* func) {
+void AggressiveDCEPass::InitializeFunctionLiveInstructions(
+    ir::Function* func) {
   // Mark function parameters as live.
   AddToWorklist(&func->DefInst());
   func->ForEachParam(
@@ -304,14 +308,14 @@ bool AggressiveDCEPass::AggressiveDCE(ir::Function* func) {
   // Compute map from block to controlling conditional branch
   std::list<ir::BasicBlock*> structuredOrder;
   cfg()->ComputeStructuredOrder(func, &*func->begin(), &structuredOrder);
+  const uint32_t firstBlock = static_cast<uint32_t>(blocks_.size());
   ComputeBlock2HeaderMaps(structuredOrder);
-  bool modified = false;
   // Add instructions with external side effects to worklist. Also add branches
   // EXCEPT those immediately contained in an "if" selection construct or a loop
   // or continue construct.
   // TODO(greg-lunarg): Handle Frexp, Modf more optimally
-  call_in_func_ = false;
-  func_is_entry_point_ = false;
+  bool call_in_func = false;
+  bool func_is_entry_point = false;
   private_stores_.clear();
   // Stacks to keep track of when we are inside an if- or loop-construct.
   // When immediately inside an if- or loop-construct, we do not initially
@@ -363,7 +367,7 @@ bool AggressiveDCEPass::AggressiveDCE(ir::Function* func) {
             AddToWorklist(&*ii);
           }
           // Remember function calls
-          if (op == SpvOpFunctionCall) call_in_func_ = true;
+          if (op == SpvOpFunctionCall) call_in_func = true;
         } break;
       }
     }
@@ -372,16 +376,21 @@ bool AggressiveDCEPass::AggressiveDCE(ir::Function* func) {
   for (auto& ei : get_module()->entry_points()) {
     if (ei.GetSingleWordInOperand(kEntryPointFunctionIdInIdx) ==
         func->result_id()) {
-      func_is_entry_point_ = true;
+      func_is_entry_point = true;
       break;
     }
   }
   // If the current function is an entry point and has no function calls,
   // we can optimize private variables as locals
-  private_like_local_ = func_is_entry_point_ && !call_in_func_;
+  const bool private_like_local = func_is_entry_point && !call_in_func;
+  for (uint32_t i = firstBlock; i < blocks_.size(); ++i)
+    blocks_[i].private_like_local = private_like_local;
   // If privates are not like local, add their stores to worklist
-  if (!private_like_local_)
+  if (!private_like_local)
     for (auto& ps : private_stores_) AddToWorklist(ps);
+}
+
+void AggressiveDCEPass::ProcessWorklist() {
   // Perform closure on live instruction set.
   while (!worklist_.empty()) {
     ir::Instruction* liveInst = worklist_.front();
@@ -401,16 +410,19 @@ bool AggressiveDCEPass::AggressiveDCE(ir::Function* func) {
     // conditional branch and its merge. Any containing control construct
     // is marked live when the merge and branch are processed out of the
     // worklist.
-    ir::BasicBlock* blk = context()->get_instr_block(liveInst);
-    ir::Instruction* branchInst = block2headerBranch_[blk];
-    if (branchInst != nullptr) {
-      AddToWorklist(branchInst);
-      ir::Instruction* mergeInst = branch2merge_[branchInst];
+    const uint32_t blk = GetBlockIndex(liveInst);
+    const uint32_t header = blk != kNoBlock ? blocks_[blk].header : kNoBlock;
+    if (header != kNoBlock) {
+      AddToWorklist(&*blocks_[header].block->tail());
+      ir::Instruction* mergeInst = blocks_[header].merge;
       AddToWorklist(mergeInst);
       // If in a loop, mark all its break and continue instructions live
       if (mergeInst->opcode() == SpvOpLoopMerge)
         AddBreaksAndContinuesToWorklist(mergeInst);
     }
+    // Loads of private variables are like loads of locals only in the
+    // functions where privates are optimized like locals.
+    private_like_local_ = blk != kNoBlock && blocks_[blk].private_like_local;
     // If local load, add all variable's stores if variable not already live
     if (liveInst->opcode() == SpvOpLoad) {
       uint32_t varId;
@@ -435,11 +447,15 @@ bool AggressiveDCEPass::AggressiveDCE(ir::Function* func) {
     }
     worklist_.pop();
   }
+}
 
+bool AggressiveDCEPass::KillDeadInstructions() {
+  bool modified = false;
   // Kill dead instructions and remember dead blocks
-  for (auto bi = structuredOrder.begin(); bi != structuredOrder.end();) {
+  for (auto bi = blocks_.begin(); bi != blocks_.end();) {
     uint32_t mergeBlockId = 0;
-    (*bi)->ForEachInst([this, &modified, &mergeBlockId](ir::Instruction* inst) {
+    bi->block->ForEachInst([this, &modified,
+                            &mergeBlockId](ir::Instruction* inst) {
       if (!IsDead(inst)) return;
       if (inst->opcode() == SpvOpLabel) return;
       // If dead instruction is selection merge, remember merge block
@@ -454,8 +470,8 @@ bool AggressiveDCEPass::AggressiveDCE(ir::Function* func) {
     // block, and traverse to the merge block and continue processing there.
     // We know the block still exists because the label is not deleted.
     if (mergeBlockId != 0) {
-      AddBranch(mergeBlockId, *bi);
-      for (++bi; (*bi)->id() != mergeBlockId; ++bi) {
+      AddBranch(mergeBlockId, bi->block);
+      for (++bi; bi->block->id() != mergeBlockId; ++bi) {
       }
     } else {
       ++bi;
@@ -470,8 +486,15 @@ void AggressiveDCEPass::Initialize(ir::IRContext* c) {
 
   // Clear collections
   worklist_ = std::queue<ir::Instruction*>{};
-  live_insts_.clear();
-  live_local_vars_.clear();
+  uint32_t uniqueIdBound = 0;
+  get_module()->ForEachInst([&uniqueIdBound](ir::Instruction* inst) {
+    uniqueIdBound = std::max(uniqueIdBound, inst->unique_id() + 1);
+  });
+  live_insts_.assign(uniqueIdBound, false);
+  inst_blocks_.assign(uniqueIdBound, kNoBlock);
+  live_local_vars_.assign(get_module()->IdBound(), false);
+  blocks_.clear();
+  to_kill_.clear();
 
   // Initialize extensions whitelist
   InitExtensions();
@@ -505,9 +528,14 @@ Pass::Status AggressiveDCEPass::ProcessImpl() {
 
   InitializeModuleScopeLiveInstructions();
 
-  // Process all entry point functions.
-  ProcessFunction pfn = [this](ir::Function* fp) { return AggressiveDCE(fp); };
-  modified |= ProcessEntryPointCallTree(pfn, get_module());
+  // Process all entry point call trees with a single worklist.  Liveness is
+  // seeded from every function, whatever the function filter, since the
+  // global values only used by the functions left out would be removed.
+  for (ir::Function* func : GetEntryPointCallTree()) {
+    InitializeFunctionLiveInstructions(func);
+  }
+  ProcessWorklist();
+  modified |= KillDeadInstructions();
 
   // Process module-level instructions. Now that all live instructions have
   // been marked, it is safe to remove dead global values.
@@ -518,7 +546,9 @@ Pass::Status AggressiveDCEPass::ProcessImpl() {
     context()->KillInst(inst);
   }
 
-  // Cleanup all CFG including all unreachable blocks.
+  // Cleanup all CFG including all unreachable blocks.  The instructions killed
+  // above can be in any function, so this is not restricted by the function
+  // filter either.
   ProcessFunction cleanup = [this](ir::Function* f) { return CFGCleanup(f); };
   modified |= ProcessEntryPointCallTree(cleanup, get_module());
 
@@ -18,11 +18,13 @@
 #define LIBSPIRV_OPT_AGGRESSIVE_DCE_PASS_H_
 
 #include <algorithm>
+#include <limits>
 #include <map>
 #include <queue>
 #include <unordered_map>
 #include <unordered_set>
 #include <utility>
+#include <vector>
 
 #include "basic_block.h"
 #include "def_use_manager.h"
@@ -60,7 +62,8 @@ class AggressiveDCEPass : public MemPass {
 
   // Return true if |inst| is marked live.
   bool IsLive(const ir::Instruction* inst) const {
-    return live_insts_.find(inst) != live_insts_.end();
+    return inst->unique_id() < live_insts_.size() &&
+           live_insts_[inst->unique_id()];
   }
 
   // Returns true if |inst| is dead.
@@ -72,7 +75,19 @@ class AggressiveDCEPass : public MemPass {
 
   // Add |inst| to worklist_ and live_insts_.
   void AddToWorklist(ir::Instruction* inst) {
-    if (live_insts_.insert(inst).second) worklist_.push(inst);
+    const uint32_t index = inst->unique_id();
+    if (index >= live_insts_.size()) live_insts_.resize(index + 1, false);
+    if (live_insts_[index]) return;
+    live_insts_[index] = true;
+    worklist_.push(inst);
+  }
+
+  // Returns the index in |blocks_| of the block containing |inst|, or
+  // kNoBlock if |inst| is not in a reachable block of a processed function.
+  uint32_t GetBlockIndex(const ir::Instruction* inst) const {
+    return inst->unique_id() < inst_blocks_.size()
+               ? inst_blocks_[inst->unique_id()]
+               : kNoBlock;
   }
 
   // Add all store instruction which use |ptrId|, directly or indirectly,
@@ -101,8 +116,9 @@ class AggressiveDCEPass : public MemPass {
   bool IsStructuredHeader(ir::BasicBlock* bp, ir::Instruction** mergeInst,
                           ir::Instruction** branchInst, uint32_t* mergeBlockId);
 
-  // Initialize block2headerBranch_ and branch2merge_ using |structuredOrder|
-  // to order blocks.
+  // Appends the blocks in |structuredOrder| to |blocks_|, recording the
+  // header of the construct controlling each of them, and records the block
+  // of each of their instructions in |inst_blocks_|.
   void ComputeBlock2HeaderMaps(std::list<ir::BasicBlock*>& structuredOrder);
 
   // Add branch to |labelId| to end of block |bp|.
@@ -123,26 +139,50 @@ class AggressiveDCEPass : public MemPass {
   void EliminateFunction(ir::Function* func);
 
   // For function |func|, mark all Stores to non-function-scope variables
-  // and block terminating instructions as live. Recursively mark the values
-  // they use. When complete, mark any non-live instructions to be deleted.
-  // Returns true if the function has been modified.
+  // and block terminating instructions as live.  Adds the blocks of |func|
+  // to |blocks_|.
+  void InitializeFunctionLiveInstructions(ir::Function* func);
+
+  // Recursively marks live the values used by the instructions in the
+  // worklist, for all the functions at once.
+  void ProcessWorklist();
+
+  // Marks the non-live instructions of the blocks in |blocks_| to be deleted.
+  // Returns true if a function has been modified.
   //
   // Note: This function does not delete useless control structures. All
   // existing control structures will remain. This can leave not-insignificant
   // sequences of ultimately useless code.
   // TODO(): Remove useless control constructs.
-  bool AggressiveDCE(ir::Function* func);
+  bool KillDeadInstructions();
 
   void Initialize(ir::IRContext* c);
   Pass::Status ProcessImpl();
 
-  // True if current function has a call instruction contained in it
-  bool call_in_func_;
-
-  // True if current function is an entry point
-  bool func_is_entry_point_;
-
-  // True if current function is entry point and has no function calls.
+  // The index used for instructions that are not in a block of |blocks_|.
+  static const uint32_t kNoBlock = std::numeric_limits<uint32_t>::max();
+
+  // A reachable block of one of the functions being processed.
+  struct BlockInfo {
+    ir::BasicBlock* block;
+    // The merge instruction of the block if it is a structured header, and
+    // nullptr otherwise.
+    ir::Instruction* merge;
+    // The index of the header of the most immediate controlling structured
+    // if or loop, or kNoBlock.  A loop header points to itself.  An
+    // if-selection header points to the header of an enclosing construct, if
+    // one exists.
+    uint32_t header;
+    // True if the function is an entry point and has no function calls, so
+    // its private variables can be optimized like locals.
+    bool private_like_local;
+    // True if the breaks and continues of the loop headed by this block have
+    // been added to the worklist.
+    bool breaks_and_continues_live;
+  };
+
+  // True if the function of the instruction being processed is an entry
+  // point and has no function calls.
   bool private_like_local_;
 
   // Live Instruction Worklist.  An instruction is added to this list
@@ -152,26 +192,23 @@ class AggressiveDCEPass : public MemPass {
   // building up the live instructions set |live_insts_|.
   std::queue<ir::Instruction*> worklist_;
 
-  // Map from block to the branch instruction in the header of the most
-  // immediate controlling structured if or loop.  A loop header block points
-  // to its own branch instruction.  An if-selection block points to the branch
-  // of an enclosing construct's header, if one exists.
-  std::unordered_map<ir::BasicBlock*, ir::Instruction*> block2headerBranch_;
-
-  // Maps basic block to their index in the structured order traversal.
-  std::unordered_map<ir::BasicBlock*, uint32_t> structured_order_index_;
+  // The reachable blocks of all the functions being processed.  The blocks of
+  // each function are in structured order, one function after the other, so
+  // the index of a block is its position in the structured order traversal.
+  std::vector<BlockInfo> blocks_;
 
-  // Map from branch to its associated merge instruction, if any
-  std::unordered_map<ir::Instruction*, ir::Instruction*> branch2merge_;
+  // The index in |blocks_| of the block containing each instruction, indexed
+  // by the unique id of the instruction.
+  std::vector<uint32_t> inst_blocks_;
 
   // Store instructions to variables of private storage
   std::vector<ir::Instruction*> private_stores_;
 
-  // Live Instructions
-  std::unordered_set<const ir::Instruction*> live_insts_;
+  // Live Instructions, indexed by the unique id of the instruction.
+  std::vector<bool> live_insts_;
 
-  // Live Local Variables
-  std::unordered_set<uint32_t> live_local_vars_;
+  // Live Local Variables, indexed by the id of the variable.
+  std::vector<bool> live_local_vars_;
 
   // List of instructions to delete. Deletion is delayed until debug and
   // annotation instructions are processed.
@@ -89,6 +89,14 @@ bool BlockMergePass::MergeBlocks(ir::Function* func) {
         merge_inst->InsertBefore(bi->terminator());
       }
     }
+    // Keep the CFG and the dominator trees of |func| up to date, so they
+    // don't need to be rebuilt after this pass.
+    cfg()->ForgetMergedBlock(&*bi, lab_id);
+    const uint32_t pred_id = bi->id();
+    context()->ForEachDominatorTree(
+        func, [pred_id, lab_id](DominatorTree* tree) {
+          tree->MergeBlocks(pred_id, lab_id);
+        });
     context()->ReplaceAllUsesWith(lab_id, bi->id());
     KillInstAndName(sbi->GetLabelInst());
     (void)sbi.Erase();
@@ -143,7 +151,8 @@ Pass::Status BlockMergePass::ProcessImpl() {
   // Do not process if any disallowed extensions are enabled
   if (!AllExtensionsSupported()) return Status::SuccessWithoutChange;
   // Process all entry point functions.
-  ProcessFunction pfn = [this](ir::Function* fp) { return MergeBlocks(fp); };
+  ProcessFunction pfn = FilterFunctions(
+      [this](ir::Function* fp) { return MergeBlocks(fp); });
   bool modified = ProcessEntryPointCallTree(pfn, get_module());
   return modified ? Status::SuccessWithChange : Status::SuccessWithoutChange;
 }
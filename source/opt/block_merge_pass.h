@@ -40,6 +40,11 @@ class BlockMergePass : public Pass {
   const char* name() const override { return "merge-blocks"; }
   Status Process(ir::IRContext*) override;
 
+  ir::IRContext::Analysis GetPreservedAnalyses() override {
+    return ir::IRContext::kAnalysisCFG |
+           ir::IRContext::kAnalysisDominatorAnalysis;
+  }
+
  private:
   // Kill any OpName instruction referencing |inst|, then kill |inst|.
   void KillInstAndName(ir::Instruction* inst);
@@ -42,7 +42,7 @@ SSAPropagator::PropStatus CCPPass::MarkInstructionVarying(
     ir::Instruction* instr) {
   assert(instr->result_id() != 0 &&
          "Instructions with no result cannot be marked varying.");
-  values_[instr->result_id()] = kVaryingSSAId;
+  SetValue(instr->result_id(), kVaryingSSAId);
   return SSAPropagator::kVarying;
 }
 
@@ -58,19 +58,19 @@ SSAPropagator::PropStatus CCPPass::VisitPhi(ir::Instruction* phi) {
       continue;
     }
     uint32_t phi_arg_id = phi->GetSingleWordOperand(i);
-    auto it = values_.find(phi_arg_id);
-    if (it != values_.end()) {
+    uint32_t arg_val_id = GetValue(phi_arg_id);
+    if (arg_val_id != 0) {
       // We found an argument with a constant value.  Apply the meet operation
       // with the previous arguments.
-      if (it->second == kVaryingSSAId) {
+      if (arg_val_id == kVaryingSSAId) {
         // The "constant" value is actually a placeholder for varying. Return
         // varying for this phi.
         return MarkInstructionVarying(phi);
       } else if (meet_val_id == 0) {
         // This is the first argument we find.  Initialize the result to its
         // constant value id.
-        meet_val_id = it->second;
-      } else if (it->second == meet_val_id) {
+        meet_val_id = arg_val_id;
+      } else if (arg_val_id == meet_val_id) {
         // The argument is the same constant value already computed. Continue
         // looking.
         continue;
@@ -96,7 +96,7 @@ SSAPropagator::PropStatus CCPPass::VisitPhi(ir::Instruction* phi) {
 
   // All the operands have the same constant value represented by |meet_val_id|.
   // Set the Phi's result to that value and declare it interesting.
-  values_[phi->result_id()] = meet_val_id;
+  SetValue(phi->result_id(), meet_val_id);
   return SSAPropagator::kInteresting;
 }
 
@@ -108,12 +108,12 @@ SSAPropagator::PropStatus CCPPass::VisitAssignment(ir::Instruction* instr) {
   // value to the LHS.
   if (instr->opcode() == SpvOpCopyObject) {
     uint32_t rhs_id = instr->GetSingleWordInOperand(0);
-    auto it = values_.find(rhs_id);
-    if (it != values_.end()) {
-      if (IsVaryingValue(it->second)) {
+    uint32_t rhs_val_id = GetValue(rhs_id);
+    if (rhs_val_id != 0) {
+      if (IsVaryingValue(rhs_val_id)) {
         return MarkInstructionVarying(instr);
       } else {
-        values_[instr->result_id()] = it->second;
+        SetValue(instr->result_id(), rhs_val_id);
         return SSAPropagator::kInteresting;
       }
     }
@@ -127,11 +127,11 @@ SSAPropagator::PropStatus CCPPass::VisitAssignment(ir::Instruction* instr) {
 
   // See if the RHS of the assignment folds into a constant value.
   auto map_func = [this](uint32_t id) {
-    auto it = values_.find(id);
-    if (it == values_.end() || IsVaryingValue(it->second)) {
+    uint32_t val_id = GetValue(id);
+    if (val_id == 0 || IsVaryingValue(val_id)) {
       return id;
     }
-    return it->second;
+    return val_id;
   };
   ir::Instruction* folded_inst =
       opt::FoldInstructionToConstant(instr, map_func);
@@ -139,17 +139,14 @@ SSAPropagator::PropStatus CCPPass::VisitAssignment(ir::Instruction* instr) {
     // We do not want to change the body of the function by adding new
     // instructions.  When folding we can only generate new constants.
     assert(folded_inst->IsConstant() && "CCP is only interested in constant.");
-    values_[instr->result_id()] = folded_inst->result_id();
+    SetValue(instr->result_id(), folded_inst->result_id());
     return SSAPropagator::kInteresting;
   }
 
   // If not, see if there is a least one unknown operand to the instruction.  If
   // so, we might be able to fold it later.
-  if (!instr->WhileEachInId([this](uint32_t* op_id) {
-        auto it = values_.find(*op_id);
-        if (it == values_.end()) return false;
-        return true;
-      })) {
+  if (!instr->WhileEachInId(
+          [this](uint32_t* op_id) { return GetValue(*op_id) != 0; })) {
     return SSAPropagator::kNotInteresting;
   }
 
@@ -172,15 +169,14 @@ SSAPropagator::PropStatus CCPPass::VisitBranch(ir::Instruction* instr,
     // known value in |values_|.  If it does, set the destination block
     // according to the selector's boolean value.
     uint32_t pred_id = instr->GetSingleWordOperand(0);
-    auto it = values_.find(pred_id);
-    if (it == values_.end() || IsVaryingValue(it->second)) {
+    uint32_t pred_val_id = GetValue(pred_id);
+    if (pred_val_id == 0 || IsVaryingValue(pred_val_id)) {
       // The predicate has an unknown value, either branch could be taken.
       return SSAPropagator::kVarying;
     }
 
     // Get the constant value for the predicate selector from the value table.
     // Use it to decide which branch will be taken.
-    uint32_t pred_val_id = it->second;
     const analysis::Constant* c = const_mgr_->FindDeclaredConstant(pred_val_id);
     assert(c && "Expected to find a constant declaration for a known value.");
     // Undef values should have returned as varying above.
@@ -203,15 +199,14 @@ SSAPropagator::PropStatus CCPPass::VisitBranch(ir::Instruction* instr,
       return SSAPropagator::kVarying;
     }
     uint32_t select_id = instr->GetSingleWordOperand(0);
-    auto it = values_.find(select_id);
-    if (it == values_.end() || IsVaryingValue(it->second)) {
+    uint32_t select_val_id = GetValue(select_id);
+    if (select_val_id == 0 || IsVaryingValue(select_val_id)) {
       // The selector has an unknown value, any of the branches could be taken.
       return SSAPropagator::kVarying;
     }
 
     // Get the constant value for the selector from the value table. Use it to
     // decide which branch will be taken.
-    uint32_t select_val_id = it->second;
     const analysis::Constant* c =
         const_mgr_->FindDeclaredConstant(select_val_id);
     assert(c && "Expected to find a constant declaration for a known value.");
@@ -255,10 +250,9 @@ SSAPropagator::PropStatus CCPPass::VisitInstruction(ir::Instruction* instr,
 
 bool CCPPass::ReplaceValues() {
   bool retval = false;
-  for (const auto& it : values_) {
-    uint32_t id = it.first;
-    uint32_t cst_id = it.second;
-    if (!IsVaryingValue(cst_id) && id != cst_id) {
+  for (uint32_t id = 0; id < values_.size(); ++id) {
+    uint32_t cst_id = values_[id];
+    if (cst_id != 0 && !IsVaryingValue(cst_id) && id != cst_id) {
       retval |= context()->ReplaceAllUsesWith(id, cst_id);
     }
   }
@@ -285,6 +279,7 @@ void CCPPass::Initialize(ir::IRContext* c) {
   InitializeProcessing(c);
 
   const_mgr_ = context()->get_constant_mgr();
+  values_.assign(get_module()->IdBound(), 0);
 
   // Populate the constant table with values from constant declarations in the
   // module.  The values of each OpConstant declaration is the identity
@@ -292,9 +287,9 @@ void CCPPass::Initialize(ir::IRContext* c) {
   for (const auto& inst : get_module()->types_values()) {
     // Skip specialization constants. Treat undef as varying.
     if (inst.IsConstant()) {
-      values_[inst.result_id()] = inst.result_id();
+      SetValue(inst.result_id(), inst.result_id());
     } else if (inst.opcode() == SpvOpUndef) {
-      values_[inst.result_id()] = kVaryingSSAId;
+      SetValue(inst.result_id(), kVaryingSSAId);
     }
   }
 }
@@ -303,9 +298,8 @@ Pass::Status CCPPass::Process(ir::IRContext* c) {
   Initialize(c);
 
   // Process all entry point functions.
-  ProcessFunction pfn = [this](ir::Function* fp) {
-    return PropagateConstants(fp);
-  };
+  ProcessFunction pfn = FilterFunctions(
+      [this](ir::Function* fp) { return PropagateConstants(fp); });
   bool modified = ProcessReachableCallTree(pfn, context());
   return modified ? Pass::Status::SuccessWithChange
                   : Pass::Status::SuccessWithoutChange;
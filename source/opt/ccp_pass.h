@@ -15,6 +15,8 @@
 #ifndef LIBSPIRV_OPT_CCP_PASS_H_
 #define LIBSPIRV_OPT_CCP_PASS_H_
 
+#include <vector>
+
 #include "constants.h"
 #include "function.h"
 #include "ir_context.h"
@@ -75,20 +77,32 @@ class CCPPass : public MemPass {
   // value.
   bool IsVaryingValue(uint32_t id) const;
 
+  // Returns the value recorded for |id| in the |values_| table, or 0 if there
+  // is none.
+  uint32_t GetValue(uint32_t id) const {
+    return id < values_.size() ? values_[id] : 0;
+  }
+
+  // Records |value| as the value of |id| in the |values_| table.
+  void SetValue(uint32_t id, uint32_t value) {
+    if (id >= values_.size()) values_.resize(id + 1, 0);
+    values_[id] = value;
+  }
+
   // Constant manager for the parent IR context.  Used to record new constants
   // generated during propagation.
   analysis::ConstantManager* const_mgr_;
 
-  // Constant value table.  Each entry <id, const_decl_id> in this map
-  // represents the compile-time constant value for |id| as declared by
-  // |const_decl_id|. Each |const_decl_id| in this table is an OpConstant
+  // Constant value table, indexed by id.  Each non-zero entry const_decl_id at
+  // index |id| represents the compile-time constant value for |id| as declared
+  // by |const_decl_id|. Each |const_decl_id| in this table is an OpConstant
   // declaration for the current module.
   //
   // Additionally, this table keeps track of SSA IDs with varying values. If an
   // SSA ID is found to have a varying value, it will have an entry in this
   // table that maps to the special SSA id kVaryingSSAId.  These values are
   // never replaced in the IR, they are used by CCP during propagation.
-  std::unordered_map<uint32_t, uint32_t> values_;
+  std::vector<uint32_t> values_;
 
   // Propagator engine used.
   std::unique_ptr<SSAPropagator> propagator_;
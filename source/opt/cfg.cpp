@@ -12,6 +12,8 @@
 // See the License for the specific language governing permissions and
 // limitations under the License.
 
+#include <algorithm>
+
 #include "cfg.h"
 #include "cfa.h"
 #include "ir_context.h"
@@ -66,6 +68,16 @@ void CFG::RemoveNonExistingEdges(uint32_t blk_id) {
   label2preds_.at(blk_id) = std::move(updated_pred_list);
 }
 
+void CFG::ForgetMergedBlock(const ir::BasicBlock* pred, uint32_t blk_id) {
+  const uint32_t pred_id = pred->id();
+  pred->ForEachSuccessorLabel([blk_id, pred_id, this](const uint32_t succ_id) {
+    std::vector<uint32_t>& succ_preds = label2preds_[succ_id];
+    std::replace(succ_preds.begin(), succ_preds.end(), blk_id, pred_id);
+  });
+  label2preds_.erase(blk_id);
+  id2block_.erase(blk_id);
+}
+
 void CFG::ComputeStructuredOrder(ir::Function* func, ir::BasicBlock* root,
                                  std::list<ir::BasicBlock*>* order) {
   assert(module_->context()->get_feature_mgr()->HasCapability(
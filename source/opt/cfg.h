@@ -96,6 +96,12 @@ class CFG {
   // the basic block id |blk_id|.
   void RemoveNonExistingEdges(uint32_t blk_id);
 
+  // Removes the basic block id |blk_id| from the cfg, after the block was
+  // merged into its only predecessor |pred|.  The successors of |pred| are
+  // now those of the merged block, so |pred| takes its place in their
+  // predecessor lists.
+  void ForgetMergedBlock(const ir::BasicBlock* pred, uint32_t blk_id);
+
  private:
   using cbb_ptr = const ir::BasicBlock*;
 
@@ -33,7 +33,8 @@ Pass::Status CFGCleanupPass::Process(ir::IRContext* c) {
   Initialize(c);
 
   // Process all entry point functions.
-  ProcessFunction pfn = [this](ir::Function* fp) { return CFGCleanup(fp); };
+  ProcessFunction pfn = FilterFunctions(
+      [this](ir::Function* fp) { return CFGCleanup(fp); });
   bool modified = ProcessReachableCallTree(pfn, context());
   return modified ? Pass::Status::SuccessWithChange
                   : Pass::Status::SuccessWithoutChange;
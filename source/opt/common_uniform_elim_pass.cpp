@@ -161,12 +161,10 @@ bool CommonUniformElimPass::IsVolatileLoad(const ir::Instruction& loadInst) {
 }
 
 bool CommonUniformElimPass::IsUniformVar(uint32_t varId) {
-  const ir::Instruction* varInst =
-      get_def_use_mgr()->id_to_defs().find(varId)->second;
+  const ir::Instruction* varInst = get_def_use_mgr()->GetDef(varId);
   if (varInst->opcode() != SpvOpVariable) return false;
   const uint32_t varTypeId = varInst->type_id();
-  const ir::Instruction* varTypeInst =
-      get_def_use_mgr()->id_to_defs().find(varTypeId)->second;
+  const ir::Instruction* varTypeInst = get_def_use_mgr()->GetDef(varTypeId);
   return varTypeInst->GetSingleWordInOperand(kTypePointerStorageClassInIdx) ==
              SpvStorageClassUniform ||
          varTypeInst->GetSingleWordInOperand(kTypePointerStorageClassInIdx) ==
@@ -524,9 +522,8 @@ Pass::Status CommonUniformElimPass::ProcessImpl() {
         inst.GetSingleWordInOperand(kTypeIntWidthInIdx) != 32)
       return Status::SuccessWithoutChange;
   // Process entry point functions
-  ProcessFunction pfn = [this](ir::Function* fp) {
-    return EliminateCommonUniform(fp);
-  };
+  ProcessFunction pfn = FilterFunctions(
+      [this](ir::Function* fp) { return EliminateCommonUniform(fp); });
   bool modified = ProcessEntryPointCallTree(pfn, get_module());
   return modified ? Status::SuccessWithChange : Status::SuccessWithoutChange;
 }
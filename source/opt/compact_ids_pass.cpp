@@ -15,8 +15,8 @@
 #include "compact_ids_pass.h"
 #include "ir_context.h"
 
+#include <algorithm>
 #include <cassert>
-#include <unordered_map>
 
 namespace spvtools {
 namespace opt {
@@ -24,32 +24,102 @@ namespace opt {
 using ir::Instruction;
 using ir::Operand;
 
+namespace {
+
+// Returns the new id for |id| in |new_ids|.  Gives |id| the new id |next_id|
+// first if it has none yet.
+uint32_t GetOrAssignNewId(uint32_t id, std::vector<uint32_t>* new_ids,
+                          uint32_t* next_id) {
+  if (id >= new_ids->size()) new_ids->resize(id + 1, 0);
+  uint32_t& new_id = (*new_ids)[id];
+  if (new_id == 0) new_id = (*next_id)++;
+  return new_id;
+}
+
+}  // namespace
+
+void CompactIdsPass::NumberForLocality(ir::Module* module,
+                                       std::vector<uint32_t>* new_ids,
+                                       uint32_t* next_id) const {
+  // Count how many times each id is used as an operand.
+  std::vector<uint32_t> use_counts(new_ids->size(), 0);
+  module->ForEachInst(
+      [&use_counts](const Instruction* inst) {
+        for (const Operand& operand : *inst) {
+          if (spvIsIdType(operand.type) &&
+              operand.type != SPV_OPERAND_TYPE_RESULT_ID) {
+            const uint32_t id = operand.words[0];
+            if (id >= use_counts.size()) use_counts.resize(id + 1, 0);
+            ++use_counts[id];
+          }
+        }
+      },
+      true);
+
+  // The ids defined outside of functions, most used first.  Ids that are used
+  // equally often keep the order of their definitions.
+  std::vector<uint32_t> global_ids;
+  const auto add_global_ids = [&global_ids](ir::Module::inst_iterator begin,
+                                            ir::Module::inst_iterator end) {
+    for (auto it = begin; it != end; ++it) {
+      if (it->result_id() != 0) global_ids.push_back(it->result_id());
+    }
+  };
+  add_global_ids(module->ext_inst_imports().begin(),
+                 module->ext_inst_imports().end());
+  add_global_ids(module->debugs1().begin(), module->debugs1().end());
+  add_global_ids(module->annotations().begin(), module->annotations().end());
+  add_global_ids(module->types_values().begin(), module->types_values().end());
+  std::stable_sort(global_ids.begin(), global_ids.end(),
+                   [&use_counts](uint32_t a, uint32_t b) {
+                     const uint32_t a_uses =
+                         a < use_counts.size() ? use_counts[a] : 0;
+                     const uint32_t b_uses =
+                         b < use_counts.size() ? use_counts[b] : 0;
+                     return a_uses > b_uses;
+                   });
+  for (uint32_t id : global_ids) {
+    GetOrAssignNewId(id, new_ids, next_id);
+  }
+
+  // The ids of each function, in the order they are defined.
+  for (ir::Function& function : *module) {
+    function.ForEachInst(
+        [new_ids, next_id](Instruction* inst) {
+          if (inst->result_id() != 0) {
+            GetOrAssignNewId(inst->result_id(), new_ids, next_id);
+          }
+        },
+        true);
+  }
+}
+
 Pass::Status CompactIdsPass::Process(ir::IRContext* c) {
   InitializeProcessing(c);
 
   bool modified = false;
-  std::unordered_map<uint32_t, uint32_t> result_id_mapping;
+  // Maps each old id to its new id, or to 0 if it has none yet.
+  std::vector<uint32_t> result_id_mapping(c->module()->IdBound(), 0);
+  uint32_t next_id = 1;
+
+  if (order_ == Order::kLocality) {
+    NumberForLocality(c->module(), &result_id_mapping, &next_id);
+  }
 
+  // Any id without a new id yet gets one in the order it is first seen.
   c->module()->ForEachInst(
-      [&result_id_mapping, &modified](Instruction* inst) {
+      [&result_id_mapping, &next_id, &modified](Instruction* inst) {
         auto operand = inst->begin();
         while (operand != inst->end()) {
           const auto type = operand->type;
           if (spvIsIdType(type)) {
             assert(operand->words.size() == 1);
             uint32_t& id = operand->words[0];
-            auto it = result_id_mapping.find(id);
-            if (it == result_id_mapping.end()) {
-              const uint32_t new_id =
-                  static_cast<uint32_t>(result_id_mapping.size()) + 1;
-              const auto insertion_result =
-                  result_id_mapping.emplace(id, new_id);
-              it = insertion_result.first;
-              assert(insertion_result.second);
-            }
-            if (id != it->second) {
+            const uint32_t new_id =
+                GetOrAssignNewId(id, &result_id_mapping, &next_id);
+            if (id != new_id) {
               modified = true;
-              id = it->second;
+              id = new_id;
               // Update data cached in the instruction object.
               if (type == SPV_OPERAND_TYPE_RESULT_ID) {
                 inst->SetResultId(id);
@@ -63,9 +133,11 @@ Pass::Status CompactIdsPass::Process(ir::IRContext* c) {
       },
       true);
 
-  if (modified)
-    c->module()->SetIdBound(
-        static_cast<uint32_t>(result_id_mapping.size() + 1));
+  // The ids are now gapless, so the bound is one past the last new id.
+  if (c->module()->IdBound() != next_id) {
+    modified = true;
+    c->module()->SetIdBound(next_id);
+  }
 
   return modified ? Status::SuccessWithChange : Status::SuccessWithoutChange;
 }
@@ -15,6 +15,9 @@
 #ifndef LIBSPIRV_OPT_COMPACT_IDS_PASS_H_
 #define LIBSPIRV_OPT_COMPACT_IDS_PASS_H_
 
+#include <cstdint>
+#include <vector>
+
 #include "ir_context.h"
 #include "module.h"
 #include "pass.h"
@@ -25,8 +28,31 @@ namespace opt {
 // See optimizer.hpp for documentation.
 class CompactIdsPass : public Pass {
  public:
+  // The order in which the new ids are given out.
+  enum class Order {
+    // Ids are numbered in the order they are first seen in the module.
+    kFirstSeen,
+    // The ids defined outside of functions are numbered first, the most used
+    // ones first.  Then the ids of each function are numbered in the order
+    // they are defined.  This keeps the ids that are used together close to
+    // each other, and gives the smallest ids to the most frequent operands.
+    kLocality,
+  };
+
+  CompactIdsPass() : order_(Order::kFirstSeen) {}
+  explicit CompactIdsPass(Order order) : order_(order) {}
+
   const char* name() const override { return "compact-ids"; }
   Status Process(ir::IRContext*) override;
+
+ private:
+  // Gives new ids to the ids defined in |module| in the order described by
+  // Order::kLocality.  |new_ids| maps each old id to its new id, or to 0 if
+  // it has none yet.  |next_id| is the next new id to give out.
+  void NumberForLocality(ir::Module* module, std::vector<uint32_t>* new_ids,
+                         uint32_t* next_id) const;
+
+  Order order_;
 };
 
 }  // namespace opt
@@ -31,143 +31,63 @@ inline std::vector<uint32_t> ExtractInts(uint64_t a) {
 }
 
 // Folds an OpcompositeExtract where input is a composite constant.
-ConstantFoldingRule FoldExtractWithConstants() {
-  return [](ir::Instruction* inst,
-            const std::vector<const analysis::Constant*>& constants)
-             -> const analysis::Constant* {
-    const analysis::Constant* c = constants[kExtractCompositeIdInIdx];
-    if (c == nullptr) {
-      return nullptr;
-    }
-
-    for (uint32_t i = 1; i < inst->NumInOperands(); ++i) {
-      uint32_t element_index = inst->GetSingleWordInOperand(i);
-      if (c->AsNullConstant()) {
-        // Return Null for the return type.
-        ir::IRContext* context = inst->context();
-        analysis::ConstantManager* const_mgr = context->get_constant_mgr();
-        analysis::TypeManager* type_mgr = context->get_type_mgr();
-        return const_mgr->GetConstant(type_mgr->GetType(inst->type_id()), {});
-      }
-
-      auto cc = c->AsCompositeConstant();
-      assert(cc != nullptr);
-      auto components = cc->GetComponents();
-      c = components[element_index];
-    }
-    return c;
-  };
-}
+const analysis::Constant* FoldExtractWithConstants(
+    ir::Instruction* inst,
+    const std::vector<const analysis::Constant*>& constants) {
+  const analysis::Constant* c = constants[kExtractCompositeIdInIdx];
+  if (c == nullptr) {
+    return nullptr;
+  }
 
-ConstantFoldingRule FoldCompositeWithConstants() {
-  // Folds an OpCompositeConstruct where all of the inputs are constants to a
-  // constant.  A new constant is created if necessary.
-  return [](ir::Instruction* inst,
-            const std::vector<const analysis::Constant*>& constants)
-             -> const analysis::Constant* {
-    ir::IRContext* context = inst->context();
-    analysis::ConstantManager* const_mgr = context->get_constant_mgr();
-    analysis::TypeManager* type_mgr = context->get_type_mgr();
-    const analysis::Type* new_type = type_mgr->GetType(inst->type_id());
-
-    std::vector<uint32_t> ids;
-    for (const analysis::Constant* element_const : constants) {
-      if (element_const == nullptr) {
-        return nullptr;
-      }
-      uint32_t element_id = const_mgr->FindDeclaredConstant(element_const);
-      if (element_id == 0) {
-        return nullptr;
-      }
-      ids.push_back(element_id);
+  for (uint32_t i = 1; i < inst->NumInOperands(); ++i) {
+    uint32_t element_index = inst->GetSingleWordInOperand(i);
+    if (c->AsNullConstant()) {
+      // Return Null for the return type.
+      ir::IRContext* context = inst->context();
+      analysis::ConstantManager* const_mgr = context->get_constant_mgr();
+      analysis::TypeManager* type_mgr = context->get_type_mgr();
+      return const_mgr->GetConstant(type_mgr->GetType(inst->type_id()), {});
     }
-    return const_mgr->GetConstant(new_type, ids);
-  };
-}
 
-// The interface for a function that returns the result of applying a scalar
-// floating-point binary operation on |a| and |b|.  The type of the return value
-// will be |type|.  The input constants must also be of type |type|.
-using FloatScalarFoldingRule = std::function<const analysis::Constant*(
-    const analysis::Type* result_type, const analysis::Constant* a,
-    const analysis::Constant* b, analysis::ConstantManager*)>;
-
-// Returns an std::vector containing the elements of |constant|.  The type of
-// |constant| must be |Vector|.
-std::vector<const analysis::Constant*> GetVectorComponents(
-    const analysis::Constant* constant, analysis::ConstantManager* const_mgr) {
-  std::vector<const analysis::Constant*> components;
-  const analysis::VectorConstant* a = constant->AsVectorConstant();
-  const analysis::Vector* vector_type = constant->type()->AsVector();
-  assert(vector_type != nullptr);
-  if (a != nullptr) {
-    for (uint32_t i = 0; i < vector_type->element_count(); ++i) {
-      components.push_back(a->GetComponents()[i]);
-    }
-  } else {
-    const analysis::Type* element_type = vector_type->element_type();
-    const analysis::Constant* element_null_const =
-        const_mgr->GetConstant(element_type, {});
-    for (uint32_t i = 0; i < vector_type->element_count(); ++i) {
-      components.push_back(element_null_const);
-    }
+    auto cc = c->AsCompositeConstant();
+    assert(cc != nullptr);
+    const auto& components = cc->GetComponents();
+    c = components[element_index];
   }
-  return components;
+  return c;
 }
 
-// Returns a |ConstantFoldingRule| that folds floating point scalars using
-// |scalar_rule| and vectors of floating point by applying |scalar_rule| to the
-// elements of the vector.  The |ConstantFoldingRule| that is returned assumes
-// that |constants| contains 2 entries.  If they are not |nullptr|, then their
-// type is either |Float| or a |Vector| whose element type is |Float|.
-ConstantFoldingRule FoldFloatingPointOp(FloatScalarFoldingRule scalar_rule) {
-  return [scalar_rule](ir::Instruction* inst,
-                       const std::vector<const analysis::Constant*>& constants)
-             -> const analysis::Constant* {
-    ir::IRContext* context = inst->context();
-    analysis::ConstantManager* const_mgr = context->get_constant_mgr();
-    analysis::TypeManager* type_mgr = context->get_type_mgr();
-    const analysis::Type* result_type = type_mgr->GetType(inst->type_id());
-    const analysis::Vector* vector_type = result_type->AsVector();
-
-    if (!inst->IsFloatingPointFoldingAllowed()) {
-      return nullptr;
-    }
+// Folds an OpCompositeConstruct where all of the inputs are constants to a
+// constant.  A new constant is created if necessary.
+const analysis::Constant* FoldCompositeWithConstants(
+    ir::Instruction* inst,
+    const std::vector<const analysis::Constant*>& constants) {
+  ir::IRContext* context = inst->context();
+  analysis::ConstantManager* const_mgr = context->get_constant_mgr();
+  analysis::TypeManager* type_mgr = context->get_type_mgr();
+  const analysis::Type* new_type = type_mgr->GetType(inst->type_id());
 
-    if (constants[0] == nullptr || constants[1] == nullptr) {
+  std::vector<uint32_t> ids;
+  for (const analysis::Constant* element_const : constants) {
+    if (element_const == nullptr) {
       return nullptr;
     }
-
-    if (vector_type != nullptr) {
-      std::vector<const analysis::Constant*> a_components;
-      std::vector<const analysis::Constant*> b_components;
-      std::vector<const analysis::Constant*> results_components;
-
-      a_components = GetVectorComponents(constants[0], const_mgr);
-      b_components = GetVectorComponents(constants[1], const_mgr);
-
-      // Fold each component of the vector.
-      for (uint32_t i = 0; i < a_components.size(); ++i) {
-        results_components.push_back(scalar_rule(vector_type->element_type(),
-                                                 a_components[i],
-                                                 b_components[i], const_mgr));
-        if (results_components[i] == nullptr) {
-          return nullptr;
-        }
-      }
-
-      // Build the constant object and return it.
-      std::vector<uint32_t> ids;
-      for (const analysis::Constant* member : results_components) {
-        ids.push_back(const_mgr->GetDefiningInstruction(member)->result_id());
-      }
-      return const_mgr->GetConstant(vector_type, ids);
-    } else {
-      return scalar_rule(result_type, constants[0], constants[1], const_mgr);
+    uint32_t element_id = const_mgr->FindDeclaredConstant(element_const);
+    if (element_id == 0) {
+      return nullptr;
     }
-  };
+    ids.push_back(element_id);
+  }
+  return const_mgr->GetConstant(new_type, ids);
 }
 
+// The interface for a function that returns the result of applying a scalar
+// floating-point binary operation on |a| and |b|.  The type of the return value
+// will be |type|.  The input constants must also be of type |type|.
+using FloatScalarFoldingRule = const analysis::Constant* (*)(
+    const analysis::Type* result_type, const analysis::Constant* a,
+    const analysis::Constant* b, analysis::ConstantManager*);
+
 // Returns the floating point value of |c|.  The constant |c| must have type
 // |Float|, and width |32|.
 float GetFloatFromConst(const analysis::Constant* c) {
@@ -196,47 +116,149 @@ double GetDoubleFromConst(const analysis::Constant* c) {
   }
 }
 
-// This macro defines a |FloatScalarFoldingRule| that applies |op|.  The
-// operator |op| must work for both float and double, and use syntax "f1 op f2".
-#define FOLD_FPARITH_OP(op)                                               \
-  [](const analysis::Type* result_type, const analysis::Constant* a,      \
-     const analysis::Constant* b,                                         \
-     analysis::ConstantManager* const_mgr) -> const analysis::Constant* { \
-    assert(result_type != nullptr && a != nullptr && b != nullptr);       \
-    assert(result_type == a->type() && result_type == b->type());         \
-    const analysis::Float* float_type = result_type->AsFloat();           \
-    assert(float_type != nullptr);                                        \
-    if (float_type->width() == 32) {                                      \
-      float fa = GetFloatFromConst(a);                                    \
-      float fb = GetFloatFromConst(b);                                    \
-      spvutils::FloatProxy<float> result(fa op fb);                       \
-      std::vector<uint32_t> words = {result.data()};                      \
-      return const_mgr->GetConstant(result_type, words);                  \
-    } else if (float_type->width() == 64) {                               \
-      double fa = GetDoubleFromConst(a);                                  \
-      double fb = GetDoubleFromConst(b);                                  \
-      spvutils::FloatProxy<double> result(fa op fb);                      \
-      std::vector<uint32_t> words(ExtractInts(result.data()));            \
-      return const_mgr->GetConstant(result_type, words);                  \
-    }                                                                     \
-    return nullptr;                                                       \
-  }
+// Returns the value of |c| as a |T|, which is either float or double.
+template <typename T>
+T GetFloatingPointValue(const analysis::Constant* c);
 
-// Define the folding rules for subtraction, addition, multiplication, and
-// division for floating point values.
-ConstantFoldingRule FoldFSub() {
-  return FoldFloatingPointOp(FOLD_FPARITH_OP(-));
+template <>
+float GetFloatingPointValue<float>(const analysis::Constant* c) {
+  return GetFloatFromConst(c);
 }
-ConstantFoldingRule FoldFAdd() {
-  return FoldFloatingPointOp(FOLD_FPARITH_OP(+));
+
+template <>
+double GetFloatingPointValue<double>(const analysis::Constant* c) {
+  return GetDoubleFromConst(c);
 }
-ConstantFoldingRule FoldFMul() {
-  return FoldFloatingPointOp(FOLD_FPARITH_OP(*));
+
+// Returns the words of a constant whose value is |value|.
+std::vector<uint32_t> GetConstantWords(float value) {
+  return {spvutils::FloatProxy<float>(value).data()};
 }
-ConstantFoldingRule FoldFDiv() {
-  return FoldFloatingPointOp(FOLD_FPARITH_OP(/));
+
+std::vector<uint32_t> GetConstantWords(double value) {
+  return ExtractInts(spvutils::FloatProxy<double>(value).data());
+}
+
+std::vector<uint32_t> GetConstantWords(bool value) {
+  return {uint32_t(value)};
+}
+
+// Returns the result of |Op::Apply| on the values of |a| and |b|, which are
+// scalars of type |T|.  The result is a constant of type |result_type|.
+template <class Op, typename T>
+const analysis::Constant* FoldFloatingPointScalars(
+    const analysis::Type* result_type, const analysis::Constant* a,
+    const analysis::Constant* b, analysis::ConstantManager* const_mgr) {
+  assert(result_type != nullptr && a != nullptr && b != nullptr);
+  assert(a->type() == b->type());
+  return const_mgr->GetConstant(
+      result_type, GetConstantWords(Op::Apply(GetFloatingPointValue<T>(a),
+                                              GetFloatingPointValue<T>(b))));
+}
+
+// Returns the scalar rule that applies |Op| to floating point values of
+// |float_type|, or |nullptr| if the width of |float_type| is not supported.
+template <class Op>
+FloatScalarFoldingRule GetFloatScalarFoldingRule(
+    const analysis::Float* float_type) {
+  switch (float_type->width()) {
+    case 32:
+      return FoldFloatingPointScalars<Op, float>;
+    case 64:
+      return FoldFloatingPointScalars<Op, double>;
+    default:
+      return nullptr;
+  }
 }
 
+// Returns element |i| of the vector constant |c|.  If |c| is a null constant,
+// returns |null_element| instead.
+inline const analysis::Constant* GetVectorComponent(
+    const analysis::Constant* c, uint32_t i,
+    const analysis::Constant* null_element) {
+  const analysis::VectorConstant* vc = c->AsVectorConstant();
+  return vc != nullptr ? vc->GetComponents()[i] : null_element;
+}
+
+// A |ConstantFoldingRule| that folds floating point scalars using |Op| and
+// vectors of floating point by applying |Op| to the elements of the vector.
+// The scalar rule is picked once for the width of the operands, and the whole
+// vector is folded in a single pass over its elements.  The rule assumes that
+// |constants| contains 2 entries.  If they are not |nullptr|, then their type
+// is either |Float| or a |Vector| whose element type is |Float|.
+template <class Op>
+const analysis::Constant* FoldFloatingPointOp(
+    ir::Instruction* inst,
+    const std::vector<const analysis::Constant*>& constants) {
+  if (!inst->IsFloatingPointFoldingAllowed()) {
+    return nullptr;
+  }
+
+  const analysis::Constant* a = constants[0];
+  const analysis::Constant* b = constants[1];
+  if (a == nullptr || b == nullptr) {
+    return nullptr;
+  }
+
+  ir::IRContext* context = inst->context();
+  analysis::ConstantManager* const_mgr = context->get_constant_mgr();
+  analysis::TypeManager* type_mgr = context->get_type_mgr();
+  const analysis::Type* result_type = type_mgr->GetType(inst->type_id());
+  const analysis::Vector* operand_vector_type = a->type()->AsVector();
+  const analysis::Type* operand_element_type =
+      operand_vector_type ? operand_vector_type->element_type() : a->type();
+  assert(operand_element_type->AsFloat() != nullptr);
+
+  FloatScalarFoldingRule scalar_rule =
+      GetFloatScalarFoldingRule<Op>(operand_element_type->AsFloat());
+  if (scalar_rule == nullptr) {
+    return nullptr;
+  }
+
+  const analysis::Vector* vector_type = result_type->AsVector();
+  if (vector_type == nullptr) {
+    return scalar_rule(result_type, a, b, const_mgr);
+  }
+
+  // Null vectors stand for a vector of null elements.
+  const analysis::Constant* null_element = nullptr;
+  if (a->AsNullConstant() || b->AsNullConstant()) {
+    null_element = const_mgr->GetConstant(operand_element_type, {});
+  }
+
+  const analysis::Type* result_element_type = vector_type->element_type();
+  std::vector<uint32_t> ids;
+  ids.reserve(vector_type->element_count());
+  for (uint32_t i = 0; i < vector_type->element_count(); ++i) {
+    const analysis::Constant* result = scalar_rule(
+        result_element_type, GetVectorComponent(a, i, null_element),
+        GetVectorComponent(b, i, null_element), const_mgr);
+    if (result == nullptr) {
+      return nullptr;
+    }
+    ids.push_back(const_mgr->GetDefiningInstruction(result)->result_id());
+  }
+  return const_mgr->GetConstant(vector_type, ids);
+}
+
+// This macro defines an operation |name| for |FoldFloatingPointOp| that
+// applies |op|.  The operator |op| must work for both float and double, and
+// use syntax "f1 op f2".
+#define FOLD_FPARITH_OP(name, op)         \
+  struct name {                           \
+    template <typename T>                 \
+    static T Apply(T a, T b) {            \
+      return a op b;                      \
+    }                                     \
+  }
+
+// Define the folding operations for subtraction, addition, multiplication, and
+// division for floating point values.
+FOLD_FPARITH_OP(FSubOp, -);
+FOLD_FPARITH_OP(FAddOp, +);
+FOLD_FPARITH_OP(FMulOp, *);
+FOLD_FPARITH_OP(FDivOp, /);
+
 bool CompareFloatingPoint(bool op_result, bool op_unordered,
                           bool need_ordered) {
   if (need_ordered) {
@@ -248,73 +270,32 @@ bool CompareFloatingPoint(bool op_result, bool op_unordered,
   }
 }
 
-// This macro defines a |FloatScalarFoldingRule| that applies |op|.  The
-// operator |op| must work for both float and double, and use syntax "f1 op f2".
-#define FOLD_FPCMP_OP(op, ord)                                            \
-  [](const analysis::Type* result_type, const analysis::Constant* a,      \
-     const analysis::Constant* b,                                         \
-     analysis::ConstantManager* const_mgr) -> const analysis::Constant* { \
-    assert(result_type != nullptr && a != nullptr && b != nullptr);       \
-    assert(result_type->AsBool());                                        \
-    assert(a->type() == b->type());                                       \
-    const analysis::Float* float_type = a->type()->AsFloat();             \
-    assert(float_type != nullptr);                                        \
-    if (float_type->width() == 32) {                                      \
-      float fa = GetFloatFromConst(a);                                    \
-      float fb = GetFloatFromConst(b);                                    \
-      bool result = CompareFloatingPoint(                                 \
-          fa op fb, std::isnan(fa) || std::isnan(fb), ord);               \
-      std::vector<uint32_t> words = {uint32_t(result)};                   \
-      return const_mgr->GetConstant(result_type, words);                  \
-    } else if (float_type->width() == 64) {                               \
-      double fa = GetDoubleFromConst(a);                                  \
-      double fb = GetDoubleFromConst(b);                                  \
-      bool result = CompareFloatingPoint(                                 \
-          fa op fb, std::isnan(fa) || std::isnan(fb), ord);               \
-      std::vector<uint32_t> words = {uint32_t(result)};                   \
-      return const_mgr->GetConstant(result_type, words);                  \
-    }                                                                     \
-    return nullptr;                                                       \
+// This macro defines an operation |name| for |FoldFloatingPointOp| that
+// compares with |op|.  The operator |op| must work for both float and double,
+// and use syntax "f1 op f2".  The comparison is ordered if |ord| is true.
+#define FOLD_FPCMP_OP(name, op, ord)                                \
+  struct name {                                                     \
+    template <typename T>                                           \
+    static bool Apply(T a, T b) {                                   \
+      return CompareFloatingPoint(                                  \
+          a op b, std::isnan(a) || std::isnan(b), ord);             \
+    }                                                               \
   }
 
-// Define the folding rules for ordered and unordered comparison for floating
-// point values.
-ConstantFoldingRule FoldFOrdEqual() {
-  return FoldFloatingPointOp(FOLD_FPCMP_OP(==, true));
-}
-ConstantFoldingRule FoldFUnordEqual() {
-  return FoldFloatingPointOp(FOLD_FPCMP_OP(==, false));
-}
-ConstantFoldingRule FoldFOrdNotEqual() {
-  return FoldFloatingPointOp(FOLD_FPCMP_OP(!=, true));
-}
-ConstantFoldingRule FoldFUnordNotEqual() {
-  return FoldFloatingPointOp(FOLD_FPCMP_OP(!=, false));
-}
-ConstantFoldingRule FoldFOrdLessThan() {
-  return FoldFloatingPointOp(FOLD_FPCMP_OP(<, true));
-}
-ConstantFoldingRule FoldFUnordLessThan() {
-  return FoldFloatingPointOp(FOLD_FPCMP_OP(<, false));
-}
-ConstantFoldingRule FoldFOrdGreaterThan() {
-  return FoldFloatingPointOp(FOLD_FPCMP_OP(>, true));
-}
-ConstantFoldingRule FoldFUnordGreaterThan() {
-  return FoldFloatingPointOp(FOLD_FPCMP_OP(>, false));
-}
-ConstantFoldingRule FoldFOrdLessThanEqual() {
-  return FoldFloatingPointOp(FOLD_FPCMP_OP(<=, true));
-}
-ConstantFoldingRule FoldFUnordLessThanEqual() {
-  return FoldFloatingPointOp(FOLD_FPCMP_OP(<=, false));
-}
-ConstantFoldingRule FoldFOrdGreaterThanEqual() {
-  return FoldFloatingPointOp(FOLD_FPCMP_OP(>=, true));
-}
-ConstantFoldingRule FoldFUnordGreaterThanEqual() {
-  return FoldFloatingPointOp(FOLD_FPCMP_OP(>=, false));
-}
+// Define the folding operations for ordered and unordered comparison for
+// floating point values.
+FOLD_FPCMP_OP(FOrdEqualOp, ==, true);
+FOLD_FPCMP_OP(FUnordEqualOp, ==, false);
+FOLD_FPCMP_OP(FOrdNotEqualOp, !=, true);
+FOLD_FPCMP_OP(FUnordNotEqualOp, !=, false);
+FOLD_FPCMP_OP(FOrdLessThanOp, <, true);
+FOLD_FPCMP_OP(FUnordLessThanOp, <, false);
+FOLD_FPCMP_OP(FOrdGreaterThanOp, >, true);
+FOLD_FPCMP_OP(FUnordGreaterThanOp, >, false);
+FOLD_FPCMP_OP(FOrdLessThanEqualOp, <=, true);
+FOLD_FPCMP_OP(FUnordLessThanEqualOp, <=, false);
+FOLD_FPCMP_OP(FOrdGreaterThanEqualOp, >=, true);
+FOLD_FPCMP_OP(FUnordGreaterThanEqualOp, >=, false);
 }  // namespace
 
 spvtools::opt::ConstantFoldingRules::ConstantFoldingRules() {
@@ -323,27 +304,33 @@ spvtools::opt::ConstantFoldingRules::ConstantFoldingRules() {
   // applies to the instruction, the rest of the rules will not be attempted.
   // Take that into consideration.
 
-  rules_[SpvOpCompositeConstruct].push_back(FoldCompositeWithConstants());
-
-  rules_[SpvOpCompositeExtract].push_back(FoldExtractWithConstants());
-
-  rules_[SpvOpFAdd].push_back(FoldFAdd());
-  rules_[SpvOpFDiv].push_back(FoldFDiv());
-  rules_[SpvOpFMul].push_back(FoldFMul());
-  rules_[SpvOpFSub].push_back(FoldFSub());
-
-  rules_[SpvOpFOrdEqual].push_back(FoldFOrdEqual());
-  rules_[SpvOpFUnordEqual].push_back(FoldFUnordEqual());
-  rules_[SpvOpFOrdNotEqual].push_back(FoldFOrdNotEqual());
-  rules_[SpvOpFUnordNotEqual].push_back(FoldFUnordNotEqual());
-  rules_[SpvOpFOrdLessThan].push_back(FoldFOrdLessThan());
-  rules_[SpvOpFUnordLessThan].push_back(FoldFUnordLessThan());
-  rules_[SpvOpFOrdGreaterThan].push_back(FoldFOrdGreaterThan());
-  rules_[SpvOpFUnordGreaterThan].push_back(FoldFUnordGreaterThan());
-  rules_[SpvOpFOrdLessThanEqual].push_back(FoldFOrdLessThanEqual());
-  rules_[SpvOpFUnordLessThanEqual].push_back(FoldFUnordLessThanEqual());
-  rules_[SpvOpFOrdGreaterThanEqual].push_back(FoldFOrdGreaterThanEqual());
-  rules_[SpvOpFUnordGreaterThanEqual].push_back(FoldFUnordGreaterThanEqual());
+  rules_[SpvOpCompositeConstruct].push_back(FoldCompositeWithConstants);
+
+  rules_[SpvOpCompositeExtract].push_back(FoldExtractWithConstants);
+
+  rules_[SpvOpFAdd].push_back(FoldFloatingPointOp<FAddOp>);
+  rules_[SpvOpFDiv].push_back(FoldFloatingPointOp<FDivOp>);
+  rules_[SpvOpFMul].push_back(FoldFloatingPointOp<FMulOp>);
+  rules_[SpvOpFSub].push_back(FoldFloatingPointOp<FSubOp>);
+
+  rules_[SpvOpFOrdEqual].push_back(FoldFloatingPointOp<FOrdEqualOp>);
+  rules_[SpvOpFUnordEqual].push_back(FoldFloatingPointOp<FUnordEqualOp>);
+  rules_[SpvOpFOrdNotEqual].push_back(FoldFloatingPointOp<FOrdNotEqualOp>);
+  rules_[SpvOpFUnordNotEqual].push_back(FoldFloatingPointOp<FUnordNotEqualOp>);
+  rules_[SpvOpFOrdLessThan].push_back(FoldFloatingPointOp<FOrdLessThanOp>);
+  rules_[SpvOpFUnordLessThan].push_back(FoldFloatingPointOp<FUnordLessThanOp>);
+  rules_[SpvOpFOrdGreaterThan].push_back(
+      FoldFloatingPointOp<FOrdGreaterThanOp>);
+  rules_[SpvOpFUnordGreaterThan].push_back(
+      FoldFloatingPointOp<FUnordGreaterThanOp>);
+  rules_[SpvOpFOrdLessThanEqual].push_back(
+      FoldFloatingPointOp<FOrdLessThanEqualOp>);
+  rules_[SpvOpFUnordLessThanEqual].push_back(
+      FoldFloatingPointOp<FUnordLessThanEqualOp>);
+  rules_[SpvOpFOrdGreaterThanEqual].push_back(
+      FoldFloatingPointOp<FOrdGreaterThanEqualOp>);
+  rules_[SpvOpFUnordGreaterThanEqual].push_back(
+      FoldFloatingPointOp<FUnordGreaterThanEqualOp>);
 }
 }  // namespace opt
 }  // namespace spvtools
@@ -52,30 +52,27 @@ namespace opt {
 // rules in the list are given priority.  That is, if an earlier rule is able to
 // fold an instruction, the later rules will not be attempted.
 
-using ConstantFoldingRule = std::function<const analysis::Constant*(
+using ConstantFoldingRule = const analysis::Constant* (*)(
     ir::Instruction* inst,
-    const std::vector<const analysis::Constant*>& constants)>;
+    const std::vector<const analysis::Constant*>& constants);
 
 class ConstantFoldingRules {
  public:
   ConstantFoldingRules();
 
   // Returns true if there is at least 1 folding rule for |opcode|.
-  bool HasFoldingRule(SpvOp opcode) const { return rules_.count(opcode); }
+  bool HasFoldingRule(SpvOp opcode) const {
+    return !rules_.Get(opcode).empty();
+  }
 
   // Returns an vector of constant folding rules for |opcode|.
   const std::vector<ConstantFoldingRule>& GetRulesForOpcode(
       SpvOp opcode) const {
-    auto it = rules_.find(opcode);
-    if (it != rules_.end()) {
-      return it->second;
-    }
-    return empty_vector_;
+    return rules_.Get(opcode);
   }
 
  private:
-  std::unordered_map<uint32_t, std::vector<ConstantFoldingRule>> rules_;
-  std::vector<ConstantFoldingRule> empty_vector_;
+  OpcodeRuleTable<ConstantFoldingRule> rules_;
 };
 
 }  // namespace opt
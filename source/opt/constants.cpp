@@ -22,12 +22,38 @@ namespace spvtools {
 namespace opt {
 namespace analysis {
 
-ConstantManager::ConstantManager(ir::IRContext* ctx) : ctx_(ctx) {
-  // Populate the constant table with values from constant declarations in the
-  // module.  The values of each OpConstant declaration is the identity
-  // assignment (i.e., each constant is its own value).
-  for (const auto& inst : ctx_->module()->GetConstants()) {
-    MapInst(inst);
+ConstantManager::ConstantManager(ir::IRContext* ctx)
+    : ctx_(ctx), all_constants_mapped_(false) {}
+
+const Constant* ConstantManager::MapDeclaredConstant(uint32_t id) {
+  ir::Instruction* inst = context()->get_def_use_mgr()->GetDef(id);
+  if (inst == nullptr || !ir::IsConstantInst(inst->opcode())) return nullptr;
+  const Constant* cst = GetConstantFromInst(inst);
+  if (cst != nullptr) SetDeclaredConstant(id, cst);
+  return cst;
+}
+
+void ConstantManager::MapAllConstants() {
+  if (all_constants_mapped_) return;
+  all_constants_mapped_ = true;
+
+  // The values of each OpConstant declaration is the identity assignment
+  // (i.e., each constant is its own value).  When a value is declared more
+  // than once, the last declaration in the module is the one that is found,
+  // unless another one has been mapped explicitly already.
+  std::vector<ir::Instruction*> const_insts =
+      context()->module()->GetConstants();
+  for (auto it = const_insts.rbegin(); it != const_insts.rend(); ++it) {
+    ir::Instruction* inst = *it;
+    const uint32_t id = inst->result_id();
+    const Constant* cst = id < id_to_const_val_.size() ? id_to_const_val_[id]
+                                                        : nullptr;
+    if (cst == nullptr) {
+      cst = GetConstantFromInst(inst);
+      if (cst == nullptr) continue;
+      SetDeclaredConstant(id, cst);
+    }
+    const_val_to_id_.insert({cst, id});
   }
 }
 
@@ -36,7 +62,7 @@ Type* ConstantManager::GetType(const ir::Instruction* inst) const {
 }
 
 std::vector<const Constant*> ConstantManager::GetConstantsFromIds(
-    const std::vector<uint32_t>& ids) const {
+    const std::vector<uint32_t>& ids) {
   std::vector<const Constant*> constants;
   for (uint32_t id : ids) {
     if (const Constant* c = FindDeclaredConstant(id)) {
@@ -79,7 +105,7 @@ ir::Instruction* ConstantManager::GetDefiningInstruction(
 }
 
 const Constant* ConstantManager::CreateConstant(
-    const Type* type, const std::vector<uint32_t>& literal_words_or_ids) const {
+    const Type* type, const std::vector<uint32_t>& literal_words_or_ids) {
   if (literal_words_or_ids.size() == 0) {
     // Constant declared with OpConstantNull
     return new NullConstant(type);
@@ -163,7 +189,7 @@ const Constant* ConstantManager::GetConstantFromInst(ir::Instruction* inst) {
 }
 
 std::unique_ptr<ir::Instruction> ConstantManager::CreateInstruction(
-    uint32_t id, const Constant* c, uint32_t type_id) const {
+    uint32_t id, const Constant* c, uint32_t type_id) {
   uint32_t type =
       (type_id == 0) ? context()->get_type_mgr()->GetId(c->type()) : type_id;
   if (c->AsNullConstant()) {
@@ -195,7 +221,7 @@ std::unique_ptr<ir::Instruction> ConstantManager::CreateInstruction(
 }
 
 std::unique_ptr<ir::Instruction> ConstantManager::CreateCompositeInstruction(
-    uint32_t result_id, const CompositeConstant* cc, uint32_t type_id) const {
+    uint32_t result_id, const CompositeConstant* cc, uint32_t type_id) {
   std::vector<ir::Operand> operands;
   for (const Constant* component_const : cc->GetComponents()) {
     uint32_t id = FindDeclaredConstant(component_const);
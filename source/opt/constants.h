@@ -424,6 +424,13 @@ struct ConstantEqual {
 };
 
 // This class represents a pool of constants.
+//
+// The manager does not scan the module when it is created.  The constant
+// declared by an id is analyzed the first time that id is looked up, so a pass
+// that only queries a few ids never pays for the thousands of constants a
+// module may declare.  Looking up the id of a Constant instance needs to know
+// every declaration, so the first such query maps all of the constants in the
+// module.
 class ConstantManager {
  public:
   ConstantManager(ir::IRContext* ctx);
@@ -471,17 +478,21 @@ class ConstantManager {
   // nullptr if the instruction does not have a type id (type id is 0).
   Type* GetType(const ir::Instruction* inst) const;
 
-  // A helper function to get the collected normal constant with the given id.
+  // A helper function to get the normal constant declared with the given id.
   // Returns the pointer to the Constant instance in case it is found.
-  // Otherwise, it returns a null pointer.
-  const Constant* FindDeclaredConstant(uint32_t id) const {
-    auto iter = id_to_const_val_.find(id);
-    return (iter != id_to_const_val_.end()) ? iter->second : nullptr;
+  // Otherwise, it returns a null pointer.  The declaration of |id| is analyzed
+  // if this is the first time it is looked up.
+  const Constant* FindDeclaredConstant(uint32_t id) {
+    if (id < id_to_const_val_.size() && id_to_const_val_[id] != nullptr) {
+      return id_to_const_val_[id];
+    }
+    return all_constants_mapped_ ? nullptr : MapDeclaredConstant(id);
   }
 
   // A helper function to get the id of a collected constant with the pointer
   // to the Constant instance. Returns 0 in case the constant is not found.
-  uint32_t FindDeclaredConstant(const Constant* c) const {
+  uint32_t FindDeclaredConstant(const Constant* c) {
+    MapAllConstants();
     auto iter = const_val_to_id_.find(c);
     return (iter != const_val_to_id_.end()) ? iter->second : 0;
   }
@@ -505,7 +516,7 @@ class ConstantManager {
   // ids. If it can not find the Constant instance for any one of the ids,
   // it returns an empty vector.
   std::vector<const Constant*> GetConstantsFromIds(
-      const std::vector<uint32_t>& ids) const;
+      const std::vector<uint32_t>& ids);
 
   // Records a mapping between |inst| and the constant value generated by it.
   // It returns true if a new Constant was successfully mapped, false if |inst|
@@ -519,10 +530,9 @@ class ConstantManager {
   }
 
   void RemoveId(uint32_t id) {
-    auto it = id_to_const_val_.find(id);
-    if (it != id_to_const_val_.end()) {
-      const_val_to_id_.erase(it->second);
-      id_to_const_val_.erase(it);
+    if (id < id_to_const_val_.size() && id_to_const_val_[id] != nullptr) {
+      const_val_to_id_.erase(id_to_const_val_[id]);
+      id_to_const_val_[id] = nullptr;
     }
   }
 
@@ -530,10 +540,25 @@ class ConstantManager {
   // two mappings |id_to_const_val_| and |const_val_to_id_|.
   void MapConstantToInst(const Constant* const_value, ir::Instruction* inst) {
     const_val_to_id_[const_value] = inst->result_id();
-    id_to_const_val_[inst->result_id()] = const_value;
+    SetDeclaredConstant(inst->result_id(), const_value);
   }
 
  private:
+  // Analyzes the instruction that defines |id|, and records the constant it
+  // declares in |id_to_const_val_|.  Returns the constant, or nullptr if |id|
+  // is not the result of a normal constant declaration.
+  const Constant* MapDeclaredConstant(uint32_t id);
+
+  // Maps every constant declared in the module, if that has not been done
+  // yet.  The mappings that are already recorded are kept.
+  void MapAllConstants();
+
+  // Records that |id| declares |const_value| in |id_to_const_val_|.
+  void SetDeclaredConstant(uint32_t id, const Constant* const_value) {
+    if (id >= id_to_const_val_.size()) id_to_const_val_.resize(id + 1, nullptr);
+    id_to_const_val_[id] = const_value;
+  }
+
   // Creates a Constant instance with the given type and a vector of constant
   // defining words. Returns a unique pointer to the created Constant instance
   // if the Constant instance can be created successfully. To create scalar
@@ -548,7 +573,7 @@ class ConstantManager {
   // a NullConstant instance will be created with the given type.
   const Constant* CreateConstant(
       const Type* type,
-      const std::vector<uint32_t>& literal_words_or_ids) const;
+      const std::vector<uint32_t>& literal_words_or_ids);
 
   // Creates an instruction with the given result id to declare a constant
   // represented by the given Constant instance. Returns an unique pointer to
@@ -560,7 +585,7 @@ class ConstantManager {
   // the type of the constant is derived by getting an id from the type manager
   // for |c|.
   std::unique_ptr<ir::Instruction> CreateInstruction(
-      uint32_t result_id, const Constant* c, uint32_t type_id = 0) const;
+      uint32_t result_id, const Constant* c, uint32_t type_id = 0);
 
   // Creates an OpConstantComposite instruction with the given result id and
   // the CompositeConst instance which represents a composite constant. Returns
@@ -573,23 +598,27 @@ class ConstantManager {
   // for |c|.
   std::unique_ptr<ir::Instruction> CreateCompositeInstruction(
       uint32_t result_id, const CompositeConstant* cc,
-      uint32_t type_id = 0) const;
+      uint32_t type_id = 0);
 
   // IR context that owns this constant manager.
   ir::IRContext* ctx_;
 
-  // A mapping from the result ids of Normal Constants to their
-  // Constant instances. All Normal Constants in the module, either
-  // existing ones before optimization or the newly generated ones, should have
-  // their Constant instance stored and their result id registered in this map.
-  std::unordered_map<uint32_t, const Constant*> id_to_const_val_;
+  // The Constant instances of the Normal Constants, indexed by their result
+  // ids.  The entry of an id that was not looked up yet, or that does not
+  // declare a Normal Constant, is null.  The newly generated Normal Constants
+  // are recorded here as soon as they are created.
+  std::vector<const Constant*> id_to_const_val_;
 
   // A mapping from the Constant instance of Normal Constants to their
-  // result id in the module. This is a mirror map of |id_to_const_val_|. All
-  // Normal Constants that defining instructions in the module should have
-  // their Constant and their result id registered here.
+  // result id in the module. This is a mirror map of |id_to_const_val_|.  Once
+  // |all_constants_mapped_| is set, all Normal Constants that have defining
+  // instructions in the module have their Constant and their result id
+  // registered here.
   std::unordered_map<const Constant*, uint32_t> const_val_to_id_;
 
+  // True once every constant declared in the module has been mapped.
+  bool all_constants_mapped_;
+
   // The constant pool.  All created constants are registered here.
   std::unordered_set<const Constant*, ConstantHash, ConstantEqual> const_pool_;
 };
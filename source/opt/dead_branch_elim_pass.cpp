@@ -392,9 +392,8 @@ Pass::Status DeadBranchElimPass::ProcessImpl() {
   // Do not process if any disallowed extensions are enabled
   if (!AllExtensionsSupported()) return Status::SuccessWithoutChange;
   // Process all entry point functions
-  ProcessFunction pfn = [this](ir::Function* fp) {
-    return EliminateDeadBranches(fp);
-  };
+  ProcessFunction pfn = FilterFunctions(
+      [this](ir::Function* fp) { return EliminateDeadBranches(fp); });
   bool modified = ProcessReachableCallTree(pfn, context());
   return modified ? Status::SuccessWithChange : Status::SuccessWithoutChange;
 }
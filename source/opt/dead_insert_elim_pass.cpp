@@ -264,9 +264,8 @@ Pass::Status DeadInsertElimPass::ProcessImpl() {
   // Do not process if any disallowed extensions are enabled
   if (!AllExtensionsSupported()) return Status::SuccessWithoutChange;
   // Process all entry point functions.
-  ProcessFunction pfn = [this](ir::Function* fp) {
-    return EliminateDeadInserts(fp);
-  };
+  ProcessFunction pfn = FilterFunctions(
+      [this](ir::Function* fp) { return EliminateDeadInserts(fp); });
   bool modified = ProcessEntryPointCallTree(pfn, get_module());
   return modified ? Status::SuccessWithChange : Status::SuccessWithoutChange;
 }
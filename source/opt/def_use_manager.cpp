@@ -14,6 +14,9 @@
 
 #include "def_use_manager.h"
 
+#include <algorithm>
+#include <cstdint>
+
 #include "log.h"
 #include "reflect.h"
 
@@ -24,12 +27,12 @@ namespace analysis {
 void DefUseManager::AnalyzeInstDef(ir::Instruction* inst) {
   const uint32_t def_id = inst->result_id();
   if (def_id != 0) {
-    auto iter = id_to_def_.find(def_id);
-    if (iter != id_to_def_.end()) {
+    if (ir::Instruction* old_def = GetDef(def_id)) {
       // Clear the original instruction that defining the same result id of the
       // new instruction.
-      ClearInst(iter->second);
+      ClearInst(old_def);
     }
+    if (def_id >= id_to_def_.size()) id_to_def_.resize(def_id + 1, nullptr);
     id_to_def_[def_id] = inst;
   } else {
     ClearInst(inst);
@@ -40,12 +43,8 @@ void DefUseManager::AnalyzeInstUse(ir::Instruction* inst) {
   // Create entry for the given instruction. Note that the instruction may
   // not have any in-operands. In such cases, we still need a entry for those
   // instructions so this manager knows it has seen the instruction later.
-  auto* used_ids = &inst_to_used_ids_[inst];
-  if (used_ids->size()) {
-    EraseUseRecordsOfOperandIds(inst);
-    used_ids = &inst_to_used_ids_[inst];
-  }
-  used_ids->clear();  // It might have existed before.
+  EraseUseRecordsOfOperandIds(inst);
+  std::vector<uint32_t>* used_ids = &GetOrAddUsedIds(inst)->ids;
 
   for (uint32_t i = 0; i < inst->NumOperands(); ++i) {
     switch (inst->GetOperand(i).type) {
@@ -57,7 +56,8 @@ void DefUseManager::AnalyzeInstUse(ir::Instruction* inst) {
         uint32_t use_id = inst->GetSingleWordOperand(i);
         ir::Instruction* def = GetDef(use_id);
         assert(def && "Definition is not registered.");
-        id_to_users_.insert(UserEntry(def, inst));
+        (void)def;
+        AddUser(use_id, inst);
         used_ids->push_back(use_id);
       } break;
       default:
@@ -73,43 +73,94 @@ void DefUseManager::AnalyzeInstDefUse(ir::Instruction* inst) {
 
 void DefUseManager::UpdateDefUse(ir::Instruction* inst) {
   const uint32_t def_id = inst->result_id();
-  if (def_id != 0) {
-    auto iter = id_to_def_.find(def_id);
-    if (iter != id_to_def_.end()) {
-      AnalyzeInstDef(inst);
-    } else {
-    }
+  if (def_id != 0 && GetDef(def_id)) {
+    AnalyzeInstDef(inst);
   }
   AnalyzeInstUse(inst);
 }
 
 ir::Instruction* DefUseManager::GetDef(uint32_t id) {
-  auto iter = id_to_def_.find(id);
-  if (iter == id_to_def_.end()) return nullptr;
-  return iter->second;
+  return id < id_to_def_.size() ? id_to_def_[id] : nullptr;
 }
 
 const ir::Instruction* DefUseManager::GetDef(uint32_t id) const {
-  const auto iter = id_to_def_.find(id);
-  if (iter == id_to_def_.end()) return nullptr;
-  return iter->second;
+  return id < id_to_def_.size() ? id_to_def_[id] : nullptr;
+}
+
+namespace {
+
+// Orders instructions by their unique ids.
+bool UniqueIdLess(const ir::Instruction* lhs, const ir::Instruction* rhs) {
+  return lhs->unique_id() < rhs->unique_id();
+}
+
+// Returns the index in |users| of the user to visit after the one at index
+// |i|, whose unique id is |unique_id|.  The users may have changed since it was
+// visited, so if it is no longer at |i| this is the first user with a larger
+// unique id.
+size_t NextUserIndex(const std::vector<ir::Instruction*>& users, size_t i,
+                     uint32_t unique_id) {
+  if (i < users.size() && users[i]->unique_id() == unique_id) return i + 1;
+  return std::upper_bound(users.begin(), users.end(), unique_id,
+                          [](uint32_t id, const ir::Instruction* user) {
+                            return id < user->unique_id();
+                          }) -
+         users.begin();
 }
 
-DefUseManager::IdToUsersMap::const_iterator DefUseManager::UsersBegin(
-    const ir::Instruction* def) const {
-  return id_to_users_.lower_bound(
-      UserEntry(const_cast<ir::Instruction*>(def), nullptr));
+}  // anonymous namespace
+
+void DefUseManager::AddUser(uint32_t id, ir::Instruction* user) {
+  if (id >= id_to_users_.size()) id_to_users_.resize(id + 1);
+  UserList& users = id_to_users_[id];
+  // Instructions are mostly analyzed in the order they were created, so the
+  // new user usually goes at the end.
+  if (users.empty() || UniqueIdLess(users.back(), user)) {
+    users.push_back(user);
+    return;
+  }
+  auto iter = std::lower_bound(users.begin(), users.end(), user, UniqueIdLess);
+  if (*iter != user) users.insert(iter, user);
 }
 
-bool DefUseManager::UsersNotEnd(const IdToUsersMap::const_iterator& iter,
-                                const IdToUsersMap::const_iterator& cached_end,
-                                const ir::Instruction* inst) const {
-  return (iter != cached_end && iter->first == inst);
+void DefUseManager::RemoveUser(uint32_t id, const ir::Instruction* user) {
+  if (id >= id_to_users_.size()) return;
+  UserList& users = id_to_users_[id];
+  auto iter = std::lower_bound(users.begin(), users.end(), user, UniqueIdLess);
+  if (iter != users.end() && *iter == user) users.erase(iter);
 }
 
-bool DefUseManager::UsersNotEnd(const IdToUsersMap::const_iterator& iter,
-                                const ir::Instruction* inst) const {
-  return UsersNotEnd(iter, id_to_users_.end(), inst);
+DefUseManager::UsedIds* DefUseManager::FindUsedIds(
+    const ir::Instruction* inst) {
+  // Unique ids below |first_unique_id_| wrap around to large offsets.
+  const uint32_t offset = inst->unique_id() - first_unique_id_;
+  if (offset < inst_to_used_ids_.size() &&
+      inst_to_used_ids_[offset].inst == inst) {
+    return &inst_to_used_ids_[offset];
+  }
+  if (sparse_used_ids_.empty()) return nullptr;
+  const auto it = sparse_used_ids_.find(inst->unique_id());
+  return it == sparse_used_ids_.end() ? nullptr : &it->second;
+}
+
+DefUseManager::UsedIds* DefUseManager::GetOrAddUsedIds(
+    const ir::Instruction* inst) {
+  if (UsedIds* used_ids = FindUsedIds(inst)) return used_ids;
+  const uint32_t offset = inst->unique_id() - first_unique_id_;
+  UsedIds* used_ids = nullptr;
+  if (offset < inst_to_used_ids_.size()) {
+    used_ids = &inst_to_used_ids_[offset];
+  } else if (offset < 2 * inst_to_used_ids_.size() + 16) {
+    // Instructions added since the module was analyzed take the next unique
+    // ids, so the table grows at its end.
+    inst_to_used_ids_.resize(
+        std::max<size_t>(offset + 1, 2 * inst_to_used_ids_.size()));
+    used_ids = &inst_to_used_ids_[offset];
+  } else {
+    used_ids = &sparse_used_ids_[inst->unique_id()];
+  }
+  used_ids->inst = inst;
+  return used_ids;
 }
 
 bool DefUseManager::WhileEachUser(
@@ -120,9 +171,16 @@ bool DefUseManager::WhileEachUser(
          "Definition is not registered.");
   if (!def->HasResultId()) return true;
 
-  auto end = id_to_users_.end();
-  for (auto iter = UsersBegin(def); UsersNotEnd(iter, end, def); ++iter) {
-    if (!f(iter->second)) return false;
+  // |f| may change the def-use records, and even remove the user it is given,
+  // so look up the users again after each call.
+  const uint32_t id = def->result_id();
+  const UserList* users = GetUsers(id);
+  for (size_t i = 0; users && i < users->size();) {
+    ir::Instruction* user = (*users)[i];
+    const uint32_t unique_id = user->unique_id();
+    if (!f(user)) return false;
+    users = GetUsers(id);
+    if (users) i = NextUserIndex(*users, i, unique_id);
   }
   return true;
 }
@@ -154,9 +212,13 @@ bool DefUseManager::WhileEachUse(
          "Definition is not registered.");
   if (!def->HasResultId()) return true;
 
-  auto end = id_to_users_.end();
-  for (auto iter = UsersBegin(def); UsersNotEnd(iter, end, def); ++iter) {
-    ir::Instruction* user = iter->second;
+  // |f| may change the def-use records, and even remove the user it is given,
+  // so look up the users again after each user.
+  const uint32_t id = def->result_id();
+  const UserList* users = GetUsers(id);
+  for (size_t i = 0; users && i < users->size();) {
+    ir::Instruction* user = (*users)[i];
+    const uint32_t unique_id = user->unique_id();
     for (uint32_t idx = 0; idx != user->NumOperands(); ++idx) {
       const ir::Operand& op = user->GetOperand(idx);
       if (op.type != SPV_OPERAND_TYPE_RESULT_ID && spvIsIdType(op.type)) {
@@ -165,6 +227,8 @@ bool DefUseManager::WhileEachUse(
         }
       }
     }
+    users = GetUsers(id);
+    if (users) i = NextUserIndex(*users, i, unique_id);
   }
   return true;
 }
@@ -225,6 +289,33 @@ std::vector<ir::Instruction*> DefUseManager::GetAnnotations(uint32_t id) const {
 
 void DefUseManager::AnalyzeDefUse(ir::Module* module) {
   if (!module) return;
+  id_to_def_.reserve(module->IdBound());
+  id_to_users_.reserve(module->IdBound());
+
+  // Cover the unique ids of the module with the table of used ids, unless
+  // they are spread over a range much larger than the module.  Then only the
+  // instructions added from now on go in the table.
+  uint32_t min_unique_id = UINT32_MAX;
+  uint32_t max_unique_id = 0;
+  size_t num_insts = 0;
+  module->ForEachInst([&min_unique_id, &max_unique_id,
+                       &num_insts](ir::Instruction* inst) {
+    min_unique_id = std::min(min_unique_id, inst->unique_id());
+    max_unique_id = std::max(max_unique_id, inst->unique_id());
+    ++num_insts;
+  });
+  if (num_insts != 0) {
+    const uint64_t range =
+        static_cast<uint64_t>(max_unique_id) - min_unique_id + 1;
+    if (range <= 4 * static_cast<uint64_t>(num_insts)) {
+      first_unique_id_ = min_unique_id;
+      inst_to_used_ids_.resize(static_cast<size_t>(range));
+    } else {
+      first_unique_id_ = max_unique_id + 1;
+      sparse_used_ids_.reserve(num_insts);
+    }
+  }
+
   // Analyze all the defs before any uses to catch forward references.
   module->ForEachInst(
       std::bind(&DefUseManager::AnalyzeInstDef, this, std::placeholders::_1));
@@ -233,18 +324,13 @@ void DefUseManager::AnalyzeDefUse(ir::Module* module) {
 }
 
 void DefUseManager::ClearInst(ir::Instruction* inst) {
-  auto iter = inst_to_used_ids_.find(inst);
-  if (iter != inst_to_used_ids_.end()) {
+  if (FindUsedIds(inst)) {
     EraseUseRecordsOfOperandIds(inst);
-    if (inst->result_id() != 0) {
+    const uint32_t def_id = inst->result_id();
+    if (def_id != 0) {
       // Remove all uses of this inst.
-      auto users_begin = UsersBegin(inst);
-      auto end = id_to_users_.end();
-      auto new_end = users_begin;
-      for (; UsersNotEnd(new_end, end, inst); ++new_end) {
-      }
-      id_to_users_.erase(users_begin, new_end);
-      id_to_def_.erase(inst->result_id());
+      if (def_id < id_to_users_.size()) id_to_users_[def_id].clear();
+      if (def_id < id_to_def_.size()) id_to_def_[def_id] = nullptr;
     }
   }
 }
@@ -252,26 +338,46 @@ void DefUseManager::ClearInst(ir::Instruction* inst) {
 void DefUseManager::EraseUseRecordsOfOperandIds(const ir::Instruction* inst) {
   // Go through all ids used by this instruction, remove this instruction's
   // uses of them.
-  auto iter = inst_to_used_ids_.find(inst);
-  if (iter != inst_to_used_ids_.end()) {
-    for (auto use_id : iter->second) {
-      id_to_users_.erase(
-          UserEntry(GetDef(use_id), const_cast<ir::Instruction*>(inst)));
+  if (UsedIds* used_ids = FindUsedIds(inst)) {
+    for (auto use_id : used_ids->ids) {
+      RemoveUser(use_id, inst);
+    }
+    const uint32_t offset = inst->unique_id() - first_unique_id_;
+    if (offset < inst_to_used_ids_.size() &&
+        used_ids == &inst_to_used_ids_[offset]) {
+      used_ids->inst = nullptr;
+      used_ids->ids.clear();
+    } else {
+      sparse_used_ids_.erase(inst->unique_id());
     }
-    inst_to_used_ids_.erase(inst);
   }
 }
 
-bool operator==(const DefUseManager& lhs, const DefUseManager& rhs) {
-  if (lhs.id_to_def_ != rhs.id_to_def_) {
+namespace {
+
+// Returns true if the tables |lhs| and |rhs| indexed by id hold the same
+// entries, where ids past the end of a table map to the empty entry.
+template <class Table>
+bool SameTableEntries(const Table& lhs, const Table& rhs) {
+  const Table& shorter = lhs.size() < rhs.size() ? lhs : rhs;
+  const Table& longer = lhs.size() < rhs.size() ? rhs : lhs;
+  if (!std::equal(shorter.begin(), shorter.end(), longer.begin())) {
     return false;
   }
+  return std::all_of(longer.begin() + shorter.size(), longer.end(),
+                     [](const typename Table::value_type& entry) {
+                       return entry == typename Table::value_type();
+                     });
+}
+
+}  // anonymous namespace
 
-  if (lhs.id_to_users_ != rhs.id_to_users_) {
+bool operator==(const DefUseManager& lhs, const DefUseManager& rhs) {
+  if (!SameTableEntries(lhs.id_to_def_, rhs.id_to_def_)) {
     return false;
   }
 
-  if (lhs.inst_to_used_ids_ != lhs.inst_to_used_ids_) {
+  if (!SameTableEntries(lhs.id_to_users_, rhs.id_to_users_)) {
     return false;
   }
   return true;
@@ -15,8 +15,6 @@
 #ifndef LIBSPIRV_OPT_DEF_USE_MANAGER_H_
 #define LIBSPIRV_OPT_DEF_USE_MANAGER_H_
 
-#include <list>
-#include <set>
 #include <unordered_map>
 #include <vector>
 
@@ -50,59 +48,26 @@ inline bool operator<(const Use& lhs, const Use& rhs) {
   return lhs.operand_index < rhs.operand_index;
 }
 
-// Definition and user pair.
-//
-// The first element of the pair is the definition.
-// The second element of the pair is the user.
-//
-// Definition should never be null. User can be null, however, such an entry
-// should be used only for searching (e.g. all users of a particular definition)
-// and never stored in a container.
-using UserEntry = std::pair<ir::Instruction*, ir::Instruction*>;
-
-// Orders UserEntry for use in associative containers (i.e. less than ordering).
-//
-// The definition of an UserEntry is treated as the major key and the users as
-// the minor key so that all the users of a particular definition are
-// consecutive in a container.
-//
-// A null user always compares less than a real user. This is done to provide
-// easy values to search for the beginning of the users of a particular
-// definition (i.e. using {def, nullptr}).
-struct UserEntryLess {
-  bool operator()(const UserEntry& lhs, const UserEntry& rhs) const {
-    // If lhs.first and rhs.first are both null, fall through to checking the
-    // second entries.
-    if (!lhs.first && rhs.first) return true;
-    if (lhs.first && !rhs.first) return false;
-
-    // If neither definition is null, then compare unique ids.
-    if (lhs.first && rhs.first) {
-      if (lhs.first->unique_id() < rhs.first->unique_id()) return true;
-      if (rhs.first->unique_id() < lhs.first->unique_id()) return false;
-    }
-
-    // Return false on equality.
-    if (!lhs.second && !rhs.second) return false;
-    if (!lhs.second) return true;
-    if (!rhs.second) return false;
-
-    // If neither user is null then compare unique ids.
-    return lhs.second->unique_id() < rhs.second->unique_id();
-  }
-};
-
 // A class for analyzing and managing defs and uses in an ir::Module.
+//
+// Since ids are dense up to the id bound of the module, the defs and the users
+// of an id are kept in tables indexed by the id.  The users of each id are
+// sorted by their unique ids, so they are visited in a stable order.  The ids
+// used by each instruction are kept in a table indexed by its unique id, less
+// the smallest unique id in the module when it was analyzed.
 class DefUseManager {
  public:
-  using IdToDefMap = std::unordered_map<uint32_t, ir::Instruction*>;
-  using IdToUsersMap = std::set<UserEntry, UserEntryLess>;
+  // Maps an id to its def instruction, or to null if it has no def.  Ids past
+  // the end of the table have no def either.
+  using IdToDefTable = std::vector<ir::Instruction*>;
 
   // Constructs a def-use manager from the given |module|. All internal messages
   // will be communicated to the outside via the given message |consumer|. This
   // instance only keeps a reference to the |consumer|, so the |consumer| should
   // outlive this instance.
-  DefUseManager(ir::Module* module) { AnalyzeDefUse(module); }
+  DefUseManager(ir::Module* module) : first_unique_id_(0) {
+    AnalyzeDefUse(module);
+  }
 
   DefUseManager(const DefUseManager&) = delete;
   DefUseManager(DefUseManager&&) = delete;
@@ -194,10 +159,8 @@ class DefUseManager {
   // instructions which decorate the decoration group will not be returned.
   std::vector<ir::Instruction*> GetAnnotations(uint32_t id) const;
 
-  // Returns the map from ids to their def instructions.
-  const IdToDefMap& id_to_defs() const { return id_to_def_; }
-  // Returns the map from instructions to their users.
-  const IdToUsersMap& id_to_users() const { return id_to_users_; }
+  // Returns the table from ids to their def instructions.
+  const IdToDefTable& id_to_defs() const { return id_to_def_; }
 
   // Clear the internal def-use record of the given instruction |inst|. This
   // method will update the use information of the operand ids of |inst|. The
@@ -219,33 +182,48 @@ class DefUseManager {
   void UpdateDefUse(ir::Instruction* inst);
 
  private:
-  using InstToUsedIdsMap =
-      std::unordered_map<const ir::Instruction*, std::vector<uint32_t>>;
+  // The users of an id, sorted by their unique ids.
+  using UserList = std::vector<ir::Instruction*>;
+
+  // The ids used by the instruction |inst|.  An entry with a null |inst| is
+  // unused.
+  struct UsedIds {
+    const ir::Instruction* inst = nullptr;
+    std::vector<uint32_t> ids;
+  };
+
+  // Returns the users of |id|, or null if it has none.
+  const UserList* GetUsers(uint32_t id) const {
+    return id < id_to_users_.size() ? &id_to_users_[id] : nullptr;
+  }
 
-  // Returns the first location that {|def|, nullptr} could be inserted into the
-  // users map without violating ordering.
-  IdToUsersMap::const_iterator UsersBegin(const ir::Instruction* def) const;
+  // Records that |user| uses |id|, unless that is already recorded.
+  void AddUser(uint32_t id, ir::Instruction* user);
 
-  // Returns true if |iter| has not reached the end of |def|'s users.
-  //
-  // In the first version |iter| is compared against the end of the map for
-  // validity before other checks. In the second version, |iter| is compared
-  // against |cached_end| for validity before other checks. This allows caching
-  // the map's end which is a performance improvement on some platforms.
-  bool UsersNotEnd(const IdToUsersMap::const_iterator& iter,
-                   const ir::Instruction* def) const;
-  bool UsersNotEnd(const IdToUsersMap::const_iterator& iter,
-                   const IdToUsersMap::const_iterator& cached_end,
-                   const ir::Instruction* def) const;
+  // Removes the record that |user| uses |id|, if there is one.
+  void RemoveUser(uint32_t id, const ir::Instruction* user);
+
+  // Returns the ids used by |inst|, or null if |inst| has not been analyzed.
+  UsedIds* FindUsedIds(const ir::Instruction* inst);
+
+  // Returns the entry for the ids used by |inst|, adding one if needed.
+  UsedIds* GetOrAddUsedIds(const ir::Instruction* inst);
 
   // Analyzes the defs and uses in the given |module| and populates data
   // structures in this class. Does nothing if |module| is nullptr.
   void AnalyzeDefUse(ir::Module* module);
 
-  IdToDefMap id_to_def_;      // Mapping from ids to their definitions
-  IdToUsersMap id_to_users_;  // Mapping from ids to their users
-  // Mapping from instructions to the ids used in the instruction.
-  InstToUsedIdsMap inst_to_used_ids_;
+  IdToDefTable id_to_def_;            // Mapping from ids to their definitions
+  std::vector<UserList> id_to_users_;  // Mapping from ids to their users
+  // Mapping from the unique ids of instructions, minus |first_unique_id_|, to
+  // the ids they use.  Unique ids are never reused, so after a number of
+  // passes the instructions of a module have unique ids spread over a range
+  // much larger than the module.  The table only covers the range of the
+  // module when it was analyzed, and the instructions added since.  The ones
+  // outside of it are kept in |sparse_used_ids_|.
+  uint32_t first_unique_id_;
+  std::vector<UsedIds> inst_to_used_ids_;
+  std::unordered_map<uint32_t, UsedIds> sparse_used_ids_;
 };
 
 }  // namespace analysis
@@ -15,6 +15,8 @@
 #include <iostream>
 #include <memory>
 #include <set>
+#include <unordered_map>
+#include <unordered_set>
 
 #include "cfa.h"
 #include "dominator_tree.h"
@@ -38,6 +40,12 @@ using namespace spvtools::opt;
 // 5 - Using the tree from 4, perform a depth first traversal to calculate the
 // preorder and postorder index of each node. We use these indexes to compare
 // nodes against each other for domination checks.
+//
+// After an edit to the CFG, only the subtree of the nearest common dominator
+// of the blocks whose edges changed is recomputed, with steps 2 and 3 limited
+// to the blocks in that subtree (after Georgiadis et al., "An Experimental
+// Study of Dynamic Dominators").  The indexes of step 5 are recomputed on the
+// next query.
 
 namespace {
 
@@ -249,6 +257,8 @@ bool DominatorTree::Dominates(const DominatorTreeNode* a,
   // Node A dominates node B if they are the same.
   if (a == b) return true;
 
+  UpdateDFSNumbers();
+
   return a->dfs_num_pre_ < b->dfs_num_pre_ &&
          a->dfs_num_post_ > b->dfs_num_post_;
 }
@@ -265,10 +275,8 @@ ir::BasicBlock* DominatorTree::ImmediateDominator(
 
 ir::BasicBlock* DominatorTree::ImmediateDominator(uint32_t a) const {
   // Check that A is a valid node in the tree.
-  auto a_itr = nodes_.find(a);
-  if (a_itr == nodes_.end()) return nullptr;
-
-  const DominatorTreeNode* node = &a_itr->second;
+  const DominatorTreeNode* node = GetTreeNode(a);
+  if (node == nullptr) return nullptr;
 
   if (node->parent_ == nullptr) {
     return nullptr;
@@ -277,20 +285,38 @@ ir::BasicBlock* DominatorTree::ImmediateDominator(uint32_t a) const {
   return node->parent_->bb_;
 }
 
-DominatorTreeNode* DominatorTree::GetOrInsertNode(ir::BasicBlock* bb) {
-  DominatorTreeNode* dtn = nullptr;
-
-  std::map<uint32_t, DominatorTreeNode>::iterator node_iter =
-      nodes_.find(bb->id());
-  if (node_iter == nodes_.end()) {
-    dtn = &nodes_.emplace(std::make_pair(bb->id(), DominatorTreeNode{bb}))
-               .first->second;
-  } else
-    dtn = &node_iter->second;
+bool DominatorTree::ReachableFromRoots(uint32_t a) const {
+  return GetTreeNode(a) != nullptr;
+}
 
+DominatorTreeNode* DominatorTree::GetOrInsertNode(ir::BasicBlock* bb) {
+  DominatorTreeNode* dtn = GetTreeNode(bb->id());
+  if (dtn == nullptr) {
+    nodes_.emplace_back(bb);
+    dtn = &nodes_.back();
+    SetTreeNode(bb->id(), dtn);
+  }
   return dtn;
 }
 
+void DominatorTree::SetTreeNode(uint32_t id, DominatorTreeNode* node) {
+  if (id_to_node_.empty()) {
+    if (node == nullptr) return;
+    id_offset_ = id;
+  }
+  if (id < id_offset_) {
+    if (node == nullptr) return;
+    id_to_node_.insert(id_to_node_.begin(), id_offset_ - id, nullptr);
+    id_offset_ = id;
+  }
+  const size_t index = id - id_offset_;
+  if (index >= id_to_node_.size()) {
+    if (node == nullptr) return;
+    id_to_node_.resize(index + 1, nullptr);
+  }
+  id_to_node_[index] = node;
+}
+
 void DominatorTree::GetDominatorEdges(
     const ir::Function* f, const ir::BasicBlock* dummy_start_node,
     std::vector<std::pair<ir::BasicBlock*, ir::BasicBlock*>>* edges) {
@@ -328,6 +354,8 @@ void DominatorTree::GetDominatorEdges(
 
 void DominatorTree::InitializeTree(const ir::Function* f, const ir::CFG& cfg) {
   ClearTree();
+  function_ = f;
+  cfg_ = &cfg;
 
   // Skip over empty functions.
   if (f->cbegin() == f->cend()) {
@@ -341,10 +369,28 @@ void DominatorTree::InitializeTree(const ir::Function* f, const ir::CFG& cfg) {
   std::vector<std::pair<ir::BasicBlock*, ir::BasicBlock*>> edges;
   GetDominatorEdges(f, dummy_start_node, &edges);
 
+  // Size the node table for the label ids of |f|.
+  uint32_t min_id = f->cbegin()->id();
+  uint32_t max_id = min_id;
+  for (const auto& bb : *f) {
+    min_id = std::min(min_id, bb.id());
+    max_id = std::max(max_id, bb.id());
+  }
+  id_offset_ = min_id;
+  id_to_node_.assign(max_id - min_id + 1, nullptr);
+
+  // The pseudo block has no id of its own in the function, so its node is
+  // only reachable as a root.
+  nodes_.emplace_back(const_cast<ir::BasicBlock*>(dummy_start_node));
+  DominatorTreeNode* dummy_node = &nodes_.back();
+  auto get_node = [this, dummy_start_node, dummy_node](ir::BasicBlock* bb) {
+    return bb == dummy_start_node ? dummy_node : GetOrInsertNode(bb);
+  };
+
   // Transform the vector<pair> into the tree structure which we can use to
   // efficiently query dominance.
   for (auto edge : edges) {
-    DominatorTreeNode* first = GetOrInsertNode(edge.first);
+    DominatorTreeNode* first = get_node(edge.first);
 
     if (edge.first == edge.second) {
       if (std::find(roots_.begin(), roots_.end(), first) == roots_.end())
@@ -352,12 +398,18 @@ void DominatorTree::InitializeTree(const ir::Function* f, const ir::CFG& cfg) {
       continue;
     }
 
-    DominatorTreeNode* second = GetOrInsertNode(edge.second);
+    DominatorTreeNode* second = get_node(edge.second);
 
     first->parent_ = second;
     second->children_.push_back(first);
   }
 
+  UpdateDFSNumbers();
+}
+
+void DominatorTree::UpdateDFSNumbers() const {
+  if (dfs_numbers_valid_) return;
+
   int index = 0;
   auto preFunc = [&index](const DominatorTreeNode* node) {
     const_cast<DominatorTreeNode*>(node)->dfs_num_pre_ = ++index;
@@ -370,6 +422,185 @@ void DominatorTree::InitializeTree(const ir::Function* f, const ir::CFG& cfg) {
   auto getSucc = [](const DominatorTreeNode* node) { return &node->children_; };
 
   for (auto root : roots_) DepthFirstSearch(root, getSucc, preFunc, postFunc);
+  dfs_numbers_valid_ = true;
+}
+
+DominatorTreeNode* DominatorTree::NearestCommonAncestor(DominatorTreeNode* a,
+                                                        DominatorTreeNode* b) {
+  std::unordered_set<const DominatorTreeNode*> ancestors;
+  for (DominatorTreeNode* node = a; node; node = node->parent_) {
+    ancestors.insert(node);
+  }
+  DominatorTreeNode* node = b;
+  while (node && !ancestors.count(node)) node = node->parent_;
+  return node;
+}
+
+bool DominatorTree::RecomputeSubtree(DominatorTreeNode* top) {
+  // Collect the nodes below |top|.  Every predecessor of one of their blocks
+  // is either in the subtree or unreachable, since |top| dominates them.
+  std::vector<DominatorTreeNode*> subtree;
+  std::unordered_set<const ir::BasicBlock*> in_subtree;
+  std::vector<DominatorTreeNode*> stack(1, top);
+  while (!stack.empty()) {
+    DominatorTreeNode* node = stack.back();
+    stack.pop_back();
+    subtree.push_back(node);
+    in_subtree.insert(node->bb_);
+    stack.insert(stack.end(), node->children_.begin(), node->children_.end());
+  }
+
+  // The edges of the CFG between those blocks.
+  using BlockList = std::vector<ir::BasicBlock*>;
+  std::unordered_map<const ir::BasicBlock*, BlockList> successors;
+  std::unordered_map<const ir::BasicBlock*, BlockList> predecessors;
+  for (DominatorTreeNode* node : subtree) {
+    ir::BasicBlock* bb = node->bb_;
+    BlockList& succ_list = successors[bb];
+    predecessors[bb];
+    static_cast<const ir::BasicBlock*>(bb)->ForEachSuccessorLabel(
+        [this, bb, &in_subtree, &succ_list,
+         &predecessors](const uint32_t succ_id) {
+          DominatorTreeNode* succ_node = GetTreeNode(succ_id);
+          if (!succ_node || !in_subtree.count(succ_node->bb_)) return;
+          succ_list.push_back(succ_node->bb_);
+          predecessors[succ_node->bb_].push_back(bb);
+        });
+  }
+
+  std::vector<const ir::BasicBlock*> postorder;
+  DepthFirstSearchPostOrder(
+      static_cast<const ir::BasicBlock*>(top->bb_),
+      [&successors](const ir::BasicBlock* bb) { return &successors[bb]; },
+      [&postorder](const ir::BasicBlock* bb) { postorder.push_back(bb); });
+  if (postorder.size() != subtree.size()) return false;
+
+  std::vector<std::pair<ir::BasicBlock*, ir::BasicBlock*>> edges =
+      CFA<ir::BasicBlock>::CalculateDominators(
+          postorder, [&predecessors](const ir::BasicBlock* bb) {
+            return &predecessors[bb];
+          });
+
+  // Relink the nodes below |top|.
+  for (DominatorTreeNode* node : subtree) node->children_.clear();
+  for (const auto& edge : edges) {
+    if (edge.first == top->bb_) continue;
+    DominatorTreeNode* node = GetTreeNode(edge.first->id());
+    DominatorTreeNode* idom = GetTreeNode(edge.second->id());
+    node->parent_ = idom;
+    idom->children_.push_back(node);
+  }
+  dfs_numbers_valid_ = false;
+  return true;
+}
+
+void DominatorTree::InsertEdge(uint32_t from_id, uint32_t to_id) {
+  if (roots_.empty()) return;
+  DominatorTreeNode* from = GetTreeNode(from_id);
+  DominatorTreeNode* to = GetTreeNode(to_id);
+  // In a post-dominator tree, the edge is reversed, and the pseudo exit block
+  // may gain or lose edges too.  Rebuild it instead.
+  if (postdominator_) {
+    Rebuild();
+    return;
+  }
+  // An edge out of an unreachable block changes nothing.
+  if (!from) return;
+  // The blocks that just became reachable need new nodes.
+  if (!to) {
+    Rebuild();
+    return;
+  }
+
+  // Only the blocks dominated by the nearest common dominator of |from| and
+  // |to| can have a new immediate dominator.  Nothing changes if that is |to|
+  // itself, which makes this a back edge, or the immediate dominator of |to|.
+  DominatorTreeNode* nca = NearestCommonAncestor(from, to);
+  if (nca == to || nca == to->parent_) return;
+  if (!nca->parent_ || !RecomputeSubtree(nca)) Rebuild();
+}
+
+void DominatorTree::DeleteEdge(uint32_t from_id, uint32_t to_id) {
+  if (roots_.empty()) return;
+  DominatorTreeNode* from = GetTreeNode(from_id);
+  DominatorTreeNode* to = GetTreeNode(to_id);
+  if (postdominator_) {
+    Rebuild();
+    return;
+  }
+  if (!from || !to) return;
+
+  // As for an insertion, only the blocks dominated by the nearest common
+  // dominator can change, and only if the edge is not a back edge.  If any of
+  // them became unreachable, the whole tree is rebuilt.
+  DominatorTreeNode* nca = NearestCommonAncestor(from, to);
+  if (nca == to) return;
+  if (!nca->parent_ || !RecomputeSubtree(nca)) Rebuild();
+}
+
+void DominatorTree::SplitBlock(const ir::BasicBlock* block,
+                               ir::BasicBlock* new_block) {
+  // If |block| is not in the tree, neither is |new_block|.
+  DominatorTreeNode* node = GetTreeNode(block->id());
+  if (!node) return;
+  nodes_.emplace_back(new_block);
+  DominatorTreeNode* new_node = &nodes_.back();
+  SetTreeNode(new_block->id(), new_node);
+
+  if (!postdominator_) {
+    // |new_block| is the only successor of |block|, so it takes over the
+    // blocks |block| dominated.
+    new_node->children_ = std::move(node->children_);
+    for (DominatorTreeNode* child : new_node->children_) {
+      child->parent_ = new_node;
+    }
+    node->children_.assign(1, new_node);
+    new_node->parent_ = node;
+  } else {
+    // |block| is the only predecessor of |new_block|, so |new_block| takes
+    // the place of |block| in the post-dominator tree.
+    DominatorTreeNode* parent = node->parent_;
+    auto& siblings = parent ? parent->children_ : roots_;
+    std::replace(siblings.begin(), siblings.end(), node, new_node);
+    new_node->parent_ = parent;
+    new_node->children_.assign(1, node);
+    node->parent_ = new_node;
+  }
+  dfs_numbers_valid_ = false;
+}
+
+void DominatorTree::MergeBlocks(uint32_t pred_id, uint32_t succ_id) {
+  // If |succ_id| is not in the tree, neither is |pred_id|.
+  DominatorTreeNode* succ = GetTreeNode(succ_id);
+  if (!succ) return;
+  DominatorTreeNode* pred = GetTreeNode(pred_id);
+  assert(pred && "The predecessor of a block in the tree is in the tree.");
+
+  // The two nodes are adjacent: |succ| is a child of |pred| in a dominator
+  // tree, and its parent in a post-dominator tree.  The merged block takes
+  // the place of the higher one, and the children of both.
+  if (succ->parent_ == pred) {
+    pred->children_.erase(
+        std::find(pred->children_.begin(), pred->children_.end(), succ));
+  } else {
+    assert(pred->parent_ == succ && "The merged blocks are not adjacent.");
+    DominatorTreeNode* parent = succ->parent_;
+    auto& siblings = parent ? parent->children_ : roots_;
+    std::replace(siblings.begin(), siblings.end(), succ, pred);
+    pred->parent_ = parent;
+    succ->children_.erase(
+        std::find(succ->children_.begin(), succ->children_.end(), pred));
+  }
+  for (DominatorTreeNode* child : succ->children_) {
+    child->parent_ = pred;
+    pred->children_.push_back(child);
+  }
+
+  succ->bb_ = nullptr;
+  succ->parent_ = nullptr;
+  succ->children_.clear();
+  SetTreeNode(succ_id, nullptr);
+  dfs_numbers_valid_ = false;
 }
 
 void DominatorTree::DumpTreeAsDot(std::ostream& out_stream) const {
@@ -16,7 +16,7 @@
 #define LIBSPIRV_OPT_DOMINATOR_ANALYSIS_TREE_H_
 
 #include <cstdint>
-#include <map>
+#include <deque>
 #include <utility>
 #include <vector>
 
@@ -90,10 +90,14 @@ struct DominatorTreeNode {
 
 // A class representing a tree of BasicBlocks in a given function, where each
 // node is dominated by its parent.
+//
+// Besides being built from scratch, the tree can be updated in place after
+// small edits to the CFG of its function, see InsertEdge(), DeleteEdge(),
+// SplitBlock() and MergeBlocks().  The dominance queries renumber the nodes
+// on their first use after such an update, so a tree must not be queried from
+// several threads at once.
 class DominatorTree {
  public:
-  // Map OpLabel ids to dominator tree nodes
-  using DominatorTreeNodeMap = std::map<uint32_t, DominatorTreeNode>;
   using iterator = TreeDFIterator<DominatorTreeNode>;
   using const_iterator = TreeDFIterator<const DominatorTreeNode>;
   using post_iterator = PostOrderTreeDFIterator<DominatorTreeNode>;
@@ -104,8 +108,18 @@ class DominatorTree {
   using roots_iterator = DominatorTreeNodeList::iterator;
   using roots_const_iterator = DominatorTreeNodeList::const_iterator;
 
-  DominatorTree() : postdominator_(false) {}
-  explicit DominatorTree(bool post) : postdominator_(post) {}
+  DominatorTree()
+      : function_(nullptr),
+        cfg_(nullptr),
+        id_offset_(0),
+        dfs_numbers_valid_(false),
+        postdominator_(false) {}
+  explicit DominatorTree(bool post)
+      : function_(nullptr),
+        cfg_(nullptr),
+        id_offset_(0),
+        dfs_numbers_valid_(false),
+        postdominator_(post) {}
 
   // Depth first iterators.
   // Traverse the dominator tree in a depth first pre-order.
@@ -159,6 +173,30 @@ class DominatorTree {
   // Any existing data will be overwritten
   void InitializeTree(const ir::Function* f, const ir::CFG& cfg);
 
+  // The following methods update the tree after an edit to the CFG of its
+  // function, which must already be reflected in the terminators of the
+  // basic blocks.  Only the part of the tree that can change is recomputed.
+  // A tree that has not been built is left alone.
+
+  // Updates the tree after an edge from the basic block |from_id| to the
+  // basic block |to_id| was added.
+  void InsertEdge(uint32_t from_id, uint32_t to_id);
+
+  // Updates the tree after the edge from the basic block |from_id| to the
+  // basic block |to_id| was removed.  There must be no other edge between
+  // them.
+  void DeleteEdge(uint32_t from_id, uint32_t to_id);
+
+  // Updates the tree after the tail of |block|, including its terminator,
+  // was moved into the new basic block |new_block|, and |block| was made to
+  // branch to |new_block|.
+  void SplitBlock(const ir::BasicBlock* block, ir::BasicBlock* new_block);
+
+  // Updates the tree after the basic block |succ_id| was merged into
+  // |pred_id|, where |pred_id| was the only predecessor of |succ_id| and
+  // branched only to it.  The tree no longer has a node for |succ_id|.
+  void MergeBlocks(uint32_t pred_id, uint32_t succ_id);
+
   // Check if the basic block |a| dominates the basic block |b|.
   bool Dominates(const ir::BasicBlock* a, const ir::BasicBlock* b) const;
 
@@ -203,7 +241,10 @@ class DominatorTree {
   // Clean up the tree.
   void ClearTree() {
     nodes_.clear();
+    id_to_node_.clear();
+    id_offset_ = 0;
     roots_.clear();
+    dfs_numbers_valid_ = false;
   }
 
   // Applies the std::function |func| to all nodes in the dominator tree.
@@ -251,20 +292,19 @@ class DominatorTree {
   // Returns the DominatorTreeNode associated with the basic block id |id|.
   // If the id |id| is unknown to the dominator tree, it returns null.
   inline DominatorTreeNode* GetTreeNode(uint32_t id) {
-    DominatorTreeNodeMap::iterator node_iter = nodes_.find(id);
-    if (node_iter == nodes_.end()) {
-      return nullptr;
+    if (id >= id_offset_ && id - id_offset_ < id_to_node_.size()) {
+      if (DominatorTreeNode* node = id_to_node_[id - id_offset_]) return node;
+    }
+    // The pseudo entry and exit blocks are only found through the roots.
+    for (DominatorTreeNode* root : roots_) {
+      if (root->id() == id) return root;
     }
-    return &node_iter->second;
+    return nullptr;
   }
   // Returns the DominatorTreeNode associated with the basic block id |id|.
   // If the id |id| is unknown to the dominator tree, it returns null.
   inline const DominatorTreeNode* GetTreeNode(uint32_t id) const {
-    DominatorTreeNodeMap::const_iterator node_iter = nodes_.find(id);
-    if (node_iter == nodes_.end()) {
-      return nullptr;
-    }
-    return &node_iter->second;
+    return const_cast<DominatorTree*>(this)->GetTreeNode(id);
   }
 
  private:
@@ -272,6 +312,30 @@ class DominatorTree {
   // exist.
   DominatorTreeNode* GetOrInsertNode(ir::BasicBlock* bb);
 
+  // Makes |node| the node found for the basic block id |id|.  |node| may be
+  // null to remove the node of |id|.
+  void SetTreeNode(uint32_t id, DominatorTreeNode* node);
+
+  // Numbers the nodes in depth first pre and post order, if an update has
+  // invalidated their numbers.
+  void UpdateDFSNumbers() const;
+
+  // Returns the deepest node that is an ancestor of both |a| and |b|.
+  DominatorTreeNode* NearestCommonAncestor(DominatorTreeNode* a,
+                                           DominatorTreeNode* b);
+
+  // Recomputes the part of the tree strictly below |top|, from the current
+  // successors of the basic blocks in that part.  This is enough whenever an
+  // edit only changed edges between blocks dominated by |top|.  Returns false
+  // without changing the tree if some of those blocks are no longer reachable
+  // from |top|.
+  bool RecomputeSubtree(DominatorTreeNode* top);
+
+  // Rebuilds the whole tree for the function it was built for.
+  void Rebuild() {
+    if (function_) InitializeTree(function_, *cfg_);
+  }
+
   // Wrapper function which gets the list of pairs of each BasicBlocks to its
   // immediately  dominating BasicBlock and stores the result in the the edges
   // parameter.
@@ -284,11 +348,26 @@ class DominatorTree {
       const ir::Function* f, const ir::BasicBlock* dummy_start_node,
       std::vector<std::pair<ir::BasicBlock*, ir::BasicBlock*>>* edges);
 
+  // The function and the CFG the tree was built for.
+  const ir::Function* function_;
+  const ir::CFG* cfg_;
+
   // The roots of the tree.
   std::vector<DominatorTreeNode*> roots_;
 
-  // Pairs each basic block id to the tree node containing that basic block.
-  DominatorTreeNodeMap nodes_;
+  // The nodes of the tree.  A deque keeps the nodes in place as it grows, so
+  // they can point at each other.  The nodes of merged blocks are left in
+  // place, and dropped on the next rebuild.
+  std::deque<DominatorTreeNode> nodes_;
+
+  // Maps a basic block id, minus |id_offset_|, to the tree node containing
+  // that basic block, or null.  The label ids of a function are mostly
+  // contiguous, so this is a dense table.
+  std::vector<DominatorTreeNode*> id_to_node_;
+  uint32_t id_offset_;
+
+  // True if the depth first numbers of the nodes are up to date.
+  mutable bool dfs_numbers_valid_;
 
   // True if this is a post dominator tree.
   bool postdominator_;
@@ -54,25 +54,45 @@ namespace opt {
 // given priority.  That is, if an earlier rule is able to fold an instruction,
 // the later rules will not be attempted.
 
-using FoldingRule = std::function<bool(
+using FoldingRule = bool (*)(
     ir::Instruction* inst,
-    const std::vector<const analysis::Constant*>& constants)>;
+    const std::vector<const analysis::Constant*>& constants);
+
+// A table of rules indexed directly by opcode.  The rules for an opcode are
+// found with a single array access, instead of a hash table lookup.
+template <class Rule>
+class OpcodeRuleTable {
+ public:
+  // Returns the list of rules for |opcode|, growing the table if needed.  Used
+  // while the table is built.
+  std::vector<Rule>& operator[](SpvOp opcode) {
+    if (opcode >= rules_.size()) rules_.resize(opcode + 1);
+    return rules_[opcode];
+  }
+
+  // Returns the list of rules for |opcode|.  The list is empty if there are
+  // no rules for |opcode|.
+  const std::vector<Rule>& Get(SpvOp opcode) const {
+    if (opcode < rules_.size()) return rules_[opcode];
+    return empty_vector_;
+  }
+
+ private:
+  std::vector<std::vector<Rule>> rules_;
+  std::vector<Rule> empty_vector_;
+};
 
 class FoldingRules {
  public:
   FoldingRules();
 
-  const std::vector<FoldingRule>& GetRulesForOpcode(SpvOp opcode) {
-    auto it = rules_.find(opcode);
-    if (it != rules_.end()) {
-      return it->second;
-    }
-    return empty_vector_;
+  // Returns the folding rules for |opcode|.
+  const std::vector<FoldingRule>& GetRulesForOpcode(SpvOp opcode) const {
+    return rules_.Get(opcode);
   }
 
  private:
-  std::unordered_map<uint32_t, std::vector<FoldingRule>> rules_;
-  std::vector<FoldingRule> empty_vector_;
+  OpcodeRuleTable<FoldingRule> rules_;
 };
 
 }  // namespace opt
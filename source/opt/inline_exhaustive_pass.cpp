@@ -16,15 +16,25 @@
 
 #include "inline_exhaustive_pass.h"
 
+#include "log.h"
+
 namespace spvtools {
 namespace opt {
 
+namespace {
+
+const uint32_t kFunctionCallFunctionIdInIdx = 0;
+
+}  // anonymous namespace
+
+const uint32_t InlineExhaustivePass::kNoBudget;
+
 bool InlineExhaustivePass::InlineExhaustive(ir::Function* func) {
   bool modified = false;
   // Using block iterators here because of block erasures and insertions.
   for (auto bi = func->begin(); bi != func->end(); ++bi) {
     for (auto ii = bi->begin(); ii != bi->end();) {
-      if (IsInlinableFunctionCall(&*ii)) {
+      if (IsInlinableFunctionCall(&*ii) && IsWithinBudget(&*ii)) {
         // Inline call.
         std::vector<std::unique_ptr<ir::BasicBlock>> newBlocks;
         std::vector<std::unique_ptr<ir::Instruction>> newVars;
@@ -56,23 +66,56 @@ bool InlineExhaustivePass::InlineExhaustive(ir::Function* func) {
       }
     }
   }
+  // The result ids of |func| changed, if it is inlined later on.
+  if (modified) callee_result_ids_.erase(func->result_id());
   return modified;
 }
 
+bool InlineExhaustivePass::IsWithinBudget(const ir::Instruction* inst) {
+  if (budget_ == kNoBudget) return true;
+  if (over_budget_calls_.count(inst->result_id())) return false;
+  const uint32_t calleeId =
+      inst->GetSingleWordInOperand(kFunctionCallFunctionIdInIdx);
+  // The call instruction itself goes away.
+  const uint32_t growth = GetFunctionSize(id2function_[calleeId]) - 1;
+  if (!HasOpaqueArgsOrReturn(inst)) {
+    const uint32_t cost = GetInlinedSize(calleeId) - 1;
+    if (cost > remaining_budget_) {
+      over_budget_calls_.insert(inst->result_id());
+      return false;
+    }
+  }
+  remaining_budget_ -= std::min(growth, remaining_budget_);
+  return true;
+}
+
 void InlineExhaustivePass::Initialize(ir::IRContext* c) {
   InitializeInline(c);
+  remaining_budget_ = budget_;
+  over_budget_calls_.clear();
 };
 
 Pass::Status InlineExhaustivePass::ProcessImpl() {
   // Attempt exhaustive inlining on each entry point function in module
-  ProcessFunction pfn = [this](ir::Function* fp) {
-    return InlineExhaustive(fp);
-  };
+  ProcessFunction pfn = FilterFunctions(
+      [this](ir::Function* fp) { return InlineExhaustive(fp); });
   bool modified = ProcessEntryPointCallTree(pfn, get_module());
+  if (budget_ != kNoBudget) {
+    inline_stats_.calls_over_budget =
+        static_cast<uint32_t>(over_budget_calls_.size());
+    Logf(consumer(), SPV_MSG_INFO, nullptr, {0, 0, 0},
+         "%s: inlined %u calls, %llu instructions; %u calls over budget",
+         name(), inline_stats_.calls_inlined,
+         static_cast<unsigned long long>(inline_stats_.instructions_inlined),
+         inline_stats_.calls_over_budget);
+  }
   return modified ? Status::SuccessWithChange : Status::SuccessWithoutChange;
 }
 
-InlineExhaustivePass::InlineExhaustivePass() {}
+InlineExhaustivePass::InlineExhaustivePass() : budget_(kNoBudget) {}
+
+InlineExhaustivePass::InlineExhaustivePass(uint32_t budget)
+    : budget_(budget) {}
 
 Pass::Status InlineExhaustivePass::Process(ir::IRContext* c) {
   Initialize(c);
@@ -21,6 +21,7 @@
 #include <list>
 #include <memory>
 #include <unordered_map>
+#include <unordered_set>
 #include <vector>
 
 #include "def_use_manager.h"
@@ -33,7 +34,11 @@ namespace opt {
 // See optimizer.hpp for documentation.
 class InlineExhaustivePass : public InlinePass {
  public:
+  // The budget of a pass that inlines every call it can.
+  static const uint32_t kNoBudget = UINT32_MAX;
+
   InlineExhaustivePass();
+  explicit InlineExhaustivePass(uint32_t budget);
   Status Process(ir::IRContext* c) override;
 
   const char* name() const override { return "inline-entry-points-exhaustive"; }
@@ -43,8 +48,25 @@ class InlineExhaustivePass : public InlinePass {
   // all code that is inlined into func. Return true if func is modified.
   bool InlineExhaustive(ir::Function* func);
 
+  // Returns true if the inlinable call |inst| fits in what is left of the
+  // budget, and takes the growth of its caller out of the budget if it does.
+  // The cost of a call is the number of instructions it adds once the calls
+  // in the callee are inlined as well, so that a call is only inlined if the
+  // whole call tree below it fits.  Calls with opaque arguments or return type
+  // are always inlined, since the module cannot be legal without that.
+  bool IsWithinBudget(const ir::Instruction* inst);
+
   void Initialize(ir::IRContext* c);
   Pass::Status ProcessImpl();
+
+  // The number of instructions the pass may add to the module, or kNoBudget.
+  const uint32_t budget_;
+
+  // The number of instructions the pass may still add to the module.
+  uint32_t remaining_budget_;
+
+  // The result ids of the calls that were found not to fit in the budget.
+  std::unordered_set<uint32_t> over_budget_calls_;
 };
 
 }  // namespace opt
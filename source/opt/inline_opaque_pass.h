@@ -39,12 +39,6 @@ class InlineOpaquePass : public InlinePass {
   const char* name() const override { return "inline-entry-points-opaque"; }
 
  private:
-  // Return true if |typeId| is or contains opaque type
-  bool IsOpaqueType(uint32_t typeId);
-
-  // Return true if function call |callInst| has opaque argument or return type
-  bool HasOpaqueArgsOrReturn(const ir::Instruction* callInst);
-
   // Inline all function calls in |func| that have opaque params or return
   // type. Inline similarly all code that is inlined into func. Return true
   // if func is modified.
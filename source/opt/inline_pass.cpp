@@ -25,6 +25,7 @@ static const int kSpvFunctionCallArgumentId = 3;
 static const int kSpvReturnValueId = 0;
 static const int kSpvLoopMergeMergeBlockId = 0;
 static const int kSpvLoopMergeContinueTargetIdInIdx = 1;
+static const int kSpvTypePointerTypeIdInIdx = 1;
 
 namespace spvtools {
 namespace opt {
@@ -210,17 +211,22 @@ void InlinePass::GenInlineCode(
     std::vector<std::unique_ptr<ir::Instruction>>* new_vars,
     ir::BasicBlock::iterator call_inst_itr,
     ir::UptrVectorIterator<ir::BasicBlock> call_block_itr) {
+  ir::Function* calleeFn = id2function_[call_inst_itr->GetSingleWordOperand(
+      kSpvFunctionCallFunctionId)];
+
+  // Set of callee result ids. Used to detect forward references
+  const std::unordered_set<uint32_t>& callee_result_ids =
+      GetCalleeResultIds(calleeFn);
+
   // Map from all ids in the callee to their equivalent id in the caller
   // as callee instructions are copied into caller.
   std::unordered_map<uint32_t, uint32_t> callee2caller;
+  callee2caller.reserve(callee_result_ids.size());
   // Pre-call same-block insts
   std::unordered_map<uint32_t, ir::Instruction*> preCallSB;
   // Post-call same-block op ids
   std::unordered_map<uint32_t, uint32_t> postCallSB;
 
-  ir::Function* calleeFn = id2function_[call_inst_itr->GetSingleWordOperand(
-      kSpvFunctionCallFunctionId)];
-
   // Check for multiple returns in the callee.
   auto fi = multi_return_funcs_.find(calleeFn->result_id());
   const bool multiReturn = fi != multi_return_funcs_.end();
@@ -235,12 +241,8 @@ void InlinePass::GenInlineCode(
   // Create return var if needed.
   uint32_t returnVarId = CreateReturnVar(calleeFn, new_vars);
 
-  // Create set of callee result ids. Used to detect forward references
-  std::unordered_set<uint32_t> callee_result_ids;
-  calleeFn->ForEachInst([&callee_result_ids](const ir::Instruction* cpi) {
-    const uint32_t rid = cpi->result_id();
-    if (rid != 0) callee_result_ids.insert(rid);
-  });
+  // Number of callee instructions copied into the caller.
+  uint64_t numInlinedInsts = new_vars->size();
 
   // If the caller is in a single-block loop, and the callee has multiple
   // blocks, then the normal inlining logic will place the OpLoopMerge in
@@ -279,7 +281,8 @@ void InlinePass::GenInlineCode(
                          callee_begins_with_structured_header, &calleeTypeId,
                          &multiBlocks, &postCallSB, &preCallSB, multiReturn,
                          &singleTripLoopHeaderId, &singleTripLoopContinueId,
-                         &callee_result_ids, this](const ir::Instruction* cpi) {
+                         &callee_result_ids, &numInlinedInsts,
+                         this](const ir::Instruction* cpi) {
     switch (cpi->opcode()) {
       case SpvOpFunction:
       case SpvOpFunctionParameter:
@@ -478,6 +481,7 @@ void InlinePass::GenInlineCode(
           get_decoration_mgr()->CloneDecorations(rid, nid, update_def_use_mgr_);
         }
         new_blk_ptr->AddInstruction(std::move(cp_inst));
+        ++numInlinedInsts;
       } break;
     }
   });
@@ -509,6 +513,9 @@ void InlinePass::GenInlineCode(
   for (auto& blk : *new_blocks) {
     id2block_[blk->id()] = &*blk;
   }
+
+  ++inline_stats_.calls_inlined;
+  inline_stats_.instructions_inlined += numInlinedInsts;
 }
 
 bool InlinePass::IsInlinableFunctionCall(const ir::Instruction* inst) {
@@ -519,6 +526,86 @@ bool InlinePass::IsInlinableFunctionCall(const ir::Instruction* inst) {
   return ci != inlinable_.cend();
 }
 
+bool InlinePass::IsOpaqueType(uint32_t typeId) {
+  const ir::Instruction* typeInst = get_def_use_mgr()->GetDef(typeId);
+  switch (typeInst->opcode()) {
+    case SpvOpTypeSampler:
+    case SpvOpTypeImage:
+    case SpvOpTypeSampledImage:
+      return true;
+    case SpvOpTypePointer:
+      return IsOpaqueType(
+          typeInst->GetSingleWordInOperand(kSpvTypePointerTypeIdInIdx));
+    default:
+      break;
+  }
+  // TODO(greg-lunarg): Handle arrays containing opaque type
+  if (typeInst->opcode() != SpvOpTypeStruct) return false;
+  // Return true if any member is opaque
+  return !typeInst->WhileEachInId([this](const uint32_t* tid) {
+    if (IsOpaqueType(*tid)) return false;
+    return true;
+  });
+}
+
+bool InlinePass::HasOpaqueArgsOrReturn(const ir::Instruction* callInst) {
+  // Check return type
+  if (IsOpaqueType(callInst->type_id())) return true;
+  // Check args
+  int icnt = 0;
+  return !callInst->WhileEachInId([&icnt, this](const uint32_t* iid) {
+    if (icnt > 0) {
+      const ir::Instruction* argInst = get_def_use_mgr()->GetDef(*iid);
+      if (IsOpaqueType(argInst->type_id())) return false;
+    }
+    ++icnt;
+    return true;
+  });
+}
+
+uint32_t InlinePass::GetInlinedSize(uint32_t func_id) {
+  const auto sizeItr = inlined_size_.find(func_id);
+  if (sizeItr != inlined_size_.end()) return sizeItr->second;
+  // Callees are sized before their callers.  Mark the function while its
+  // callees are visited, so that a recursive call is too large to inline.
+  inlined_size_[func_id] = UINT32_MAX;
+  uint64_t size = 0;
+  for (auto& blk : *id2function_[func_id]) {
+    for (auto& inst : blk) {
+      if (IsInlinableFunctionCall(&inst)) {
+        size += GetInlinedSize(
+            inst.GetSingleWordOperand(kSpvFunctionCallFunctionId));
+      } else {
+        ++size;
+      }
+    }
+  }
+  const uint32_t inlinedSize =
+      size < UINT32_MAX ? static_cast<uint32_t>(size) : UINT32_MAX;
+  inlined_size_[func_id] = inlinedSize;
+  return inlinedSize;
+}
+
+uint32_t InlinePass::GetFunctionSize(const ir::Function* func) const {
+  uint32_t size = 0;
+  for (const auto& blk : *func) {
+    for (auto ii = blk.cbegin(); ii != blk.cend(); ++ii) ++size;
+  }
+  return size;
+}
+
+const std::unordered_set<uint32_t>& InlinePass::GetCalleeResultIds(
+    ir::Function* func) {
+  const auto idsItr = callee_result_ids_.find(func->result_id());
+  if (idsItr != callee_result_ids_.end()) return idsItr->second;
+  std::unordered_set<uint32_t>& ids = callee_result_ids_[func->result_id()];
+  func->ForEachInst([&ids](const ir::Instruction* cpi) {
+    const uint32_t rid = cpi->result_id();
+    if (rid != 0) ids.insert(rid);
+  });
+  return ids;
+}
+
 void InlinePass::UpdateSucceedingPhis(
     std::vector<std::unique_ptr<ir::BasicBlock>>& new_blocks) {
   const auto firstBlk = new_blocks.begin();
@@ -658,6 +745,9 @@ void InlinePass::InitializeInline(ir::IRContext* c) {
   inlinable_.clear();
   no_return_in_loop_.clear();
   multi_return_funcs_.clear();
+  callee_result_ids_.clear();
+  inlined_size_.clear();
+  inline_stats_ = InlineStats();
 
   for (auto& fn : *get_module()) {
     // Initialize function and block maps.
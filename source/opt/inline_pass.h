@@ -18,9 +18,11 @@
 #define LIBSPIRV_OPT_INLINE_PASS_H_
 
 #include <algorithm>
+#include <cstdint>
 #include <list>
 #include <memory>
 #include <unordered_map>
+#include <unordered_set>
 #include <vector>
 
 #include "decoration_manager.h"
@@ -39,9 +41,24 @@ class InlinePass : public Pass {
   using GetBlocksFunction =
       std::function<std::vector<ir::BasicBlock*>*(const ir::BasicBlock*)>;
 
+  // Statistics on the calls inlined by a run of the pass.
+  struct InlineStats {
+    // The number of calls that were inlined.
+    uint32_t calls_inlined = 0;
+    // The number of instructions that were copied from the callees into their
+    // callers.
+    uint64_t instructions_inlined = 0;
+    // The number of calls that were left in place because inlining them would
+    // exceed the budget of the pass.
+    uint32_t calls_over_budget = 0;
+  };
+
   InlinePass();
   virtual ~InlinePass() = default;
 
+  // Returns the statistics of the last run of the pass.
+  const InlineStats& inline_stats() const { return inline_stats_; }
+
  protected:
 
   // Add pointer to type to module and return resultId.
@@ -125,6 +142,28 @@ class InlinePass : public Pass {
   // Return true if |inst| is a function call that can be inlined.
   bool IsInlinableFunctionCall(const ir::Instruction* inst);
 
+  // Return true if |typeId| is or contains opaque type
+  bool IsOpaqueType(uint32_t typeId);
+
+  // Return true if function call |callInst| has opaque argument or return type
+  bool HasOpaqueArgsOrReturn(const ir::Instruction* callInst);
+
+  // Returns the number of instructions in the blocks of the function with id
+  // |func_id| once every inlinable call in it, and in the code inlined into
+  // it, has been inlined.  The sizes are computed bottom-up over the call
+  // graph the first time they are needed, and are not updated afterwards.
+  // Returns UINT32_MAX if the function is part of a recursion, or if the size
+  // does not fit.
+  uint32_t GetInlinedSize(uint32_t func_id);
+
+  // Returns the number of instructions in the blocks of |func|.
+  uint32_t GetFunctionSize(const ir::Function* func) const;
+
+  // Returns the result ids defined in |func|.  They are cached until calls are
+  // inlined into |func|, so that they are computed once for all the call
+  // sites of a callee.
+  const std::unordered_set<uint32_t>& GetCalleeResultIds(ir::Function* func);
+
   // Compute structured successors for function |func|.
   // A block's structured successors are the blocks it branches to
   // together with its declared merge block if it has one.
@@ -178,6 +217,18 @@ class InlinePass : public Pass {
   // Set of ids of inlinable functions
   std::set<uint32_t> inlinable_;
 
+  // Map from function's result id to the result ids defined in the function.
+  // See GetCalleeResultIds().
+  std::unordered_map<uint32_t, std::unordered_set<uint32_t>>
+      callee_result_ids_;
+
+  // Map from function's result id to its size once everything is inlined into
+  // it.  See GetInlinedSize().
+  std::unordered_map<uint32_t, uint32_t> inlined_size_;
+
+  // Statistics on the calls inlined so far.
+  InlineStats inline_stats_;
+
   // result id for OpConstantFalse
   uint32_t false_id_;
 
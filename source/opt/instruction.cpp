@@ -58,9 +58,10 @@ Instruction::Instruction(IRContext* c, const spv_parsed_instruction_t& inst,
       dbg_line_insts_(std::move(dbg_line)) {
   assert((!IsDebugLineInst(opcode_) || dbg_line.empty()) &&
          "Op(No)Line attaching to Op(No)Line found");
+  operands_.reserve(inst.num_operands);
   for (uint32_t i = 0; i < inst.num_operands; ++i) {
     const auto& current_payload = inst.operands[i];
-    std::vector<uint32_t> words(
+    OperandData words(
         inst.words + current_payload.offset,
         inst.words + current_payload.offset + current_payload.num_words);
     operands_.emplace_back(current_payload.type, std::move(words));
@@ -142,7 +143,6 @@ void Instruction::ToBinaryWithoutAttachedDebugInsts(
 void Instruction::ReplaceOperands(const std::vector<Operand>& new_operands) {
   operands_.clear();
   operands_.insert(operands_.begin(), new_operands.begin(), new_operands.end());
-  operands_.shrink_to_fit();
 }
 
 bool Instruction::IsReadOnlyLoad() const {
@@ -23,6 +23,7 @@
 #include "opcode.h"
 #include "operand.h"
 #include "util/ilist_node.h"
+#include "util/small_vector.h"
 
 #include "latest_version_spirv_header.h"
 #include "reflect.h"
@@ -64,17 +65,21 @@ class InstructionList;
 // "%inop1" and "%inop2" are in operands, while "%rtype" and "%rid" are out
 // operands.
 
+// The words of a logical operand. Almost all operands are a single word, and
+// only literal strings and wide numbers are longer, so a couple of words are
+// stored inline with the operand instead of on the heap.
+using OperandData = utils::SmallVector<uint32_t, 2>;
+
 // A *logical* operand to a SPIR-V instruction. It can be the type id, result
 // id, or other additional operands carried in an instruction.
 struct Operand {
-  Operand(spv_operand_type_t t, std::vector<uint32_t>&& w)
+  Operand(spv_operand_type_t t, OperandData&& w)
       : type(t), words(std::move(w)) {}
 
-  Operand(spv_operand_type_t t, const std::vector<uint32_t>& w)
-      : type(t), words(w) {}
+  Operand(spv_operand_type_t t, const OperandData& w) : type(t), words(w) {}
 
-  spv_operand_type_t type;      // Type of this logical operand.
-  std::vector<uint32_t> words;  // Binary segments of this logical operand.
+  spv_operand_type_t type;  // Type of this logical operand.
+  OperandData words;        // Binary segments of this logical operand.
 
   friend bool operator==(const Operand& o1, const Operand& o2) {
     return o1.type == o2.type && o1.words == o2.words;
@@ -95,8 +100,11 @@ inline bool operator!=(const Operand& o1, const Operand& o2) {
 // needs to change, the user should create a new instruction instead.
 class Instruction : public utils::IntrusiveNodeBase<Instruction> {
  public:
-  using iterator = std::vector<Operand>::iterator;
-  using const_iterator = std::vector<Operand>::const_iterator;
+  // The logical operands of an instruction. Most instructions have few
+  // operands, so they are stored inline with the instruction.
+  using OperandList = utils::SmallVector<Operand, 4>;
+  using iterator = OperandList::iterator;
+  using const_iterator = OperandList::const_iterator;
 
   // Creates a default OpNop instruction.
   // This exists solely for containers that can't do without. Should be removed.
@@ -196,11 +204,11 @@ class Instruction : public utils::IntrusiveNodeBase<Instruction> {
   // words.
   uint32_t GetSingleWordOperand(uint32_t index) const;
   // Sets the |index|-th in-operand's data to the given |data|.
-  inline void SetInOperand(uint32_t index, std::vector<uint32_t>&& data);
+  inline void SetInOperand(uint32_t index, OperandData&& data);
   // Sets the |index|-th operand's data to the given |data|.
   // This is for in-operands modification only, but with |index| expressed in
   // terms of operand index rather than in-operand index.
-  inline void SetOperand(uint32_t index, std::vector<uint32_t>&& data);
+  inline void SetOperand(uint32_t index, OperandData&& data);
   // Replace all of the in operands with those in |new_operands|.
   inline void SetInOperands(std::vector<Operand>&& new_operands);
   // Sets the result type id.
@@ -429,7 +437,7 @@ class Instruction : public utils::IntrusiveNodeBase<Instruction> {
   uint32_t result_id_;  // Result id. A value of 0 means no result id.
   uint32_t unique_id_;  // Unique instruction id
   // All logical operands, including result type id and result id.
-  std::vector<Operand> operands_;
+  OperandList operands_;
   // Opline and OpNoLine instructions preceding this instruction. Note that for
   // Instructions representing OpLine or OpNonLine itself, this field should be
   // empty.
@@ -467,13 +475,11 @@ inline void Instruction::AddOperand(Operand&& operand) {
   operands_.push_back(std::move(operand));
 }
 
-inline void Instruction::SetInOperand(uint32_t index,
-                                      std::vector<uint32_t>&& data) {
+inline void Instruction::SetInOperand(uint32_t index, OperandData&& data) {
   SetOperand(index + TypeResultIdCount(), std::move(data));
 }
 
-inline void Instruction::SetOperand(uint32_t index,
-                                    std::vector<uint32_t>&& data) {
+inline void Instruction::SetOperand(uint32_t index, OperandData&& data) {
   assert(index < operands_.size() && "operand index out of bound");
   assert(index >= TypeResultIdCount() && "operand is not a in-operand");
   operands_[index].words = std::move(data);
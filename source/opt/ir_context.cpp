@@ -68,6 +68,9 @@ void IRContext::InvalidateAnalyses(IRContext::Analysis analyses_to_invalidate) {
   }
   if (analyses_to_invalidate & kAnalysisCFG) {
     cfg_.reset(nullptr);
+    // The roots of the dominator trees are the pseudo blocks of the CFG.
+    analyses_to_invalidate = static_cast<IRContext::Analysis>(
+        analyses_to_invalidate | kAnalysisDominatorAnalysis);
   }
   if (analyses_to_invalidate & kAnalysisDominatorAnalysis) {
     dominator_trees_.clear();
@@ -77,9 +80,33 @@ void IRContext::InvalidateAnalyses(IRContext::Analysis analyses_to_invalidate) {
     id_to_name_.reset(nullptr);
   }
 
+  for (uint32_t i = 0; i < kNumAnalyses; ++i) {
+    if (valid_analyses_ & analyses_to_invalidate & (1u << i))
+      ++analysis_counts_.invalidated[i];
+  }
   valid_analyses_ = Analysis(valid_analyses_ & ~analyses_to_invalidate);
 }
 
+void IRContext::MarkAnalysesValid(IRContext::Analysis set) {
+  CountAnalysesBuilt(set);
+  valid_analyses_ = valid_analyses_ | set;
+}
+
+void IRContext::CountAnalysesBuilt(IRContext::Analysis set) {
+  for (uint32_t i = 0; i < kNumAnalyses; ++i) {
+    if (set & (1u << i)) ++analysis_counts_.built[i];
+  }
+}
+
+const char* IRContext::GetAnalysisName(uint32_t index) {
+  static_assert(kAnalysisEnd == 1 << kNumAnalyses,
+                "kNumAnalyses does not match the Analysis enum");
+  static const char* const kNames[kNumAnalyses] = {
+      "DefUse", "InstrToBlockMapping", "Decorations", "Combinators",
+      "CFG",    "DominatorAnalysis",   "LoopAnalysis", "NameMap"};
+  return index < kNumAnalyses ? kNames[index] : "";
+}
+
 Instruction* IRContext::KillInst(ir::Instruction* inst) {
   if (!inst) {
     return nullptr;
@@ -518,7 +545,7 @@ void IRContext::InitializeCombinators() {
     AddCombinatorsForExtension(&extension);
   }
 
-  valid_analyses_ |= kAnalysisCombinators;
+  MarkAnalysesValid(kAnalysisCombinators);
 }
 
 void IRContext::RemoveFromIdToName(const Instruction* inst) {
@@ -542,6 +569,7 @@ ir::LoopDescriptor* IRContext::GetLoopDescriptor(const ir::Function* f) {
   std::unordered_map<const ir::Function*, ir::LoopDescriptor>::iterator it =
       loop_descriptors_.find(f);
   if (it == loop_descriptors_.end()) {
+    CountAnalysesBuilt(kAnalysisLoopAnalysis);
     return &loop_descriptors_.emplace(std::make_pair(f, ir::LoopDescriptor(f)))
                 .first->second;
   }
@@ -557,12 +585,25 @@ opt::DominatorAnalysis* IRContext::GetDominatorAnalysis(const ir::Function* f,
   }
 
   if (dominator_trees_.find(f) == dominator_trees_.end()) {
+    CountAnalysesBuilt(kAnalysisDominatorAnalysis);
     dominator_trees_[f].InitializeTree(f, in_cfg);
   }
 
   return &dominator_trees_[f];
 }
 
+void IRContext::ForEachDominatorTree(
+    const ir::Function* f,
+    const std::function<void(opt::DominatorTree*)>& func) {
+  if (!AreAnalysesValid(kAnalysisDominatorAnalysis)) return;
+  auto dom = dominator_trees_.find(f);
+  if (dom != dominator_trees_.end()) func(&dom->second.GetDomTree());
+  auto post_dom = post_dominator_trees_.find(f);
+  if (post_dom != post_dominator_trees_.end()) {
+    func(&post_dom->second.GetDomTree());
+  }
+}
+
 // Gets the postdominator analysis for function |f|.
 opt::PostDominatorAnalysis* IRContext::GetPostDominatorAnalysis(
     const ir::Function* f, const ir::CFG& in_cfg) {
@@ -571,6 +612,7 @@ opt::PostDominatorAnalysis* IRContext::GetPostDominatorAnalysis(
   }
 
   if (post_dominator_trees_.find(f) == post_dominator_trees_.end()) {
+    CountAnalysesBuilt(kAnalysisDominatorAnalysis);
     post_dominator_trees_[f].InitializeTree(f, in_cfg);
   }
 
@@ -61,6 +61,20 @@ class IRContext {
     kAnalysisEnd = 1 << 8
   };
 
+  // The number of analyses in |Analysis|.
+  static const uint32_t kNumAnalyses = 8;
+
+  // How often each analysis was built and invalidated over the lifetime of
+  // the context.  Both arrays are indexed by the bit position of the analysis
+  // in |Analysis|.
+  struct AnalysisCounts {
+    uint32_t built[kNumAnalyses];
+    uint32_t invalidated[kNumAnalyses];
+  };
+
+  // Returns the name of the analysis at bit position |index| in |Analysis|.
+  static const char* GetAnalysisName(uint32_t index);
+
   friend inline Analysis operator|(Analysis lhs, Analysis rhs);
   friend inline Analysis& operator|=(Analysis& lhs, Analysis rhs);
   friend inline Analysis operator<<(Analysis a, int shift);
@@ -75,9 +89,12 @@ class IRContext {
         consumer_(std::move(c)),
         def_use_mgr_(nullptr),
         valid_analyses_(kAnalysisNone),
+        analysis_counts_(),
         constant_mgr_(nullptr),
         type_mgr_(nullptr),
-        id_to_name_(nullptr) {
+        id_to_name_(nullptr),
+        thread_count_(1),
+        has_all_functions_(true) {
     libspirv::SetContextMessageConsumer(syntax_context_, consumer_);
     module_->SetContext(this);
   }
@@ -91,8 +108,11 @@ class IRContext {
         consumer_(std::move(c)),
         def_use_mgr_(nullptr),
         valid_analyses_(kAnalysisNone),
+        analysis_counts_(),
         type_mgr_(nullptr),
-        id_to_name_(nullptr) {
+        id_to_name_(nullptr),
+        thread_count_(1),
+        has_all_functions_(true) {
     libspirv::SetContextMessageConsumer(syntax_context_, consumer_);
     module_->SetContext(this);
     InitializeCombinators();
@@ -276,6 +296,36 @@ class IRContext {
   // Returns the reference to the message consumer for this pass.
   const spvtools::MessageConsumer& consumer() const { return consumer_; }
 
+  // Returns the target environment of this context.
+  spv_target_env target_env() const { return syntax_context_->target_env; }
+
+  // Sets the number of threads, including the calling thread, that
+  // function-local passes may use to process the functions of the module.  A
+  // value of 0 or 1, the default, processes them on the calling thread.  See
+  // Pass::ProcessFunctionLocalPass().
+  void SetThreadCount(uint32_t count) { thread_count_ = count ? count : 1; }
+
+  // Returns the number of threads set with SetThreadCount().
+  uint32_t thread_count() const { return thread_count_; }
+
+  // Sets whether the module has every function of the module being
+  // optimized.  It does not when it is one of the copies that function-local
+  // passes process in parallel, see Pass::ProcessFunctionLocalPass().  The
+  // def-use manager of such a copy only has the uses of global values that
+  // are in the functions of the copy.
+  void SetHasAllFunctions(bool has_all) { has_all_functions_ = has_all; }
+
+  // Returns true if the module has every function, see SetHasAllFunctions().
+  bool has_all_functions() const { return has_all_functions_; }
+
+  // Drops the type and constant managers, so that they are built again from
+  // the module when they are next used.  This is needed after types or
+  // constants are added to the module without going through the managers.
+  void ResetTypeAndConstantManagers() {
+    constant_mgr_.reset();
+    type_mgr_.reset();
+  }
+
   // Rebuilds the analyses in |set| that are invalid.
   void BuildInvalidAnalyses(Analysis set);
 
@@ -311,6 +361,9 @@ class IRContext {
   // Returns true if all of the given analyses are valid.
   bool AreAnalysesValid(Analysis set) { return (set & valid_analyses_) == set; }
 
+  // Returns how often each analysis has been built and invalidated.
+  const AnalysisCounts& analysis_counts() const { return analysis_counts_; }
+
   // Replaces all uses of |before| id with |after| id. Returns true if any
   // replacement happens. This method does not kill the definition of the
   // |before| id. If |after| is the same as |before|, does nothing and returns
@@ -397,6 +450,12 @@ class IRContext {
     post_dominator_trees_.erase(f);
   }
 
+  // Applies |func| to the dominator and postdominator trees of |f| that are
+  // in the cache.  Passes use this to update the trees in place after they
+  // edit the CFG of |f|, so the trees can be preserved.
+  void ForEachDominatorTree(const ir::Function* f,
+                            const std::function<void(opt::DominatorTree*)>& func);
+
   // Return the next available SSA id and increment it.
   inline uint32_t TakeNextId() { return module()->TakeNextIdBound(); }
 
@@ -418,7 +477,7 @@ class IRContext {
   // Builds the def-use manager from scratch, even if it was already valid.
   void BuildDefUseManager() {
     def_use_mgr_.reset(new opt::analysis::DefUseManager(module()));
-    valid_analyses_ = valid_analyses_ | kAnalysisDefUse;
+    MarkAnalysesValid(kAnalysisDefUse);
   }
 
   // Builds the instruction-block map for the whole module.
@@ -431,17 +490,17 @@ class IRContext {
         });
       }
     }
-    valid_analyses_ = valid_analyses_ | kAnalysisInstrToBlockMapping;
+    MarkAnalysesValid(kAnalysisInstrToBlockMapping);
   }
 
   void BuildDecorationManager() {
     decoration_mgr_.reset(new opt::analysis::DecorationManager(module()));
-    valid_analyses_ = valid_analyses_ | kAnalysisDecorations;
+    MarkAnalysesValid(kAnalysisDecorations);
   }
 
   void BuildCFG() {
     cfg_.reset(new ir::CFG(module()));
-    valid_analyses_ = valid_analyses_ | kAnalysisCFG;
+    MarkAnalysesValid(kAnalysisCFG);
   }
 
   // Removes all computed dominator and post-dominator trees. This will force
@@ -450,6 +509,7 @@ class IRContext {
     // Clear the cache.
     dominator_trees_.clear();
     post_dominator_trees_.clear();
+    // The trees are built lazily, so this is not counted as a build.
     valid_analyses_ = valid_analyses_ | kAnalysisDominatorAnalysis;
   }
 
@@ -457,9 +517,16 @@ class IRContext {
   void ResetLoopAnalysis() {
     // Clear the cache.
     loop_descriptors_.clear();
+    // The descriptors are built lazily, so this is not counted as a build.
     valid_analyses_ = valid_analyses_ | kAnalysisLoopAnalysis;
   }
 
+  // Marks the analyses in |set| as valid, and counts them as built.
+  void MarkAnalysesValid(Analysis set);
+
+  // Counts the analyses in |set| as built without changing their validity.
+  void CountAnalysesBuilt(Analysis set);
+
   // Analyzes the features in the owned module. Builds the manager if required.
   void AnalyzeFeatures() {
     feature_mgr_.reset(new opt::FeatureManager(grammar_));
@@ -516,6 +583,9 @@ class IRContext {
   // A bitset indicating which analyes are currently valid.
   Analysis valid_analyses_;
 
+  // How often each analysis has been built and invalidated.
+  AnalysisCounts analysis_counts_;
+
   // Opcodes of shader capability core executable instructions
   // without side-effect.
   std::unordered_map<uint32_t, std::unordered_set<uint32_t>> combinator_ops_;
@@ -540,6 +610,12 @@ class IRContext {
 
   // A map from an id to its corresponding OpName and OpMemberName instructions.
   std::unique_ptr<std::multimap<uint32_t, Instruction*>> id_to_name_;
+
+  // The number of threads function-local passes may use.
+  uint32_t thread_count_;
+
+  // False if the module only has some of the functions being optimized.
+  bool has_all_functions_;
 };
 
 inline ir::IRContext::Analysis operator|(ir::IRContext::Analysis lhs,
@@ -763,7 +839,7 @@ void IRContext::BuildIdToNameMap() {
       id_to_name_->insert({debug_inst.GetSingleWordInOperand(0), &debug_inst});
     }
   }
-  valid_analyses_ = valid_analyses_ | kAnalysisNameMap;
+  MarkAnalysesValid(kAnalysisNameMap);
 }
 
 IteratorRange<std::multimap<uint32_t, Instruction*>::iterator>
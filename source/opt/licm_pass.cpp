@@ -16,7 +16,7 @@
 #include "opt/module.h"
 #include "opt/pass.h"
 
-#include <queue>
+#include <algorithm>
 #include <utility>
 
 namespace spvtools {
@@ -45,80 +45,162 @@ bool LICMPass::ProcessIRContext() {
 }
 
 bool LICMPass::ProcessFunction(ir::Function* f) {
-  bool modified = false;
   ir::LoopDescriptor* loop_descriptor = context()->GetLoopDescriptor(f);
+  if (loop_descriptor->NumLoops() == 0) return false;
+
+  AnalyseFunction(f, loop_descriptor);
 
-  // Process each loop in the function
+  // The loop descriptor visits the loops in post-order, so each nested loop
+  // is processed before its parent, which then sees what was hoisted from it.
+  bool modified = false;
   for (ir::Loop& loop : *loop_descriptor) {
-    // Ignore nested loops, as we will process them in order in ProcessLoop
-    if (loop.IsNested()) {
-      continue;
-    }
-    modified |= ProcessLoop(&loop, f);
+    modified |= ProcessLoop(&loop);
   }
+
+  def_loop_.clear();
+  loop_blocks_.clear();
+  always_executed_.clear();
+  created_preheaders_.clear();
   return modified;
 }
 
-bool LICMPass::ProcessLoop(ir::Loop* loop, ir::Function* f) {
-  bool modified = false;
-
-  // Process all nested loops first
-  for (ir::Loop* nested_loop : *loop) {
-    modified |= ProcessLoop(nested_loop, f);
+void LICMPass::AnalyseFunction(ir::Function* f,
+                               ir::LoopDescriptor* loop_descriptor) {
+  def_loop_.assign(get_module()->IdBound(), nullptr);
+  loop_blocks_.clear();
+  always_executed_.clear();
+  created_preheaders_.clear();
+
+  // Creating a preheader invalidates the dominator analysis, so this is the
+  // only time it is used.
+  opt::DominatorTree& dom_tree =
+      context()->GetDominatorAnalysis(f, *cfg())->GetDomTree();
+  for (opt::DominatorTreeNode& node : dom_tree) {
+    ir::BasicBlock* bb = node.bb_;
+    ir::Loop* loop = (*loop_descriptor)[bb];
+    if (loop == nullptr) continue;
+
+    loop_blocks_[loop].push_back(bb);
+    if (loop->GetHeaderBlock() == bb && loop->HasParent()) {
+      loop_blocks_[loop->GetParent()].push_back(bb);
+    }
+    bb->ForEachInst([this, loop](ir::Instruction* inst) {
+      if (inst->result_id() != 0) def_loop_[inst->result_id()] = loop;
+    });
   }
 
-  std::vector<ir::BasicBlock*> loop_bbs{};
-  modified |= AnalyseAndHoistFromBB(loop, f, loop->GetHeaderBlock(), &loop_bbs);
-
-  for (size_t i = 0; i < loop_bbs.size(); ++i) {
-    ir::BasicBlock* bb = loop_bbs[i];
-    // do not delete the element
-    modified |= AnalyseAndHoistFromBB(loop, f, bb, &loop_bbs);
+  // A block runs whenever its loop is entered if it dominates the latch and
+  // every block that leaves the loop.
+  for (auto& entry : loop_blocks_) {
+    ir::Loop* loop = entry.first;
+    std::vector<uint32_t> exits;
+    if (loop->GetLatchBlock()) exits.push_back(loop->GetLatchBlock()->id());
+    for (uint32_t id : loop->GetBlocks()) {
+      const ir::BasicBlock* block = cfg()->block(id);
+      block->ForEachSuccessorLabel([loop, id, &exits](const uint32_t succ) {
+        if (!loop->IsInsideLoop(succ)) exits.push_back(id);
+      });
+    }
+    std::unordered_set<uint32_t>& executed = always_executed_[loop];
+    for (ir::BasicBlock* bb : entry.second) {
+      const uint32_t bb_id = bb->id();
+      if (std::all_of(exits.begin(), exits.end(),
+                      [&dom_tree, bb_id](uint32_t exit) {
+                        return dom_tree.Dominates(bb_id, exit);
+                      })) {
+        executed.insert(bb_id);
+      }
+    }
   }
+}
 
+bool LICMPass::ProcessLoop(ir::Loop* loop) {
+  bool modified = false;
+  const std::unordered_set<uint32_t>& executed = always_executed_[loop];
+  for (ir::BasicBlock* bb : loop_blocks_[loop]) {
+    // A preheader created for a nested loop runs whenever the nested loop's
+    // header is entered from |loop|, so it takes the header's place here.
+    const bool always_executed = executed.count(bb->id()) != 0;
+    if (def_loop_[bb->id()] != loop) {
+      // |bb| is the header of a nested loop.  Only the preheader this pass
+      // created for it belongs to |loop|.
+      auto it = created_preheaders_.find(def_loop_[bb->id()]);
+      if (it == created_preheaders_.end()) continue;
+      bb = it->second;
+    }
+    modified |= HoistFromBlock(loop, bb, always_executed);
+  }
   return modified;
 }
 
-bool LICMPass::AnalyseAndHoistFromBB(ir::Loop* loop, ir::Function* f,
-                                     ir::BasicBlock* bb,
-                                     std::vector<ir::BasicBlock*>* loop_bbs) {
+bool LICMPass::HoistFromBlock(ir::Loop* loop, ir::BasicBlock* bb,
+                              bool always_executed) {
   bool modified = false;
-  std::function<void(ir::Instruction*)> hoist_inst =
-      [this, &loop, &modified](ir::Instruction* inst) {
-        if (loop->ShouldHoistInstruction(this->context(), inst)) {
-          HoistInstruction(loop, inst);
-          modified = true;
-        }
-      };
-
-  if (IsImmediatelyContainedInLoop(loop, f, bb)) {
-    bb->ForEachInst(hoist_inst, false);
+  for (auto it = bb->begin(); it != bb->end();) {
+    // Move on before |inst| is moved to another block.
+    ir::Instruction* inst = &*it;
+    ++it;
+    if (ShouldHoistInstruction(loop, inst, always_executed)) {
+      HoistInstruction(loop, inst);
+      modified = true;
+    }
   }
+  return modified;
+}
 
-  opt::DominatorAnalysis* dom_analysis =
-      context()->GetDominatorAnalysis(f, *cfg());
-  opt::DominatorTree& dom_tree = dom_analysis->GetDomTree();
-
-  for (opt::DominatorTreeNode* child_dom_tree_node :
-       *dom_tree.GetTreeNode(bb)) {
-    if (loop->IsInsideLoop(child_dom_tree_node->bb_)) {
-      loop_bbs->push_back(child_dom_tree_node->bb_);
-    }
+bool LICMPass::ShouldHoistInstruction(ir::Loop* loop, ir::Instruction* inst,
+                                      bool always_executed) const {
+  bool is_load = false;
+  switch (inst->opcode()) {
+    case SpvOpAccessChain:
+    case SpvOpInBoundsAccessChain:
+      // An access chain may be out of bounds where the code does not run.
+      if (!always_executed) return false;
+      break;
+    case SpvOpLoad:
+      if (!always_executed) return false;
+      if (inst->NumInOperands() > 1 &&
+          (inst->GetSingleWordInOperand(1) & SpvMemoryAccessVolatileMask)) {
+        return false;
+      }
+      is_load = true;
+      break;
+    default:
+      if (!inst->IsOpcodeCodeMotionSafe()) return false;
+      break;
   }
 
-  return modified;
+  const bool all_invariant = inst->WhileEachInId(
+      [this, loop](const uint32_t* id) { return IsInvariant(loop, *id); });
+  // Checking the storage of a load needs the def-use manager, so it is left
+  // for last.
+  return all_invariant && (!is_load || inst->IsReadOnlyLoad());
 }
 
-bool LICMPass::IsImmediatelyContainedInLoop(ir::Loop* loop, ir::Function* f,
-                                            ir::BasicBlock* bb) {
-  ir::LoopDescriptor* loop_descriptor = context()->GetLoopDescriptor(f);
-  return loop == (*loop_descriptor)[bb->id()];
+bool LICMPass::IsInvariant(ir::Loop* loop, uint32_t id) const {
+  if (id >= def_loop_.size()) return true;
+  for (ir::Loop* def_loop = def_loop_[id]; def_loop != nullptr;
+       def_loop = def_loop->GetParent()) {
+    if (def_loop == loop) return false;
+  }
+  return true;
 }
 
 void LICMPass::HoistInstruction(ir::Loop* loop, ir::Instruction* inst) {
-  ir::BasicBlock* pre_header_bb = loop->GetOrCreatePreHeaderBlock();
-  inst->InsertBefore(std::move(&(*pre_header_bb->tail())));
+  ir::BasicBlock* pre_header_bb = loop->GetPreHeaderBlock();
+  if (pre_header_bb == nullptr) {
+    pre_header_bb = loop->GetOrCreatePreHeaderBlock();
+    created_preheaders_[loop] = pre_header_bb;
+    def_loop_.resize(get_module()->IdBound(), nullptr);
+    pre_header_bb->ForEachInst([this, loop](ir::Instruction* new_inst) {
+      if (new_inst->result_id() != 0) {
+        def_loop_[new_inst->result_id()] = loop->GetParent();
+      }
+    });
+  }
+  inst->InsertBefore(&*pre_header_bb->tail());
   context()->set_instr_block(inst, pre_header_bb);
+  def_loop_[inst->result_id()] = loop->GetParent();
 }
 
 }  // namespace opt
@@ -20,7 +20,9 @@
 #include "opt/loop_descriptor.h"
 #include "opt/pass.h"
 
-#include <queue>
+#include <unordered_map>
+#include <unordered_set>
+#include <vector>
 
 namespace spvtools {
 namespace opt {
@@ -39,27 +41,59 @@ class LICMPass : public Pass {
   bool ProcessIRContext();
 
   // Checks the function for loops, calling ProcessLoop on each one found.
+  // Nested loops are processed before the loops that contain them.
   // Returns true if a change was made to the function, false otherwise.
   bool ProcessFunction(ir::Function* f);
 
-  // Checks for invariants in the loop and attempts to move them to the loops
-  // preheader. Works from inner loop to outer when nested loops are found.
+  // Fills |def_loop_| and |loop_blocks_| for the function |f|, whose loops
+  // are described by |loop_descriptor|.
+  void AnalyseFunction(ir::Function* f, ir::LoopDescriptor* loop_descriptor);
+
+  // Checks for invariants in the blocks immediately contained in |loop|, and
+  // in the preheaders this pass created for its nested loops, and moves them
+  // to the preheader of |loop|.
   // Returns true if a change was made to the loop, false otherwise.
-  bool ProcessLoop(ir::Loop* loop, ir::Function* f);
+  bool ProcessLoop(ir::Loop* loop);
+
+  // Hoists the invariants of |bb| to the preheader of |loop|.
+  // |always_executed| is true if |bb| runs whenever |loop| is entered.
+  // Returns true if a change was made to |bb|, false otherwise.
+  bool HoistFromBlock(ir::Loop* loop, ir::BasicBlock* bb,
+                      bool always_executed);
 
-  // Analyses each instruction in |bb|, hoisting invariants to |pre_header_bb|.
-  // Each child of |bb| wrt to |dom_tree| is pushed to |loop_bbs|
-  bool AnalyseAndHoistFromBB(ir::Loop* loop, ir::Function* f,
-                             ir::BasicBlock* bb,
-                             std::vector<ir::BasicBlock*>* loop_bbs);
+  // Returns true if |inst| can be moved out of |loop|: it has no side effect,
+  // and all its operands are defined outside of |loop|.  Loads from
+  // read-only storage, such as Uniform, PushConstant or NonWritable
+  // variables, and the access chains they load from, can be moved as well if
+  // |always_executed| is true.  Otherwise the block of |inst| may not run, and
+  // moving them would make an access that a branch guards unconditional.
+  bool ShouldHoistInstruction(ir::Loop* loop, ir::Instruction* inst,
+                              bool always_executed) const;
 
-  // Returns true if |bb| is immediately contained in |loop|
-  bool IsImmediatelyContainedInLoop(ir::Loop* loop, ir::Function* f,
-                                    ir::BasicBlock* bb);
+  // Returns true if |id| is defined outside of |loop|.
+  bool IsInvariant(ir::Loop* loop, uint32_t id) const;
 
-  // Move the instruction to the given BasicBlock
+  // Move the instruction to the preheader of |loop|, creating it if needed.
   // This method will update the instruction to block mapping for the context
   void HoistInstruction(ir::Loop* loop, ir::Instruction* inst);
+
+  // The innermost loop containing the definition of each id of the function
+  // being processed, or nullptr if it is not defined in a loop.  Ids are
+  // moved to the parent loop as they are hoisted, so this caches the
+  // invariance of every instruction for the whole loop nest.
+  std::vector<ir::Loop*> def_loop_;
+
+  // The blocks immediately contained in each loop, in dominator tree
+  // pre-order.  The header of each nested loop is listed in its parent as
+  // well, to mark the place of the preheader created for it, if any.
+  std::unordered_map<ir::Loop*, std::vector<ir::BasicBlock*>> loop_blocks_;
+
+  // The ids of the blocks in |loop_blocks_| that run whenever their loop is
+  // entered, for each loop.
+  std::unordered_map<ir::Loop*, std::unordered_set<uint32_t>> always_executed_;
+
+  // The preheaders created by this pass, which are not in |loop_blocks_|.
+  std::unordered_map<ir::Loop*, ir::BasicBlock*> created_preheaders_;
 };
 
 }  // namespace opt
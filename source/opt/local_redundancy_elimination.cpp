@@ -20,27 +20,33 @@ namespace spvtools {
 namespace opt {
 
 Pass::Status LocalRedundancyEliminationPass::Process(ir::IRContext* c) {
+  return ProcessFunctionLocalPass(c);
+}
+
+bool LocalRedundancyEliminationPass::InitializeFunctionLocal(
+    ir::IRContext* c) {
   InitializeProcessing(c);
+  vn_table_.reset(new ValueNumberTable(context()));
+  return true;
+}
 
+bool LocalRedundancyEliminationPass::ProcessFunctionLocal(ir::Function* func) {
   bool modified = false;
-  ValueNumberTable vnTable(context());
-
-  for (auto& func : *get_module()) {
-    for (auto& bb : func) {
-      // Keeps track of all ids that contain a given value number. We keep
-      // track of multiple values because they could have the same value, but
-      // different decorations.
-      std::map<uint32_t, uint32_t> value_to_ids;
-      if (EliminateRedundanciesInBB(&bb, vnTable, &value_to_ids))
-        modified = true;
-    }
+  // Keeps track of all ids that contain a given value number. We keep
+  // track of multiple values because they could have the same value, but
+  // different decorations.
+  std::unordered_map<uint32_t, uint32_t> value_to_ids;
+  for (auto& bb : *func) {
+    value_to_ids.clear();
+    if (EliminateRedundanciesInBB(&bb, *vn_table_, &value_to_ids))
+      modified = true;
   }
-  return (modified ? Status::SuccessWithChange : Status::SuccessWithoutChange);
+  return modified;
 }
 
 bool LocalRedundancyEliminationPass::EliminateRedundanciesInBB(
     ir::BasicBlock* block, const ValueNumberTable& vnTable,
-    std::map<uint32_t, uint32_t>* value_to_ids) {
+    std::unordered_map<uint32_t, uint32_t>* value_to_ids) {
   bool modified = false;
 
   auto func = [this, &vnTable, &modified, value_to_ids](ir::Instruction* inst) {
@@ -15,6 +15,9 @@
 #ifndef LIBSPIRV_OPT_LOCAL_REDUNDANCY_ELIMINATION_H_
 #define LIBSPIRV_OPT_LOCAL_REDUNDANCY_ELIMINATION_H_
 
+#include <memory>
+#include <unordered_map>
+
 #include "ir_context.h"
 #include "pass.h"
 #include "value_number_table.h"
@@ -54,9 +57,20 @@ class LocalRedundancyEliminationPass : public Pass {
   // dominates |bb|.
   //
   // Returns true if the module is changed.
-  bool EliminateRedundanciesInBB(ir::BasicBlock* block,
-                                 const ValueNumberTable& vnTable,
-                                 std::map<uint32_t, uint32_t>* value_to_ids);
+  bool EliminateRedundanciesInBB(
+      ir::BasicBlock* block, const ValueNumberTable& vnTable,
+      std::unordered_map<uint32_t, uint32_t>* value_to_ids);
+
+  // The pass is function-local, see Pass.  The value numbers are computed for
+  // the whole module before the functions are processed.
+  std::unique_ptr<Pass> CloneFunctionLocal() const override {
+    return std::unique_ptr<Pass>(new LocalRedundancyEliminationPass());
+  }
+  bool InitializeFunctionLocal(ir::IRContext* c) override;
+  bool ProcessFunctionLocal(ir::Function* func) override;
+
+  // The value number table of the module being processed.
+  std::unique_ptr<ValueNumberTable> vn_table_;
 };
 
 }  // namespace opt
@@ -186,31 +186,28 @@ bool LocalSingleBlockLoadStoreElimPass::AllExtensionsSupported() const {
   return true;
 }
 
-Pass::Status LocalSingleBlockLoadStoreElimPass::ProcessImpl() {
+bool LocalSingleBlockLoadStoreElimPass::InitializeFunctionLocal(
+    ir::IRContext* c) {
+  Initialize(c);
   // Assumes relaxed logical addressing only (see instruction.h).
   if (context()->get_feature_mgr()->HasCapability(SpvCapabilityAddresses))
-    return Status::SuccessWithoutChange;
+    return false;
   // Do not process if module contains OpGroupDecorate. Additional
   // support required in KillNamesAndDecorates().
   // TODO(greg-lunarg): Add support for OpGroupDecorate
   for (auto& ai : get_module()->annotations())
-    if (ai.opcode() == SpvOpGroupDecorate) return Status::SuccessWithoutChange;
+    if (ai.opcode() == SpvOpGroupDecorate) return false;
   // If any extensions in the module are not explicitly supported,
   // return unmodified.
-  if (!AllExtensionsSupported()) return Status::SuccessWithoutChange;
-  // Process all entry point functions
-  ProcessFunction pfn = [this](ir::Function* fp) {
-    return LocalSingleBlockLoadStoreElim(fp);
-  };
-  bool modified = ProcessEntryPointCallTree(pfn, get_module());
-  return modified ? Status::SuccessWithChange : Status::SuccessWithoutChange;
+  if (!AllExtensionsSupported()) return false;
+  return true;
 }
 
 LocalSingleBlockLoadStoreElimPass::LocalSingleBlockLoadStoreElimPass() {}
 
 Pass::Status LocalSingleBlockLoadStoreElimPass::Process(ir::IRContext* c) {
-  Initialize(c);
-  return ProcessImpl();
+  // Process all entry point functions
+  return ProcessFunctionLocalPass(c);
 }
 
 void LocalSingleBlockLoadStoreElimPass::InitExtensions() {
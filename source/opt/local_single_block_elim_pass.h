@@ -66,7 +66,19 @@ class LocalSingleBlockLoadStoreElimPass : public MemPass {
   bool AllExtensionsSupported() const;
 
   void Initialize(ir::IRContext* c);
-  Pass::Status ProcessImpl();
+
+  // The pass is function-local, see Pass.  It processes the functions in the
+  // call trees of the entry points.
+  std::unique_ptr<Pass> CloneFunctionLocal() const override {
+    return std::unique_ptr<Pass>(new LocalSingleBlockLoadStoreElimPass());
+  }
+  bool InitializeFunctionLocal(ir::IRContext* c) override;
+  std::vector<ir::Function*> GetFunctionsToProcess() override {
+    return GetEntryPointCallTree();
+  }
+  bool ProcessFunctionLocal(ir::Function* func) override {
+    return LocalSingleBlockLoadStoreElim(func);
+  }
 
   // Map from function scope variable to a store of that variable in the
   // current block whose value is currently valid. This map is cleared
@@ -74,35 +74,31 @@ bool LocalMultiStoreElimPass::AllExtensionsSupported() const {
   return true;
 }
 
-Pass::Status LocalMultiStoreElimPass::ProcessImpl() {
+bool LocalMultiStoreElimPass::InitializeFunctionLocal(ir::IRContext* c) {
+  Initialize(c);
   // Assumes all control flow structured.
   // TODO(greg-lunarg): Do SSA rewrite for non-structured control flow
   if (!context()->get_feature_mgr()->HasCapability(SpvCapabilityShader))
-    return Status::SuccessWithoutChange;
+    return false;
   // Assumes relaxed logical addressing only (see instruction.h)
   // TODO(greg-lunarg): Add support for physical addressing
   if (context()->get_feature_mgr()->HasCapability(SpvCapabilityAddresses))
-    return Status::SuccessWithoutChange;
+    return false;
   // Do not process if module contains OpGroupDecorate. Additional
   // support required in KillNamesAndDecorates().
   // TODO(greg-lunarg): Add support for OpGroupDecorate
   for (auto& ai : get_module()->annotations())
-    if (ai.opcode() == SpvOpGroupDecorate) return Status::SuccessWithoutChange;
+    if (ai.opcode() == SpvOpGroupDecorate) return false;
   // Do not process if any disallowed extensions are enabled
-  if (!AllExtensionsSupported()) return Status::SuccessWithoutChange;
-  // Process functions
-  ProcessFunction pfn = [this](ir::Function* fp) {
-    return EliminateMultiStoreLocal(fp);
-  };
-  bool modified = ProcessEntryPointCallTree(pfn, get_module());
-  return modified ? Status::SuccessWithChange : Status::SuccessWithoutChange;
+  if (!AllExtensionsSupported()) return false;
+  return true;
 }
 
 LocalMultiStoreElimPass::LocalMultiStoreElimPass() {}
 
 Pass::Status LocalMultiStoreElimPass::Process(ir::IRContext* c) {
-  Initialize(c);
-  return ProcessImpl();
+  // Process functions
+  return ProcessFunctionLocalPass(c);
 }
 
 void LocalMultiStoreElimPass::InitExtensions() {
@@ -64,7 +64,19 @@ class LocalMultiStoreElimPass : public MemPass {
   bool EliminateMultiStoreLocal(ir::Function* func);
 
   void Initialize(ir::IRContext* c);
-  Pass::Status ProcessImpl();
+
+  // The pass is function-local, see Pass.  It processes the functions in the
+  // call trees of the entry points.
+  std::unique_ptr<Pass> CloneFunctionLocal() const override {
+    return std::unique_ptr<Pass>(new LocalMultiStoreElimPass());
+  }
+  bool InitializeFunctionLocal(ir::IRContext* c) override;
+  std::vector<ir::Function*> GetFunctionsToProcess() override {
+    return GetEntryPointCallTree();
+  }
+  bool ProcessFunctionLocal(ir::Function* func) override {
+    return EliminateMultiStoreLocal(func);
+  }
 
   // Extensions supported by this pass.
   std::unordered_set<std::string> extensions_whitelist_;
@@ -255,6 +255,7 @@ void MemPass::InitSSARewrite(ir::Function* func) {
   type2undefs_.clear();
   supported_ref_vars_.clear();
   block_defs_map_.clear();
+  live_in_vars_.clear();
   phis_to_patch_.clear();
   dominator_ = context()->GetDominatorAnalysis(func, *cfg());
 
@@ -277,16 +278,72 @@ void MemPass::InitSSARewrite(ir::Function* func) {
       }
     }
   }
+
+  ComputeLiveInVars(func);
 }
 
-bool MemPass::IsLiveAfter(uint32_t var_id, uint32_t label) const {
-  // For now, return very conservative result: true. This will result in
-  // correct, but possibly usused, phi code to be generated. A subsequent
-  // DCE pass should eliminate this code.
-  // TODO(greg-lunarg): Return more accurate information
-  (void)var_id;
-  (void)label;
-  return true;
+void MemPass::ComputeLiveInVars(ir::Function* func) {
+  // Find the blocks in which each target variable is loaded before it is
+  // stored, and the blocks in which it is stored.  The variables are kept in
+  // increasing order, so the lists in |live_in_vars_| come out sorted.
+  std::map<uint32_t, std::vector<uint32_t>> upward_loads;
+  std::unordered_map<uint32_t, std::unordered_set<uint32_t>> store_blocks;
+  for (auto& blk : *func) {
+    const uint32_t label = blk.id();
+    for (auto& inst : blk) {
+      uint32_t varId = 0;
+      switch (inst.opcode()) {
+        case SpvOpStore:
+          (void)GetPtr(&inst, &varId);
+          if (IsTargetVar(varId)) store_blocks[varId].insert(label);
+          break;
+        case SpvOpVariable:
+          // Treat initialized OpVariable like an OpStore
+          if (inst.NumInOperands() < 2) break;
+          varId = inst.result_id();
+          if (IsTargetVar(varId)) store_blocks[varId].insert(label);
+          break;
+        case SpvOpLoad: {
+          (void)GetPtr(&inst, &varId);
+          if (!IsTargetVar(varId)) break;
+          const auto stores = store_blocks.find(varId);
+          if (stores != store_blocks.end() && stores->second.count(label))
+            break;
+          std::vector<uint32_t>& loads = upward_loads[varId];
+          if (loads.empty() || loads.back() != label) loads.push_back(label);
+        } break;
+        default:
+          break;
+      }
+    }
+  }
+
+  // Propagate liveness backwards from the loads, stopping at the blocks that
+  // store the variable.
+  for (const auto& var_loads : upward_loads) {
+    const uint32_t varId = var_loads.first;
+    const std::unordered_set<uint32_t>& stores = store_blocks[varId];
+    std::vector<uint32_t> worklist = var_loads.second;
+    std::unordered_set<uint32_t> live(worklist.begin(), worklist.end());
+    while (!worklist.empty()) {
+      const uint32_t label = worklist.back();
+      worklist.pop_back();
+      live_in_vars_[label].push_back(varId);
+      for (uint32_t predLabel : cfg()->preds(label)) {
+        if (stores.count(predLabel) || !live.insert(predLabel).second)
+          continue;
+        worklist.push_back(predLabel);
+      }
+    }
+  }
+}
+
+uint32_t MemPass::GetFirstPredValue(uint32_t var_id, uint32_t label) {
+  for (uint32_t predLabel : cfg()->preds(label)) {
+    const uint32_t current_value = GetCurrentValue(var_id, predLabel);
+    if (current_value != 0) return current_value;
+  }
+  return 0;
 }
 
 uint32_t MemPass::Type2Undef(uint32_t type_id) {
@@ -301,31 +358,16 @@ uint32_t MemPass::Type2Undef(uint32_t type_id) {
   return undefId;
 }
 
-void MemPass::CollectLiveVars(uint32_t block_label,
-                              std::map<uint32_t, uint32_t>* live_vars) {
-  // Walk up the dominator chain starting at |block_label| looking for variables
-  // defined at each block in the chain.  Since we are only interested for the
-  // most recent value for each live variable, we only add a <variable, value>
-  // pair to |live_vars| if this is the first time we find the variable in the
-  // chain.
-  for (ir::BasicBlock* block = cfg()->block(block_label); block != nullptr;
-       block = dominator_->ImmediateDominator(block)) {
-    for (const auto& var_val : block_defs_map_[block->id()]) {
-      auto live_vars_it = live_vars->find(var_val.first);
-      if (live_vars_it == live_vars->end()) live_vars->insert(var_val);
-    }
-  }
-}
-
 uint32_t MemPass::GetCurrentValue(uint32_t var_id, uint32_t block_label) {
   // Walk up the dominator chain starting at |block_label| looking for the
   // current value of variable |var_id|.  The first block we find containing a
   // definition for |var_id| is the one we are interested in.
   for (ir::BasicBlock* block = cfg()->block(block_label); block != nullptr;
        block = dominator_->ImmediateDominator(block)) {
-    const auto& block_defs = block_defs_map_[block->id()];
-    const auto& var_val_it = block_defs.find(var_id);
-    if (var_val_it != block_defs.end()) return var_val_it->second;
+    const auto block_defs = block_defs_map_.find(block->id());
+    if (block_defs == block_defs_map_.end()) continue;
+    const auto var_val_it = block_defs->second.find(var_id);
+    if (var_val_it != block_defs->second.end()) return var_val_it->second;
   }
   return 0;
 }
@@ -351,16 +393,8 @@ void MemPass::SSABlockInitLoopHeader(
   uint32_t mergeLabel =
       mergeInst->GetSingleWordInOperand(kLoopMergeMergeBlockIdInIdx);
 
-  // Collect all live variables and a default value for each across all
-  // non-backedge predecesors. Must be ordered map because phis are
-  // generated based on order and test results will otherwise vary across
-  // platforms.
-  std::map<uint32_t, uint32_t> liveVars;
-  for (uint32_t predLabel : cfg()->preds(label)) {
-    CollectLiveVars(predLabel, &liveVars);
-  }
-
-  // Add all stored variables in loop. Set their default value id to zero.
+  // Collect all stored variables in loop.
+  std::unordered_set<uint32_t> loopStoredVars;
   for (auto bi = block_itr; (*bi)->id() != mergeLabel; ++bi) {
     ir::BasicBlock* bp = *bi;
     for (auto ii = bp->begin(); ii != bp->end(); ++ii) {
@@ -372,19 +406,23 @@ void MemPass::SSABlockInitLoopHeader(
       if (!IsTargetVar(varId)) {
         continue;
       }
-      liveVars[varId] = 0;
+      loopStoredVars.insert(varId);
     }
   }
   // Insert phi for all live variables that require them. All variables
   // defined in loop require a phi. Otherwise all variables
-  // with differing predecessor values require a phi.
+  // with differing predecessor values require a phi. The live variables are
+  // in increasing order, so the phis are generated in the same order on all
+  // platforms.
+  const auto live_itr = live_in_vars_.find(label);
+  if (live_itr == live_in_vars_.end()) return;
   auto insertItr = (*block_itr)->begin();
-  for (auto var_val : liveVars) {
-    const uint32_t varId = var_val.first;
-    if (!IsLiveAfter(varId, label)) {
-      continue;
-    }
-    const uint32_t val0Id = var_val.second;
+  for (const uint32_t varId : live_itr->second) {
+    const bool storedInLoop = loopStoredVars.count(varId) != 0;
+    const uint32_t val0Id =
+        storedInLoop ? 0 : GetFirstPredValue(varId, label);
+    // A variable with no value in any predecessor stays undefined.
+    if (!storedInLoop && val0Id == 0) continue;
     bool needsPhi = false;
     if (val0Id != 0) {
       for (uint32_t predLabel : cfg()->preds(label)) {
@@ -407,7 +445,7 @@ void MemPass::SSABlockInitLoopHeader(
 
     // If val is the same for all predecessors, enter it in map
     if (!needsPhi) {
-      block_defs_map_[label].insert(var_val);
+      block_defs_map_[label].insert({varId, val0Id});
       continue;
     }
 
@@ -451,22 +489,23 @@ void MemPass::SSABlockInitLoopHeader(
 
 void MemPass::SSABlockInitMultiPred(ir::BasicBlock* block_ptr) {
   const uint32_t label = block_ptr->id();
-  // Collect all live variables and a default value for each across all
-  // predecesors. Must be ordered map because phis are generated based on
-  // order and test results will otherwise vary across platforms.
-  std::map<uint32_t, uint32_t> liveVars;
+#ifndef NDEBUG
   for (uint32_t predLabel : cfg()->preds(label)) {
     assert(visitedBlocks_.find(predLabel) != visitedBlocks_.end());
-    CollectLiveVars(predLabel, &liveVars);
   }
-
-  // For each live variable, look for a difference in values across
-  // predecessors that would require a phi and insert one.
+#endif  // NDEBUG
+
+  // For each variable live on entry to the block, look for a difference in
+  // values across predecessors that would require a phi and insert one. The
+  // live variables are in increasing order, so the phis are generated in the
+  // same order on all platforms.
+  const auto live_itr = live_in_vars_.find(label);
+  if (live_itr == live_in_vars_.end()) return;
   auto insertItr = block_ptr->begin();
-  for (auto var_val : liveVars) {
-    const uint32_t varId = var_val.first;
-    if (!IsLiveAfter(varId, label)) continue;
-    const uint32_t val0Id = var_val.second;
+  for (const uint32_t varId : live_itr->second) {
+    // A variable with no value in any predecessor stays undefined.
+    const uint32_t val0Id = GetFirstPredValue(varId, label);
+    if (val0Id == 0) continue;
     bool differs = false;
     for (uint32_t predLabel : cfg()->preds(label)) {
       uint32_t current_value = GetCurrentValue(varId, predLabel);
@@ -483,7 +522,7 @@ void MemPass::SSABlockInitMultiPred(ir::BasicBlock* block_ptr) {
     }
     // If val is the same for all predecessors, enter it in map
     if (!differs) {
-      block_defs_map_[label].insert(var_val);
+      block_defs_map_[label].insert({varId, val0Id});
       continue;
     }
 
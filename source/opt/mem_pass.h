@@ -24,6 +24,7 @@
 #include <unordered_map>
 #include <unordered_set>
 #include <utility>
+#include <vector>
 
 #include "basic_block.h"
 #include "def_use_manager.h"
@@ -148,24 +149,31 @@ class MemPass : public Pass {
   void PatchPhis(uint32_t header_id, uint32_t back_id);
 
   // Initialize data structures used by EliminateLocalMultiStore for
-  // function |func|, specifically block predecessors and target variables.
+  // function |func|, specifically block predecessors, target variables and
+  // their liveness.
   void InitSSARewrite(ir::Function* func);
 
+  // Computes the target variables of |func| that are live on entry to each of
+  // its blocks, and stores them in |live_in_vars_|.  A variable is live on
+  // entry to a block if it may be loaded in the block or in a block reachable
+  // from it before it is stored again.
+  void ComputeLiveInVars(ir::Function* func);
+
   // Initialize block_defs_map_ entry for loop header block pointed to
-  // |block_itr| by merging entries from all predecessors. If any value
-  // ids differ for any variable across predecessors, create a phi function
-  // in the block and use that value id for the variable in the new map.
-  // Assumes all predecessors have been visited by EliminateLocalMultiStore
-  // except the back edge. Use a dummy value in the phi for the back edge
-  // until the back edge block is visited and patch the phi value then.
+  // |block_itr| for the variables live on entry to it. If any value ids
+  // differ for such a variable across predecessors, or the variable is
+  // stored in the loop, create a phi function in the block and use that value
+  // id for the variable in the new map. Assumes all predecessors have been
+  // visited by EliminateLocalMultiStore except the back edge. Use a dummy
+  // value in the phi for the back edge until the back edge block is visited
+  // and patch the phi value then.
   void SSABlockInitLoopHeader(std::list<ir::BasicBlock*>::iterator block_itr);
 
   // Initialize block_defs_map_ entry for multiple predecessor block
-  // |block_ptr| by merging block_defs_map_ entries for all predecessors.
-  // If any value ids differ for any variable across predecessors, create
-  // a phi function in the block and use that value id for the variable in
-  // the new map. Assumes all predecessors have been visited by
-  // EliminateLocalMultiStore.
+  // |block_ptr| for the variables live on entry to it. If any value ids
+  // differ for such a variable across predecessors, create a phi function in
+  // the block and use that value id for the variable in the new map. Assumes
+  // all predecessors have been visited by EliminateLocalMultiStore.
   void SSABlockInitMultiPred(ir::BasicBlock* block_ptr);
 
   // Initialize the label2ssa_map entry for a block pointed to by |block_itr|.
@@ -174,9 +182,9 @@ class MemPass : public Pass {
   // backedges.
   void SSABlockInit(std::list<ir::BasicBlock*>::iterator block_itr);
 
-  // Return true if variable is loaded in block with |label| or in any
-  // succeeding block in structured order.
-  bool IsLiveAfter(uint32_t var_id, uint32_t label) const;
+  // Returns the value of variable |var_id| at the end of the first
+  // predecessor of |label| that has one, or 0 if no predecessor has a value.
+  uint32_t GetFirstPredValue(uint32_t var_id, uint32_t label);
 
   // Remove all the unreachable basic blocks in |func|.
   bool RemoveUnreachableBlocks(ir::Function* func);
@@ -190,16 +198,6 @@ class MemPass : public Pass {
   void RemovePhiOperands(ir::Instruction* phi,
                          std::unordered_set<ir::BasicBlock*> reachable_blocks);
 
-  // Collects a map of all the live variables and their values along the path of
-  // dominator parents starting at |block_label|.  Each entry
-  // |live_vars[var_id]| returns the latest value of |var_id| along that
-  // dominator path.  Note that the mapping |live_vars| is never cleared,
-  // multiple calls to this function will accumulate new <var_id, value_id>
-  // mappings.  This is done to support the logic in
-  // MemPass::SSABlockInitLoopHeader.
-  void CollectLiveVars(uint32_t block_label,
-                       std::map<uint32_t, uint32_t>* live_vars);
-
   // Returns the ID of the most current value taken by variable |var_id| on the
   // dominator path starting at |block_id|.  This walks the dominator parents
   // starting at |block_id| and returns the first value it finds for |var_id|.
@@ -215,6 +213,11 @@ class MemPass : public Pass {
   std::unordered_map<uint32_t, std::unordered_map<uint32_t, uint32_t>>
       block_defs_map_;
 
+  // Each entry |live_in_vars_[block_id]| holds the target variables that are
+  // live on entry to |block_id|, in increasing order.  Blocks without live
+  // variables have no entry.
+  std::unordered_map<uint32_t, std::vector<uint32_t>> live_in_vars_;
+
   // Set of label ids of visited blocks
   std::unordered_set<uint32_t> visitedBlocks_;
 
@@ -125,6 +125,29 @@ void Module::ToBinary(std::vector<uint32_t>* binary, bool skip_nop) const {
   ForEachInst(write_inst, true);
 }
 
+bool Module::ToBinary(
+    const std::function<bool(const uint32_t*, size_t)>& write,
+    bool skip_nop) const {
+  // The number of words gathered before they are passed on.
+  static const size_t kPieceSize = 4096;
+  std::vector<uint32_t> piece = {header_.magic_number, header_.version,
+                                 header_.generator, header_.bound,
+                                 header_.reserved};
+  piece.reserve(2 * kPieceSize);
+  bool ok = true;
+  auto write_inst = [&piece, &ok, &write, skip_nop](const Instruction* i) {
+    if (!ok || (skip_nop && i->IsNop())) return;
+    i->ToBinaryWithoutAttachedDebugInsts(&piece);
+    if (piece.size() >= kPieceSize) {
+      ok = write(piece.data(), piece.size());
+      piece.clear();
+    }
+  };
+  ForEachInst(write_inst, true);
+  if (ok && !piece.empty()) ok = write(piece.data(), piece.size());
+  return ok;
+}
+
 uint32_t Module::ComputeIdBound() const {
   uint32_t highest = 0;
 
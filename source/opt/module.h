@@ -106,6 +106,9 @@ class Module {
   // Appends a function to this module.
   inline void AddFunction(std::unique_ptr<Function> f);
 
+  // Replaces the |index|th function of this module with |f|.
+  inline void SetFunction(size_t index, std::unique_ptr<Function> f);
+
   // Returns a vector of pointers to type-declaration instructions in this
   // module.
   std::vector<Instruction*> GetTypes();
@@ -235,6 +238,13 @@ class Module {
   // If |skip_nop| is true and this is a OpNop, do nothing.
   void ToBinary(std::vector<uint32_t>* binary, bool skip_nop) const;
 
+  // Passes the binary for this module to |write| in order, a piece of at most
+  // a few thousand words at a time, so the whole binary is never held in
+  // memory.  If |skip_nop| is true, OpNops are left out.  Stops and returns
+  // false as soon as |write| returns false.
+  bool ToBinary(const std::function<bool(const uint32_t*, size_t)>& write,
+                bool skip_nop) const;
+
   // Returns 1 more than the maximum Id value mentioned in the module.
   uint32_t ComputeIdBound() const;
 
@@ -328,6 +338,11 @@ inline void Module::AddFunction(std::unique_ptr<Function> f) {
   functions_.emplace_back(std::move(f));
 }
 
+inline void Module::SetFunction(size_t index, std::unique_ptr<Function> f) {
+  assert(index < functions_.size());
+  functions_[index] = std::move(f);
+}
+
 inline Module::inst_iterator Module::capability_begin() {
   return capabilities_.begin();
 }
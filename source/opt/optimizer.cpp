@@ -14,20 +14,89 @@
 
 #include "spirv-tools/optimizer.hpp"
 
+#include <atomic>
+#include <functional>
+
 #include "build_module.h"
 #include "make_unique.h"
 #include "pass_manager.h"
 #include "passes.h"
 #include "simplification_pass.h"
+#include "util/parallel.h"
 
 namespace spvtools {
 
+namespace {
+
+// Creates a new instance of a pass.
+using PassFactory = std::function<std::unique_ptr<opt::Pass>()>;
+
+}  // anonymous namespace
+
 struct Optimizer::PassToken::Impl {
-  Impl(std::unique_ptr<opt::Pass> p) : pass(std::move(p)) {}
+  Impl(PassFactory f) : pass(f()), factory(std::move(f)) {}
 
   std::unique_ptr<opt::Pass> pass;  // Internal implementation pass.
+  // Creates more instances of |pass|, so it can run on several modules at
+  // once.
+  PassFactory factory;
 };
 
+namespace {
+
+// Returns a token for a pass of type |T| constructed from |args|.  The token
+// keeps a copy of |args|, to construct more instances of the pass on demand.
+template <typename T, typename... Args>
+Optimizer::PassToken MakePassToken(const Args&... args) {
+  return MakeUnique<Optimizer::PassToken::Impl>(
+      PassFactory([args...]() -> std::unique_ptr<opt::Pass> {
+        return MakeUnique<T>(args...);
+      }));
+}
+
+// Builds the module in |original_binary| for |env| and runs the passes in
+// |pass_manager| on it, storing their status in |status|.  The
+// function-local passes use up to |thread_count| threads.  Returns the module,
+// or null if it could not be built.
+std::unique_ptr<ir::IRContext> BuildAndRunPasses(
+    spv_target_env env, opt::PassManager* pass_manager,
+    const uint32_t* original_binary, size_t original_binary_size,
+    uint32_t thread_count, opt::Pass::Status* status) {
+  std::unique_ptr<ir::IRContext> context =
+      BuildModule(env, pass_manager->consumer(), original_binary,
+                  original_binary_size);
+  if (context == nullptr) return nullptr;
+  context->SetThreadCount(thread_count);
+  *status = pass_manager->Run(context.get());
+  return context;
+}
+
+// Optimizes the module in |original_binary| for |env| with the passes in
+// |pass_manager|, and writes the result to |optimized_binary|.  The
+// function-local passes use up to |thread_count| threads.  Has the same
+// semantics as Optimizer::Run().
+bool RunPasses(spv_target_env env, opt::PassManager* pass_manager,
+               const uint32_t* original_binary, size_t original_binary_size,
+               std::vector<uint32_t>* optimized_binary, uint32_t thread_count) {
+  opt::Pass::Status status;
+  std::unique_ptr<ir::IRContext> context =
+      BuildAndRunPasses(env, pass_manager, original_binary,
+                        original_binary_size, thread_count, &status);
+  if (context == nullptr) return false;
+
+  if (status == opt::Pass::Status::SuccessWithChange ||
+      (status == opt::Pass::Status::SuccessWithoutChange &&
+       (optimized_binary->data() != original_binary ||
+        optimized_binary->size() != original_binary_size))) {
+    optimized_binary->clear();
+    context->module()->ToBinary(optimized_binary, /* skip_nop = */ true);
+  }
+
+  return status != opt::Pass::Status::Failure;
+}
+
+}  // anonymous namespace
+
 Optimizer::PassToken::PassToken(
     std::unique_ptr<Optimizer::PassToken::Impl> impl)
     : impl_(std::move(impl)) {}
@@ -42,10 +111,19 @@ Optimizer::PassToken& Optimizer::PassToken::operator=(PassToken&& that) {
 Optimizer::PassToken::~PassToken() {}
 
 struct Optimizer::Impl {
-  explicit Impl(spv_target_env env) : target_env(env), pass_manager() {}
+  explicit Impl(spv_target_env env)
+      : target_env(env),
+        pass_manager(),
+        thread_count(1),
+        inline_budget(opt::InlineExhaustivePass::kNoBudget) {}
 
   const spv_target_env target_env;  // Target environment.
   opt::PassManager pass_manager;    // Internal implementation pass manager.
+  uint32_t thread_count;            // Threads for the functions of a module.
+  uint32_t inline_budget;           // Budget of the registered inline passes.
+  // Factories for the passes in |pass_manager|, in the same order.  They are
+  // kept after |pass_manager| has run its passes.
+  std::vector<PassFactory> pass_factories;
 };
 
 Optimizer::Optimizer(spv_target_env env) : impl_(new Impl(env)) {}
@@ -64,6 +142,7 @@ Optimizer& Optimizer::RegisterPass(PassToken&& p) {
   // Change to use the pass manager's consumer.
   p.impl_->pass->SetMessageConsumer(impl_->pass_manager.consumer());
   impl_->pass_manager.AddPass(std::move(p.impl_->pass));
+  impl_->pass_factories.push_back(std::move(p.impl_->factory));
   return *this;
 }
 
@@ -91,7 +170,7 @@ Optimizer& Optimizer::RegisterPass(PassToken&& p) {
 Optimizer& Optimizer::RegisterLegalizationPasses() {
   return
       // Make sure uses and definitions are in the same function.
-      RegisterPass(CreateInlineExhaustivePass())
+      RegisterPass(CreateInlineExhaustivePass(impl_->inline_budget))
           // Make private variable function scope
           .RegisterPass(CreateEliminateDeadFunctionsPass())
           .RegisterPass(CreatePrivateToLocalPass())
@@ -121,7 +200,7 @@ Optimizer& Optimizer::RegisterLegalizationPasses() {
 Optimizer& Optimizer::RegisterPerformancePasses() {
   return RegisterPass(CreateRemoveDuplicatesPass())
       .RegisterPass(CreateMergeReturnPass())
-      .RegisterPass(CreateInlineExhaustivePass())
+      .RegisterPass(CreateInlineExhaustivePass(impl_->inline_budget))
       .RegisterPass(CreateAggressiveDCEPass())
       .RegisterPass(CreateScalarReplacementPass())
       .RegisterPass(CreateLocalAccessChainConvertPass())
@@ -149,7 +228,7 @@ Optimizer& Optimizer::RegisterPerformancePasses() {
 Optimizer& Optimizer::RegisterSizePasses() {
   return RegisterPass(CreateRemoveDuplicatesPass())
       .RegisterPass(CreateMergeReturnPass())
-      .RegisterPass(CreateInlineExhaustivePass())
+      .RegisterPass(CreateInlineExhaustivePass(impl_->inline_budget))
       .RegisterPass(CreateAggressiveDCEPass())
       .RegisterPass(CreateScalarReplacementPass())
       .RegisterPass(CreateLocalAccessChainConvertPass())
@@ -176,21 +255,51 @@ Optimizer& Optimizer::RegisterSizePasses() {
 bool Optimizer::Run(const uint32_t* original_binary,
                     const size_t original_binary_size,
                     std::vector<uint32_t>* optimized_binary) const {
-  std::unique_ptr<ir::IRContext> context =
-      BuildModule(impl_->target_env, impl_->pass_manager.consumer(),
-                  original_binary, original_binary_size);
-  if (context == nullptr) return false;
+  return RunPasses(impl_->target_env, &impl_->pass_manager, original_binary,
+                   original_binary_size, optimized_binary,
+                   impl_->thread_count);
+}
 
-  auto status = impl_->pass_manager.Run(context.get());
-  if (status == opt::Pass::Status::SuccessWithChange ||
-      (status == opt::Pass::Status::SuccessWithoutChange &&
-       (optimized_binary->data() != original_binary ||
-        optimized_binary->size() != original_binary_size))) {
-    optimized_binary->clear();
-    context->module()->ToBinary(optimized_binary, /* skip_nop = */ true);
+bool Optimizer::Run(const uint32_t* original_binary,
+                    const size_t original_binary_size,
+                    const BinaryWriter& write) const {
+  opt::Pass::Status status;
+  std::unique_ptr<ir::IRContext> context = BuildAndRunPasses(
+      impl_->target_env, &impl_->pass_manager, original_binary,
+      original_binary_size, impl_->thread_count, &status);
+  if (context == nullptr || status == opt::Pass::Status::Failure) {
+    return false;
   }
-
-  return status != opt::Pass::Status::Failure;
+  return context->module()->ToBinary(write, /* skip_nop = */ true);
+}
+
+bool Optimizer::RunBatch(
+    const std::vector<std::vector<uint32_t>>& original_binaries,
+    std::vector<std::vector<uint32_t>>* optimized_binaries,
+    uint32_t thread_count) const {
+  const size_t num_modules = original_binaries.size();
+  optimized_binaries->resize(num_modules);
+  std::atomic<bool> ok(true);
+  spvutils::ParallelFor(num_modules, thread_count, [&](size_t i) {
+    // Passes keep state between their calls, and the pass manager drops them
+    // once they have run, so each module gets its own instances.
+    opt::PassManager pass_manager;
+    pass_manager.SetMessageConsumer(impl_->pass_manager.consumer());
+    pass_manager.SetMaxIterations(impl_->pass_manager.max_iterations());
+    for (const auto& factory : impl_->pass_factories) {
+      std::unique_ptr<opt::Pass> pass = factory();
+      pass->SetMessageConsumer(pass_manager.consumer());
+      pass_manager.AddPass(std::move(pass));
+    }
+    const std::vector<uint32_t>& original = original_binaries[i];
+    std::vector<uint32_t>* optimized = &(*optimized_binaries)[i];
+    if (!RunPasses(impl_->target_env, &pass_manager, original.data(),
+                   original.size(), optimized, 1)) {
+      optimized->clear();
+      ok = false;
+    }
+  });
+  return ok;
 }
 
 Optimizer& Optimizer::SetPrintAll(std::ostream* out) {
@@ -198,135 +307,140 @@ Optimizer& Optimizer::SetPrintAll(std::ostream* out) {
   return *this;
 }
 
+Optimizer& Optimizer::SetTimeReport(std::ostream* out,
+                                    TimeReportFormat format) {
+  impl_->pass_manager.SetTimeReport(out, format);
+  return *this;
+}
+
+Optimizer& Optimizer::SetMaxIterations(uint32_t max_iterations) {
+  impl_->pass_manager.SetMaxIterations(max_iterations);
+  return *this;
+}
+
+Optimizer& Optimizer::SetThreadCount(uint32_t thread_count) {
+  impl_->thread_count = thread_count;
+  return *this;
+}
+
+Optimizer& Optimizer::SetInlineBudget(uint32_t budget) {
+  impl_->inline_budget = budget;
+  return *this;
+}
+
 Optimizer::PassToken CreateNullPass() {
-  return MakeUnique<Optimizer::PassToken::Impl>(MakeUnique<opt::NullPass>());
+  return MakePassToken<opt::NullPass>();
 }
 
 Optimizer::PassToken CreateStripDebugInfoPass() {
-  return MakeUnique<Optimizer::PassToken::Impl>(
-      MakeUnique<opt::StripDebugInfoPass>());
+  return MakePassToken<opt::StripDebugInfoPass>();
 }
 
 Optimizer::PassToken CreateEliminateDeadFunctionsPass() {
-  return MakeUnique<Optimizer::PassToken::Impl>(
-      MakeUnique<opt::EliminateDeadFunctionsPass>());
+  return MakePassToken<opt::EliminateDeadFunctionsPass>();
 }
 
 Optimizer::PassToken CreateSetSpecConstantDefaultValuePass(
     const std::unordered_map<uint32_t, std::string>& id_value_map) {
-  return MakeUnique<Optimizer::PassToken::Impl>(
-      MakeUnique<opt::SetSpecConstantDefaultValuePass>(id_value_map));
+  return MakePassToken<opt::SetSpecConstantDefaultValuePass>(id_value_map);
 }
 
 Optimizer::PassToken CreateSetSpecConstantDefaultValuePass(
     const std::unordered_map<uint32_t, std::vector<uint32_t>>& id_value_map) {
-  return MakeUnique<Optimizer::PassToken::Impl>(
-      MakeUnique<opt::SetSpecConstantDefaultValuePass>(id_value_map));
+  return MakePassToken<opt::SetSpecConstantDefaultValuePass>(id_value_map);
 }
 
 Optimizer::PassToken CreateFlattenDecorationPass() {
-  return MakeUnique<Optimizer::PassToken::Impl>(
-      MakeUnique<opt::FlattenDecorationPass>());
+  return MakePassToken<opt::FlattenDecorationPass>();
 }
 
 Optimizer::PassToken CreateFreezeSpecConstantValuePass() {
-  return MakeUnique<Optimizer::PassToken::Impl>(
-      MakeUnique<opt::FreezeSpecConstantValuePass>());
+  return MakePassToken<opt::FreezeSpecConstantValuePass>();
 }
 
 Optimizer::PassToken CreateFoldSpecConstantOpAndCompositePass() {
-  return MakeUnique<Optimizer::PassToken::Impl>(
-      MakeUnique<opt::FoldSpecConstantOpAndCompositePass>());
+  return MakePassToken<opt::FoldSpecConstantOpAndCompositePass>();
 }
 
 Optimizer::PassToken CreateUnifyConstantPass() {
-  return MakeUnique<Optimizer::PassToken::Impl>(
-      MakeUnique<opt::UnifyConstantPass>());
+  return MakePassToken<opt::UnifyConstantPass>();
 }
 
 Optimizer::PassToken CreateEliminateDeadConstantPass() {
-  return MakeUnique<Optimizer::PassToken::Impl>(
-      MakeUnique<opt::EliminateDeadConstantPass>());
+  return MakePassToken<opt::EliminateDeadConstantPass>();
 }
 
 Optimizer::PassToken CreateDeadVariableEliminationPass() {
-  return MakeUnique<Optimizer::PassToken::Impl>(
-      MakeUnique<opt::DeadVariableElimination>());
+  return MakePassToken<opt::DeadVariableElimination>();
 }
 
 Optimizer::PassToken CreateStrengthReductionPass() {
-  return MakeUnique<Optimizer::PassToken::Impl>(
-      MakeUnique<opt::StrengthReductionPass>());
+  return MakePassToken<opt::StrengthReductionPass>();
 }
 
 Optimizer::PassToken CreateBlockMergePass() {
-  return MakeUnique<Optimizer::PassToken::Impl>(
-      MakeUnique<opt::BlockMergePass>());
+  return MakePassToken<opt::BlockMergePass>();
 }
 
 Optimizer::PassToken CreateInlineExhaustivePass() {
-  return MakeUnique<Optimizer::PassToken::Impl>(
-      MakeUnique<opt::InlineExhaustivePass>());
+  return MakePassToken<opt::InlineExhaustivePass>();
+}
+
+Optimizer::PassToken CreateInlineExhaustivePass(uint32_t budget) {
+  return MakePassToken<opt::InlineExhaustivePass>(budget);
 }
 
 Optimizer::PassToken CreateInlineOpaquePass() {
-  return MakeUnique<Optimizer::PassToken::Impl>(
-      MakeUnique<opt::InlineOpaquePass>());
+  return MakePassToken<opt::InlineOpaquePass>();
 }
 
 Optimizer::PassToken CreateLocalAccessChainConvertPass() {
-  return MakeUnique<Optimizer::PassToken::Impl>(
-      MakeUnique<opt::LocalAccessChainConvertPass>());
+  return MakePassToken<opt::LocalAccessChainConvertPass>();
 }
 
 Optimizer::PassToken CreateLocalSingleBlockLoadStoreElimPass() {
-  return MakeUnique<Optimizer::PassToken::Impl>(
-      MakeUnique<opt::LocalSingleBlockLoadStoreElimPass>());
+  return MakePassToken<opt::LocalSingleBlockLoadStoreElimPass>();
 }
 
 Optimizer::PassToken CreateLocalSingleStoreElimPass() {
-  return MakeUnique<Optimizer::PassToken::Impl>(
-      MakeUnique<opt::LocalSingleStoreElimPass>());
+  return MakePassToken<opt::LocalSingleStoreElimPass>();
 }
 
 Optimizer::PassToken CreateInsertExtractElimPass() {
-  return MakeUnique<Optimizer::PassToken::Impl>(
-      MakeUnique<opt::InsertExtractElimPass>());
+  return MakePassToken<opt::InsertExtractElimPass>();
 }
 
 Optimizer::PassToken CreateDeadInsertElimPass() {
-  return MakeUnique<Optimizer::PassToken::Impl>(
-      MakeUnique<opt::DeadInsertElimPass>());
+  return MakePassToken<opt::DeadInsertElimPass>();
 }
 
 Optimizer::PassToken CreateDeadBranchElimPass() {
-  return MakeUnique<Optimizer::PassToken::Impl>(
-      MakeUnique<opt::DeadBranchElimPass>());
+  return MakePassToken<opt::DeadBranchElimPass>();
 }
 
 Optimizer::PassToken CreateLocalMultiStoreElimPass() {
-  return MakeUnique<Optimizer::PassToken::Impl>(
-      MakeUnique<opt::LocalMultiStoreElimPass>());
+  return MakePassToken<opt::LocalMultiStoreElimPass>();
 }
 
 Optimizer::PassToken CreateAggressiveDCEPass() {
-  return MakeUnique<Optimizer::PassToken::Impl>(
-      MakeUnique<opt::AggressiveDCEPass>());
+  return MakePassToken<opt::AggressiveDCEPass>();
 }
 
 Optimizer::PassToken CreateCommonUniformElimPass() {
-  return MakeUnique<Optimizer::PassToken::Impl>(
-      MakeUnique<opt::CommonUniformElimPass>());
+  return MakePassToken<opt::CommonUniformElimPass>();
 }
 
 Optimizer::PassToken CreateCompactIdsPass() {
-  return MakeUnique<Optimizer::PassToken::Impl>(
-      MakeUnique<opt::CompactIdsPass>());
+  return MakePassToken<opt::CompactIdsPass>();
+}
+
+Optimizer::PassToken CreateCompactIdsForLocalityPass() {
+  return MakePassToken<opt::CompactIdsPass>(
+      opt::CompactIdsPass::Order::kLocality);
 }
 
 Optimizer::PassToken CreateMergeReturnPass() {
-  return MakeUnique<Optimizer::PassToken::Impl>(
-      MakeUnique<opt::MergeReturnPass>());
+  return MakePassToken<opt::MergeReturnPass>();
 }
 
 std::vector<const char*> Optimizer::GetPassNames() const {
@@ -338,65 +452,54 @@ std::vector<const char*> Optimizer::GetPassNames() const {
 }
 
 Optimizer::PassToken CreateCFGCleanupPass() {
-  return MakeUnique<Optimizer::PassToken::Impl>(
-      MakeUnique<opt::CFGCleanupPass>());
+  return MakePassToken<opt::CFGCleanupPass>();
 }
 
 Optimizer::PassToken CreateLocalRedundancyEliminationPass() {
-  return MakeUnique<Optimizer::PassToken::Impl>(
-      MakeUnique<opt::LocalRedundancyEliminationPass>());
+  return MakePassToken<opt::LocalRedundancyEliminationPass>();
 }
 
 Optimizer::PassToken CreateLoopInvariantCodeMotionPass() {
-  return MakeUnique<Optimizer::PassToken::Impl>(MakeUnique<opt::LICMPass>());
+  return MakePassToken<opt::LICMPass>();
 }
 
 Optimizer::PassToken CreateRedundancyEliminationPass() {
-  return MakeUnique<Optimizer::PassToken::Impl>(
-      MakeUnique<opt::RedundancyEliminationPass>());
+  return MakePassToken<opt::RedundancyEliminationPass>();
 }
 
 Optimizer::PassToken CreateRemoveDuplicatesPass() {
-  return MakeUnique<Optimizer::PassToken::Impl>(
-      MakeUnique<opt::RemoveDuplicatesPass>());
+  return MakePassToken<opt::RemoveDuplicatesPass>();
 }
 
 Optimizer::PassToken CreateScalarReplacementPass() {
-  return MakeUnique<Optimizer::PassToken::Impl>(
-      MakeUnique<opt::ScalarReplacementPass>());
+  return MakePassToken<opt::ScalarReplacementPass>();
 }
 
 Optimizer::PassToken CreatePrivateToLocalPass() {
-  return MakeUnique<Optimizer::PassToken::Impl>(
-      MakeUnique<opt::PrivateToLocalPass>());
+  return MakePassToken<opt::PrivateToLocalPass>();
 }
 
 Optimizer::PassToken CreateCCPPass() {
-  return MakeUnique<Optimizer::PassToken::Impl>(MakeUnique<opt::CCPPass>());
+  return MakePassToken<opt::CCPPass>();
 }
 
 Optimizer::PassToken CreateWorkaround1209Pass() {
-  return MakeUnique<Optimizer::PassToken::Impl>(
-      MakeUnique<opt::Workaround1209>());
+  return MakePassToken<opt::Workaround1209>();
 }
 
 Optimizer::PassToken CreateIfConversionPass() {
-  return MakeUnique<Optimizer::PassToken::Impl>(
-      MakeUnique<opt::IfConversion>());
+  return MakePassToken<opt::IfConversion>();
 }
 
 Optimizer::PassToken CreateReplaceInvalidOpcodePass() {
-  return MakeUnique<Optimizer::PassToken::Impl>(
-      MakeUnique<opt::ReplaceInvalidOpcodePass>());
+  return MakePassToken<opt::ReplaceInvalidOpcodePass>();
 }
 
 Optimizer::PassToken CreateSimplificationPass() {
-  return MakeUnique<Optimizer::PassToken::Impl>(
-      MakeUnique<opt::SimplificationPass>());
+  return MakePassToken<opt::SimplificationPass>();
 }
 
 Optimizer::PassToken CreateLoopFullyUnrollPass() {
-  return MakeUnique<Optimizer::PassToken::Impl>(
-      MakeUnique<opt::LoopUnroller>());
+  return MakePassToken<opt::LoopUnroller>();
 }
 }  // namespace spvtools
@@ -16,7 +16,11 @@
 
 #include "pass.h"
 
+#include <map>
+
 #include "iterator.h"
+#include "reflect.h"
+#include "util/parallel.h"
 
 namespace spvtools {
 namespace opt {
@@ -26,9 +30,213 @@ namespace {
 const uint32_t kEntryPointFunctionIdInIdx = 1;
 const uint32_t kTypePointerTypeIdInIdx = 1;
 
+// A group of the functions of a function-local pass, processed by its own
+// instance of the pass in a copy of the module.
+struct FunctionGroup {
+  // The context of the copy of the module.
+  std::unique_ptr<ir::IRContext> context;
+  // The functions of the group, their positions in the original module, and
+  // their copies, in the order they are processed.
+  std::vector<const ir::Function*> originals;
+  std::vector<size_t> indices;
+  std::vector<ir::Function*> functions;
+  // The unique ids of the copies of the names, the decorations and the global
+  // values of the original module.
+  std::vector<uint32_t> debug2_ids;
+  std::vector<uint32_t> annotation_ids;
+  std::vector<uint32_t> types_values_ids;
+  // True if the pass applied to the copy, and if it changed it.
+  bool initialized = false;
+  bool modified = false;
+  // The ids of the functions the pass changed.
+  std::vector<uint32_t> changed;
+  // The global values the pass added, and for each of them whether it repeats
+  // a type or constant that an earlier group added.
+  std::vector<const ir::Instruction*> new_values;
+  std::vector<bool> repeated;
+  // The final id of each id the pass took, indexed by the id minus the id
+  // bound of the original module.
+  std::vector<uint32_t> remap;
+};
+
+// Appends the binary of the instructions in |range|, without their debug line
+// instructions, to |words|.
+template <class Range>
+void AppendWords(const Range& range, std::vector<uint32_t>* words) {
+  for (const auto& inst : range) inst.ToBinaryWithoutAttachedDebugInsts(words);
+}
+
+// Returns the binary of the sections of |module| that a function-local pass
+// must leave alone.
+std::vector<uint32_t> GetFixedSectionWords(const ir::Module& module) {
+  std::vector<uint32_t> words;
+  AppendWords(module.capabilities(), &words);
+  AppendWords(module.extensions(), &words);
+  AppendWords(module.ext_inst_imports(), &words);
+  if (module.GetMemoryModel()) {
+    module.GetMemoryModel()->ToBinaryWithoutAttachedDebugInsts(&words);
+  }
+  AppendWords(module.entry_points(), &words);
+  AppendWords(module.execution_modes(), &words);
+  AppendWords(module.debugs1(), &words);
+  AppendWords(module.debugs3(), &words);
+  return words;
+}
+
+// Adds clones of the instructions in |range| to the module of |c| using
+// |add|.  Returns the unique ids of the clones.
+template <class Range, class AddFn>
+std::vector<uint32_t> CloneInstructions(const Range& range, ir::IRContext* c,
+                                        AddFn add) {
+  std::vector<uint32_t> unique_ids;
+  for (const auto& inst : range) {
+    std::unique_ptr<ir::Instruction> clone(inst.Clone(c));
+    unique_ids.push_back(clone->unique_id());
+    add(std::move(clone));
+  }
+  return unique_ids;
+}
+
+// Fills |group->context| with a copy of the global sections of |module| and of
+// the functions in |group->originals|.
+void CopyModule(const ir::Module& module, spv_target_env env,
+                const MessageConsumer& consumer, FunctionGroup* group) {
+  group->context.reset(new ir::IRContext(env, consumer));
+  ir::IRContext* c = group->context.get();
+  c->SetHasAllFunctions(false);
+  ir::Module* copy = c->module();
+  copy->SetHeader({SpvMagicNumber, module.version(), 0, module.id_bound(), 0});
+
+  using InstPtr = std::unique_ptr<ir::Instruction>;
+  CloneInstructions(module.capabilities(), c, [copy](InstPtr i) {
+    copy->AddCapability(std::move(i));
+  });
+  CloneInstructions(module.extensions(), c,
+                    [copy](InstPtr i) { copy->AddExtension(std::move(i)); });
+  CloneInstructions(module.ext_inst_imports(), c, [copy](InstPtr i) {
+    copy->AddExtInstImport(std::move(i));
+  });
+  if (module.GetMemoryModel()) {
+    copy->SetMemoryModel(InstPtr(module.GetMemoryModel()->Clone(c)));
+  }
+  CloneInstructions(module.entry_points(), c,
+                    [copy](InstPtr i) { copy->AddEntryPoint(std::move(i)); });
+  CloneInstructions(module.execution_modes(), c, [copy](InstPtr i) {
+    copy->AddExecutionMode(std::move(i));
+  });
+  CloneInstructions(module.debugs1(), c,
+                    [copy](InstPtr i) { copy->AddDebug1Inst(std::move(i)); });
+  group->debug2_ids = CloneInstructions(
+      module.debugs2(), c,
+      [copy](InstPtr i) { copy->AddDebug2Inst(std::move(i)); });
+  CloneInstructions(module.debugs3(), c,
+                    [copy](InstPtr i) { copy->AddDebug3Inst(std::move(i)); });
+  group->annotation_ids = CloneInstructions(
+      module.annotations(), c,
+      [copy](InstPtr i) { copy->AddAnnotationInst(std::move(i)); });
+  group->types_values_ids = CloneInstructions(
+      module.types_values(), c,
+      [copy](InstPtr i) { copy->AddGlobalValue(std::move(i)); });
+
+  for (const ir::Function* fn : group->originals) {
+    std::unique_ptr<ir::Function> clone(fn->Clone(c));
+    group->functions.push_back(clone.get());
+    copy->AddFunction(std::move(clone));
+  }
+}
+
+// Sets |removed[i]| for each id in |original_ids| that is not the unique id
+// of an instruction in |range|.  Returns false if |range| has instructions
+// that are not in |original_ids|, or has them in a different order.
+template <class Range>
+bool FindRemovedInstructions(const Range& range,
+                             const std::vector<uint32_t>& original_ids,
+                             std::vector<bool>* removed) {
+  size_t i = 0;
+  for (const auto& inst : range) {
+    while (i < original_ids.size() && original_ids[i] != inst.unique_id()) {
+      (*removed)[i++] = true;
+    }
+    if (i == original_ids.size()) return false;
+    ++i;
+  }
+  for (; i < original_ids.size(); ++i) (*removed)[i] = true;
+  return true;
+}
+
+// Checks that the pass only changed the copy in |group| in ways that can be
+// merged into |module|: the global sections in |fixed_words| and the global
+// values in |types_values_words| are unchanged, and the names and decorations
+// were only removed from.  Sets the entries of |removed_debug2| and
+// |removed_annotations| for the names and decorations that were removed, and
+// collects the new global values.
+bool CheckGroup(const std::vector<uint32_t>& fixed_words,
+                const std::vector<uint32_t>& types_values_words,
+                FunctionGroup* group, std::vector<bool>* removed_debug2,
+                std::vector<bool>* removed_annotations) {
+  const ir::Module& copy = *group->context->module();
+  if (GetFixedSectionWords(copy) != fixed_words) return false;
+  if (!FindRemovedInstructions(copy.debugs2(), group->debug2_ids,
+                               removed_debug2) ||
+      !FindRemovedInstructions(copy.annotations(), group->annotation_ids,
+                               removed_annotations)) {
+    return false;
+  }
+
+  std::vector<uint32_t> words;
+  size_t i = 0;
+  for (const auto& inst : copy.types_values()) {
+    if (i < group->types_values_ids.size()) {
+      if (inst.unique_id() != group->types_values_ids[i++]) return false;
+      inst.ToBinaryWithoutAttachedDebugInsts(&words);
+    } else {
+      group->new_values.push_back(&inst);
+    }
+  }
+  return i == group->types_values_ids.size() && words == types_values_words;
+}
+
+// Returns in |key| what identifies the type or constant |inst| once its ids
+// are mapped with |remap|.  Ids below |bound| are not mapped.  Returns false
+// if |inst| uses an id that has no mapping yet.
+bool GetValueKey(const ir::Instruction& inst, uint32_t bound,
+                 const std::vector<uint32_t>& remap,
+                 std::vector<uint32_t>* key) {
+  key->clear();
+  key->push_back(inst.opcode());
+  for (uint32_t i = 0; i < inst.NumOperands(); ++i) {
+    const ir::Operand& operand = inst.GetOperand(i);
+    if (operand.type == SPV_OPERAND_TYPE_RESULT_ID) continue;
+    if (spvIsIdType(operand.type) && operand.words[0] >= bound) {
+      const uint32_t id = remap[operand.words[0] - bound];
+      if (id == 0) return false;
+      key->push_back(id);
+    } else {
+      key->insert(key->end(), operand.words.begin(), operand.words.end());
+    }
+  }
+  return true;
+}
+
+// Changes the ids of |inst| and its debug line instructions that are not
+// below |bound| with |remap|.
+void RemapIds(ir::Instruction* inst, uint32_t bound,
+              const std::vector<uint32_t>& remap) {
+  inst->ForEachInst(
+      [bound, &remap](ir::Instruction* i) {
+        i->ForEachId([bound, &remap](uint32_t* id) {
+          if (*id >= bound) *id = remap[*id - bound];
+        });
+      },
+      true);
+}
+
 }  // namespace
 
-Pass::Pass() : consumer_(nullptr), context_(nullptr) {}
+Pass::Pass()
+    : consumer_(nullptr),
+      tracks_changed_functions_(false),
+      context_(nullptr) {}
 
 void Pass::AddCalls(ir::Function* func, std::queue<uint32_t>* todo) {
   for (auto bi = func->begin(); bi != func->end(); ++bi)
@@ -102,7 +310,182 @@ bool Pass::ProcessCallTreeFromRoots(
   return modified;
 }
 
+std::vector<ir::Function*> Pass::GetFunctionsToProcess() {
+  std::vector<ir::Function*> functions;
+  for (auto& fn : *get_module()) functions.push_back(&fn);
+  return functions;
+}
+
+std::vector<ir::Function*> Pass::GetEntryPointCallTree() {
+  std::vector<ir::Function*> functions;
+  ProcessFunction collect = [&functions](ir::Function* fn) {
+    functions.push_back(fn);
+    return false;
+  };
+  ProcessEntryPointCallTree(collect, get_module());
+  return functions;
+}
+
+Pass::ProcessFunction Pass::FilterFunctions(ProcessFunction pfn) {
+  tracks_changed_functions_ = true;
+  return [this, pfn](ir::Function* fn) {
+    if (function_filter_ && !function_filter_(fn)) return false;
+    if (!pfn(fn)) return false;
+    changed_functions_.insert(fn->result_id());
+    return true;
+  };
+}
+
+Pass::Status Pass::ProcessFunctionLocalPass(ir::IRContext* c) {
+  tracks_changed_functions_ = true;
+  if (!InitializeFunctionLocal(c)) return Status::SuccessWithoutChange;
+
+  std::vector<ir::Function*> functions;
+  for (ir::Function* fn : GetFunctionsToProcess()) {
+    if (!function_filter_ || function_filter_(fn)) functions.push_back(fn);
+  }
+
+  bool modified = false;
+  if (c->thread_count() <= 1 || functions.size() <= 1 ||
+      !ProcessFunctionsInParallel(functions, &modified)) {
+    for (ir::Function* fn : functions) {
+      if (ProcessFunctionLocal(fn)) {
+        changed_functions_.insert(fn->result_id());
+        modified = true;
+      }
+    }
+  }
+  return modified ? Status::SuccessWithChange : Status::SuccessWithoutChange;
+}
+
+bool Pass::ProcessFunctionsInParallel(
+    const std::vector<ir::Function*>& functions, bool* modified) {
+  ir::IRContext* c = context();
+  ir::Module* module = get_module();
+  const uint32_t bound = module->IdBound();
+
+  std::unordered_map<const ir::Function*, size_t> function_index;
+  for (auto& fn : *module) {
+    function_index.insert({&fn, function_index.size()});
+  }
+
+  // Split the functions into contiguous groups, one per thread.
+  const size_t num_groups =
+      std::min(functions.size(), static_cast<size_t>(c->thread_count()));
+  std::vector<FunctionGroup> groups(num_groups);
+  for (size_t g = 0; g < num_groups; ++g) {
+    const size_t first = g * functions.size() / num_groups;
+    const size_t last = (g + 1) * functions.size() / num_groups;
+    for (size_t i = first; i < last; ++i) {
+      groups[g].originals.push_back(functions[i]);
+      groups[g].indices.push_back(function_index.at(functions[i]));
+    }
+  }
+
+  // Copying only reads |module|, and each group has its own context and pass,
+  // so the groups don't share anything that changes.
+  spvutils::ParallelFor(num_groups, c->thread_count(), [&](size_t g) {
+    FunctionGroup& group = groups[g];
+    CopyModule(*module, c->target_env(), consumer(), &group);
+    std::unique_ptr<Pass> pass = CloneFunctionLocal();
+    pass->SetMessageConsumer(consumer());
+    group.initialized = pass->InitializeFunctionLocal(group.context.get());
+    if (!group.initialized) return;
+    for (ir::Function* fn : group.functions) {
+      if (pass->ProcessFunctionLocal(fn)) {
+        group.changed.push_back(fn->result_id());
+        group.modified = true;
+      }
+    }
+  });
+
+  // Check that every group can be merged before changing the module.
+  const std::vector<uint32_t> fixed_words = GetFixedSectionWords(*module);
+  std::vector<uint32_t> types_values_words;
+  AppendWords(module->types_values(), &types_values_words);
+  std::vector<bool> removed_debug2(groups[0].debug2_ids.size(), false);
+  std::vector<bool> removed_annotations(groups[0].annotation_ids.size(),
+                                        false);
+  for (FunctionGroup& group : groups) {
+    if (!group.initialized ||
+        !CheckGroup(fixed_words, types_values_words, &group, &removed_debug2,
+                    &removed_annotations)) {
+      return false;
+    }
+  }
+
+  // Hand out the ids the groups took in the order serial processing takes
+  // them, skipping the ids of types and constants that repeat earlier ones.
+  uint32_t next_id = bound;
+  std::map<std::vector<uint32_t>, uint32_t> merged_values;
+  std::vector<uint32_t> key;
+  for (FunctionGroup& group : groups) {
+    group.remap.assign(group.context->module()->IdBound() - bound, 0);
+    for (const ir::Instruction* inst : group.new_values) {
+      bool repeated = false;
+      if ((ir::IsTypeInst(inst->opcode()) ||
+           ir::IsConstantInst(inst->opcode())) &&
+          GetValueKey(*inst, bound, group.remap, &key)) {
+        auto it = merged_values.find(key);
+        if (it != merged_values.end()) {
+          group.remap[inst->result_id() - bound] = it->second;
+          repeated = true;
+        }
+      }
+      group.repeated.push_back(repeated);
+    }
+    for (uint32_t& id : group.remap) {
+      if (id == 0) id = next_id++;
+    }
+    for (size_t i = 0; i < group.new_values.size(); ++i) {
+      const ir::Instruction* inst = group.new_values[i];
+      if (!group.repeated[i] && (ir::IsTypeInst(inst->opcode()) ||
+                                 ir::IsConstantInst(inst->opcode()))) {
+        GetValueKey(*inst, bound, group.remap, &key);
+        merged_values.insert({key, group.remap[inst->result_id() - bound]});
+      }
+    }
+  }
+
+  // Merge the groups.  The analyses are rebuilt from the merged module.
+  c->InvalidateAnalysesExceptFor(ir::IRContext::kAnalysisNone);
+  std::vector<ir::Instruction*> to_kill;
+  size_t i = 0;
+  for (auto& inst : module->debugs2()) {
+    if (removed_debug2[i++]) to_kill.push_back(&inst);
+  }
+  i = 0;
+  for (auto& inst : module->annotations()) {
+    if (removed_annotations[i++]) to_kill.push_back(&inst);
+  }
+  for (ir::Instruction* inst : to_kill) c->KillInst(inst);
+
+  *modified = !to_kill.empty();
+  for (FunctionGroup& group : groups) {
+    for (size_t j = 0; j < group.new_values.size(); ++j) {
+      if (group.repeated[j]) continue;
+      std::unique_ptr<ir::Instruction> value(group.new_values[j]->Clone(c));
+      RemapIds(value.get(), bound, group.remap);
+      module->AddGlobalValue(std::move(value));
+    }
+    for (size_t j = 0; j < group.functions.size(); ++j) {
+      std::unique_ptr<ir::Function> fn(group.functions[j]->Clone(c));
+      fn->ForEachInst([bound, &group](ir::Instruction* inst) {
+        RemapIds(inst, bound, group.remap);
+      });
+      module->SetFunction(group.indices[j], std::move(fn));
+    }
+    changed_functions_.insert(group.changed.begin(), group.changed.end());
+    *modified = *modified || group.modified || !group.new_values.empty();
+  }
+  module->SetIdBound(next_id);
+  c->ResetTypeAndConstantManagers();
+  return true;
+}
+
 Pass::Status Pass::Run(ir::IRContext* ctx) {
+  changed_functions_.clear();
+  tracks_changed_functions_ = false;
   Pass::Status status = Process(ctx);
   if (status == Status::SuccessWithChange) {
     ctx->InvalidateAnalysesExceptFor(GetPreservedAnalyses());
@@ -17,10 +17,12 @@
 
 #include <algorithm>
 #include <map>
+#include <memory>
 #include <queue>
 #include <unordered_map>
 #include <unordered_set>
 #include <utility>
+#include <vector>
 
 #include "basic_block.h"
 #include "def_use_manager.h"
@@ -46,6 +48,7 @@ class Pass {
   };
 
   using ProcessFunction = std::function<bool(ir::Function*)>;
+  using FunctionFilter = std::function<bool(const ir::Function*)>;
 
   // Constructs a new pass.
   //
@@ -117,6 +120,23 @@ class Pass {
       const std::unordered_map<uint32_t, ir::Function*>& id2function,
       std::queue<uint32_t>* roots);
 
+  // Restricts the passes to changing the bodies of the functions for which
+  // |filter| returns true.  Only the walks that transform functions honour
+  // it, through FilterFunctions() and ProcessFunctionLocalPass().  The walks
+  // above still visit every function, so that what a pass finds to be live
+  // does not depend on the filter.  If |filter| is null, which is the
+  // default, every function is processed.
+  void SetFunctionFilter(FunctionFilter filter) {
+    function_filter_ = std::move(filter);
+  }
+
+  // Returns the ids of the functions whose bodies the last Run() changed, or
+  // null if the pass does not track them.  A pass tracks them if it uses
+  // FilterFunctions() or ProcessFunctionLocalPass().
+  const std::unordered_set<uint32_t>* changed_functions() const {
+    return tracks_changed_functions_ ? &changed_functions_ : nullptr;
+  }
+
   // Run the pass on the given |module|. Returns Status::Failure if errors occur
   // when
   // processing. Returns the corresponding Status::Success if processing is
@@ -140,6 +160,68 @@ class Pass {
   // succesful to indicate whether changes are made to the module.
   virtual Status Process(ir::IRContext* context) = 0;
 
+  // Function-local passes
+  //
+  // A pass is function-local if processing a function only changes the body
+  // of that function, and outside of it only adds types, constants and other
+  // global values, and removes names and decorations.  New types and
+  // constants must be found or created by value, the way the type and
+  // constant managers do, and what the pass does to a function must not
+  // depend on what it did to other functions.
+  //
+  // Such a pass implements the four methods below, and its Process() returns
+  // ProcessFunctionLocalPass().  If the context allows more than one thread,
+  // see IRContext::SetThreadCount(), the functions are then split into groups
+  // that are each processed by a new instance of the pass, in a copy of the
+  // module that only has the functions of the group.  The groups are merged
+  // back in the order the functions are processed serially: new ids are
+  // handed out in that order, and a new type or constant that repeats one
+  // made for an earlier function is replaced with it.  This gives the module
+  // that processing the functions one after the other gives.  If a group
+  // changed the module in any other way, it is processed again serially.
+  //
+  // Since a copy only has the functions of its group, the def-use manager of
+  // the copy only sees the uses of a global value that are in those
+  // functions.  Processing a function must not depend on its uses elsewhere,
+  // such as whether another function stores to a private variable.  A pass
+  // that needs them returns false from InitializeFunctionLocal() when
+  // IRContext::has_all_functions() is false, and is then run serially.
+
+  // Returns a new instance of this pass, with the same options, if the pass
+  // is function-local.  Returns nullptr otherwise, which is the default.
+  virtual std::unique_ptr<Pass> CloneFunctionLocal() const { return nullptr; }
+
+  // Prepares a function-local pass for processing the functions of |c|.
+  // Returns false if the pass does not apply to the module.
+  virtual bool InitializeFunctionLocal(ir::IRContext* c) {
+    InitializeProcessing(c);
+    return true;
+  }
+
+  // Returns the functions a function-local pass processes, in the order it
+  // processes them.  The default is every function, in module order.
+  virtual std::vector<ir::Function*> GetFunctionsToProcess();
+
+  // Processes |func| for a function-local pass.  Returns true if it changed
+  // the module.
+  virtual bool ProcessFunctionLocal(ir::Function*) { return false; }
+
+  // Runs a function-local pass on |c|, as described above.  The functions the
+  // function filter rejects are not processed.
+  Status ProcessFunctionLocalPass(ir::IRContext* c);
+
+  // Returns a ProcessFunction that applies |pfn| to the functions the
+  // function filter accepts, and returns false for the others.  Passes wrap
+  // the ProcessFunction that transforms functions with it before handing it
+  // to a call tree walk.  A pass that uses it must only change function
+  // bodies through the wrapped ProcessFunction, which records the functions
+  // it changes for changed_functions().
+  ProcessFunction FilterFunctions(ProcessFunction pfn);
+
+  // Returns the functions in the call trees rooted at the entry points, in
+  // the order ProcessEntryPointCallTree() visits them.
+  std::vector<ir::Function*> GetEntryPointCallTree();
+
   // Return type id for |ptrInst|'s pointee
   uint32_t GetPointeeTypeId(const ir::Instruction* ptrInst) const;
 
@@ -149,6 +231,27 @@ class Pass {
  private:
   MessageConsumer consumer_;  // Message consumer.
 
+  // Processes |functions| of a function-local pass in groups on separate
+  // threads, and merges the results into the module.  Returns false, without
+  // changing the module, if a group changed the module in a way that can't
+  // be merged, or the pass did not apply to a group.  Otherwise sets
+  // |modified| to whether the module changed.
+  //
+  // Each group is processed in a copy of the module that only has the
+  // functions of the group, and whose context says so through
+  // has_all_functions().  Analyses of the copy that look at the uses of
+  // global values, or at other functions, only see part of the module.
+  bool ProcessFunctionsInParallel(const std::vector<ir::Function*>& functions,
+                                  bool* modified);
+
+  // The functions the pass may change, if not null.
+  FunctionFilter function_filter_;
+
+  // The ids of the functions the last Run() changed, and whether the pass
+  // tracks them.
+  std::unordered_set<uint32_t> changed_functions_;
+  bool tracks_changed_functions_;
+
   // The context that this pass belongs to.
   ir::IRContext* context_;
 };
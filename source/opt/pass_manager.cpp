@@ -14,16 +14,261 @@
 
 #include "pass_manager.h"
 
+#include <algorithm>
+#include <iomanip>
 #include <iostream>
+#include <unordered_map>
+#include <unordered_set>
 #include <vector>
 
 #include "ir_context.h"
 #include "spirv-tools/libspirv.hpp"
+#include "util/timer.h"
 
 namespace spvtools {
 
 namespace opt {
 
+namespace {
+
+const uint32_t kNumAnalyses = ir::IRContext::kNumAnalyses;
+
+// The resources used by one pass, as shown in the time report.
+struct PassMeasurement {
+  const char* name;
+  double wall_seconds;
+  double cpu_seconds;
+  uint32_t instructions_before;
+  uint32_t instructions_after;
+  uint32_t id_bound_before;
+  uint32_t id_bound_after;
+  uint64_t peak_rss_delta_kb;
+  // How often each analysis was built and invalidated during the pass.
+  uint32_t built[kNumAnalyses];
+  uint32_t invalidated[kNumAnalyses];
+};
+
+// Returns the number of instructions in |module|, including debug line
+// instructions.
+uint32_t CountInstructions(const ir::Module& module) {
+  uint32_t count = 0;
+  module.ForEachInst([&count](const ir::Instruction*) { ++count; }, true);
+  return count;
+}
+
+// Returns the id bound of |module|.  Passes are not required to keep the bound
+// in the header up to date, so this also looks at the ids in use.
+uint32_t CurrentIdBound(ir::Module* module) {
+  return std::max(module->IdBound(), module->ComputeIdBound());
+}
+
+// Writes the analyses counted in |counts| to |out| as a comma separated list
+// of names, with a repeat count for those that occur more than once.
+void WriteAnalysisList(std::ostream* out, const uint32_t* counts) {
+  bool first = true;
+  for (uint32_t i = 0; i < kNumAnalyses; ++i) {
+    if (!counts[i]) continue;
+    *out << (first ? "" : ", ") << ir::IRContext::GetAnalysisName(i);
+    if (counts[i] > 1) *out << " x" << counts[i];
+    first = false;
+  }
+  if (first) *out << "none";
+}
+
+// A summary of the contents of a module, to find out what a pass changed.
+struct ModuleFingerprint {
+  // A hash of the instructions outside of the functions.
+  uint64_t globals;
+  // A hash of the instructions of each function, by function id.
+  std::unordered_map<uint32_t, uint64_t> functions;
+};
+
+// The FNV-1a offset basis and prime for 64-bit hashes.
+const uint64_t kHashOffset = 14695981039346656037ull;
+const uint64_t kHashPrime = 1099511628211ull;
+
+// Returns |hash| with the opcode and operands of |inst| mixed in.
+uint64_t HashInstruction(uint64_t hash, const ir::Instruction& inst) {
+  hash = (hash ^ inst.opcode()) * kHashPrime;
+  for (uint32_t i = 0; i < inst.NumOperands(); ++i) {
+    const ir::Operand& operand = inst.GetOperand(i);
+    hash = (hash ^ operand.words.size()) * kHashPrime;
+    for (uint32_t word : operand.words) hash = (hash ^ word) * kHashPrime;
+  }
+  return hash;
+}
+
+// Returns the hash of the instructions of |module| outside of the functions.
+uint64_t HashGlobals(const ir::Module& module) {
+  uint64_t hash = kHashOffset;
+  auto hash_section = [&hash](
+      const ir::IteratorRange<ir::Module::const_inst_iterator>& section) {
+    for (const ir::Instruction& inst : section)
+      hash = HashInstruction(hash, inst);
+  };
+  hash_section(module.capabilities());
+  hash_section(module.extensions());
+  hash_section(module.ext_inst_imports());
+  hash_section(module.entry_points());
+  hash_section(module.execution_modes());
+  hash_section(module.debugs1());
+  hash_section(module.debugs2());
+  hash_section(module.debugs3());
+  hash_section(module.annotations());
+  hash_section(module.types_values());
+  return hash;
+}
+
+// Returns the hash of the instructions of |func|.
+uint64_t HashFunction(const ir::Function& func) {
+  uint64_t hash = kHashOffset;
+  func.ForEachInst(
+      [&hash](const ir::Instruction* inst) {
+        hash = HashInstruction(hash, *inst);
+      },
+      true);
+  return hash;
+}
+
+// Returns the fingerprint of |module|.
+ModuleFingerprint ComputeFingerprint(const ir::Module& module) {
+  ModuleFingerprint fingerprint;
+  fingerprint.globals = HashGlobals(module);
+  for (const auto& func : module) {
+    fingerprint.functions[func.result_id()] = HashFunction(func);
+  }
+  return fingerprint;
+}
+
+// Adds to |changed| the ids of the functions whose fingerprint differs
+// between |before| and |after|.  Returns true if something outside of the
+// functions differs, which includes adding or removing a function.
+bool DiffFingerprints(const ModuleFingerprint& before,
+                      const ModuleFingerprint& after,
+                      std::unordered_set<uint32_t>* changed) {
+  bool globals_changed = before.globals != after.globals ||
+                         before.functions.size() != after.functions.size();
+  for (const auto& entry : after.functions) {
+    const auto iter = before.functions.find(entry.first);
+    if (iter == before.functions.end()) {
+      globals_changed = true;
+    } else if (iter->second != entry.second) {
+      changed->insert(entry.first);
+    }
+  }
+  return globals_changed;
+}
+
+// Updates |fingerprint| to the contents of |module| after a pass changed it,
+// and adds to |changed| the ids of the functions that differ.  If |reported|
+// is not null, it has the ids of the only functions the pass changed, and
+// only those functions and the global sections are hashed again.  Otherwise
+// the whole module is.  Returns true if something outside of the functions
+// differs, which includes adding or removing a function.
+bool UpdateFingerprint(const ir::Module& module,
+                       const std::unordered_set<uint32_t>* reported,
+                       ModuleFingerprint* fingerprint,
+                       std::unordered_set<uint32_t>* changed) {
+  // A pass that reports its changes doesn't add or remove functions, but
+  // check it, as a function missing from |fingerprint| would be missed.
+  bool same_functions = reported != nullptr;
+  if (same_functions) {
+    size_t num_functions = 0;
+    for (const auto& func : module) {
+      ++num_functions;
+      if (!fingerprint->functions.count(func.result_id())) {
+        same_functions = false;
+      }
+    }
+    same_functions =
+        same_functions && num_functions == fingerprint->functions.size();
+  }
+  if (!same_functions) {
+    ModuleFingerprint new_fingerprint = ComputeFingerprint(module);
+    const bool globals_changed =
+        DiffFingerprints(*fingerprint, new_fingerprint, changed);
+    *fingerprint = std::move(new_fingerprint);
+    return globals_changed;
+  }
+
+  const uint64_t globals = HashGlobals(module);
+  const bool globals_changed = globals != fingerprint->globals;
+  fingerprint->globals = globals;
+  for (const auto& func : module) {
+    if (!reported->count(func.result_id())) continue;
+    const uint64_t hash = HashFunction(func);
+    uint64_t& old_hash = fingerprint->functions[func.result_id()];
+    if (old_hash != hash) changed->insert(func.result_id());
+    old_hash = hash;
+  }
+  return globals_changed;
+}
+
+// Writes |measurements| to |out| in human readable form, followed by
+// |stats| if that is not null.
+void WriteTimeReportText(std::ostream* out,
+                         const std::vector<PassMeasurement>& measurements,
+                         const PassManager::IterationStats* stats) {
+  double total_wall_seconds = 0;
+  double total_cpu_seconds = 0;
+  uint64_t total_peak_rss_delta_kb = 0;
+  for (const auto& m : measurements) {
+    *out << "Pass " << m.name << ":\n"
+         << "  wall time: " << m.wall_seconds << " s\n"
+         << "  CPU time: " << m.cpu_seconds << " s\n"
+         << "  instructions: " << m.instructions_before << " -> "
+         << m.instructions_after << "\n"
+         << "  id bound: " << m.id_bound_before << " -> " << m.id_bound_after
+         << "\n"
+         << "  peak RSS: +" << m.peak_rss_delta_kb << " KB\n"
+         << "  analyses built: ";
+    WriteAnalysisList(out, m.built);
+    *out << "\n  analyses invalidated: ";
+    WriteAnalysisList(out, m.invalidated);
+    *out << "\n";
+    total_wall_seconds += m.wall_seconds;
+    total_cpu_seconds += m.cpu_seconds;
+    total_peak_rss_delta_kb += m.peak_rss_delta_kb;
+  }
+  *out << "Total for " << measurements.size()
+       << " passes: wall time: " << total_wall_seconds
+       << " s, CPU time: " << total_cpu_seconds << " s, peak RSS: +"
+       << total_peak_rss_delta_kb << " KB" << std::endl;
+  if (stats) {
+    *out << "Iterations: " << stats->iterations << ", passes run: "
+         << stats->pass_runs << ", passes skipped: "
+         << stats->skipped_pass_runs
+         << (stats->converged ? ", converged" : ", not converged")
+         << std::endl;
+  }
+}
+
+// Writes |measurements| to |out| as comma separated values, with a header
+// row and one row per pass.
+void WriteTimeReportCsv(std::ostream* out,
+                        const std::vector<PassMeasurement>& measurements) {
+  *out << "pass,wall_seconds,cpu_seconds,instructions_before,"
+          "instructions_after,id_bound_before,id_bound_after,"
+          "peak_rss_delta_kb";
+  for (uint32_t i = 0; i < kNumAnalyses; ++i)
+    *out << ",built_" << ir::IRContext::GetAnalysisName(i);
+  for (uint32_t i = 0; i < kNumAnalyses; ++i)
+    *out << ",invalidated_" << ir::IRContext::GetAnalysisName(i);
+  *out << "\n";
+  for (const auto& m : measurements) {
+    *out << m.name << "," << m.wall_seconds << "," << m.cpu_seconds << ","
+         << m.instructions_before << "," << m.instructions_after << ","
+         << m.id_bound_before << "," << m.id_bound_after << ","
+         << m.peak_rss_delta_kb;
+    for (uint32_t i = 0; i < kNumAnalyses; ++i) *out << "," << m.built[i];
+    for (uint32_t i = 0; i < kNumAnalyses; ++i) *out << "," << m.invalidated[i];
+    *out << "\n";
+  }
+  out->flush();
+}
+
+}  // anonymous namespace
+
 Pass::Status PassManager::Run(ir::IRContext* context) {
   auto status = Pass::Status::SuccessWithoutChange;
 
@@ -41,13 +286,119 @@ Pass::Status PassManager::Run(ir::IRContext* context) {
     }
   };
 
-  for (const auto& pass : passes_) {
-    print_disassembly("; IR before pass ", pass.get());
+  // The measurements of the passes run so far, if there is a time report.
+  std::vector<PassMeasurement> measurements;
+  const bool iterate = max_iterations_ > 1;
+  auto write_time_report = [&measurements, iterate, this]() {
+    if (!time_report_stream_) return;
+    std::ostream* out = time_report_stream_;
+    const auto old_flags = out->flags();
+    const auto old_precision = out->precision();
+    *out << std::fixed << std::setprecision(6);
+    if (time_report_format_ == Optimizer::TimeReportFormat::kCsv)
+      WriteTimeReportCsv(out, measurements);
+    else
+      WriteTimeReportText(out, measurements,
+                          iterate ? &iteration_stats_ : nullptr);
+    out->flags(old_flags);
+    out->precision(old_precision);
+  };
+
+  // Runs |pass|, measuring it if there is a time report.
+  auto run_pass = [&measurements, &context, this](Pass* pass) {
+    if (!time_report_stream_) return pass->Run(context);
+
+    PassMeasurement m = {};
+    m.name = pass->name();
+    m.instructions_before = CountInstructions(*context->module());
+    m.id_bound_before = CurrentIdBound(context->module());
+    const auto counts_before = context->analysis_counts();
+    const auto usage_before = spvutils::GetResourceUsage();
+
     const auto one_status = pass->Run(context);
-    if (one_status == Pass::Status::Failure) return one_status;
-    if (one_status == Pass::Status::SuccessWithChange) status = one_status;
+
+    const auto usage_after = spvutils::GetResourceUsage();
+    const auto& counts_after = context->analysis_counts();
+    m.wall_seconds = usage_after.wall_seconds - usage_before.wall_seconds;
+    m.cpu_seconds = usage_after.cpu_seconds - usage_before.cpu_seconds;
+    m.peak_rss_delta_kb = usage_after.peak_rss_kb - usage_before.peak_rss_kb;
+    for (uint32_t i = 0; i < kNumAnalyses; ++i) {
+      m.built[i] = counts_after.built[i] - counts_before.built[i];
+      m.invalidated[i] =
+          counts_after.invalidated[i] - counts_before.invalidated[i];
+    }
+    m.instructions_after = CountInstructions(*context->module());
+    m.id_bound_after = CurrentIdBound(context->module());
+    measurements.push_back(m);
+    return one_status;
+  };
+
+  // The changes made since each pass last ran: the ids of the functions that
+  // changed, and whether something outside of the functions changed.  These
+  // are only tracked if the passes may run more than once.
+  struct PendingChanges {
+    std::unordered_set<uint32_t> functions;
+    bool globals = false;
+  };
+  std::vector<PendingChanges> pending(passes_.size());
+  ModuleFingerprint fingerprint;
+  if (iterate) fingerprint = ComputeFingerprint(*context->module());
+
+  iteration_stats_ = IterationStats();
+  for (uint32_t iteration = 0; iteration < max_iterations_; ++iteration) {
+    ++iteration_stats_.iterations;
+    for (size_t i = 0; i < passes_.size(); ++i) {
+      Pass* pass = passes_[i].get();
+      PendingChanges& changes = pending[i];
+      if (iteration > 0) {
+        if (!changes.globals && changes.functions.empty()) {
+          ++iteration_stats_.skipped_pass_runs;
+          continue;
+        }
+        if (!changes.globals) {
+          pass->SetFunctionFilter([&changes](const ir::Function* func) {
+            return changes.functions.count(func->result_id()) != 0;
+          });
+        }
+      }
+
+      print_disassembly("; IR before pass ", pass);
+      const auto one_status = run_pass(pass);
+      pass->SetFunctionFilter(nullptr);
+      ++iteration_stats_.pass_runs;
+      changes.functions.clear();
+      changes.globals = false;
+
+      if (one_status == Pass::Status::Failure) {
+        write_time_report();
+        return one_status;
+      }
+      if (one_status != Pass::Status::SuccessWithChange) continue;
+      status = one_status;
+
+      // Let the other passes know what this pass changed.
+      if (!iterate) continue;
+      std::unordered_set<uint32_t> changed_functions;
+      const bool globals_changed =
+          UpdateFingerprint(*context->module(), pass->changed_functions(),
+                            &fingerprint, &changed_functions);
+      for (size_t j = 0; j < passes_.size(); ++j) {
+        if (j == i) continue;
+        pending[j].functions.insert(changed_functions.begin(),
+                                    changed_functions.end());
+        pending[j].globals = pending[j].globals || globals_changed;
+      }
+    }
+
+    iteration_stats_.converged =
+        std::none_of(pending.begin(), pending.end(),
+                     [](const PendingChanges& changes) {
+                       return changes.globals || !changes.functions.empty();
+                     });
+    if (!iterate || iteration_stats_.converged) break;
   }
   print_disassembly("; IR after last pass", nullptr);
+  write_time_report();
 
   // Set the Id bound in the header in case a pass forgot to do so.
   //
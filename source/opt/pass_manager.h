@@ -25,6 +25,7 @@
 
 #include "ir_context.h"
 #include "spirv-tools/libspirv.hpp"
+#include "spirv-tools/optimizer.hpp"
 
 namespace spvtools {
 namespace opt {
@@ -34,12 +35,30 @@ namespace opt {
 // to run on a module. Passes are executed in the exact order of addition.
 class PassManager {
  public:
+  // Statistics about the iterations made by the last call to Run().
+  struct IterationStats {
+    // The number of times the list of passes was walked.
+    uint32_t iterations;
+    // The number of passes run, and the number skipped because the module did
+    // not change since they last ran.
+    uint32_t pass_runs;
+    uint32_t skipped_pass_runs;
+    // True if the last iteration left no pass with changes to look at.
+    bool converged;
+  };
+
   // Constructs a pass manager.
   //
   // The constructed instance will have an empty message consumer, which just
   // ignores all messages from the library. Use SetMessageConsumer() to supply
   // one if messages are of concern.
-  PassManager() : consumer_(nullptr), print_all_stream_(nullptr) {}
+  PassManager()
+      : consumer_(nullptr),
+        print_all_stream_(nullptr),
+        time_report_stream_(nullptr),
+        time_report_format_(Optimizer::TimeReportFormat::kText),
+        max_iterations_(1),
+        iteration_stats_() {}
 
   // Sets the message consumer to the given |consumer|.
   void SetMessageConsumer(MessageConsumer c) { consumer_ = std::move(c); }
@@ -66,9 +85,30 @@ class PassManager {
   // corresponding Status::Success if processing is succesful to indicate
   // whether changes are made to the module.
   //
+  // If more than one iteration is allowed, see SetMaxIterations(), the passes
+  // are then run again until none of them changes the module.
+  //
   // After running all the passes, they are removed from the list.
   Pass::Status Run(ir::IRContext* context);
 
+  // Sets the number of times Run() may walk the list of passes.  After the
+  // first walk, which runs every pass, a pass is only run again if other
+  // passes changed the module since it last ran, and then only on the
+  // functions they changed, unless they changed something outside of the
+  // functions.  The walks stop once no pass has changes to look at, or after
+  // |max_iterations| walks.  The default is 1, which runs each pass once.
+  PassManager& SetMaxIterations(uint32_t max_iterations) {
+    max_iterations_ = max_iterations ? max_iterations : 1;
+    return *this;
+  }
+
+  // Returns the number of times Run() may walk the list of passes.
+  uint32_t max_iterations() const { return max_iterations_; }
+
+  // Returns the statistics of the last call to Run().  Convergence is only
+  // tracked when more than one iteration is allowed.
+  const IterationStats& iteration_stats() const { return iteration_stats_; }
+
   // Sets the option to print the disassembly before each pass and after the
   // last pass.   Output is written to |out| if that is not null.  No output
   // is generated if |out| is null.
@@ -77,6 +117,16 @@ class PassManager {
     return *this;
   }
 
+  // Sets the option to measure the resources used by each pass, and to write
+  // a report of them in |format| to |out| after the last pass.  No report is
+  // generated if |out| is null.
+  PassManager& SetTimeReport(std::ostream* out,
+                             Optimizer::TimeReportFormat format) {
+    time_report_stream_ = out;
+    time_report_format_ = format;
+    return *this;
+  }
+
  private:
   // Consumer for messages.
   MessageConsumer consumer_;
@@ -85,6 +135,15 @@ class PassManager {
   // The output stream to write disassembly to before each pass, and after
   // the last pass.  If this is null, no output is generated.
   std::ostream* print_all_stream_;
+  // The output stream to write the time report to after the last pass.  If
+  // this is null, the passes are not measured.
+  std::ostream* time_report_stream_;
+  // The format of the time report.
+  Optimizer::TimeReportFormat time_report_format_;
+  // The number of times Run() may walk the list of passes.
+  uint32_t max_iterations_;
+  // The statistics of the last call to Run().
+  IterationStats iteration_stats_;
 };
 
 inline void PassManager::AddPass(std::unique_ptr<Pass> pass) {
@@ -14,26 +14,49 @@
 
 #include "propagator.h"
 
+#include <algorithm>
+
 namespace spvtools {
 namespace opt {
 
-void SSAPropagator::AddControlEdge(const Edge& edge) {
-  ir::BasicBlock* dest_bb = edge.dest;
+const uint32_t SSAPropagator::kNoSlot;
+const uint32_t SSAPropagator::kNoEdge;
+
+uint32_t SSAPropagator::GetSlot(const ir::Instruction* inst) const {
+  if (inst == nullptr) return kNoSlot;
+  // Unique ids below |first_unique_id_| wrap around to large offsets.
+  const uint32_t offset = inst->unique_id() - first_unique_id_;
+  if (offset < dense_slots_.size()) return dense_slots_[offset];
+  if (sparse_slots_.empty()) return kNoSlot;
+  const auto it = sparse_slots_.find(inst->unique_id());
+  return it == sparse_slots_.end() ? kNoSlot : it->second;
+}
+
+uint32_t SSAPropagator::FindEdge(uint32_t source, uint32_t dest) const {
+  for (uint32_t e = succ_begin_[source]; e < succ_begin_[source + 1]; ++e) {
+    if (edge_dest_[e] == dest) return e;
+  }
+  return kNoEdge;
+}
+
+void SSAPropagator::AddControlEdge(uint32_t edge) {
+  const uint32_t dest = edge_dest_[edge];
 
   // Refuse to add the exit block to the work list.
-  if (dest_bb == ctx_->cfg()->pseudo_exit_block()) {
+  if (dest == block_list_.size() - 1) {
     return;
   }
 
   // Try to mark the edge executable.  If it was already in the set of
   // executable edges, do nothing.
-  if (!MarkEdgeExecutable(edge)) {
+  if (executable_edges_[edge]) {
     return;
   }
+  executable_edges_[edge] = true;
 
   // If the edge had not already been marked executable, add the destination
   // basic block to the work list.
-  blocks_.push(dest_bb);
+  blocks_.push_back(dest);
 }
 
 void SSAPropagator::AddSSAEdges(ir::Instruction* instr) {
@@ -46,60 +69,66 @@ void SSAPropagator::AddSSAEdges(ir::Instruction* instr) {
       instr->result_id(), [this](ir::Instruction* use_instr) {
         // If the basic block for |use_instr| has not been simulated yet, do
         // nothing.  The instruction |use_instr| will be simulated next time the
-        // block is scheduled.
-        if (!BlockHasBeenSimulated(ctx_->get_instr_block(use_instr))) {
+        // block is scheduled.  Users outside of the function, like
+        // decorations, are never simulated.
+        const InstState* state = GetState(use_instr);
+        if (state == nullptr || !simulated_blocks_[state->block]) {
           return;
         }
 
-        if (ShouldSimulateAgain(use_instr)) {
-          ssa_edge_uses_.push(use_instr);
+        if (state->simulate_again) {
+          ssa_edge_uses_.push_back(use_instr);
         }
       });
 }
 
 bool SSAPropagator::IsPhiArgExecutable(ir::Instruction* phi, uint32_t i) const {
-  ir::BasicBlock* phi_bb = ctx_->get_instr_block(phi);
+  const InstState* phi_state = GetState(phi);
 
   uint32_t in_label_id = phi->GetSingleWordOperand(i + 1);
   ir::Instruction* in_label_instr = get_def_use_mgr()->GetDef(in_label_id);
-  ir::BasicBlock* in_bb = ctx_->get_instr_block(in_label_instr);
+  const InstState* in_state = GetState(in_label_instr);
 
-  return IsEdgeExecutable(Edge(in_bb, phi_bb));
+  if (phi_state == nullptr || in_state == nullptr) return false;
+  const uint32_t edge = FindEdge(in_state->block, phi_state->block);
+  return edge != kNoEdge && executable_edges_[edge];
 }
 
 bool SSAPropagator::SetStatus(ir::Instruction* inst, PropStatus status) {
-  bool has_old_status = false;
-  PropStatus old_status = kVarying;
-  if (HasStatus(inst)) {
-    has_old_status = true;
-    old_status = Status(inst);
-  }
+  InstState* state = GetState(inst);
+  assert(state && "Instruction is not in the function being simulated.");
+  return UpdateStatus(state, status);
+}
 
-  assert((!has_old_status || old_status <= status) &&
+bool SSAPropagator::UpdateStatus(InstState* state, PropStatus status) {
+  assert((!state->has_status || state->status <= status) &&
          "Invalid lattice transition");
 
-  bool status_changed = !has_old_status || (old_status != status);
-  if (status_changed) statuses_[inst] = status;
+  bool status_changed = !state->has_status || (state->status != status);
+  state->has_status = true;
+  state->status = status;
 
   return status_changed;
 }
 
 bool SSAPropagator::Simulate(ir::Instruction* instr) {
   bool changed = false;
+  InstState* state = GetState(instr);
+  assert(state && "Instruction is not in the function being simulated.");
 
   // Don't bother visiting instructions that should not be simulated again.
-  if (!ShouldSimulateAgain(instr)) {
+  if (!state->simulate_again) {
     return changed;
   }
 
   ir::BasicBlock* dest_bb = nullptr;
   PropStatus status = visit_fn_(instr, &dest_bb);
-  bool status_changed = SetStatus(instr, status);
+  bool status_changed = UpdateStatus(state, status);
 
   if (status == kVarying) {
     // The statement produces a varying result, add it to the list of statements
     // not to simulate anymore and add its SSA def-use edges for simulation.
-    DontSimulateAgain(instr);
+    state->simulate_again = false;
     if (status_changed) {
       AddSSAEdges(instr);
     }
@@ -107,8 +136,8 @@ bool SSAPropagator::Simulate(ir::Instruction* instr) {
     // If |instr| is a block terminator, add all the control edges out of its
     // block.
     if (instr->IsBlockTerminator()) {
-      ir::BasicBlock* block = ctx_->get_instr_block(instr);
-      for (const auto& e : bb_succs_.at(block)) {
+      for (uint32_t e = succ_begin_[state->block];
+           e < succ_begin_[state->block + 1]; ++e) {
         AddControlEdge(e);
       }
     }
@@ -123,7 +152,9 @@ bool SSAPropagator::Simulate(ir::Instruction* instr) {
     // If there are multiple outgoing control flow edges and we know which one
     // will be taken, add the destination block to the CFG work list.
     if (dest_bb) {
-      AddControlEdge(Edge(ctx_->get_instr_block(instr), dest_bb));
+      const uint32_t edge = FindEdge(state->block, GetBlockIndex(dest_bb));
+      assert(edge != kNoEdge && "Destination is not a successor block.");
+      AddControlEdge(edge);
     }
     changed = true;
   }
@@ -166,72 +197,122 @@ bool SSAPropagator::Simulate(ir::Instruction* instr) {
   }
 
   if (!has_operands_to_simulate) {
-    DontSimulateAgain(instr);
+    state->simulate_again = false;
   }
 
   return changed;
 }
 
-bool SSAPropagator::Simulate(ir::BasicBlock* block) {
-  if (block == ctx_->cfg()->pseudo_exit_block()) {
-    return false;
-  }
+bool SSAPropagator::Simulate(uint32_t block) {
+  assert(block != 0 && block != block_list_.size() - 1 &&
+         "Pseudo blocks cannot be simulated.");
+  ir::BasicBlock* bb = block_list_[block];
 
   // Always simulate Phi instructions, even if we have simulated this block
   // before. We do this because Phi instructions receive their inputs from
   // incoming edges. When those edges are marked executable, the corresponding
   // operand can be simulated.
   bool changed = false;
-  block->ForEachPhiInst(
+  bb->ForEachPhiInst(
       [&changed, this](ir::Instruction* instr) { changed |= Simulate(instr); });
 
   // If this is the first time this block is being simulated, simulate every
   // statement in it.
-  if (!BlockHasBeenSimulated(block)) {
-    block->ForEachInst([this, &changed](ir::Instruction* instr) {
+  if (!simulated_blocks_[block]) {
+    bb->ForEachInst([this, &changed](ir::Instruction* instr) {
       if (instr->opcode() != SpvOpPhi) {
         changed |= Simulate(instr);
       }
     });
 
-    MarkBlockSimulated(block);
+    simulated_blocks_[block] = true;
 
     // If this block has exactly one successor, mark the edge to its successor
     // as executable.
-    if (bb_succs_.at(block).size() == 1) {
-      AddControlEdge(bb_succs_.at(block).at(0));
+    if (succ_begin_[block + 1] - succ_begin_[block] == 1) {
+      AddControlEdge(succ_begin_[block]);
     }
   }
 
   return changed;
 }
 
-void SSAPropagator::Initialize(ir::Function* fn) {
-  // Compute predecessor and successor blocks for every block in |fn|'s CFG.
-  // TODO(dnovillo): Move this to ir::CFG and always build them. Alternately,
-  // move it to IRContext and build CFG preds/succs on-demand.
-  bb_succs_[ctx_->cfg()->pseudo_entry_block()].push_back(
-      Edge(ctx_->cfg()->pseudo_entry_block(), fn->entry().get()));
-
+void SSAPropagator::NumberBlocksAndInstructions(ir::Function* fn) {
+  block_list_.assign(1, nullptr);
+  inst_states_.clear();
+  uint32_t min_unique_id = UINT32_MAX;
+  uint32_t max_unique_id = 0;
   for (auto& block : *fn) {
-    const auto& const_block = block;
-    const_block.ForEachSuccessorLabel([this, &block](const uint32_t label_id) {
-      ir::BasicBlock* succ_bb =
-          ctx_->get_instr_block(get_def_use_mgr()->GetDef(label_id));
-      bb_succs_[&block].push_back(Edge(&block, succ_bb));
-      bb_preds_[succ_bb].push_back(Edge(succ_bb, &block));
+    const uint32_t index = static_cast<uint32_t>(block_list_.size());
+    block_list_.push_back(&block);
+    block.ForEachInst([this, index, &min_unique_id,
+                       &max_unique_id](ir::Instruction* inst) {
+      inst_states_.push_back({index, kNotInteresting, false, true});
+      min_unique_id = std::min(min_unique_id, inst->unique_id());
+      max_unique_id = std::max(max_unique_id, inst->unique_id());
     });
-    if (block.IsReturnOrAbort()) {
-      bb_succs_[&block].push_back(
-          Edge(&block, ctx_->cfg()->pseudo_exit_block()));
-      bb_preds_[ctx_->cfg()->pseudo_exit_block()].push_back(
-          Edge(ctx_->cfg()->pseudo_exit_block(), &block));
+  }
+  block_list_.push_back(nullptr);
+
+  // Look the slots up by unique id, unless the unique ids are spread out over
+  // a range much larger than the function.
+  first_unique_id_ = min_unique_id;
+  const size_t num_insts = inst_states_.size();
+  const uint64_t range =
+      static_cast<uint64_t>(max_unique_id) - min_unique_id + 1;
+  dense_slots_.clear();
+  sparse_slots_.clear();
+  if (range <= 4 * static_cast<uint64_t>(num_insts)) {
+    dense_slots_.assign(static_cast<size_t>(range), kNoSlot);
+  } else {
+    sparse_slots_.reserve(num_insts);
+  }
+  uint32_t slot = 0;
+  for (auto& block : *fn) {
+    block.ForEachInst([this, &slot](ir::Instruction* inst) {
+      if (dense_slots_.empty()) {
+        sparse_slots_[inst->unique_id()] = slot++;
+      } else {
+        dense_slots_[inst->unique_id() - first_unique_id_] = slot++;
+      }
+    });
+  }
+}
+
+void SSAPropagator::Initialize(ir::Function* fn) {
+  NumberBlocksAndInstructions(fn);
+
+  // Compute the successor edges of every block in |fn|'s CFG.  The pseudo
+  // entry block has a single edge into the entry block of |fn|.
+  const uint32_t exit_index = static_cast<uint32_t>(block_list_.size() - 1);
+  succ_begin_.clear();
+  edge_dest_.clear();
+  succ_begin_.push_back(0);
+  edge_dest_.push_back(1);
+  for (uint32_t index = 1; index < exit_index; ++index) {
+    succ_begin_.push_back(static_cast<uint32_t>(edge_dest_.size()));
+    const ir::BasicBlock* block = block_list_[index];
+    block->ForEachSuccessorLabel([this](const uint32_t label_id) {
+      const InstState* state = GetState(get_def_use_mgr()->GetDef(label_id));
+      assert(state && "Branch to a block outside of the function.");
+      edge_dest_.push_back(state->block);
+    });
+    if (block->IsReturnOrAbort()) {
+      edge_dest_.push_back(exit_index);
     }
   }
+  succ_begin_.push_back(static_cast<uint32_t>(edge_dest_.size()));
+  succ_begin_.push_back(static_cast<uint32_t>(edge_dest_.size()));
+
+  executable_edges_.assign(edge_dest_.size(), false);
+  simulated_blocks_.assign(block_list_.size(), false);
+  blocks_.clear();
+  blocks_head_ = 0;
+  ssa_edge_uses_.clear();
+  ssa_edge_uses_head_ = 0;
 
   // Add the edges out of the entry block to seed the propagator.
-  const auto& entry_succs = bb_succs_[ctx_->cfg()->pseudo_entry_block()];
-  for (const auto& e : entry_succs) {
+  for (uint32_t e = succ_begin_[0]; e < succ_begin_[1]; ++e) {
     AddControlEdge(e);
   }
 }
@@ -240,32 +321,35 @@ bool SSAPropagator::Run(ir::Function* fn) {
   Initialize(fn);
 
   bool changed = false;
-  while (!blocks_.empty() || !ssa_edge_uses_.empty()) {
+  while (blocks_head_ < blocks_.size() ||
+         ssa_edge_uses_head_ < ssa_edge_uses_.size()) {
     // Simulate all blocks first. Simulating blocks will add SSA edges to
     // follow after all the blocks have been simulated.
-    if (!blocks_.empty()) {
-      auto block = blocks_.front();
+    if (blocks_head_ < blocks_.size()) {
+      const uint32_t block = blocks_[blocks_head_++];
       changed |= Simulate(block);
-      blocks_.pop();
       continue;
     }
+    blocks_.clear();
+    blocks_head_ = 0;
 
     // Simulate edges from the SSA queue.
-    if (!ssa_edge_uses_.empty()) {
-      ir::Instruction* instr = ssa_edge_uses_.front();
-      changed |= Simulate(instr);
-      ssa_edge_uses_.pop();
+    ir::Instruction* instr = ssa_edge_uses_[ssa_edge_uses_head_++];
+    changed |= Simulate(instr);
+    if (ssa_edge_uses_head_ == ssa_edge_uses_.size()) {
+      ssa_edge_uses_.clear();
+      ssa_edge_uses_head_ = 0;
     }
   }
 
 #ifndef NDEBUG
   // Verify all visited values have settled. No value that has been simulated
   // should end on not interesting.
-  fn->ForEachInst([this](ir::Instruction* inst) {
-    assert(
-        (!HasStatus(inst) || Status(inst) != SSAPropagator::kNotInteresting) &&
-        "Unsettled value");
-  });
+  for (const InstState& state : inst_states_) {
+    assert((!state.has_status ||
+            state.status != SSAPropagator::kNotInteresting) &&
+           "Unsettled value");
+  }
 #endif
 
   return changed;
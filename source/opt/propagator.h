@@ -15,11 +15,9 @@
 #ifndef LIBSPIRV_OPT_PROPAGATOR_H_
 #define LIBSPIRV_OPT_PROPAGATOR_H_
 
+#include <cstdint>
 #include <functional>
-#include <queue>
-#include <set>
 #include <unordered_map>
-#include <unordered_set>
 #include <vector>
 
 #include "ir_context.h"
@@ -28,20 +26,6 @@
 namespace spvtools {
 namespace opt {
 
-// Represents a CFG control edge.
-struct Edge {
-  Edge(ir::BasicBlock* b1, ir::BasicBlock* b2) : source(b1), dest(b2) {
-    assert(source && "CFG edges cannot have a null source block.");
-    assert(dest && "CFG edges cannot have a null destination block.");
-  }
-  ir::BasicBlock* source;
-  ir::BasicBlock* dest;
-  bool operator<(const Edge& o) const {
-    return std::make_pair(source->id(), dest->id()) <
-           std::make_pair(o.source->id(), o.dest->id());
-  }
-};
-
 // This class implements a generic value propagation algorithm based on the
 // conditional constant propagation algorithm proposed in
 //
@@ -187,10 +171,15 @@ class SSAPropagator {
       std::function<PropStatus(ir::Instruction*, ir::BasicBlock**)>;
 
   SSAPropagator(ir::IRContext* context, const VisitFunction& visit_fn)
-      : ctx_(context), visit_fn_(visit_fn) {}
+      : ctx_(context),
+        visit_fn_(visit_fn),
+        ssa_edge_uses_head_(0),
+        blocks_head_(0),
+        first_unique_id_(0) {}
 
   // Runs the propagator on function |fn|. Returns true if changes were made to
-  // the function. Otherwise, it returns false.
+  // the function. Otherwise, it returns false.  The statuses recorded for the
+  // function of a previous run are discarded.
   bool Run(ir::Function* fn);
 
   // Returns true if the |i|th argument for |phi| comes through a CFG edge that
@@ -200,25 +189,46 @@ class SSAPropagator {
 
   // Returns true if |inst| has a recorded status. This will be true once |inst|
   // has been simulated once.
-  bool HasStatus(ir::Instruction* inst) const { return statuses_.count(inst); }
+  bool HasStatus(ir::Instruction* inst) const {
+    const InstState* state = GetState(inst);
+    return state && state->has_status;
+  }
 
   // Returns the current propagation status of |inst|. Assumes
   // |HasStatus(inst)| returns true.
   PropStatus Status(ir::Instruction* inst) const {
-    return statuses_.find(inst)->second;
+    assert(HasStatus(inst) && "Instruction has not been simulated.");
+    return GetState(inst)->status;
   }
 
-  // Records the propagation status |status| for |inst|. Returns true if the
-  // status for |inst| has changed or set was set for the first time.
+  // Records the propagation status |status| for |inst|, which must be in the
+  // function being simulated. Returns true if the status for |inst| has changed
+  // or set was set for the first time.
   bool SetStatus(ir::Instruction* inst, PropStatus status);
 
  private:
+  // Propagation state of an instruction in the function being simulated.
+  struct InstState {
+    // Index of the block that contains the instruction.
+    uint32_t block;
+    // The current propagation status.  Only valid if |has_status| is true.
+    PropStatus status;
+    bool has_status;
+    // False once the instruction is known not to need any more simulation.
+    bool simulate_again;
+  };
+
   // Initialize processing.
   void Initialize(ir::Function* fn);
 
-  // Simulate the execution |block| by calling |visit_fn_| on every instruction
-  // in it.
-  bool Simulate(ir::BasicBlock* block);
+  // Gives every block of |fn| an index, and every instruction in them a state
+  // slot.  Index 0 is the pseudo entry block, and the last index is the
+  // pseudo exit block.
+  void NumberBlocksAndInstructions(ir::Function* fn);
+
+  // Simulate the execution of the block with index |block| by calling
+  // |visit_fn_| on every instruction in it.
+  bool Simulate(uint32_t block);
 
   // Simulate the execution of |instr| by replacing all the known values in
   // every operand and determining whether the result is interesting for
@@ -226,50 +236,63 @@ class SSAPropagator {
   // the value computed by |instr|.
   bool Simulate(ir::Instruction* instr);
 
-  // Returns true if |instr| should be simulated again.
-  bool ShouldSimulateAgain(ir::Instruction* instr) const {
-    return do_not_simulate_.find(instr) == do_not_simulate_.end();
+  // Returns the state of |inst|, or nullptr if |inst| is not an instruction
+  // in the blocks of the function being simulated.
+  InstState* GetState(const ir::Instruction* inst) {
+    const uint32_t slot = GetSlot(inst);
+    return slot == kNoSlot ? nullptr : &inst_states_[slot];
   }
-
-  // Add |instr| to the set of instructions not to simulate again.
-  void DontSimulateAgain(ir::Instruction* instr) {
-    do_not_simulate_.insert(instr);
+  const InstState* GetState(const ir::Instruction* inst) const {
+    const uint32_t slot = GetSlot(inst);
+    return slot == kNoSlot ? nullptr : &inst_states_[slot];
   }
 
-  // Returns true if |block| has been simulated already.
-  bool BlockHasBeenSimulated(ir::BasicBlock* block) const {
-    return simulated_blocks_.find(block) != simulated_blocks_.end();
-  }
+  // Records the propagation status |status| in |state|.  Returns true if the
+  // status has changed or was set for the first time.
+  bool UpdateStatus(InstState* state, PropStatus status);
 
-  // Marks block |block| as simulated.
-  void MarkBlockSimulated(ir::BasicBlock* block) {
-    simulated_blocks_.insert(block);
-  }
+  // Returns the index of the state slot of |inst|, or kNoSlot if it has none.
+  uint32_t GetSlot(const ir::Instruction* inst) const;
 
-  // Marks |edge| as executable.  Returns false if the edge was already marked
-  // as executable.
-  bool MarkEdgeExecutable(const Edge& edge) {
-    return executable_edges_.insert(edge).second;
+  // Returns the index of the block |bb|, which must be in the function being
+  // simulated.
+  uint32_t GetBlockIndex(ir::BasicBlock* bb) const {
+    const InstState* state = GetState(bb->GetLabelInst());
+    assert(state && "Block is not in the function being simulated.");
+    return state->block;
   }
 
-  // Returns true if |edge| has been marked as executable.
-  bool IsEdgeExecutable(const Edge& edge) const {
-    return executable_edges_.find(edge) != executable_edges_.end();
+  // Returns true if |instr| should be simulated again.  Instructions outside
+  // of the function, like constants and function parameters, are never
+  // simulated, so they are always considered worth simulating again.
+  bool ShouldSimulateAgain(const ir::Instruction* instr) const {
+    const InstState* state = GetState(instr);
+    return state == nullptr || state->simulate_again;
   }
 
+  // Returns the index of the first CFG edge from block |source| to block
+  // |dest|, or kNoEdge if there is no such edge.
+  uint32_t FindEdge(uint32_t source, uint32_t dest) const;
+
   // Returns a pointer to the def-use manager for |ctx_|.
   analysis::DefUseManager* get_def_use_mgr() const {
     return ctx_->get_def_use_mgr();
   }
 
-  // If the CFG edge |e| has not been executed, this function adds |e|'s
-  // destination block to the work list.
-  void AddControlEdge(const Edge& e);
+  // If the CFG edge with index |edge| has not been executed, this function
+  // marks it executable and adds its destination block to the work list.
+  void AddControlEdge(uint32_t edge);
 
   // Adds all the instructions that use the result of |instr| to the SSA edges
   // work list. If |instr| produces no result id, this does nothing.
   void AddSSAEdges(ir::Instruction* instr);
 
+  // Marker for instructions without a state slot.
+  static const uint32_t kNoSlot = UINT32_MAX;
+
+  // Marker for block pairs that are not connected by a CFG edge.
+  static const uint32_t kNoEdge = UINT32_MAX;
+
   // IR context to use.
   ir::IRContext* ctx_;
 
@@ -280,34 +303,42 @@ class SSAPropagator {
   VisitFunction visit_fn_;
 
   // SSA def-use edges to traverse. Each entry is a destination statement for an
-  // SSA def-use edge as returned by |def_use_manager_|.
-  std::queue<ir::Instruction*> ssa_edge_uses_;
-
-  // Blocks to simulate.
-  std::queue<ir::BasicBlock*> blocks_;
-
-  // Blocks simulated during propagation.
-  std::unordered_set<ir::BasicBlock*> simulated_blocks_;
-
-  // Set of instructions that should not be simulated again because they have
-  // been found to be in the kVarying state.
-  std::unordered_set<ir::Instruction*> do_not_simulate_;
-
-  // Map between a basic block and its predecessor edges.
-  // TODO(dnovillo): Move this to ir::CFG and always build them. Alternately,
-  // move it to IRContext and build CFG preds/succs on-demand.
-  std::unordered_map<ir::BasicBlock*, std::vector<Edge>> bb_preds_;
-
-  // Map between a basic block and its successor edges.
-  // TODO(dnovillo): Move this to ir::CFG and always build them. Alternately,
-  // move it to IRContext and build CFG preds/succs on-demand.
-  std::unordered_map<ir::BasicBlock*, std::vector<Edge>> bb_succs_;
-
-  // Set of executable CFG edges.
-  std::set<Edge> executable_edges_;
-
-  // Tracks instruction propagation status.
-  std::unordered_map<ir::Instruction*, SSAPropagator::PropStatus> statuses_;
+  // SSA def-use edge as returned by |def_use_manager_|.  The queue starts at
+  // |ssa_edge_uses_head_|.
+  std::vector<ir::Instruction*> ssa_edge_uses_;
+  size_t ssa_edge_uses_head_;
+
+  // Indices of the blocks to simulate.  The queue starts at |blocks_head_|.
+  std::vector<uint32_t> blocks_;
+  size_t blocks_head_;
+
+  // The blocks of the function being simulated, by index.  The entries for
+  // the pseudo entry and exit blocks are null.
+  std::vector<ir::BasicBlock*> block_list_;
+
+  // Whether each block has been simulated, by block index.
+  std::vector<bool> simulated_blocks_;
+
+  // The successor edges of block |i| are the edges with indices in
+  // [succ_begin_[i], succ_begin_[i + 1]).  Edge |e| goes into the block with
+  // index |edge_dest_[e]|.  A block that branches twice to the same block has
+  // two edges to it; only the first of them is ever marked executable.
+  std::vector<uint32_t> succ_begin_;
+  std::vector<uint32_t> edge_dest_;
+
+  // Whether each CFG edge is executable, by edge index.
+  std::vector<bool> executable_edges_;
+
+  // Propagation state of every instruction in the blocks of the function.
+  std::vector<InstState> inst_states_;
+
+  // Maps the unique id of an instruction, minus |first_unique_id_|, to its
+  // state slot.  Instructions that are inserted by earlier passes get unique
+  // ids far away from the rest of their function, so if the range of unique
+  // ids is much larger than the function, |sparse_slots_| is used instead.
+  uint32_t first_unique_id_;
+  std::vector<uint32_t> dense_slots_;
+  std::unordered_map<uint32_t, uint32_t> sparse_slots_;
 };
 
 std::ostream& operator<<(std::ostream& str,
@@ -20,38 +20,45 @@ namespace spvtools {
 namespace opt {
 
 Pass::Status RedundancyEliminationPass::Process(ir::IRContext* c) {
-  InitializeProcessing(c);
-
-  bool modified = false;
-  ValueNumberTable vnTable(context());
+  return ProcessFunctionLocalPass(c);
+}
 
-  for (auto& func : *get_module()) {
-    // Build the dominator tree for this function. It is how the code is
-    // traversed.
-    opt::DominatorTree& dom_tree =
-        context()->GetDominatorAnalysis(&func, *context()->cfg())->GetDomTree();
+bool RedundancyEliminationPass::ProcessFunctionLocal(ir::Function* func) {
+  // Build the dominator tree for this function. It is how the code is
+  // traversed.
+  opt::DominatorTree& dom_tree =
+      context()->GetDominatorAnalysis(func, *context()->cfg())->GetDomTree();
 
-    // Keeps track of all ids that contain a given value number. We keep
-    // track of multiple values because they could have the same value, but
-    // different decorations.
-    std::map<uint32_t, uint32_t> value_to_ids;
+  // Keeps track of all ids that contain a given value number. We keep
+  // track of multiple values because they could have the same value, but
+  // different decorations.
+  std::unordered_map<uint32_t, uint32_t> value_to_ids;
 
-    if (EliminateRedundanciesFrom(dom_tree.GetRoot(), vnTable, value_to_ids)) {
-      modified = true;
-    }
-  }
-  return (modified ? Status::SuccessWithChange : Status::SuccessWithoutChange);
+  return EliminateRedundanciesFrom(dom_tree.GetRoot(), *vn_table_,
+                                   &value_to_ids);
 }
 
 bool RedundancyEliminationPass::EliminateRedundanciesFrom(
     DominatorTreeNode* bb, const ValueNumberTable& vnTable,
-    std::map<uint32_t, uint32_t> value_to_ids) {
-  bool modified = EliminateRedundanciesInBB(bb->bb_, vnTable, &value_to_ids);
+    std::unordered_map<uint32_t, uint32_t>* value_to_ids) {
+  bool modified = EliminateRedundanciesInBB(bb->bb_, vnTable, value_to_ids);
 
   for (auto dominated_bb : bb->children_) {
     modified |= EliminateRedundanciesFrom(dominated_bb, vnTable, value_to_ids);
   }
 
+  // Leave the scope of |bb|.  The values first computed in |bb| do not
+  // dominate the blocks visited after it.
+  bb->bb_->ForEachInst([&vnTable, value_to_ids](ir::Instruction* inst) {
+    if (inst->result_id() == 0) {
+      return;
+    }
+    auto it = value_to_ids->find(vnTable.GetValueNumber(inst));
+    if (it != value_to_ids->end() && it->second == inst->result_id()) {
+      value_to_ids->erase(it);
+    }
+  });
+
   return modified;
 }
 }  // namespace opt
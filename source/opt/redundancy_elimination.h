@@ -15,6 +15,8 @@
 #ifndef LIBSPIRV_OPT_REDUNDANCY_ELIMINATION_H_
 #define LIBSPIRV_OPT_REDUNDANCY_ELIMINATION_H_
 
+#include <unordered_map>
+
 #include "ir_context.h"
 #include "local_redundancy_elimination.h"
 #include "pass.h"
@@ -40,12 +42,20 @@ class RedundancyEliminationPass : public LocalRedundancyEliminationPass {
   //
   // |value_to_ids| is a map from value number to ids.  If {vn, id} is in
   // |value_to_ids| then vn is the value number of id, and the defintion of id
-  // dominates |bb|.
+  // dominates |bb|.  The entries added for the blocks dominated by |bb| are
+  // removed again before returning, so a single map is shared by the whole
+  // walk over the dominator tree.
   //
   // Returns true if at least one instruction is deleted.
-  bool EliminateRedundanciesFrom(DominatorTreeNode* bb,
-                                 const ValueNumberTable& vnTable,
-                                 std::map<uint32_t, uint32_t> value_to_ids);
+  bool EliminateRedundanciesFrom(
+      DominatorTreeNode* bb, const ValueNumberTable& vnTable,
+      std::unordered_map<uint32_t, uint32_t>* value_to_ids);
+
+  // The pass is function-local, like LocalRedundancyEliminationPass.
+  std::unique_ptr<Pass> CloneFunctionLocal() const override {
+    return std::unique_ptr<Pass>(new RedundancyEliminationPass());
+  }
+  bool ProcessFunctionLocal(ir::Function* func) override;
 };
 
 }  // namespace opt
@@ -54,17 +54,19 @@ namespace spvtools {
 namespace opt {
 
 Pass::Status StrengthReductionPass::Process(ir::IRContext* c) {
+  return ProcessFunctionLocalPass(c);
+}
+
+bool StrengthReductionPass::InitializeFunctionLocal(ir::IRContext* c) {
   InitializeProcessing(c);
 
   // Initialize the member variables on a per module basis.
-  bool modified = false;
   int32_type_id_ = 0;
   uint32_type_id_ = 0;
   std::memset(constant_ids_, 0, sizeof(constant_ids_));
 
   FindIntTypesAndConstants();
-  modified = ScanFunctions();
-  return (modified ? Status::SuccessWithChange : Status::SuccessWithoutChange);
+  return true;
 }
 
 bool StrengthReductionPass::ReplaceMultiplyByPowerOf2(
@@ -174,21 +176,19 @@ uint32_t StrengthReductionPass::GetConstantId(uint32_t val) {
   return constant_ids_[val];
 }
 
-bool StrengthReductionPass::ScanFunctions() {
-  // I did not use |ForEachInst| in the module because the function that acts on
-  // the instruction gets a pointer to the instruction.  We cannot use that to
-  // insert a new instruction.  I want an iterator.
+bool StrengthReductionPass::ScanFunction(ir::Function* func) {
+  // I did not use |ForEachInst| in the function because the function that acts
+  // on the instruction gets a pointer to the instruction.  We cannot use that
+  // to insert a new instruction.  I want an iterator.
   bool modified = false;
-  for (auto& func : *get_module()) {
-    for (auto& bb : func) {
-      for (auto inst = bb.begin(); inst != bb.end(); ++inst) {
-        switch (inst->opcode()) {
-          case SpvOp::SpvOpIMul:
-            if (ReplaceMultiplyByPowerOf2(&inst)) modified = true;
-            break;
-          default:
-            break;
-        }
+  for (auto& bb : *func) {
+    for (auto inst = bb.begin(); inst != bb.end(); ++inst) {
+      switch (inst->opcode()) {
+        case SpvOp::SpvOpIMul:
+          if (ReplaceMultiplyByPowerOf2(&inst)) modified = true;
+          break;
+        default:
+          break;
       }
     }
   }
@@ -45,9 +45,18 @@ class StrengthReductionPass : public Pass {
   // created.  The parameter must be between 0 and 32 inclusive.
   uint32_t GetConstantId(uint32_t);
 
-  // Replaces certain instructions in function bodies with presumably cheaper
-  // ones. Returns true if something changed.
-  bool ScanFunctions();
+  // Replaces certain instructions in the body of |func| with presumably
+  // cheaper ones. Returns true if something changed.
+  bool ScanFunction(ir::Function* func);
+
+  // The pass is function-local, see Pass.
+  std::unique_ptr<Pass> CloneFunctionLocal() const override {
+    return std::unique_ptr<Pass>(new StrengthReductionPass());
+  }
+  bool InitializeFunctionLocal(ir::IRContext* c) override;
+  bool ProcessFunctionLocal(ir::Function* func) override {
+    return ScanFunction(func);
+  }
 
   // Type ids for the types of interest, or 0 if they do not exist.
   uint32_t int32_type_id_;
@@ -21,17 +21,200 @@
 namespace spvtools {
 namespace opt {
 
+namespace {
+
+const uint32_t kLoadPointerInIdx = 0;
+const uint32_t kLoadMemoryAccessInIdx = 1;
+const uint32_t kAccessChainBaseInIdx = 0;
+const uint32_t kVariableStorageClassInIdx = 0;
+
+// Marks loads whose result must get a new value number.
+const uint32_t kNewValueForLoad = UINT32_MAX;
+
+// Returns true if the result of |opcode| does not depend on the order of its
+// two operands.
+bool IsCommutative(SpvOp opcode) {
+  switch (opcode) {
+    case SpvOpIAdd:
+    case SpvOpFAdd:
+    case SpvOpIMul:
+    case SpvOpFMul:
+    case SpvOpDot:
+    case SpvOpIAddCarry:
+    case SpvOpUMulExtended:
+    case SpvOpSMulExtended:
+    case SpvOpBitwiseOr:
+    case SpvOpBitwiseXor:
+    case SpvOpBitwiseAnd:
+    case SpvOpLogicalEqual:
+    case SpvOpLogicalNotEqual:
+    case SpvOpLogicalOr:
+    case SpvOpLogicalAnd:
+    case SpvOpIEqual:
+    case SpvOpINotEqual:
+    case SpvOpFOrdEqual:
+    case SpvOpFUnordEqual:
+    case SpvOpFOrdNotEqual:
+    case SpvOpFUnordNotEqual:
+      return true;
+    default:
+      return false;
+  }
+}
+
+// Returns the hash of the |size| words starting at |words|.
+size_t HashWords(const uint32_t* words, size_t size) {
+  size_t hash = size;
+  for (size_t i = 0; i < size; ++i) {
+    hash ^= words[i] + 0x9e3779b9 + (hash << 6) + (hash >> 2);
+  }
+  return hash;
+}
+
+}  // namespace
+
 uint32_t ValueNumberTable::GetValueNumber(
     spvtools::ir::Instruction* inst) const {
   assert(inst->result_id() != 0 &&
          "inst must have a result id to get a value number.");
+  return GetValueNumber(inst->result_id());
+}
+
+bool ValueNumberTable::IsUnmodifiedVariable(ir::Instruction* var) {
+  // The uses of other variables can be in functions that are not in the
+  // module, see IRContext::has_all_functions().
+  assert(var->GetSingleWordInOperand(kVariableStorageClassInIdx) ==
+             SpvStorageClassFunction &&
+         "Only function variables have all their uses in the module.");
+  auto it = unmodified_variables_.find(var->result_id());
+  if (it != unmodified_variables_.end()) {
+    return it->second;
+  }
 
-  // Check if this instruction already has a value.
-  auto result_id_to_val = id_to_value_.find(inst->result_id());
-  if (result_id_to_val != id_to_value_.end()) {
-    return result_id_to_val->second;
+  std::vector<ir::Instruction*> pointers = {var};
+  bool unmodified = true;
+  while (unmodified && !pointers.empty()) {
+    ir::Instruction* ptr = pointers.back();
+    pointers.pop_back();
+    unmodified = context()->get_def_use_mgr()->WhileEachUser(
+        ptr, [&pointers](ir::Instruction* user) {
+          switch (user->opcode()) {
+            case SpvOpLoad:
+              return true;
+            case SpvOpAccessChain:
+            case SpvOpInBoundsAccessChain:
+              // |ptr| is the base of the access chain, because the indices
+              // are integers.
+              pointers.push_back(user);
+              return true;
+            case SpvOpName:
+              return true;
+            default:
+              return user->IsDecoration();
+          }
+        });
   }
-  return 0;
+  unmodified_variables_[var->result_id()] = unmodified;
+  return unmodified;
+}
+
+uint32_t ValueNumberTable::GetLoadMemoryVersion(ir::Instruction* inst) {
+  if (inst->IsReadOnlyLoad()) {
+    return 0;
+  }
+  if (inst->opcode() != SpvOpLoad) {
+    return kNewValueForLoad;
+  }
+  if (inst->NumInOperands() > kLoadMemoryAccessInIdx &&
+      (inst->GetSingleWordInOperand(kLoadMemoryAccessInIdx) &
+       SpvMemoryAccessVolatileMask)) {
+    return kNewValueForLoad;
+  }
+
+  // Only the current invocation can write to function and private variables,
+  // so their contents can only change through the instructions we see.
+  ir::Instruction* var = context()->get_def_use_mgr()->GetDef(
+      inst->GetSingleWordInOperand(kLoadPointerInIdx));
+  while (var->opcode() == SpvOpAccessChain ||
+         var->opcode() == SpvOpInBoundsAccessChain) {
+    var = context()->get_def_use_mgr()->GetDef(
+        var->GetSingleWordInOperand(kAccessChainBaseInIdx));
+  }
+  if (var->opcode() != SpvOpVariable) {
+    return kNewValueForLoad;
+  }
+  const uint32_t storage_class =
+      var->GetSingleWordInOperand(kVariableStorageClassInIdx);
+  switch (storage_class) {
+    case SpvStorageClassFunction:
+    case SpvStorageClassPrivate:
+      break;
+    default:
+      return kNewValueForLoad;
+  }
+  const bool is_volatile =
+      !context()->get_decoration_mgr()->WhileEachDecoration(
+          var->result_id(), SpvDecorationVolatile,
+          [](const ir::Instruction&) { return false; });
+  if (is_volatile) {
+    return kNewValueForLoad;
+  }
+  // All the uses of a function variable are in its function, but a private
+  // variable can be stored by a function that is not in the module, when a
+  // function-local pass processes a group of functions in parallel.
+  if (storage_class == SpvStorageClassFunction && IsUnmodifiedVariable(var)) {
+    return 0;
+  }
+  return memory_version_;
+}
+
+bool ValueNumberTable::MayWriteMemory(ir::Instruction* inst) {
+  switch (inst->opcode()) {
+    case SpvOpLabel:
+    case SpvOpPhi:
+    case SpvOpVariable:
+    case SpvOpSelectionMerge:
+    case SpvOpLoopMerge:
+    case SpvOpBranch:
+    case SpvOpBranchConditional:
+    case SpvOpSwitch:
+    case SpvOpReturn:
+    case SpvOpReturnValue:
+    case SpvOpKill:
+    case SpvOpUnreachable:
+      return false;
+    default:
+      return !context()->IsCombinatorInstruction(inst);
+  }
+}
+
+uint32_t ValueNumberTable::GetEntryMemoryVersion(
+    const ir::BasicBlock& block,
+    const std::unordered_map<uint32_t, uint32_t>& exit_versions) {
+  // Predecessors that have not been numbered yet, like the ones at the end of
+  // back edges, could write to memory.
+  uint32_t version = 0;
+  for (uint32_t pred : context()->cfg()->preds(block.id())) {
+    auto it = exit_versions.find(pred);
+    if (it == exit_versions.end() || (version != 0 && version != it->second)) {
+      return TakeNextMemoryVersion();
+    }
+    version = it->second;
+  }
+  return version != 0 ? version : TakeNextMemoryVersion();
+}
+
+bool ValueNumberTable::IsSameValue(const ValueKey& key, uint32_t size,
+                                   uint32_t result_id) const {
+  if (key.size != size) {
+    return false;
+  }
+  const uint32_t* words = key_words_.data() + key_words_.size() - size;
+  if (!std::equal(words, words + size, key_words_.data() + key.offset)) {
+    return false;
+  }
+  return context()->get_decoration_mgr()->HaveTheSameDecorations(
+      key.result_id, result_id);
 }
 
 uint32_t ValueNumberTable::AssignValueNumber(ir::Instruction* inst) {
@@ -46,40 +229,34 @@ uint32_t ValueNumberTable::AssignValueNumber(ir::Instruction* inst) {
   // OpSampledImage and OpImage must remain in the same basic block in which
   // they are used, because of this we will assign each one it own value number.
   if (!context()->IsCombinatorInstruction(inst)) {
-    value = TakeNextValueNumber();
-    id_to_value_[inst->result_id()] = value;
-    return value;
+    return SetValueNumber(inst->result_id(), TakeNextValueNumber());
   }
 
   switch (inst->opcode()) {
     case SpvOpSampledImage:
     case SpvOpImage:
     case SpvOpVariable:
-      value = TakeNextValueNumber();
-      id_to_value_[inst->result_id()] = value;
-      return value;
+      return SetValueNumber(inst->result_id(), TakeNextValueNumber());
     default:
       break;
   }
 
-  // If it is a load from memory that can be modified, we have to assume the
-  // memory has been modified, so we give it a new value number.
-  //
-  // Note that this test will also handle volatile loads because they are not
-  // read only.  However, if this is ever relaxed because we analyze stores, we
-  // will have to add a new case for volatile loads.
-  if (inst->IsLoad() && !inst->IsReadOnlyLoad()) {
-    value = TakeNextValueNumber();
-    id_to_value_[inst->result_id()] = value;
-    return value;
+  // If it is a load from memory that can be modified, the value depends on the
+  // memory version.  If the memory could change at any time, we give it a new
+  // value number.
+  uint32_t memory_version = 0;
+  if (inst->IsLoad()) {
+    memory_version = GetLoadMemoryVersion(inst);
+    if (memory_version == kNewValueForLoad) {
+      return SetValueNumber(inst->result_id(), TakeNextValueNumber());
+    }
   }
 
   // When we copy an object, the value numbers should be the same.
   if (inst->opcode() == SpvOpCopyObject) {
     value = GetValueNumber(inst->GetSingleWordInOperand(0));
     if (value != 0) {
-      id_to_value_[inst->result_id()] = value;
-      return value;
+      return SetValueNumber(inst->result_id(), value);
     }
   }
 
@@ -95,49 +272,66 @@ uint32_t ValueNumberTable::AssignValueNumber(ir::Instruction* inst) {
         }
       }
       if (value != 0) {
-        id_to_value_[inst->result_id()] = value;
-        return value;
+        return SetValueNumber(inst->result_id(), value);
       }
     }
   }
 
-  // Replace all of the operands by their value number.  The sign bit will be
-  // set to distinguish between an id and a value number.
-  ir::Instruction value_ins(context(), inst->opcode(), inst->type_id(),
-                            inst->result_id(), {});
+  // Build the key of the value at the end of |key_words_|: the opcode, the
+  // type, and the in-operands with every id replaced by its value number.  The
+  // sign bit is set to distinguish between an id and a value number.  Each
+  // operand starts with a word holding its type and size.
+  const uint32_t offset = static_cast<uint32_t>(key_words_.size());
+  key_words_.push_back(inst->opcode());
+  key_words_.push_back(inst->type_id());
   for (uint32_t o = 0; o < inst->NumInOperands(); ++o) {
     const ir::Operand& op = inst->GetInOperand(o);
+    key_words_.push_back((static_cast<uint32_t>(op.type) << 16) |
+                         static_cast<uint32_t>(op.words.size()));
     if (spvIsIdType(op.type)) {
       uint32_t id_value = op.words[0];
-      auto use_id_to_val = id_to_value_.find(id_value);
-      if (use_id_to_val != id_to_value_.end()) {
-        id_value = (1 << 31) | use_id_to_val->second;
+      uint32_t use_value = GetValueNumber(id_value);
+      if (use_value != 0) {
+        id_value = (1u << 31) | use_value;
       }
-      value_ins.AddOperand(ir::Operand(op.type, {id_value}));
+      key_words_.push_back(id_value);
     } else {
-      value_ins.AddOperand(ir::Operand(op.type, op.words));
+      key_words_.insert(key_words_.end(), op.words.begin(), op.words.end());
     }
   }
+  key_words_.push_back(memory_version);
 
-  // TODO: Implement a normal form for opcodes that commute like integer
-  // addition.  This will let us know that a+b is the same value as b+a.
+  // Put the operands of commutative operations in a canonical order.  This
+  // lets us know that a+b is the same value as b+a.
+  if (IsCommutative(inst->opcode()) && inst->NumInOperands() == 2 &&
+      key_words_.size() - offset == 7 &&
+      key_words_[offset + 2] == key_words_[offset + 4] &&
+      key_words_[offset + 3] > key_words_[offset + 5]) {
+    std::swap(key_words_[offset + 3], key_words_[offset + 5]);
+  }
 
   // Otherwise, we check if this value has been computed before.
-  auto value_iterator = instruction_to_value_.find(value_ins);
-  if (value_iterator != instruction_to_value_.end()) {
-    value = id_to_value_[value_iterator->first.result_id()];
-    id_to_value_[inst->result_id()] = value;
-    return value;
+  const uint32_t size = static_cast<uint32_t>(key_words_.size()) - offset;
+  const size_t hash = HashWords(key_words_.data() + offset, size);
+  auto range = hash_to_keys_.equal_range(hash);
+  for (auto it = range.first; it != range.second; ++it) {
+    const ValueKey& key = value_keys_[it->second];
+    if (IsSameValue(key, size, inst->result_id())) {
+      key_words_.resize(offset);
+      return SetValueNumber(inst->result_id(), key.value);
+    }
   }
 
   // If not, assign it a new value number.
   value = TakeNextValueNumber();
-  id_to_value_[inst->result_id()] = value;
-  instruction_to_value_[value_ins] = value;
-  return value;
+  hash_to_keys_.insert({hash, static_cast<uint32_t>(value_keys_.size())});
+  value_keys_.push_back({offset, size, inst->result_id(), value});
+  return SetValueNumber(inst->result_id(), value);
 }
 
 void ValueNumberTable::BuildDominatorTreeValueNumberTable() {
+  id_to_value_.assign(context()->module()->IdBound(), 0);
+
   // First value number the headers.
   for (auto& inst : context()->annotations()) {
     if (inst.result_id() != 0) {
@@ -163,62 +357,30 @@ void ValueNumberTable::BuildDominatorTreeValueNumberTable() {
     }
   }
 
+  std::unordered_map<uint32_t, uint32_t> exit_versions;
   for (ir::Function& func : *context()->module()) {
     // For best results we want to traverse the code in reverse post order.
     // This happens naturally because of the forward referencing rules.
     for (ir::BasicBlock& block : func) {
+      memory_version_ = GetEntryMemoryVersion(block, exit_versions);
       for (ir::Instruction& inst : block) {
         if (inst.result_id() != 0) {
           AssignValueNumber(&inst);
         }
+        if (MayWriteMemory(&inst)) {
+          memory_version_ = TakeNextMemoryVersion();
+        }
       }
-    }
-  }
-}
-
-bool ComputeSameValue::operator()(const ir::Instruction& lhs,
-                                  const ir::Instruction& rhs) const {
-  if (lhs.result_id() == 0 || rhs.result_id() == 0) {
-    return false;
-  }
-
-  if (lhs.opcode() != rhs.opcode()) {
-    return false;
-  }
-
-  if (lhs.type_id() != rhs.type_id()) {
-    return false;
-  }
-
-  if (lhs.NumInOperands() != rhs.NumInOperands()) {
-    return false;
-  }
-
-  for (uint32_t i = 0; i < lhs.NumInOperands(); ++i) {
-    if (lhs.GetInOperand(i) != rhs.GetInOperand(i)) {
-      return false;
+      exit_versions[block.id()] = memory_version_;
     }
   }
 
-  return lhs.context()->get_decoration_mgr()->HaveTheSameDecorations(
-      lhs.result_id(), rhs.result_id());
+  // The keys are only needed to number new instructions.
+  std::vector<uint32_t>().swap(key_words_);
+  std::vector<ValueKey>().swap(value_keys_);
+  hash_to_keys_.clear();
+  unmodified_variables_.clear();
 }
 
-std::size_t ValueTableHash::operator()(
-    const spvtools::ir::Instruction& inst) const {
-  // We hash the opcode and in-operands, not the result, because we want
-  // instructions that are the same except for the result to hash to the
-  // same value.
-  std::u32string h;
-  h.push_back(inst.opcode());
-  h.push_back(inst.type_id());
-  for (uint32_t i = 0; i < inst.NumInOperands(); ++i) {
-    const auto& opnd = inst.GetInOperand(i);
-    for (uint32_t word : opnd.words) {
-      h.push_back(word);
-    }
-  }
-  return std::hash<std::u32string>()(h);
-}
 }  // namespace opt
 }  // namespace spvtools
@@ -17,25 +17,14 @@
 
 #include <cstdint>
 #include <unordered_map>
+#include <vector>
+
 #include "instruction.h"
 #include "ir_context.h"
 
 namespace spvtools {
 namespace opt {
 
-// Returns true if the two instructions compute the same value.  Used by the
-// value number table to compare two instructions.
-class ComputeSameValue {
- public:
-  bool operator()(const ir::Instruction& lhs, const ir::Instruction& rhs) const;
-};
-
-// The hash function used in the value number table.
-class ValueTableHash {
- public:
-  std::size_t operator()(const spvtools::ir::Instruction& inst) const;
-};
-
 // This class implements the value number analysis.  It is using a hash-based
 // approach to value numbering.  It is essentially doing dominator-tree value
 // numbering described in
@@ -47,9 +36,23 @@ class ValueTableHash {
 // The main difference is that because we do not perform redundancy elimination
 // as we build the value number table, we do not have to deal with cleaning up
 // the scope.
+//
+// Two instructions get the same value number if they have the same opcode,
+// type, decorations and operand value numbers.  The operands of commutative
+// operations are put in a canonical order first.  Loads from function and
+// private variables also get the same value number if no instruction that
+// may write to memory is executed between them.  This is tracked with memory
+// versions: the version changes after every such instruction, and at the
+// start of every block whose predecessors do not all end with the same
+// version.  Loads from function variables that are never written to at all
+// do not depend on the version.
 class ValueNumberTable {
  public:
-  ValueNumberTable(ir::IRContext* ctx) : context_(ctx), next_value_number_(1) {
+  ValueNumberTable(ir::IRContext* ctx)
+      : memory_version_(0),
+        context_(ctx),
+        next_value_number_(1),
+        next_memory_version_(1) {
     BuildDominatorTreeValueNumberTable();
   }
 
@@ -60,34 +63,89 @@ class ValueNumberTable {
 
   // Returns the value number of the value contain in |id|.  Returns 0 if it
   // has not been assigned a value number.
-  inline uint32_t GetValueNumber(uint32_t id) const;
+  uint32_t GetValueNumber(uint32_t id) const {
+    return id < id_to_value_.size() ? id_to_value_[id] : 0;
+  }
 
   ir::IRContext* context() const { return context_; }
 
  private:
+  // A value that has been computed before.  Its key is the range
+  // [offset, offset + size) of |key_words_|, and |result_id| is the first id
+  // that holds it.
+  struct ValueKey {
+    uint32_t offset;
+    uint32_t size;
+    uint32_t result_id;
+    uint32_t value;
+  };
+
   // Assigns a value number to every result id in the module.
   void BuildDominatorTreeValueNumberTable();
 
   // Returns the new value number.
   uint32_t TakeNextValueNumber() { return next_value_number_++; }
 
+  // Returns a memory version that has not been used yet.
+  uint32_t TakeNextMemoryVersion() { return next_memory_version_++; }
+
+  // Records |value| as the value number of |id|, and returns it.
+  uint32_t SetValueNumber(uint32_t id, uint32_t value) {
+    if (id >= id_to_value_.size()) id_to_value_.resize(id + 1, 0);
+    id_to_value_[id] = value;
+    return value;
+  }
+
   // Assigns a new value number to the result of |inst| if it does not already
   // have one.  Return the value number for |inst|.  |inst| must have a result
   // id.
   uint32_t AssignValueNumber(ir::Instruction* inst);
 
-  std::unordered_map<spvtools::ir::Instruction, uint32_t, ValueTableHash,
-                     ComputeSameValue>
-      instruction_to_value_;
-  std::unordered_map<uint32_t, uint32_t> id_to_value_;
+  // Returns the memory version a load of |inst| depends on, or 0 if it does
+  // not depend on it.  Returns UINT32_MAX if |inst| must get a new value
+  // number because the memory it reads may change at any time.
+  uint32_t GetLoadMemoryVersion(ir::Instruction* inst);
+
+  // Returns true if the function variable |var| is never written to.  That
+  // is, all of its uses are loads, names and decorations, or access chains
+  // whose uses are like that.
+  bool IsUnmodifiedVariable(ir::Instruction* var);
+
+  // Returns true if |inst| may write to memory.
+  bool MayWriteMemory(ir::Instruction* inst);
+
+  // Returns the memory version at the start of |block|.  |exit_versions| holds
+  // the memory version at the end of every block that has been numbered.
+  uint32_t GetEntryMemoryVersion(
+      const ir::BasicBlock& block,
+      const std::unordered_map<uint32_t, uint32_t>& exit_versions);
+
+  // Returns true if the key of |key| is the last |size| words of |key_words_|,
+  // and |key|'s result id has the same decorations as |result_id|.
+  bool IsSameValue(const ValueKey& key, uint32_t size,
+                   uint32_t result_id) const;
+
+  // The value number of every id, indexed by id.
+  std::vector<uint32_t> id_to_value_;
+
+  // The keys of the values computed so far, and an index from the hash of a
+  // key to its position in |value_keys_|.  These are only used while the table
+  // is built.
+  std::vector<uint32_t> key_words_;
+  std::vector<ValueKey> value_keys_;
+  std::unordered_multimap<size_t, uint32_t> hash_to_keys_;
+
+  // Whether each variable that has been checked is never written to.
+  std::unordered_map<uint32_t, bool> unmodified_variables_;
+
+  // The memory version at the instruction being numbered.
+  uint32_t memory_version_;
+
   ir::IRContext* context_;
   uint32_t next_value_number_;
+  uint32_t next_memory_version_;
 };
 
-uint32_t ValueNumberTable::GetValueNumber(uint32_t id) const {
-  return GetValueNumber(context()->get_def_use_mgr()->GetDef(id));
-}
-
 }  // namespace opt
 }  // namespace spvtools
 
@@ -86,3 +86,8 @@ void spvValidatorOptionsSetRelaxLogicalPointer(spv_validator_options options,
                                                bool val) {
   options->relax_logcial_pointer = val;
 }
+
+void spvValidatorOptionsSetThreadCount(spv_validator_options options,
+                                       uint32_t thread_count) {
+  options->thread_count = thread_count;
+}
@@ -40,11 +40,13 @@ struct spv_validator_options_t {
   spv_validator_options_t()
       : universal_limits_(),
         relax_struct_store(false),
-        relax_logcial_pointer(false) {}
+        relax_logcial_pointer(false),
+        thread_count(1) {}
 
   validator_universal_limits_t universal_limits_;
   bool relax_struct_store;
   bool relax_logcial_pointer;
+  uint32_t thread_count;
 };
 
 #endif  // LIBSPIRV_SPIRV_VALIDATOR_OPTIONS_H_
@@ -53,6 +53,12 @@ typedef struct spv_operand_desc_group_t {
   const spv_operand_type_t type;
   const uint32_t count;
   const spv_operand_desc_t* entries;
+  // Open-addressed hash indexes into |entries|, keyed by enumerant name and by
+  // enumerant value. Both have |index_size| slots, a power of two. See
+  // spvTableNameHash and spvTableValueHash.
+  const uint32_t index_size;
+  const uint16_t* name_index;
+  const uint16_t* value_index;
 } spv_operand_desc_group_t;
 
 typedef struct spv_ext_inst_desc_t {
@@ -72,6 +78,10 @@ typedef struct spv_ext_inst_group_t {
 typedef struct spv_opcode_table_t {
   const uint32_t count;
   const spv_opcode_desc_t* entries;
+  // Open-addressed hash index into |entries|, keyed by opcode name. It has
+  // |name_index_size| slots, a power of two. See spvTableNameHash.
+  const uint32_t name_index_size;
+  const uint16_t* name_index;
 } spv_opcode_table_t;
 
 typedef struct spv_operand_table_t {
@@ -92,6 +102,32 @@ typedef const spv_opcode_table_t* spv_opcode_table;
 typedef const spv_operand_table_t* spv_operand_table;
 typedef const spv_ext_inst_table_t* spv_ext_inst_table;
 
+// The indexes of the grammar tables are generated by
+// utils/generate_grammar_tables.py. Slot |hash & (size - 1)| of an index holds
+// the position of the entry with that key, or the search continues with the
+// following slots until the entry, or an empty slot, is found. The generator
+// keeps every index at most half full.
+
+// Marks an empty slot in a table index.
+static const uint16_t kSpvTableIndexEmpty = 0xffff;
+
+// Returns the hash of the |length| characters of |name| used by the name
+// indexes. This is 32-bit FNV-1a.
+inline uint32_t spvTableNameHash(const char* name, size_t length) {
+  uint32_t hash = 2166136261u;
+  for (size_t i = 0; i < length; ++i) {
+    hash = (hash ^ static_cast<uint8_t>(name[i])) * 16777619u;
+  }
+  return hash;
+}
+
+// Returns the hash of |value| used by the value indexes.
+inline uint32_t spvTableValueHash(uint32_t value) {
+  value = (value ^ (value >> 16)) * 0x45d9f3bu;
+  value = (value ^ (value >> 16)) * 0x45d9f3bu;
+  return value ^ (value >> 16);
+}
+
 struct spv_context_t {
   const spv_target_env target_env;
   const spv_opcode_table opcode_table;
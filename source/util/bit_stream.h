@@ -19,6 +19,7 @@
 
 #include <algorithm>
 #include <bitset>
+#include <cassert>
 #include <cstdint>
 #include <functional>
 #include <sstream>
@@ -420,6 +421,34 @@ class BitReaderWord64 : public BitReaderInterface {
   bool ReachedEnd() const override;
   bool OnlyZeroesLeft() const override;
 
+  // Returns the next |num_bits| from the stream without reading them. Bits
+  // past the end of the buffer are returned as zeroes. |num_bits| must be no
+  // greater than 64. Unlike ReadBits, this is not virtual, so decoders which
+  // look at several bits at a time can have it inlined.
+  uint64_t PeekBits(size_t num_bits) const {
+    assert(num_bits <= 64);
+    const size_t index = pos_ / 64;
+    if (index >= buffer_.size()) return 0;
+    const size_t offset = pos_ % 64;
+    uint64_t bits = buffer_[index] >> offset;
+    if (offset + num_bits > 64 && index + 1 < buffer_.size())
+      bits |= buffer_[index + 1] << (64 - offset);
+    return GetLowerBits(bits, num_bits);
+  }
+
+  // Returns the number of bits which are left to read.
+  size_t GetNumRemainingBits() const {
+    return ReachedEnd() ? 0 : buffer_.size() * 64 - pos_;
+  }
+
+  // Reads and discards |num_bits| from the stream. |num_bits| must be no
+  // greater than 64 or GetNumRemainingBits().
+  void SkipBits(size_t num_bits) {
+    assert(num_bits <= 64 && num_bits <= GetNumRemainingBits());
+    if (callback_ && num_bits) EmitSequence(PeekBits(num_bits), num_bits);
+    pos_ += num_bits;
+  }
+
   BitReaderWord64() = delete;
 
   // Sets callback to emit bit sequences after every read.
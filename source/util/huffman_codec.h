@@ -31,6 +31,8 @@
 #include <unordered_map>
 #include <vector>
 
+#include "util/bit_stream.h"
+
 namespace spvutils {
 
 // Used to generate and apply a Huffman coding scheme.
@@ -116,8 +118,9 @@ class HuffmanCodec {
       queue.push(parent);
     }
 
-    // Traverse the tree and form encoding table.
+    // Traverse the tree and form encoding and decoding tables.
     CreateEncodingTable();
+    CreateDecodingTable();
   }
 
   // Creates Huffman codec from saved tree structure.
@@ -131,8 +134,9 @@ class HuffmanCodec {
 
     root_ = root_handle;
 
-    // Traverse the tree and form encoding table.
+    // Traverse the tree and form encoding and decoding tables.
     CreateEncodingTable();
+    CreateDecodingTable();
   }
 
   // Serializes the codec in the following text format:
@@ -241,7 +245,46 @@ class HuffmanCodec {
     return false;
   }
 
+  // Reads a code from |reader| and stores the matching value in |val|.
+  // Returns false if the stream terminates before a code was matched. Up to
+  // kMaxDecodingTableBits bits are looked up at once in the decoding table,
+  // and longer codes are finished one bit at a time.
+  bool DecodeFromStream(BitReaderWord64* reader, Val* val) const {
+    if (decoding_table_.empty()) return false;
+    const size_t num_remaining_bits = reader->GetNumRemainingBits();
+    const DecodingTableEntry& entry =
+        decoding_table_[reader->PeekBits(decoding_table_bits_)];
+    uint32_t node = entry.node;
+    size_t num_bits = entry.num_bits;
+    if (num_bits > num_remaining_bits) return false;
+
+    if (nodes_[node].left || nodes_[node].right) {
+      const uint64_t bits = reader->PeekBits(64);
+      do {
+        if (num_bits >= num_remaining_bits || num_bits >= 64) return false;
+        node = (bits >> num_bits) & 1 ? nodes_[node].right : nodes_[node].left;
+        ++num_bits;
+        assert(node);
+      } while (nodes_[node].left || nodes_[node].right);
+    }
+
+    reader->SkipBits(num_bits);
+    *val = nodes_[node].value;
+    return true;
+  }
+
  private:
+  // The maximal number of bits looked up at once by DecodeFromStream.
+  static const size_t kMaxDecodingTableBits = 8;
+
+  // The node reached from the root by following the first |num_bits| bits of
+  // the index of the entry.  The node is either a leaf, or the one reached
+  // after decoding_table_bits_ bits.
+  struct DecodingTableEntry {
+    uint32_t node;
+    uint32_t num_bits;
+  };
+
   // Returns value of the node referenced by |handle|.
   Val ValueOf(uint32_t node) const { return nodes_.at(node).value; }
 
@@ -357,6 +400,30 @@ class HuffmanCodec {
     }
   }
 
+  // Fills decoding_table_ with the nodes reached by every sequence of
+  // decoding_table_bits_ bits.  The codes from the tree are kept, so that the
+  // table decodes the same streams as walking the tree.
+  void CreateDecodingTable() {
+    decoding_table_bits_ = 0;
+    for (const auto& pair : encoding_table_) {
+      decoding_table_bits_ = std::max(decoding_table_bits_, pair.second.second);
+    }
+    decoding_table_bits_ =
+        std::min(decoding_table_bits_, kMaxDecodingTableBits);
+
+    decoding_table_.resize(size_t(1) << decoding_table_bits_);
+    for (size_t index = 0; index < decoding_table_.size(); ++index) {
+      uint32_t node = root_;
+      uint32_t num_bits = 0;
+      while ((LeftOf(node) || RightOf(node)) &&
+             num_bits < decoding_table_bits_) {
+        node = (index >> num_bits) & 1 ? RightOf(node) : LeftOf(node);
+        ++num_bits;
+      }
+      decoding_table_[index] = {node, num_bits};
+    }
+  }
+
   // Creates new Huffman tree node and stores it in the deleter array.
   uint32_t CreateNode() {
     const uint32_t handle = static_cast<uint32_t>(nodes_.size());
@@ -376,10 +443,18 @@ class HuffmanCodec {
   // impossible if frequencies are stored as uint32_t).
   std::unordered_map<Val, std::pair<uint64_t, size_t>> encoding_table_;
 
+  // Decoding table indexed by the next decoding_table_bits_ bits of the
+  // stream, the first bit being the lowest.
+  std::vector<DecodingTableEntry> decoding_table_;
+  size_t decoding_table_bits_ = 0;
+
   // Next node id issued by CreateNode();
   uint32_t next_node_id_ = 1;
 };
 
+template <class Val>
+const size_t HuffmanCodec<Val>::kMaxDecodingTableBits;
+
 }  // namespace spvutils
 
 #endif  // LIBSPIRV_UTIL_HUFFMAN_CODEC_H_
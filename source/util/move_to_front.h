@@ -20,6 +20,7 @@
 #include <cstdint>
 #include <iomanip>
 #include <iostream>
+#include <limits>
 #include <map>
 #include <ostream>
 #include <set>
@@ -310,105 +311,290 @@ class MoveToFront {
   bool last_accessed_value_valid_ = false;
 };
 
+// A set of move-to-front sequences, each identified by a uint64_t handle. A
+// value can be in several sequences, and can be promoted in all of them at
+// once. The ranks are the same as with one MoveToFront object per sequence.
+//
+// The sequences are stored in a dense array, indexed through a map from their
+// handles. Each sequence keeps its values in a flat array of slots, ordered
+// from the back of the sequence to its front: a value moved to the front is
+// appended, and the slot it leaves behind stays vacant until the sequence is
+// compacted, once half of its slots are vacant. A Fenwick tree counting the
+// occupied slots gives ranks in log time. Each value has a single list of
+// the sequences which contain it, and of its slots there.
 template <typename Val>
 class MultiMoveToFront {
  public:
   // Inserts |value| to sequence with handle |mtf|.
   // Returns false if |mtf| already has |value|.
   bool Insert(uint64_t mtf, const Val& value) {
-    if (GetMtf(mtf).Insert(value)) {
-      val_to_mtfs_[value].insert(mtf);
-      return true;
-    }
-    return false;
+    const uint32_t sequence = GetSequence(mtf);
+    const uint32_t value_index = GetOrCreateValueIndex(value);
+    if (FindEntry(value_index, sequence)) return false;
+    const uint32_t slot = PushFront(sequence, value_index);
+    entries_[value_index].push_back({sequence, slot});
+    return true;
   }
 
   // Removes |value| from sequence with handle |mtf|.
   // Returns false if |mtf| doesn't have |value|.
   bool Remove(uint64_t mtf, const Val& value) {
-    if (GetMtf(mtf).Remove(value)) {
-      val_to_mtfs_[value].erase(mtf);
-      return true;
-    }
-    assert(val_to_mtfs_[value].count(mtf) == 0);
-    return false;
+    const uint32_t sequence = GetSequence(mtf);
+    const uint32_t value_index = FindValueIndex(value);
+    if (value_index == kNoValue) return false;
+    Entry* entry = FindEntry(value_index, sequence);
+    if (!entry) return false;
+    Vacate(sequence, entry->slot);
+    std::vector<Entry>& entries = entries_[value_index];
+    *entry = entries.back();
+    entries.pop_back();
+    return true;
   }
 
   // Removes |value| from all sequences which have it.
   void RemoveFromAll(const Val& value) {
-    auto it = val_to_mtfs_.find(value);
-    if (it == val_to_mtfs_.end()) return;
-
-    auto& mtfs_containing_value = it->second;
-    for (uint64_t mtf : mtfs_containing_value) {
-      GetMtf(mtf).Remove(value);
+    const uint32_t value_index = FindValueIndex(value);
+    if (value_index == kNoValue) return;
+    for (const Entry& entry : entries_[value_index]) {
+      Vacate(entry.sequence, entry.slot);
     }
-
-    val_to_mtfs_.erase(value);
+    entries_[value_index].clear();
   }
 
   // Computes rank of |value| in sequence |mtf|.
   // Returns false if |mtf| doesn't have |value|.
   bool RankFromValue(uint64_t mtf, const Val& value, uint32_t* rank) {
-    return GetMtf(mtf).RankFromValue(value, rank);
+    const uint32_t sequence = GetSequence(mtf);
+    const uint32_t value_index = FindValueIndex(value);
+    if (value_index == kNoValue) return false;
+    Entry* entry = FindEntry(value_index, sequence);
+    if (!entry) return false;
+    *rank = RankOf(sequence, entry->slot);
+    if (*rank != 1) MoveToFront(entry);
+    return true;
   }
 
   // Finds |value| with |rank| in sequence |mtf|.
   // Returns false if |rank| is out of bounds.
   bool ValueFromRank(uint64_t mtf, uint32_t rank, Val* value) {
-    return GetMtf(mtf).ValueFromRank(rank, value);
+    const uint32_t sequence = GetSequence(mtf);
+    if (rank == 0 || rank > sequences_[sequence].size) return false;
+    const uint32_t value_index =
+        sequences_[sequence].slots[SlotOfRank(sequence, rank)];
+    *value = values_[value_index];
+    if (rank != 1) MoveToFront(FindEntry(value_index, sequence));
+    return true;
   }
 
   // Returns size of |mtf| sequence.
-  uint32_t GetSize(uint64_t mtf) { return GetMtf(mtf).GetSize(); }
+  uint32_t GetSize(uint64_t mtf) { return sequences_[GetSequence(mtf)].size; }
 
   // Promotes |value| in all sequences which have it.
   void Promote(const Val& value) {
-    const auto it = val_to_mtfs_.find(value);
-    if (it == val_to_mtfs_.end()) return;
-
-    const auto& mtfs_containing_value = it->second;
-    for (uint64_t mtf : mtfs_containing_value) {
-      GetMtf(mtf).Promote(value);
-    }
+    const uint32_t value_index = FindValueIndex(value);
+    if (value_index == kNoValue) return;
+    for (Entry& entry : entries_[value_index]) MoveToFront(&entry);
   }
 
   // Inserts |value| in sequence |mtf| or promotes if it's already there.
   void InsertOrPromote(uint64_t mtf, const Val& value) {
-    if (!Insert(mtf, value)) {
-      GetMtf(mtf).Promote(value);
+    const uint32_t sequence = GetSequence(mtf);
+    const uint32_t value_index = GetOrCreateValueIndex(value);
+    if (Entry* entry = FindEntry(value_index, sequence)) {
+      MoveToFront(entry);
+      return;
     }
+    const uint32_t slot = PushFront(sequence, value_index);
+    entries_[value_index].push_back({sequence, slot});
   }
 
   // Returns if |mtf| sequence has |value|.
   bool HasValue(uint64_t mtf, const Val& value) {
-    return GetMtf(mtf).HasValue(value);
+    const uint32_t value_index = FindValueIndex(value);
+    return value_index != kNoValue &&
+           FindEntry(value_index, GetSequence(mtf)) != nullptr;
   }
 
  private:
-  // Returns actual MoveToFront object corresponding to |handle|.
-  // As multiple operations are often performed consecutively for the same
-  // sequence, the last returned value is cached.
-  MoveToFront<Val>& GetMtf(uint64_t handle) {
-    if (!cached_mtf_ || cached_handle_ != handle) {
-      cached_handle_ = handle;
-      cached_mtf_ = &mtfs_[handle];
+  // Marks missing values, and vacant slots.
+  static const uint32_t kNoValue = std::numeric_limits<uint32_t>::max();
+
+  // A sequence which is compacted only has at least this many slots.
+  static const uint32_t kMinSlotsToCompact = 16;
+
+  // The slot of a value in a sequence.
+  struct Entry {
+    uint32_t sequence;
+    uint32_t slot;
+  };
+
+  // A move-to-front sequence.
+  struct Sequence {
+    // The value indices in the slots, from the back to the front of the
+    // sequence. Vacant slots hold kNoValue.
+    std::vector<uint32_t> slots;
+    // Fenwick tree over the slots, counting the occupied ones. Element i
+    // covers the slots [i - (i & -i), i), so element 0 is unused.
+    std::vector<uint32_t> counts = std::vector<uint32_t>(1, 0);
+    // The number of occupied slots.
+    uint32_t size = 0;
+  };
+
+  // Returns the lowest set bit of |i|.
+  static uint32_t LowestBit(uint32_t i) { return i & (~i + 1); }
+
+  // Returns the index of the sequence with handle |mtf|, creating it if
+  // needed. As multiple operations are often performed consecutively for the
+  // same sequence, the last returned index is cached.
+  uint32_t GetSequence(uint64_t mtf) {
+    if (cached_sequence_ != kNoValue && cached_handle_ == mtf) {
+      return cached_sequence_;
+    }
+    const auto result = sequence_indices_.emplace(
+        mtf, static_cast<uint32_t>(sequences_.size()));
+    if (result.second) sequences_.emplace_back();
+    cached_handle_ = mtf;
+    cached_sequence_ = result.first->second;
+    return cached_sequence_;
+  }
+
+  // Returns the index of |value|, or kNoValue if it was never inserted.
+  uint32_t FindValueIndex(const Val& value) const {
+    const auto it = value_indices_.find(value);
+    return it == value_indices_.end() ? kNoValue : it->second;
+  }
+
+  // Returns the index of |value|, creating one if needed.
+  uint32_t GetOrCreateValueIndex(const Val& value) {
+    const auto result = value_indices_.emplace(
+        value, static_cast<uint32_t>(values_.size()));
+    if (result.second) {
+      values_.push_back(value);
+      entries_.emplace_back();
+    }
+    return result.first->second;
+  }
+
+  // Returns the entry of the value with |value_index| in |sequence|, or
+  // nullptr if the sequence doesn't have it.
+  Entry* FindEntry(uint32_t value_index, uint32_t sequence) {
+    for (Entry& entry : entries_[value_index]) {
+      if (entry.sequence == sequence) return &entry;
+    }
+    return nullptr;
+  }
+
+  // Returns the rank of the value in |slot| of |sequence|.
+  uint32_t RankOf(uint32_t sequence, uint32_t slot) const {
+    const Sequence& seq = sequences_[sequence];
+    // Count the occupied slots before |slot|.
+    uint32_t count = 0;
+    for (uint32_t i = slot; i > 0; i -= LowestBit(i)) count += seq.counts[i];
+    return seq.size - count;
+  }
+
+  // Returns the slot of the value with |rank| in |sequence|. |rank| must be
+  // in [1, size].
+  uint32_t SlotOfRank(uint32_t sequence, uint32_t rank) const {
+    const Sequence& seq = sequences_[sequence];
+    const uint32_t num_slots = static_cast<uint32_t>(seq.slots.size());
+    // Find the slot preceded by |remaining| - 1 occupied slots.
+    uint32_t remaining = seq.size - rank + 1;
+    uint32_t step = 1;
+    while (step * 2 <= num_slots) step *= 2;
+    uint32_t slot = 0;
+    for (; step; step /= 2) {
+      if (slot + step <= num_slots && seq.counts[slot + step] < remaining) {
+        slot += step;
+        remaining -= seq.counts[slot];
+      }
     }
+    assert(seq.slots[slot] != kNoValue);
+    return slot;
+  }
 
-    return *cached_mtf_;
+  // Puts the value with |value_index| at the front of |sequence|, and
+  // returns its slot.
+  uint32_t PushFront(uint32_t sequence, uint32_t value_index) {
+    Sequence& seq = sequences_[sequence];
+    if (seq.slots.size() >= kMinSlotsToCompact &&
+        seq.slots.size() >= 2 * size_t(seq.size)) {
+      Compact(sequence);
+    }
+    const uint32_t slot = static_cast<uint32_t>(seq.slots.size());
+    seq.slots.push_back(value_index);
+    // The new element of the tree covers the new slot, and the elements
+    // below it which cover the slots since the last one it doesn't cover.
+    const uint32_t i = slot + 1;
+    uint32_t count = 1;
+    for (uint32_t j = i - 1; j > i - LowestBit(i); j -= LowestBit(j)) {
+      count += seq.counts[j];
+    }
+    seq.counts.push_back(count);
+    ++seq.size;
+    return slot;
+  }
+
+  // Removes the value in |slot| from |sequence|.
+  void Vacate(uint32_t sequence, uint32_t slot) {
+    Sequence& seq = sequences_[sequence];
+    assert(seq.slots[slot] != kNoValue);
+    seq.slots[slot] = kNoValue;
+    for (uint32_t i = slot + 1; i < seq.counts.size(); i += LowestBit(i)) {
+      --seq.counts[i];
+    }
+    --seq.size;
+  }
+
+  // Moves the value of |entry| to the front of its sequence.
+  void MoveToFront(Entry* entry) {
+    const Sequence& seq = sequences_[entry->sequence];
+    if (entry->slot + 1 == seq.slots.size()) return;
+    const uint32_t value_index = seq.slots[entry->slot];
+    Vacate(entry->sequence, entry->slot);
+    entry->slot = PushFront(entry->sequence, value_index);
+  }
+
+  // Drops the vacant slots of |sequence|, and updates the slots of its
+  // values.
+  void Compact(uint32_t sequence) {
+    Sequence& seq = sequences_[sequence];
+    uint32_t num_slots = 0;
+    for (uint32_t value_index : seq.slots) {
+      if (value_index == kNoValue) continue;
+      FindEntry(value_index, sequence)->slot = num_slots;
+      seq.slots[num_slots++] = value_index;
+    }
+    seq.slots.resize(num_slots);
+    seq.counts.assign(num_slots + 1, 0);
+    for (uint32_t i = 1; i <= num_slots; ++i) {
+      ++seq.counts[i];
+      const uint32_t parent = i + LowestBit(i);
+      if (parent <= num_slots) seq.counts[parent] += seq.counts[i];
+    }
   }
 
-  // Container holding MoveToFront objects. Map key is sequence handle.
-  std::map<uint64_t, MoveToFront<Val>> mtfs_;
+  // The sequences, and the map from their handles to their indices.
+  std::vector<Sequence> sequences_;
+  std::unordered_map<uint64_t, uint32_t> sequence_indices_;
 
-  // Container mapping value to sequences which contain that value.
-  std::unordered_map<Val, std::set<uint64_t>> val_to_mtfs_;
+  // The values, the map from them to their indices, and the entries of each
+  // value in the sequences which have it.
+  std::vector<Val> values_;
+  std::unordered_map<Val, uint32_t> value_indices_;
+  std::vector<std::vector<Entry>> entries_;
 
   // Cache for the last accessed sequence.
   uint64_t cached_handle_ = 0;
-  MoveToFront<Val>* cached_mtf_ = nullptr;
+  uint32_t cached_sequence_ = kNoValue;
 };
 
+template <typename Val>
+const uint32_t MultiMoveToFront<Val>::kNoValue;
+
+template <typename Val>
+const uint32_t MultiMoveToFront<Val>::kMinSlotsToCompact;
+
 template <typename Val>
 bool MoveToFront<Val>::Insert(const Val& value) {
   auto it = value_to_node_.find(value);
@@ -0,0 +1,170 @@
+// Copyright (c) 2018 Google LLC
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#ifndef LIBSPIRV_UTIL_PARALLEL_H_
+#define LIBSPIRV_UTIL_PARALLEL_H_
+
+#include <algorithm>
+#include <atomic>
+#include <condition_variable>
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+namespace spvutils {
+
+// Calls |fn(i)| for every |i| in [0, |count|) using at most |thread_count|
+// threads, including the calling thread. Indices are handed out one at a time
+// from a shared counter, so a thread that finishes early picks up the
+// remaining work. Returns once every call has completed.
+//
+// If |thread_count| is 0 or 1 the calls are made on the calling thread in
+// increasing order of |i|. Otherwise the order is unspecified and |fn| must be
+// safe to call concurrently for different indices.
+template <typename Fn>
+void ParallelFor(size_t count, uint32_t thread_count, const Fn& fn) {
+  const size_t num_threads =
+      std::min(count, static_cast<size_t>(std::max(thread_count, 1u)));
+  if (num_threads <= 1) {
+    for (size_t i = 0; i < count; ++i) fn(i);
+    return;
+  }
+
+  std::atomic<size_t> next(0);
+  auto worker = [&next, count, &fn]() {
+    for (size_t i = next++; i < count; i = next++) fn(i);
+  };
+
+  std::vector<std::thread> threads;
+  threads.reserve(num_threads - 1);
+  for (size_t t = 1; t < num_threads; ++t) threads.emplace_back(worker);
+  worker();
+  for (auto& thread : threads) thread.join();
+}
+
+// A set of worker threads that is started once and then runs any number of
+// ParallelFor() loops, so that a caller running several of them in a row does
+// not start and join threads for each one.
+class ThreadPool {
+ public:
+  // Starts |thread_count| - 1 worker threads.  The thread calling
+  // ParallelFor() is the remaining one.  If |thread_count| is 0 or 1, no
+  // thread is started and every loop runs on the calling thread.
+  explicit ThreadPool(uint32_t thread_count)
+      : thread_count_(std::max(thread_count, 1u)),
+        stop_(false),
+        generation_(0),
+        count_(0),
+        fn_(nullptr),
+        next_(0),
+        busy_(0) {
+    workers_.reserve(thread_count_ - 1);
+    for (uint32_t t = 1; t < thread_count_; ++t) {
+      workers_.emplace_back([this]() { Work(); });
+    }
+  }
+  ThreadPool(const ThreadPool&) = delete;
+  ThreadPool& operator=(const ThreadPool&) = delete;
+
+  ~ThreadPool() {
+    {
+      std::lock_guard<std::mutex> lock(mutex_);
+      stop_ = true;
+    }
+    start_.notify_all();
+    for (auto& worker : workers_) worker.join();
+  }
+
+  // Returns the number of threads, including the calling thread, that the
+  // loops run on.
+  uint32_t thread_count() const { return thread_count_; }
+
+  // Same as spvutils::ParallelFor() with the thread count of this pool.  Only
+  // one loop runs at a time; |fn| must not start another one on this pool.
+  template <typename Fn>
+  void ParallelFor(size_t count, const Fn& fn) {
+    if (workers_.empty() || count <= 1) {
+      for (size_t i = 0; i < count; ++i) fn(i);
+      return;
+    }
+
+    std::function<void(size_t)> job(std::cref(fn));
+    {
+      std::lock_guard<std::mutex> lock(mutex_);
+      count_ = count;
+      fn_ = &job;
+      next_ = 0;
+      busy_ = workers_.size();
+      ++generation_;
+    }
+    start_.notify_all();
+    RunLoop(count, job);
+    std::unique_lock<std::mutex> lock(mutex_);
+    done_.wait(lock, [this]() { return busy_ == 0; });
+    fn_ = nullptr;
+  }
+
+ private:
+  // Calls |fn| for the indices of the current loop that are left.
+  void RunLoop(size_t count, const std::function<void(size_t)>& fn) {
+    for (size_t i = next_++; i < count; i = next_++) fn(i);
+  }
+
+  // The body of a worker thread: waits for a loop, helps run it, and signals
+  // when it is done, until the pool is destroyed.
+  void Work() {
+    uint64_t seen = 0;
+    while (true) {
+      size_t count;
+      const std::function<void(size_t)>* fn;
+      {
+        std::unique_lock<std::mutex> lock(mutex_);
+        start_.wait(lock, [this, seen]() {
+          return stop_ || generation_ != seen;
+        });
+        if (stop_) return;
+        seen = generation_;
+        count = count_;
+        fn = fn_;
+      }
+      RunLoop(count, *fn);
+      {
+        std::lock_guard<std::mutex> lock(mutex_);
+        --busy_;
+      }
+      done_.notify_one();
+    }
+  }
+
+  const uint32_t thread_count_;
+  std::vector<std::thread> workers_;
+
+  std::mutex mutex_;
+  std::condition_variable start_;  // Signals a new loop, or stop_.
+  std::condition_variable done_;   // Signals a worker finishing a loop.
+  // The state below is guarded by |mutex_|, except for |next_|.
+  bool stop_;
+  uint64_t generation_;  // Counts the loops started so far.
+  size_t count_;         // The number of indices of the current loop.
+  const std::function<void(size_t)>* fn_;  // The body of the current loop.
+  std::atomic<size_t> next_;  // The next index of the current loop.
+  size_t busy_;               // The workers still in the current loop.
+};
+
+}  // namespace spvutils
+
+#endif  // LIBSPIRV_UTIL_PARALLEL_H_
@@ -0,0 +1,269 @@
+// Copyright (c) 2018 Google LLC
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#ifndef LIBSPIRV_UTIL_SMALL_VECTOR_H_
+#define LIBSPIRV_UTIL_SMALL_VECTOR_H_
+
+#include <algorithm>
+#include <cassert>
+#include <cstddef>
+#include <cstdint>
+#include <initializer_list>
+#include <iterator>
+#include <new>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+namespace spvtools {
+namespace utils {
+
+// A vector that stores up to |small_size| elements inline, and only allocates
+// memory on the heap once it grows past that.  It supports the subset of the
+// std::vector interface used in this code base.  Iterators are plain
+// pointers, and are invalidated by any operation that changes the size, as
+// well as by moving the vector while its elements are stored inline.
+template <class T, size_t small_size>
+class SmallVector {
+ public:
+  using value_type = T;
+  using size_type = size_t;
+  using difference_type = ptrdiff_t;
+  using reference = T&;
+  using const_reference = const T&;
+  using pointer = T*;
+  using const_pointer = const T*;
+  using iterator = T*;
+  using const_iterator = const T*;
+
+  SmallVector() : data_(small_data()), size_(0), capacity_(small_size) {}
+
+  SmallVector(const SmallVector& that) : SmallVector() {
+    append(that.begin(), that.end());
+  }
+
+  // Moving does not throw as long as moving the elements does not, so that
+  // containers of SmallVectors move them when they grow.
+  SmallVector(SmallVector&& that) noexcept(
+      std::is_nothrow_move_constructible<T>::value)
+      : SmallVector() {
+    steal(&that);
+  }
+
+  SmallVector(std::initializer_list<T> init) : SmallVector() {
+    append(init.begin(), init.end());
+  }
+
+  SmallVector(const std::vector<T>& vec) : SmallVector() {
+    append(vec.begin(), vec.end());
+  }
+
+  // Creates a vector with a copy of the elements in [first, last).
+  template <class InputIt, class = typename std::enable_if<
+                               !std::is_integral<InputIt>::value>::type>
+  SmallVector(InputIt first, InputIt last) : SmallVector() {
+    append(first, last);
+  }
+
+  ~SmallVector() {
+    clear();
+    if (!is_small()) ::operator delete(data_);
+  }
+
+  SmallVector& operator=(const SmallVector& that) {
+    if (this != &that) {
+      clear();
+      append(that.begin(), that.end());
+    }
+    return *this;
+  }
+
+  SmallVector& operator=(SmallVector&& that) noexcept(
+      std::is_nothrow_move_constructible<T>::value) {
+    if (this != &that) {
+      clear();
+      steal(&that);
+    }
+    return *this;
+  }
+
+  SmallVector& operator=(std::initializer_list<T> init) {
+    clear();
+    append(init.begin(), init.end());
+    return *this;
+  }
+
+  SmallVector& operator=(const std::vector<T>& vec) {
+    clear();
+    append(vec.begin(), vec.end());
+    return *this;
+  }
+
+  size_t size() const { return size_; }
+  size_t capacity() const { return capacity_; }
+  bool empty() const { return size_ == 0; }
+
+  T* data() { return data_; }
+  const T* data() const { return data_; }
+
+  iterator begin() { return data_; }
+  iterator end() { return data_ + size_; }
+  const_iterator begin() const { return data_; }
+  const_iterator end() const { return data_ + size_; }
+  const_iterator cbegin() const { return data_; }
+  const_iterator cend() const { return data_ + size_; }
+
+  T& operator[](size_t index) {
+    assert(index < size_);
+    return data_[index];
+  }
+  const T& operator[](size_t index) const {
+    assert(index < size_);
+    return data_[index];
+  }
+
+  T& front() { return (*this)[0]; }
+  const T& front() const { return (*this)[0]; }
+  T& back() { return (*this)[size_ - 1]; }
+  const T& back() const { return (*this)[size_ - 1]; }
+
+  void reserve(size_t new_capacity) {
+    if (new_capacity <= capacity_) return;
+    T* new_data = static_cast<T*>(::operator new(new_capacity * sizeof(T)));
+    for (size_t i = 0; i < size_; ++i) {
+      new (new_data + i) T(std::move(data_[i]));
+      data_[i].~T();
+    }
+    if (!is_small()) ::operator delete(data_);
+    data_ = new_data;
+    capacity_ = static_cast<uint32_t>(new_capacity);
+  }
+
+  void push_back(const T& value) { emplace_back(value); }
+  void push_back(T&& value) { emplace_back(std::move(value)); }
+
+  template <class... Args>
+  void emplace_back(Args&&... args) {
+    if (size_ == capacity_) {
+      // |args| may refer to an element of this vector, so construct the new
+      // element before moving the old ones.
+      T value(std::forward<Args>(args)...);
+      grow(size_ + 1);
+      new (data_ + size_) T(std::move(value));
+    } else {
+      new (data_ + size_) T(std::forward<Args>(args)...);
+    }
+    ++size_;
+  }
+
+  void pop_back() {
+    assert(size_ > 0);
+    data_[--size_].~T();
+  }
+
+  void clear() {
+    for (size_t i = 0; i < size_; ++i) data_[i].~T();
+    size_ = 0;
+  }
+
+  // Inserts a copy of the elements in [first, last) before |pos|.  Returns an
+  // iterator to the first inserted element.  The range must not be part of
+  // this vector.
+  template <class InputIt>
+  iterator insert(const_iterator pos, InputIt first, InputIt last) {
+    const size_t index = pos - data_;
+    assert(index <= size_);
+    const size_t old_size = size_;
+    append(first, last);
+    std::rotate(data_ + index, data_ + old_size, data_ + size_);
+    return data_ + index;
+  }
+
+  // Removes the elements in [first, last).  Returns an iterator to the element
+  // following the removed ones.
+  iterator erase(const_iterator first, const_iterator last) {
+    T* const dest = data_ + (first - data_);
+    T* const new_end = std::move(dest + (last - first), end(), dest);
+    for (T* it = new_end; it != end(); ++it) it->~T();
+    size_ = static_cast<uint32_t>(new_end - data_);
+    return dest;
+  }
+
+  iterator erase(const_iterator pos) { return erase(pos, pos + 1); }
+
+  friend bool operator==(const SmallVector& a, const SmallVector& b) {
+    return a.size() == b.size() && std::equal(a.begin(), a.end(), b.begin());
+  }
+  friend bool operator==(const SmallVector& a, const std::vector<T>& b) {
+    return a.size() == b.size() && std::equal(a.begin(), a.end(), b.begin());
+  }
+  friend bool operator==(const std::vector<T>& a, const SmallVector& b) {
+    return b == a;
+  }
+  friend bool operator!=(const SmallVector& a, const SmallVector& b) {
+    return !(a == b);
+  }
+  friend bool operator!=(const SmallVector& a, const std::vector<T>& b) {
+    return !(a == b);
+  }
+  friend bool operator!=(const std::vector<T>& a, const SmallVector& b) {
+    return !(b == a);
+  }
+
+ private:
+  T* small_data() { return reinterpret_cast<T*>(small_data_); }
+  bool is_small() const {
+    return data_ == reinterpret_cast<const T*>(small_data_);
+  }
+
+  // Makes room for at least |min_capacity| elements.
+  void grow(size_t min_capacity) {
+    reserve(std::max<size_t>(min_capacity, 2 * capacity_));
+  }
+
+  // Appends a copy of the elements in [first, last).
+  template <class InputIt>
+  void append(InputIt first, InputIt last) {
+    for (; first != last; ++first) emplace_back(*first);
+  }
+
+  // Takes over the elements of |that|, leaving it empty.  Assumes this vector
+  // is empty.
+  void steal(SmallVector* that) {
+    assert(size_ == 0);
+    if (that->is_small()) {
+      for (T& element : *that) emplace_back(std::move(element));
+      that->clear();
+      return;
+    }
+    if (!is_small()) ::operator delete(data_);
+    data_ = that->data_;
+    size_ = that->size_;
+    capacity_ = that->capacity_;
+    that->data_ = that->small_data();
+    that->size_ = 0;
+    that->capacity_ = small_size;
+  }
+
+  T* data_;
+  uint32_t size_;
+  uint32_t capacity_;
+  typename std::aligned_storage<sizeof(T), alignof(T)>::type
+      small_data_[small_size];
+};
+
+}  // namespace utils
+}  // namespace spvtools
+
+#endif  // LIBSPIRV_UTIL_SMALL_VECTOR_H_
@@ -0,0 +1,67 @@
+// Copyright (c) 2018 Google LLC
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "util/timer.h"
+
+#include <chrono>
+#include <ctime>
+
+#if defined(SPIRV_ANDROID) || defined(SPIRV_LINUX) || defined(SPIRV_MAC) || \
+    defined(SPIRV_FREEBSD)
+#include <sys/resource.h>
+#include <sys/time.h>
+#endif
+
+namespace spvutils {
+
+namespace {
+
+// Returns the wall-clock time in seconds since an arbitrary fixed point.
+double WallSeconds() {
+  return std::chrono::duration<double>(
+             std::chrono::steady_clock::now().time_since_epoch())
+      .count();
+}
+
+}  // anonymous namespace
+
+#if defined(SPIRV_ANDROID) || defined(SPIRV_LINUX) || defined(SPIRV_MAC) || \
+    defined(SPIRV_FREEBSD)
+
+ResourceUsage GetResourceUsage() {
+  ResourceUsage usage = {WallSeconds(), 0, 0};
+  struct rusage ru;
+  if (getrusage(RUSAGE_SELF, &ru) == 0) {
+    usage.cpu_seconds = ru.ru_utime.tv_sec + ru.ru_utime.tv_usec * 1e-6 +
+                        ru.ru_stime.tv_sec + ru.ru_stime.tv_usec * 1e-6;
+#if defined(SPIRV_MAC)
+    // Reported in bytes on macOS, and in kilobytes elsewhere.
+    usage.peak_rss_kb = static_cast<uint64_t>(ru.ru_maxrss) / 1024;
+#else
+    usage.peak_rss_kb = static_cast<uint64_t>(ru.ru_maxrss);
+#endif
+  }
+  return usage;
+}
+
+#else
+
+ResourceUsage GetResourceUsage() {
+  return {WallSeconds(), static_cast<double>(std::clock()) / CLOCKS_PER_SEC,
+          0};
+}
+
+#endif
+
+}  // namespace spvutils
@@ -0,0 +1,38 @@
+// Copyright (c) 2018 Google LLC
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#ifndef LIBSPIRV_UTIL_TIMER_H_
+#define LIBSPIRV_UTIL_TIMER_H_
+
+#include <cstdint>
+
+namespace spvutils {
+
+// A snapshot of the time and memory used by the process so far.
+struct ResourceUsage {
+  // Wall-clock time, in seconds since an arbitrary fixed point.
+  double wall_seconds;
+  // CPU time used by all threads of the process, in seconds.
+  double cpu_seconds;
+  // Peak resident set size of the process, in kilobytes.  This is 0 on
+  // platforms where it is not available.
+  uint64_t peak_rss_kb;
+};
+
+// Returns the resources used by the process so far.
+ResourceUsage GetResourceUsage();
+
+}  // namespace spvutils
+
+#endif  // LIBSPIRV_UTIL_TIMER_H_
@@ -67,8 +67,8 @@ spv_result_t Function::RegisterFunctionParameter(uint32_t parameter_id,
          "ouside of a block");
   // TODO(umar): Validate function parameter type order and count
   // TODO(umar): Use these variables to validate parameter type
-  (void)parameter_id;
   (void)type_id;
+  parameter_ids_.push_back(parameter_id);
   return SPV_SUCCESS;
 }
 
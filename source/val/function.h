@@ -141,6 +141,12 @@ class Function {
   /// Returns return type id of the function
   uint32_t GetResultTypeId() const { return result_type_id_; }
 
+  /// Returns the id of the OpTypeFunction instruction of the function
+  uint32_t function_type_id() const { return function_type_id_; }
+
+  /// Returns the ids of the function's parameters in declaration order
+  const std::vector<uint32_t>& parameter_ids() const { return parameter_ids_; }
+
   /// Returns the number of blocks in the current function being parsed
   size_t undefined_block_count() const;
   const std::unordered_set<uint32_t>& undefined_blocks() const {
@@ -17,6 +17,7 @@
 #include <cassert>
 
 #include "opcode.h"
+#include "spirv_validator_options.h"
 #include "val/basic_block.h"
 #include "val/construct.h"
 #include "val/function.h"
@@ -155,6 +156,7 @@ ValidationState_t::ValidationState_t(const spv_const_context ctx,
       memory_model_(SpvMemoryModelSimple),
       in_function_(false) {
   assert(opt && "Validator options may not be Null.");
+  thread_pool_.reset(new spvutils::ThreadPool(opt->thread_count));
 }
 
 spv_result_t ValidationState_t::ForwardDeclareId(uint32_t id) {
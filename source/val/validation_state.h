@@ -16,6 +16,7 @@
 #define LIBSPIRV_VAL_VALIDATIONSTATE_H_
 
 #include <deque>
+#include <memory>
 #include <set>
 #include <string>
 #include <tuple>
@@ -30,6 +31,7 @@
 #include "latest_version_spirv_header.h"
 #include "spirv-tools/libspirv.h"
 #include "spirv_definition.h"
+#include "util/parallel.h"
 #include "val/function.h"
 #include "val/instruction.h"
 
@@ -84,6 +86,11 @@ class ValidationState_t {
   /// Returns the command line options
   spv_const_validator_options options() const { return options_; }
 
+  /// Returns the threads that the checks run after parsing may use, as set
+  /// by the thread count of the options.  They are started once and shared
+  /// by all of those checks.
+  spvutils::ThreadPool& thread_pool() const { return *thread_pool_; }
+
   /// Forward declares the id in the module
   spv_result_t ForwardDeclareId(uint32_t id);
 
@@ -511,6 +518,9 @@ class ValidationState_t {
 
   /// Maps function ids to function stat objects.
   std::unordered_map<uint32_t, Function*> id_to_function_;
+
+  /// The threads of the checks run after parsing.
+  std::unique_ptr<spvutils::ThreadPool> thread_pool_;
 };
 
 }  // namespace libspirv
@@ -57,21 +57,6 @@ using libspirv::LiteralsPass;
 using libspirv::ModuleLayoutPass;
 using libspirv::ValidationState_t;
 
-spv_result_t spvValidateIDs(const spv_instruction_t* pInsts,
-                            const uint64_t count,
-                            const spv_opcode_table opcodeTable,
-                            const spv_operand_table operandTable,
-                            const spv_ext_inst_table extInstTable,
-                            const ValidationState_t& state,
-                            spv_position position) {
-  position->index = SPV_INDEX_INSTRUCTION;
-  if (auto error =
-          spvValidateInstructionIDs(pInsts, count, opcodeTable, operandTable,
-                                    extInstTable, state, position))
-    return error;
-  return SPV_SUCCESS;
-}
-
 namespace {
 
 // TODO(umar): Validate header
@@ -122,37 +107,56 @@ void DebugInstructionPass(ValidationState_t& _,
   }
 }
 
-// Parses OpExtension instruction and registers extension.
-void RegisterExtension(ValidationState_t& _,
-                       const spv_parsed_instruction_t* inst) {
-  const std::string extension_str = libspirv::GetExtensionString(inst);
-  Extension extension;
-  if (!GetExtensionFromString(extension_str.c_str(), &extension)) {
-    // The error will be logged in the ProcessInstruction pass.
-    return;
+// Decodes the literal string of the OpExtension instruction starting at
+// |words| and registers the extension if it is recognized.
+void RegisterExtension(ValidationState_t& _, const uint32_t* words,
+                       uint16_t word_count, spv_endianness_t endian) {
+  std::string extension_str;
+  // The string starts at word 1. Characters are packed little-endian into
+  // each word and the string is nul-terminated.
+  for (uint16_t i = 1; i < word_count; ++i) {
+    const uint32_t word = spvFixWord(words[i], endian);
+    for (int byte = 0; byte < 4; ++byte) {
+      const char c = static_cast<char>((word >> (8 * byte)) & 0xff);
+      if (c == '\0') {
+        Extension extension;
+        // An unrecognized extension will be logged in the ProcessInstruction
+        // pass.
+        if (GetExtensionFromString(extension_str.c_str(), &extension)) {
+          _.RegisterExtension(extension);
+        }
+        return;
+      }
+      extension_str.push_back(c);
+    }
   }
-
-  _.RegisterExtension(extension);
+  // Missing terminator. The binary parser will report the error.
 }
 
-// Parses the beginning of the module searching for OpExtension instructions.
-// Registers extensions if recognized. Returns SPV_REQUESTED_TERMINATION
-// once an instruction which is not SpvOpCapability and SpvOpExtension is
-// encountered. According to the SPIR-V spec extensions are declared after
-// capabilities and before everything else.
-spv_result_t ProcessExtensions(void* user_data,
-                               const spv_parsed_instruction_t* inst) {
-  const SpvOp opcode = static_cast<SpvOp>(inst->opcode);
-  if (opcode == SpvOpCapability) return SPV_SUCCESS;
-
-  if (opcode == SpvOpExtension) {
-    ValidationState_t& _ = *(reinterpret_cast<ValidationState_t*>(user_data));
-    RegisterExtension(_, inst);
-    return SPV_SUCCESS;
+// Scans the beginning of the module searching for OpExtension instructions
+// and registers the recognized extensions. According to the SPIR-V spec
+// extensions are declared after capabilities and before everything else, so
+// the scan stops at the first instruction which is not SpvOpCapability or
+// SpvOpExtension. This only splits the leading instruction words, so it is
+// much cheaper than running the binary parser over the whole module.
+void ProcessExtensions(ValidationState_t& _, const uint32_t* words,
+                       size_t num_words, spv_endianness_t endian) {
+  size_t index = SPV_INDEX_INSTRUCTION;
+  while (index < num_words) {
+    uint16_t word_count;
+    uint16_t opcode;
+    spvOpcodeSplit(spvFixWord(words[index], endian), &word_count, &opcode);
+    // Malformed instructions are diagnosed by the binary parser.
+    if (word_count == 0 || word_count > num_words - index) return;
+
+    if (opcode == SpvOpExtension) {
+      RegisterExtension(_, words + index, word_count, endian);
+    } else if (opcode != SpvOpCapability) {
+      // OpExtension block is finished.
+      return;
+    }
+    index += word_count;
   }
-
-  // OpExtension block is finished, requesting termination.
-  return SPV_REQUESTED_TERMINATION;
 }
 
 spv_result_t ProcessInstruction(void* user_data,
@@ -261,12 +265,12 @@ spv_result_t ValidateBinaryUsingContextAndValidationState(
 
   // Look for OpExtension instructions and register extensions.
   // Diagnostics if any will be produced in the next pass (ProcessInstruction).
-  spvBinaryParse(&context, vstate, words, num_words,
-                 /* parsed_header = */ nullptr, ProcessExtensions,
-                 /* diagnostic = */ nullptr);
+  ProcessExtensions(*vstate, words, num_words, endian);
 
   // NOTE: Parse the module and perform inline validation checks. These
-  // checks do not require the the knowledge of the whole module.
+  // checks do not require the the knowledge of the whole module. This is the
+  // only full parse of the module; the remaining checks work on the
+  // instructions recorded in |vstate|.
   if (auto error = spvBinaryParse(&context, vstate, words, num_words, setHeader,
                                   ProcessInstruction, pDiagnostic))
     return error;
@@ -323,27 +327,11 @@ spv_result_t ValidateBinaryUsingContextAndValidationState(
     }
   }
 
-  // NOTE: Copy each instruction for easier processing
-  std::vector<spv_instruction_t> instructions;
-  // Expect average instruction length to be a bit over 2 words.
-  instructions.reserve(binary->wordCount / 2);
-  uint64_t index = SPV_INDEX_INSTRUCTION;
-  while (index < binary->wordCount) {
-    uint16_t wordCount;
-    uint16_t opcode;
-    spvOpcodeSplit(spvFixWord(binary->code[index], endian), &wordCount,
-                   &opcode);
-    spv_instruction_t inst;
-    spvInstructionCopy(&binary->code[index], static_cast<SpvOp>(opcode),
-                       wordCount, endian, &inst);
-    instructions.emplace_back(std::move(inst));
-    index += wordCount;
-  }
-
+  // NOTE: The ID checks run over the instructions recorded in |vstate| while
+  // parsing, rather than over a fresh copy of the binary.
   position.index = SPV_INDEX_INSTRUCTION;
-  return spvValidateIDs(instructions.data(), instructions.size(),
-                        context.opcode_table, context.operand_table,
-                        context.ext_inst_table, *vstate, &position);
+  return spvValidateInstructionIDs(context.opcode_table, context.operand_table,
+                                   context.ext_inst_table, *vstate, &position);
 }
 }  // anonymous namespace
 
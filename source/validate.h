@@ -180,17 +180,16 @@ spv_result_t PrimitivesPass(ValidationState_t& _,
 
 /// @brief Validate the ID usage of the instruction stream
 ///
-/// @param[in] pInsts stream of instructions
-/// @param[in] instCount number of instructions
+/// The instructions are the ones recorded in the validation state while the
+/// module was parsed.
+///
 /// @param[in] opcodeTable table of specified Opcodes
 /// @param[in] operandTable table of specified operands
-/// @param[in] usedefs use-def info from module parsing
+/// @param[in] state validation state holding the parsed instructions
 /// @param[in,out] position current position in the stream
 ///
 /// @return result code
-spv_result_t spvValidateInstructionIDs(const spv_instruction_t* pInsts,
-                                       const uint64_t instCount,
-                                       const spv_opcode_table opcodeTable,
+spv_result_t spvValidateInstructionIDs(const spv_opcode_table opcodeTable,
                                        const spv_operand_table operandTable,
                                        const spv_ext_inst_table extInstTable,
                                        const libspirv::ValidationState_t& state,
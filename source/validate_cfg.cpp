@@ -256,8 +256,70 @@ spv_result_t StructuredControlFlowChecks(
   return SPV_SUCCESS;
 }
 
+/// Sets each block's immediate dominator and immediate postdominator, and
+/// finds all back-edges of |function|. Only the blocks and constructs of
+/// |function| are modified, so different functions may be analyzed
+/// concurrently.
+void AnalyzeFunctionCfg(Function& function,
+                        vector<pair<uint32_t, uint32_t>>* back_edges) {
+  // We want to analyze all the blocks in the function, even in degenerate
+  // control flow cases including unreachable blocks.  So use the augmented
+  // CFG to ensure we cover all the blocks.
+  vector<const BasicBlock*> postorder;
+  vector<const BasicBlock*> postdom_postorder;
+  auto ignore_block = [](cbb_ptr) {};
+  auto ignore_edge = [](cbb_ptr, cbb_ptr) {};
+  if (!function.ordered_blocks().empty()) {
+    /// calculate dominators
+    spvtools::CFA<libspirv::BasicBlock>::DepthFirstTraversal(
+        function.first_block(), function.AugmentedCFGSuccessorsFunction(),
+        ignore_block, [&](cbb_ptr b) { postorder.push_back(b); },
+        ignore_edge);
+    auto edges = spvtools::CFA<libspirv::BasicBlock>::CalculateDominators(
+        postorder, function.AugmentedCFGPredecessorsFunction());
+    for (auto edge : edges) {
+      edge.first->SetImmediateDominator(edge.second);
+    }
+
+    /// calculate post dominators
+    spvtools::CFA<libspirv::BasicBlock>::DepthFirstTraversal(
+        function.pseudo_exit_block(),
+        function.AugmentedCFGPredecessorsFunction(), ignore_block,
+        [&](cbb_ptr b) { postdom_postorder.push_back(b); }, ignore_edge);
+    auto postdom_edges =
+        spvtools::CFA<libspirv::BasicBlock>::CalculateDominators(
+            postdom_postorder, function.AugmentedCFGSuccessorsFunction());
+    for (auto edge : postdom_edges) {
+      edge.first->SetImmediatePostDominator(edge.second);
+    }
+    /// calculate back edges.
+    spvtools::CFA<libspirv::BasicBlock>::DepthFirstTraversal(
+        function.pseudo_entry_block(),
+        function.AugmentedCFGSuccessorsFunctionIncludingHeaderToContinueEdge(),
+        ignore_block, ignore_block, [&](cbb_ptr from, cbb_ptr to) {
+          back_edges->emplace_back(from->id(), to->id());
+        });
+  }
+  UpdateContinueConstructExitBlocks(function, *back_edges);
+}
+
 spv_result_t PerformCfgChecks(ValidationState_t& _) {
-  for (auto& function : _.functions()) {
+  // The dominance analysis of a function only depends on that function, so
+  // it is done up front, possibly on several threads. The checks below then
+  // run in module order so the reported diagnostic does not depend on the
+  // thread count.
+  auto& functions = _.functions();
+  vector<vector<pair<uint32_t, uint32_t>>> function_back_edges(
+      functions.size());
+  _.thread_pool().ParallelFor(functions.size(), [&](size_t i) {
+    // Functions referencing undefined blocks are rejected below.
+    if (functions[i].undefined_block_count() != 0) return;
+    AnalyzeFunctionCfg(functions[i], &function_back_edges[i]);
+  });
+
+  for (size_t i = 0; i < functions.size(); ++i) {
+    auto& function = functions[i];
+    const auto& back_edges = function_back_edges[i];
     // Check all referenced blocks are defined within a function
     if (function.undefined_block_count() != 0) {
       string undef_blocks("{");
@@ -270,51 +332,6 @@ spv_result_t PerformCfgChecks(ValidationState_t& _) {
              << _.getIdName(function.id());
     }
 
-    // Set each block's immediate dominator and immediate postdominator,
-    // and find all back-edges.
-    //
-    // We want to analyze all the blocks in the function, even in degenerate
-    // control flow cases including unreachable blocks.  So use the augmented
-    // CFG to ensure we cover all the blocks.
-    vector<const BasicBlock*> postorder;
-    vector<const BasicBlock*> postdom_postorder;
-    vector<pair<uint32_t, uint32_t>> back_edges;
-    auto ignore_block = [](cbb_ptr) {};
-    auto ignore_edge = [](cbb_ptr, cbb_ptr) {};
-    if (!function.ordered_blocks().empty()) {
-      /// calculate dominators
-      spvtools::CFA<libspirv::BasicBlock>::DepthFirstTraversal(
-          function.first_block(), function.AugmentedCFGSuccessorsFunction(),
-          ignore_block, [&](cbb_ptr b) { postorder.push_back(b); },
-          ignore_edge);
-      auto edges = spvtools::CFA<libspirv::BasicBlock>::CalculateDominators(
-          postorder, function.AugmentedCFGPredecessorsFunction());
-      for (auto edge : edges) {
-        edge.first->SetImmediateDominator(edge.second);
-      }
-
-      /// calculate post dominators
-      spvtools::CFA<libspirv::BasicBlock>::DepthFirstTraversal(
-          function.pseudo_exit_block(),
-          function.AugmentedCFGPredecessorsFunction(), ignore_block,
-          [&](cbb_ptr b) { postdom_postorder.push_back(b); }, ignore_edge);
-      auto postdom_edges =
-          spvtools::CFA<libspirv::BasicBlock>::CalculateDominators(
-              postdom_postorder, function.AugmentedCFGSuccessorsFunction());
-      for (auto edge : postdom_edges) {
-        edge.first->SetImmediatePostDominator(edge.second);
-      }
-      /// calculate back edges.
-      spvtools::CFA<libspirv::BasicBlock>::DepthFirstTraversal(
-          function.pseudo_entry_block(),
-          function
-              .AugmentedCFGSuccessorsFunctionIncludingHeaderToContinueEdge(),
-          ignore_block, ignore_block, [&](cbb_ptr from, cbb_ptr to) {
-            back_edges.emplace_back(from->id(), to->id());
-          });
-    }
-    UpdateContinueConstructExitBlocks(function, back_edges);
-
     auto& blocks = function.ordered_blocks();
     if (!blocks.empty()) {
       // Check if the order of blocks in the binary appear before the blocks
@@ -17,6 +17,7 @@
 #include <cassert>
 
 #include <algorithm>
+#include <atomic>
 #include <iostream>
 #include <stack>
 #include <unordered_set>
@@ -35,6 +36,7 @@
 
 using libspirv::Decoration;
 using libspirv::Function;
+using libspirv::Instruction;
 using libspirv::ValidationState_t;
 using std::function;
 using std::ignore;
@@ -50,7 +52,6 @@ class idUsage {
   idUsage(const spv_opcode_table opcodeTableArg,
           const spv_operand_table operandTableArg,
           const spv_ext_inst_table extInstTableArg,
-          const spv_instruction_t* pInsts, const uint64_t instCountArg,
           const SpvMemoryModel memoryModelArg,
           const SpvAddressingModel addressingModelArg,
           const ValidationState_t& module, const vector<uint32_t>& entry_points,
@@ -58,8 +59,6 @@ class idUsage {
       : opcodeTable(opcodeTableArg),
         operandTable(operandTableArg),
         extInstTable(extInstTableArg),
-        firstInst(pInsts),
-        instCount(instCountArg),
         memoryModel(memoryModelArg),
         addressingModel(addressingModelArg),
         position(positionArg),
@@ -67,17 +66,15 @@ class idUsage {
         module_(module),
         entry_points_(entry_points) {}
 
-  bool isValid(const spv_instruction_t* inst);
+  bool isValid(const Instruction* inst);
 
   template <SpvOp>
-  bool isValid(const spv_instruction_t* inst, const spv_opcode_desc);
+  bool isValid(const Instruction* inst, const spv_opcode_desc);
 
  private:
   const spv_opcode_table opcodeTable;
   const spv_operand_table operandTable;
   const spv_ext_inst_table extInstTable;
-  const spv_instruction_t* const firstInst;
-  const uint64_t instCount;
   const SpvMemoryModel memoryModel;
   const SpvAddressingModel addressingModel;
   spv_position position;
@@ -85,6 +82,10 @@ class idUsage {
   const ValidationState_t& module_;
   vector<uint32_t> entry_points_;
 
+  // Validates the OpAccessChain family of instructions. The indexes of |inst|
+  // start at word |first_index_word|.
+  bool isValidAccessChain(const Instruction* inst, size_t first_index_word);
+
   // Returns true if the two instructions represent structs that, as far as the
   // validator can tell, have the exact same data layout.
   bool AreLayoutCompatibleStructs(const libspirv::Instruction* type1,
@@ -114,7 +115,7 @@ class idUsage {
 
 #if 0
 template <>
-bool idUsage::isValid<SpvOpUndef>(const spv_instruction_t *inst,
+bool idUsage::isValid<SpvOpUndef>(const Instruction* inst,
                                   const spv_opcode_desc) {
   assert(0 && "Unimplemented!");
   return false;
@@ -122,21 +123,21 @@ bool idUsage::isValid<SpvOpUndef>(const spv_instruction_t *inst,
 #endif  // 0
 
 template <>
-bool idUsage::isValid<SpvOpMemberName>(const spv_instruction_t* inst,
+bool idUsage::isValid<SpvOpMemberName>(const Instruction* inst,
                                        const spv_opcode_desc) {
   auto typeIndex = 1;
-  auto type = module_.FindDef(inst->words[typeIndex]);
+  auto type = module_.FindDef(inst->word(typeIndex));
   if (!type || SpvOpTypeStruct != type->opcode()) {
-    DIAG(typeIndex) << "OpMemberName Type <id> '" << inst->words[typeIndex]
+    DIAG(typeIndex) << "OpMemberName Type <id> '" << inst->word(typeIndex)
                     << "' is not a struct type.";
     return false;
   }
   auto memberIndex = 2;
-  auto member = inst->words[memberIndex];
+  auto member = inst->word(memberIndex);
   auto memberCount = (uint32_t)(type->words().size() - 2);
   if (memberCount <= member) {
     DIAG(memberIndex) << "OpMemberName Member <id> '"
-                      << inst->words[memberIndex]
+                      << inst->word(memberIndex)
                       << "' index is larger than Type <id> '" << type->id()
                       << "'s member count.";
     return false;
@@ -145,12 +146,12 @@ bool idUsage::isValid<SpvOpMemberName>(const spv_instruction_t* inst,
 }
 
 template <>
-bool idUsage::isValid<SpvOpLine>(const spv_instruction_t* inst,
+bool idUsage::isValid<SpvOpLine>(const Instruction* inst,
                                  const spv_opcode_desc) {
   auto fileIndex = 1;
-  auto file = module_.FindDef(inst->words[fileIndex]);
+  auto file = module_.FindDef(inst->word(fileIndex));
   if (!file || SpvOpString != file->opcode()) {
-    DIAG(fileIndex) << "OpLine Target <id> '" << inst->words[fileIndex]
+    DIAG(fileIndex) << "OpLine Target <id> '" << inst->word(fileIndex)
                     << "' is not an OpString.";
     return false;
   }
@@ -158,16 +159,16 @@ bool idUsage::isValid<SpvOpLine>(const spv_instruction_t* inst,
 }
 
 template <>
-bool idUsage::isValid<SpvOpDecorate>(const spv_instruction_t* inst,
+bool idUsage::isValid<SpvOpDecorate>(const Instruction* inst,
                                      const spv_opcode_desc) {
   auto decorationIndex = 2;
-  auto decoration = inst->words[decorationIndex];
+  auto decoration = inst->word(decorationIndex);
   if (decoration == SpvDecorationSpecId) {
     auto targetIndex = 1;
-    auto target = module_.FindDef(inst->words[targetIndex]);
+    auto target = module_.FindDef(inst->word(targetIndex));
     if (!target || !spvOpcodeIsScalarSpecConstant(target->opcode())) {
       DIAG(targetIndex) << "OpDecorate SpectId decoration target <id> '"
-                        << inst->words[decorationIndex]
+                        << inst->word(decorationIndex)
                         << "' is not a scalar specialization constant.";
       return false;
     }
@@ -177,23 +178,23 @@ bool idUsage::isValid<SpvOpDecorate>(const spv_instruction_t* inst,
 }
 
 template <>
-bool idUsage::isValid<SpvOpMemberDecorate>(const spv_instruction_t* inst,
+bool idUsage::isValid<SpvOpMemberDecorate>(const Instruction* inst,
                                            const spv_opcode_desc) {
   auto structTypeIndex = 1;
-  auto structType = module_.FindDef(inst->words[structTypeIndex]);
+  auto structType = module_.FindDef(inst->word(structTypeIndex));
   if (!structType || SpvOpTypeStruct != structType->opcode()) {
     DIAG(structTypeIndex) << "OpMemberDecorate Structure type <id> '"
-                          << inst->words[structTypeIndex]
+                          << inst->word(structTypeIndex)
                           << "' is not a struct type.";
     return false;
   }
   auto memberIndex = 2;
-  auto member = inst->words[memberIndex];
+  auto member = inst->word(memberIndex);
   auto memberCount = static_cast<uint32_t>(structType->words().size() - 2);
   if (memberCount < member) {
     DIAG(memberIndex) << "Index " << member
                       << " provided in OpMemberDecorate for struct <id> "
-                      << inst->words[structTypeIndex]
+                      << inst->word(structTypeIndex)
                       << " is out of bounds. The structure has " << memberCount
                       << " members. Largest valid index is " << memberCount - 1
                       << ".";
@@ -203,10 +204,10 @@ bool idUsage::isValid<SpvOpMemberDecorate>(const spv_instruction_t* inst,
 }
 
 template <>
-bool idUsage::isValid<SpvOpDecorationGroup>(const spv_instruction_t* inst,
+bool idUsage::isValid<SpvOpDecorationGroup>(const Instruction* inst,
                                             const spv_opcode_desc) {
   auto decorationGroupIndex = 1;
-  auto decorationGroup = module_.FindDef(inst->words[decorationGroupIndex]);
+  auto decorationGroup = module_.FindDef(inst->word(decorationGroupIndex));
 
   for (auto pair : decorationGroup->uses()) {
     auto use = pair.first;
@@ -223,35 +224,35 @@ bool idUsage::isValid<SpvOpDecorationGroup>(const spv_instruction_t* inst,
 }
 
 template <>
-bool idUsage::isValid<SpvOpGroupDecorate>(const spv_instruction_t* inst,
+bool idUsage::isValid<SpvOpGroupDecorate>(const Instruction* inst,
                                           const spv_opcode_desc) {
   auto decorationGroupIndex = 1;
-  auto decorationGroup = module_.FindDef(inst->words[decorationGroupIndex]);
+  auto decorationGroup = module_.FindDef(inst->word(decorationGroupIndex));
   if (!decorationGroup || SpvOpDecorationGroup != decorationGroup->opcode()) {
     DIAG(decorationGroupIndex)
         << "OpGroupDecorate Decoration group <id> '"
-        << inst->words[decorationGroupIndex] << "' is not a decoration group.";
+        << inst->word(decorationGroupIndex) << "' is not a decoration group.";
     return false;
   }
   return true;
 }
 
 template <>
-bool idUsage::isValid<SpvOpGroupMemberDecorate>(const spv_instruction_t* inst,
+bool idUsage::isValid<SpvOpGroupMemberDecorate>(const Instruction* inst,
                                                 const spv_opcode_desc) {
   auto decorationGroupIndex = 1;
-  auto decorationGroup = module_.FindDef(inst->words[decorationGroupIndex]);
+  auto decorationGroup = module_.FindDef(inst->word(decorationGroupIndex));
   if (!decorationGroup || SpvOpDecorationGroup != decorationGroup->opcode()) {
     DIAG(decorationGroupIndex)
         << "OpGroupMemberDecorate Decoration group <id> '"
-        << inst->words[decorationGroupIndex] << "' is not a decoration group.";
+        << inst->word(decorationGroupIndex) << "' is not a decoration group.";
     return false;
   }
   // Grammar checks ensures that the number of arguments to this instruction
   // is an odd number: 1 decoration group + (id,literal) pairs.
-  for (size_t i = 2; i + 1 < inst->words.size(); i = i + 2) {
-    const uint32_t struct_id = inst->words[i];
-    const uint32_t index = inst->words[i + 1];
+  for (size_t i = 2; i + 1 < inst->words().size(); i = i + 2) {
+    const uint32_t struct_id = inst->word(i);
+    const uint32_t index = inst->word(i + 1);
     auto struct_instr = module_.FindDef(struct_id);
     if (!struct_instr || SpvOpTypeStruct != struct_instr->opcode()) {
       DIAG(i) << "OpGroupMemberDecorate Structure type <id> '" << struct_id
@@ -274,30 +275,30 @@ bool idUsage::isValid<SpvOpGroupMemberDecorate>(const spv_instruction_t* inst,
 
 #if 0
 template <>
-bool idUsage::isValid<SpvOpExtInst>(const spv_instruction_t *inst,
+bool idUsage::isValid<SpvOpExtInst>(const Instruction* inst,
                                     const spv_opcode_desc opcodeEntry) {}
 #endif  // 0
 
 template <>
-bool idUsage::isValid<SpvOpEntryPoint>(const spv_instruction_t* inst,
+bool idUsage::isValid<SpvOpEntryPoint>(const Instruction* inst,
                                        const spv_opcode_desc) {
   auto entryPointIndex = 2;
-  auto entryPoint = module_.FindDef(inst->words[entryPointIndex]);
+  auto entryPoint = module_.FindDef(inst->word(entryPointIndex));
   if (!entryPoint || SpvOpFunction != entryPoint->opcode()) {
     DIAG(entryPointIndex) << "OpEntryPoint Entry Point <id> '"
-                          << inst->words[entryPointIndex]
+                          << inst->word(entryPointIndex)
                           << "' is not a function.";
     return false;
   }
   // don't check kernel function signatures
-  const SpvExecutionModel executionModel = SpvExecutionModel(inst->words[1]);
+  const SpvExecutionModel executionModel = SpvExecutionModel(inst->word(1));
   if (executionModel != SpvExecutionModelKernel) {
     // TODO: Check the entry point signature is void main(void), may be subject
     // to change
     auto entryPointType = module_.FindDef(entryPoint->words()[4]);
     if (!entryPointType || 3 != entryPointType->words().size()) {
       DIAG(entryPointIndex)
-          << "OpEntryPoint Entry Point <id> '" << inst->words[entryPointIndex]
+          << "OpEntryPoint Entry Point <id> '" << inst->word(entryPointIndex)
           << "'s function parameter count is not zero.";
       return false;
     }
@@ -317,7 +318,7 @@ bool idUsage::isValid<SpvOpEntryPoint>(const spv_instruction_t* inst,
     std::string reason;
     if (!called_func->IsCompatibleWithExecutionModel(executionModel, &reason)) {
       DIAG(entryPointIndex)
-          << "OpEntryPoint Entry Point <id> '" << inst->words[entryPointIndex]
+          << "OpEntryPoint Entry Point <id> '" << inst->word(entryPointIndex)
           << "'s callgraph contains function <id> " << called_func_id
           << ", which cannot be used with the current execution model:\n"
           << reason;
@@ -332,7 +333,7 @@ bool idUsage::isValid<SpvOpEntryPoint>(const spv_instruction_t* inst,
   auto returnType = module_.FindDef(entryPoint->type_id());
   if (!returnType || SpvOpTypeVoid != returnType->opcode()) {
     DIAG(entryPointIndex) << "OpEntryPoint Entry Point <id> '"
-                          << inst->words[entryPointIndex]
+                          << inst->word(entryPointIndex)
                           << "'s function return type is not void.";
     return false;
   }
@@ -340,15 +341,15 @@ bool idUsage::isValid<SpvOpEntryPoint>(const spv_instruction_t* inst,
 }
 
 template <>
-bool idUsage::isValid<SpvOpExecutionMode>(const spv_instruction_t* inst,
+bool idUsage::isValid<SpvOpExecutionMode>(const Instruction* inst,
                                           const spv_opcode_desc) {
   auto entryPointIndex = 1;
-  auto entryPointID = inst->words[entryPointIndex];
+  auto entryPointID = inst->word(entryPointIndex);
   auto found =
       std::find(entry_points_.cbegin(), entry_points_.cend(), entryPointID);
   if (found == entry_points_.cend()) {
     DIAG(entryPointIndex) << "OpExecutionMode Entry Point <id> '"
-                          << inst->words[entryPointIndex]
+                          << inst->word(entryPointIndex)
                           << "' is not the Entry Point "
                              "operand of an OpEntryPoint.";
     return false;
@@ -357,13 +358,13 @@ bool idUsage::isValid<SpvOpExecutionMode>(const spv_instruction_t* inst,
 }
 
 template <>
-bool idUsage::isValid<SpvOpTypeVector>(const spv_instruction_t* inst,
+bool idUsage::isValid<SpvOpTypeVector>(const Instruction* inst,
                                        const spv_opcode_desc) {
   auto componentIndex = 2;
-  auto componentType = module_.FindDef(inst->words[componentIndex]);
+  auto componentType = module_.FindDef(inst->word(componentIndex));
   if (!componentType || !spvOpcodeIsScalarType(componentType->opcode())) {
     DIAG(componentIndex) << "OpTypeVector Component Type <id> '"
-                         << inst->words[componentIndex]
+                         << inst->word(componentIndex)
                          << "' is not a scalar type.";
     return false;
   }
@@ -371,13 +372,13 @@ bool idUsage::isValid<SpvOpTypeVector>(const spv_instruction_t* inst,
 }
 
 template <>
-bool idUsage::isValid<SpvOpTypeMatrix>(const spv_instruction_t* inst,
+bool idUsage::isValid<SpvOpTypeMatrix>(const Instruction* inst,
                                        const spv_opcode_desc) {
   auto columnTypeIndex = 2;
-  auto columnType = module_.FindDef(inst->words[columnTypeIndex]);
+  auto columnType = module_.FindDef(inst->word(columnTypeIndex));
   if (!columnType || SpvOpTypeVector != columnType->opcode()) {
     DIAG(columnTypeIndex) << "OpTypeMatrix Column Type <id> '"
-                          << inst->words[columnTypeIndex]
+                          << inst->word(columnTypeIndex)
                           << "' is not a vector.";
     return false;
   }
@@ -385,7 +386,7 @@ bool idUsage::isValid<SpvOpTypeMatrix>(const spv_instruction_t* inst,
 }
 
 template <>
-bool idUsage::isValid<SpvOpTypeSampler>(const spv_instruction_t*,
+bool idUsage::isValid<SpvOpTypeSampler>(const Instruction*,
                                         const spv_opcode_desc) {
   // OpTypeSampler takes no arguments in Rev31 and beyond.
   return true;
@@ -412,20 +413,20 @@ bool aboveZero(const vector<uint32_t>& constWords,
 }
 
 template <>
-bool idUsage::isValid<SpvOpTypeArray>(const spv_instruction_t* inst,
+bool idUsage::isValid<SpvOpTypeArray>(const Instruction* inst,
                                       const spv_opcode_desc) {
   auto elementTypeIndex = 2;
-  auto elementType = module_.FindDef(inst->words[elementTypeIndex]);
+  auto elementType = module_.FindDef(inst->word(elementTypeIndex));
   if (!elementType || !spvOpcodeGeneratesType(elementType->opcode())) {
     DIAG(elementTypeIndex) << "OpTypeArray Element Type <id> '"
-                           << inst->words[elementTypeIndex]
+                           << inst->word(elementTypeIndex)
                            << "' is not a type.";
     return false;
   }
   auto lengthIndex = 3;
-  auto length = module_.FindDef(inst->words[lengthIndex]);
+  auto length = module_.FindDef(inst->word(lengthIndex));
   if (!length || !spvOpcodeIsConstant(length->opcode())) {
-    DIAG(lengthIndex) << "OpTypeArray Length <id> '" << inst->words[lengthIndex]
+    DIAG(lengthIndex) << "OpTypeArray Length <id> '" << inst->word(lengthIndex)
                       << "' is not a scalar constant type.";
     return false;
   }
@@ -435,7 +436,7 @@ bool idUsage::isValid<SpvOpTypeArray>(const spv_instruction_t* inst,
   auto constResultTypeIndex = 1;
   auto constResultType = module_.FindDef(constInst[constResultTypeIndex]);
   if (!constResultType || SpvOpTypeInt != constResultType->opcode()) {
-    DIAG(lengthIndex) << "OpTypeArray Length <id> '" << inst->words[lengthIndex]
+    DIAG(lengthIndex) << "OpTypeArray Length <id> '" << inst->word(lengthIndex)
                       << "' is not a constant integer type.";
     return false;
   }
@@ -447,7 +448,7 @@ bool idUsage::isValid<SpvOpTypeArray>(const spv_instruction_t* inst,
     // Else fall through!
     case SpvOpConstantNull: {
       DIAG(lengthIndex) << "OpTypeArray Length <id> '"
-                        << inst->words[lengthIndex]
+                        << inst->word(lengthIndex)
                         << "' default value must be at least 1.";
       return false;
     }
@@ -461,13 +462,13 @@ bool idUsage::isValid<SpvOpTypeArray>(const spv_instruction_t* inst,
 }
 
 template <>
-bool idUsage::isValid<SpvOpTypeRuntimeArray>(const spv_instruction_t* inst,
+bool idUsage::isValid<SpvOpTypeRuntimeArray>(const Instruction* inst,
                                              const spv_opcode_desc) {
   auto elementTypeIndex = 2;
-  auto elementType = module_.FindDef(inst->words[elementTypeIndex]);
+  auto elementType = module_.FindDef(inst->word(elementTypeIndex));
   if (!elementType || !spvOpcodeGeneratesType(elementType->opcode())) {
     DIAG(elementTypeIndex) << "OpTypeRuntimeArray Element Type <id> '"
-                           << inst->words[elementTypeIndex]
+                           << inst->word(elementTypeIndex)
                            << "' is not a type.";
     return false;
   }
@@ -475,17 +476,17 @@ bool idUsage::isValid<SpvOpTypeRuntimeArray>(const spv_instruction_t* inst,
 }
 
 template <>
-bool idUsage::isValid<SpvOpTypeStruct>(const spv_instruction_t* inst,
+bool idUsage::isValid<SpvOpTypeStruct>(const Instruction* inst,
                                        const spv_opcode_desc) {
   ValidationState_t& vstate = const_cast<ValidationState_t&>(module_);
-  const uint32_t struct_id = inst->words[1];
-  for (size_t memberTypeIndex = 2; memberTypeIndex < inst->words.size();
+  const uint32_t struct_id = inst->word(1);
+  for (size_t memberTypeIndex = 2; memberTypeIndex < inst->words().size();
        ++memberTypeIndex) {
-    auto memberTypeId = inst->words[memberTypeIndex];
+    auto memberTypeId = inst->word(memberTypeIndex);
     auto memberType = module_.FindDef(memberTypeId);
     if (!memberType || !spvOpcodeGeneratesType(memberType->opcode())) {
       DIAG(memberTypeIndex)
-          << "OpTypeStruct Member Type <id> '" << inst->words[memberTypeIndex]
+          << "OpTypeStruct Member Type <id> '" << inst->word(memberTypeIndex)
           << "' is not a type.";
       return false;
     }
@@ -528,7 +529,7 @@ bool idUsage::isValid<SpvOpTypeStruct>(const spv_instruction_t* inst,
       built_in_members.insert(decoration.struct_member_index());
     }
   }
-  int num_struct_members = static_cast<int>(inst->words.size() - 2);
+  int num_struct_members = static_cast<int>(inst->words().size() - 2);
   int num_builtin_members = static_cast<int>(built_in_members.size());
   if (num_builtin_members > 0 && num_builtin_members != num_struct_members) {
     DIAG(0)
@@ -546,12 +547,12 @@ bool idUsage::isValid<SpvOpTypeStruct>(const spv_instruction_t* inst,
 }
 
 template <>
-bool idUsage::isValid<SpvOpTypePointer>(const spv_instruction_t* inst,
+bool idUsage::isValid<SpvOpTypePointer>(const Instruction* inst,
                                         const spv_opcode_desc) {
   auto typeIndex = 3;
-  auto type = module_.FindDef(inst->words[typeIndex]);
+  auto type = module_.FindDef(inst->word(typeIndex));
   if (!type || !spvOpcodeGeneratesType(type->opcode())) {
-    DIAG(typeIndex) << "OpTypePointer Type <id> '" << inst->words[typeIndex]
+    DIAG(typeIndex) << "OpTypePointer Type <id> '" << inst->word(typeIndex)
                     << "' is not a type.";
     return false;
   }
@@ -559,22 +560,22 @@ bool idUsage::isValid<SpvOpTypePointer>(const spv_instruction_t* inst,
 }
 
 template <>
-bool idUsage::isValid<SpvOpTypeFunction>(const spv_instruction_t* inst,
+bool idUsage::isValid<SpvOpTypeFunction>(const Instruction* inst,
                                          const spv_opcode_desc) {
   auto returnTypeIndex = 2;
-  auto returnType = module_.FindDef(inst->words[returnTypeIndex]);
+  auto returnType = module_.FindDef(inst->word(returnTypeIndex));
   if (!returnType || !spvOpcodeGeneratesType(returnType->opcode())) {
     DIAG(returnTypeIndex) << "OpTypeFunction Return Type <id> '"
-                          << inst->words[returnTypeIndex] << "' is not a type.";
+                          << inst->word(returnTypeIndex) << "' is not a type.";
     return false;
   }
   size_t num_args = 0;
-  for (size_t paramTypeIndex = 3; paramTypeIndex < inst->words.size();
+  for (size_t paramTypeIndex = 3; paramTypeIndex < inst->words().size();
        ++paramTypeIndex, ++num_args) {
-    auto paramType = module_.FindDef(inst->words[paramTypeIndex]);
+    auto paramType = module_.FindDef(inst->word(paramTypeIndex));
     if (!paramType || !spvOpcodeGeneratesType(paramType->opcode())) {
       DIAG(paramTypeIndex) << "OpTypeFunction Parameter Type <id> '"
-                           << inst->words[paramTypeIndex] << "' is not a type.";
+                           << inst->word(paramTypeIndex) << "' is not a type.";
       return false;
     }
   }
@@ -584,7 +585,7 @@ bool idUsage::isValid<SpvOpTypeFunction>(const spv_instruction_t* inst,
     DIAG(returnTypeIndex) << "OpTypeFunction may not take more than "
                           << num_function_args_limit
                           << " arguments. OpTypeFunction <id> '"
-                          << inst->words[1] << "' has " << num_args
+                          << inst->word(1) << "' has " << num_args
                           << " arguments.";
     return false;
   }
@@ -592,20 +593,20 @@ bool idUsage::isValid<SpvOpTypeFunction>(const spv_instruction_t* inst,
 }
 
 template <>
-bool idUsage::isValid<SpvOpTypePipe>(const spv_instruction_t*,
+bool idUsage::isValid<SpvOpTypePipe>(const Instruction*,
                                      const spv_opcode_desc) {
   // OpTypePipe has no ID arguments.
   return true;
 }
 
 template <>
-bool idUsage::isValid<SpvOpConstantTrue>(const spv_instruction_t* inst,
+bool idUsage::isValid<SpvOpConstantTrue>(const Instruction* inst,
                                          const spv_opcode_desc) {
   auto resultTypeIndex = 1;
-  auto resultType = module_.FindDef(inst->words[resultTypeIndex]);
+  auto resultType = module_.FindDef(inst->word(resultTypeIndex));
   if (!resultType || SpvOpTypeBool != resultType->opcode()) {
     DIAG(resultTypeIndex) << "OpConstantTrue Result Type <id> '"
-                          << inst->words[resultTypeIndex]
+                          << inst->word(resultTypeIndex)
                           << "' is not a boolean type.";
     return false;
   }
@@ -613,13 +614,13 @@ bool idUsage::isValid<SpvOpConstantTrue>(const spv_instruction_t* inst,
 }
 
 template <>
-bool idUsage::isValid<SpvOpConstantFalse>(const spv_instruction_t* inst,
+bool idUsage::isValid<SpvOpConstantFalse>(const Instruction* inst,
                                           const spv_opcode_desc) {
   auto resultTypeIndex = 1;
-  auto resultType = module_.FindDef(inst->words[resultTypeIndex]);
+  auto resultType = module_.FindDef(inst->word(resultTypeIndex));
   if (!resultType || SpvOpTypeBool != resultType->opcode()) {
     DIAG(resultTypeIndex) << "OpConstantFalse Result Type <id> '"
-                          << inst->words[resultTypeIndex]
+                          << inst->word(resultTypeIndex)
                           << "' is not a boolean type.";
     return false;
   }
@@ -627,24 +628,24 @@ bool idUsage::isValid<SpvOpConstantFalse>(const spv_instruction_t* inst,
 }
 
 template <>
-bool idUsage::isValid<SpvOpConstantComposite>(const spv_instruction_t* inst,
+bool idUsage::isValid<SpvOpConstantComposite>(const Instruction* inst,
                                               const spv_opcode_desc) {
   auto resultTypeIndex = 1;
-  auto resultType = module_.FindDef(inst->words[resultTypeIndex]);
+  auto resultType = module_.FindDef(inst->word(resultTypeIndex));
   if (!resultType || !spvOpcodeIsComposite(resultType->opcode())) {
     DIAG(resultTypeIndex) << "OpConstantComposite Result Type <id> '"
-                          << inst->words[resultTypeIndex]
+                          << inst->word(resultTypeIndex)
                           << "' is not a composite type.";
     return false;
   }
 
-  auto constituentCount = inst->words.size() - 3;
+  auto constituentCount = inst->words().size() - 3;
   switch (resultType->opcode()) {
     case SpvOpTypeVector: {
       auto componentCount = resultType->words()[3];
       if (componentCount != constituentCount) {
         // TODO: Output ID's on diagnostic
-        DIAG(inst->words.size() - 1)
+        DIAG(inst->words().size() - 1)
             << "OpConstantComposite Constituent <id> count does not match "
                "Result Type <id> '"
             << resultType->id() << "'s vector component count.";
@@ -652,13 +653,13 @@ bool idUsage::isValid<SpvOpConstantComposite>(const spv_instruction_t* inst,
       }
       auto componentType = module_.FindDef(resultType->words()[2]);
       assert(componentType);
-      for (size_t constituentIndex = 3; constituentIndex < inst->words.size();
+      for (size_t constituentIndex = 3; constituentIndex < inst->words().size();
            constituentIndex++) {
-        auto constituent = module_.FindDef(inst->words[constituentIndex]);
+        auto constituent = module_.FindDef(inst->word(constituentIndex));
         if (!constituent ||
             !spvOpcodeIsConstantOrUndef(constituent->opcode())) {
           DIAG(constituentIndex) << "OpConstantComposite Constituent <id> '"
-                                 << inst->words[constituentIndex]
+                                 << inst->word(constituentIndex)
                                  << "' is not a constant or undef.";
           return false;
         }
@@ -667,7 +668,7 @@ bool idUsage::isValid<SpvOpConstantComposite>(const spv_instruction_t* inst,
             componentType->opcode() != constituentResultType->opcode()) {
           DIAG(constituentIndex)
               << "OpConstantComposite Constituent <id> '"
-              << inst->words[constituentIndex]
+              << inst->word(constituentIndex)
               << "'s type does not match Result Type <id> '" << resultType->id()
               << "'s vector element type.";
           return false;
@@ -678,7 +679,7 @@ bool idUsage::isValid<SpvOpConstantComposite>(const spv_instruction_t* inst,
       auto columnCount = resultType->words()[3];
       if (columnCount != constituentCount) {
         // TODO: Output ID's on diagnostic
-        DIAG(inst->words.size() - 1)
+        DIAG(inst->words().size() - 1)
             << "OpConstantComposite Constituent <id> count does not match "
                "Result Type <id> '"
             << resultType->id() << "'s matrix column count.";
@@ -691,15 +692,15 @@ bool idUsage::isValid<SpvOpConstantComposite>(const spv_instruction_t* inst,
       auto componentType = module_.FindDef(columnType->words()[2]);
       assert(componentType);
 
-      for (size_t constituentIndex = 3; constituentIndex < inst->words.size();
+      for (size_t constituentIndex = 3; constituentIndex < inst->words().size();
            constituentIndex++) {
-        auto constituent = module_.FindDef(inst->words[constituentIndex]);
+        auto constituent = module_.FindDef(inst->word(constituentIndex));
         if (!constituent || !(SpvOpConstantComposite == constituent->opcode() ||
                               SpvOpUndef == constituent->opcode())) {
           // The message says "... or undef" because the spec does not say
           // undef is a constant.
           DIAG(constituentIndex) << "OpConstantComposite Constituent <id> '"
-                                 << inst->words[constituentIndex]
+                                 << inst->word(constituentIndex)
                                  << "' is not a constant composite or undef.";
           return false;
         }
@@ -708,7 +709,7 @@ bool idUsage::isValid<SpvOpConstantComposite>(const spv_instruction_t* inst,
         if (columnType->opcode() != vector->opcode()) {
           DIAG(constituentIndex)
               << "OpConstantComposite Constituent <id> '"
-              << inst->words[constituentIndex]
+              << inst->word(constituentIndex)
               << "' type does not match Result Type <id> '" << resultType->id()
               << "'s matrix column type.";
           return false;
@@ -718,7 +719,7 @@ bool idUsage::isValid<SpvOpConstantComposite>(const spv_instruction_t* inst,
         if (componentType->id() != vectorComponentType->id()) {
           DIAG(constituentIndex)
               << "OpConstantComposite Constituent <id> '"
-              << inst->words[constituentIndex]
+              << inst->word(constituentIndex)
               << "' component type does not match Result Type <id> '"
               << resultType->id() << "'s matrix column component type.";
           return false;
@@ -726,7 +727,7 @@ bool idUsage::isValid<SpvOpConstantComposite>(const spv_instruction_t* inst,
         if (componentCount != vector->words()[3]) {
           DIAG(constituentIndex)
               << "OpConstantComposite Constituent <id> '"
-              << inst->words[constituentIndex]
+              << inst->word(constituentIndex)
               << "' vector component count does not match Result Type <id> '"
               << resultType->id() << "'s vector component count.";
           return false;
@@ -739,19 +740,19 @@ bool idUsage::isValid<SpvOpConstantComposite>(const spv_instruction_t* inst,
       auto length = module_.FindDef(resultType->words()[3]);
       assert(length);
       if (length->words()[3] != constituentCount) {
-        DIAG(inst->words.size() - 1)
+        DIAG(inst->words().size() - 1)
             << "OpConstantComposite Constituent count does not match "
                "Result Type <id> '"
             << resultType->id() << "'s array length.";
         return false;
       }
-      for (size_t constituentIndex = 3; constituentIndex < inst->words.size();
+      for (size_t constituentIndex = 3; constituentIndex < inst->words().size();
            constituentIndex++) {
-        auto constituent = module_.FindDef(inst->words[constituentIndex]);
+        auto constituent = module_.FindDef(inst->word(constituentIndex));
         if (!constituent ||
             !spvOpcodeIsConstantOrUndef(constituent->opcode())) {
           DIAG(constituentIndex) << "OpConstantComposite Constituent <id> '"
-                                 << inst->words[constituentIndex]
+                                 << inst->word(constituentIndex)
                                  << "' is not a constant or undef.";
           return false;
         }
@@ -760,7 +761,7 @@ bool idUsage::isValid<SpvOpConstantComposite>(const spv_instruction_t* inst,
         if (elementType->id() != constituentType->id()) {
           DIAG(constituentIndex)
               << "OpConstantComposite Constituent <id> '"
-              << inst->words[constituentIndex]
+              << inst->word(constituentIndex)
               << "'s type does not match Result Type <id> '" << resultType->id()
               << "'s array element type.";
           return false;
@@ -771,19 +772,19 @@ bool idUsage::isValid<SpvOpConstantComposite>(const spv_instruction_t* inst,
       auto memberCount = resultType->words().size() - 2;
       if (memberCount != constituentCount) {
         DIAG(resultTypeIndex) << "OpConstantComposite Constituent <id> '"
-                              << inst->words[resultTypeIndex]
+                              << inst->word(resultTypeIndex)
                               << "' count does not match Result Type <id> '"
                               << resultType->id() << "'s struct member count.";
         return false;
       }
       for (uint32_t constituentIndex = 3, memberIndex = 2;
-           constituentIndex < inst->words.size();
+           constituentIndex < inst->words().size();
            constituentIndex++, memberIndex++) {
-        auto constituent = module_.FindDef(inst->words[constituentIndex]);
+        auto constituent = module_.FindDef(inst->word(constituentIndex));
         if (!constituent ||
             !spvOpcodeIsConstantOrUndef(constituent->opcode())) {
           DIAG(constituentIndex) << "OpConstantComposite Constituent <id> '"
-                                 << inst->words[constituentIndex]
+                                 << inst->word(constituentIndex)
                                  << "' is not a constant or undef.";
           return false;
         }
@@ -795,7 +796,7 @@ bool idUsage::isValid<SpvOpConstantComposite>(const spv_instruction_t* inst,
         if (memberType->id() != constituentType->id()) {
           DIAG(constituentIndex)
               << "OpConstantComposite Constituent <id> '"
-              << inst->words[constituentIndex]
+              << inst->word(constituentIndex)
               << "' type does not match the Result Type <id> '"
               << resultType->id() << "'s member type.";
           return false;
@@ -808,13 +809,13 @@ bool idUsage::isValid<SpvOpConstantComposite>(const spv_instruction_t* inst,
 }
 
 template <>
-bool idUsage::isValid<SpvOpConstantSampler>(const spv_instruction_t* inst,
+bool idUsage::isValid<SpvOpConstantSampler>(const Instruction* inst,
                                             const spv_opcode_desc) {
   auto resultTypeIndex = 1;
-  auto resultType = module_.FindDef(inst->words[resultTypeIndex]);
+  auto resultType = module_.FindDef(inst->word(resultTypeIndex));
   if (!resultType || SpvOpTypeSampler != resultType->opcode()) {
     DIAG(resultTypeIndex) << "OpConstantSampler Result Type <id> '"
-                          << inst->words[resultTypeIndex]
+                          << inst->word(resultTypeIndex)
                           << "' is not a sampler type.";
     return false;
   }
@@ -859,13 +860,13 @@ bool IsTypeNullable(const vector<uint32_t>& instruction,
 }
 
 template <>
-bool idUsage::isValid<SpvOpConstantNull>(const spv_instruction_t* inst,
+bool idUsage::isValid<SpvOpConstantNull>(const Instruction* inst,
                                          const spv_opcode_desc) {
   auto resultTypeIndex = 1;
-  auto resultType = module_.FindDef(inst->words[resultTypeIndex]);
+  auto resultType = module_.FindDef(inst->word(resultTypeIndex));
   if (!resultType || !IsTypeNullable(resultType->words(), module_)) {
     DIAG(resultTypeIndex) << "OpConstantNull Result Type <id> '"
-                          << inst->words[resultTypeIndex]
+                          << inst->word(resultTypeIndex)
                           << "' cannot have a null value.";
     return false;
   }
@@ -873,13 +874,13 @@ bool idUsage::isValid<SpvOpConstantNull>(const spv_instruction_t* inst,
 }
 
 template <>
-bool idUsage::isValid<SpvOpSpecConstantTrue>(const spv_instruction_t* inst,
+bool idUsage::isValid<SpvOpSpecConstantTrue>(const Instruction* inst,
                                              const spv_opcode_desc) {
   auto resultTypeIndex = 1;
-  auto resultType = module_.FindDef(inst->words[resultTypeIndex]);
+  auto resultType = module_.FindDef(inst->word(resultTypeIndex));
   if (!resultType || SpvOpTypeBool != resultType->opcode()) {
     DIAG(resultTypeIndex) << "OpSpecConstantTrue Result Type <id> '"
-                          << inst->words[resultTypeIndex]
+                          << inst->word(resultTypeIndex)
                           << "' is not a boolean type.";
     return false;
   }
@@ -887,13 +888,13 @@ bool idUsage::isValid<SpvOpSpecConstantTrue>(const spv_instruction_t* inst,
 }
 
 template <>
-bool idUsage::isValid<SpvOpSpecConstantFalse>(const spv_instruction_t* inst,
+bool idUsage::isValid<SpvOpSpecConstantFalse>(const Instruction* inst,
                                               const spv_opcode_desc) {
   auto resultTypeIndex = 1;
-  auto resultType = module_.FindDef(inst->words[resultTypeIndex]);
+  auto resultType = module_.FindDef(inst->word(resultTypeIndex));
   if (!resultType || SpvOpTypeBool != resultType->opcode()) {
     DIAG(resultTypeIndex) << "OpSpecConstantFalse Result Type <id> '"
-                          << inst->words[resultTypeIndex]
+                          << inst->word(resultTypeIndex)
                           << "' is not a boolean type.";
     return false;
   }
@@ -901,10 +902,10 @@ bool idUsage::isValid<SpvOpSpecConstantFalse>(const spv_instruction_t* inst,
 }
 
 template <>
-bool idUsage::isValid<SpvOpSampledImage>(const spv_instruction_t* inst,
+bool idUsage::isValid<SpvOpSampledImage>(const Instruction* inst,
                                          const spv_opcode_desc) {
   auto resultTypeIndex = 2;
-  auto resultID = inst->words[resultTypeIndex];
+  auto resultID = inst->word(resultTypeIndex);
   auto sampledImageInstr = module_.FindDef(resultID);
   // We need to validate 2 things:
   // * All OpSampledImage instructions must be in the same block in which their
@@ -949,19 +950,19 @@ bool idUsage::isValid<SpvOpSampledImage>(const spv_instruction_t* inst,
 }
 
 template <>
-bool idUsage::isValid<SpvOpSpecConstantComposite>(const spv_instruction_t* inst,
+bool idUsage::isValid<SpvOpSpecConstantComposite>(const Instruction* inst,
                                                   const spv_opcode_desc) {
   // The result type must be a composite type.
   auto resultTypeIndex = 1;
-  auto resultType = module_.FindDef(inst->words[resultTypeIndex]);
+  auto resultType = module_.FindDef(inst->word(resultTypeIndex));
   if (!resultType || !spvOpcodeIsComposite(resultType->opcode())) {
     DIAG(resultTypeIndex) << "OpSpecConstantComposite Result Type <id> '"
-                          << inst->words[resultTypeIndex]
+                          << inst->word(resultTypeIndex)
                           << "' is not a composite type.";
     return false;
   }
   // Validation checks differ based on the type of composite type.
-  auto constituentCount = inst->words.size() - 3;
+  auto constituentCount = inst->words().size() - 3;
   switch (resultType->opcode()) {
     // For Vectors, the following must be met:
     // * Number of constituents in the result type and the vector must match.
@@ -972,7 +973,7 @@ bool idUsage::isValid<SpvOpSpecConstantComposite>(const spv_instruction_t* inst,
     case SpvOpTypeVector: {
       auto componentCount = resultType->words()[3];
       if (componentCount != constituentCount) {
-        DIAG(inst->words.size() - 1)
+        DIAG(inst->words().size() - 1)
             << "OpSpecConstantComposite Constituent <id> count does not match "
                "Result Type <id> '"
             << resultType->id() << "'s vector component count.";
@@ -980,13 +981,13 @@ bool idUsage::isValid<SpvOpSpecConstantComposite>(const spv_instruction_t* inst,
       }
       auto componentType = module_.FindDef(resultType->words()[2]);
       assert(componentType);
-      for (size_t constituentIndex = 3; constituentIndex < inst->words.size();
+      for (size_t constituentIndex = 3; constituentIndex < inst->words().size();
            constituentIndex++) {
-        auto constituent = module_.FindDef(inst->words[constituentIndex]);
+        auto constituent = module_.FindDef(inst->word(constituentIndex));
         if (!constituent ||
             !spvOpcodeIsConstantOrUndef(constituent->opcode())) {
           DIAG(constituentIndex) << "OpSpecConstantComposite Constituent <id> '"
-                                 << inst->words[constituentIndex]
+                                 << inst->word(constituentIndex)
                                  << "' is not a constant or undef.";
           return false;
         }
@@ -995,7 +996,7 @@ bool idUsage::isValid<SpvOpSpecConstantComposite>(const spv_instruction_t* inst,
             componentType->opcode() != constituentResultType->opcode()) {
           DIAG(constituentIndex)
               << "OpSpecConstantComposite Constituent <id> '"
-              << inst->words[constituentIndex]
+              << inst->word(constituentIndex)
               << "'s type does not match Result Type <id> '" << resultType->id()
               << "'s vector element type.";
           return false;
@@ -1006,7 +1007,7 @@ bool idUsage::isValid<SpvOpSpecConstantComposite>(const spv_instruction_t* inst,
     case SpvOpTypeMatrix: {
       auto columnCount = resultType->words()[3];
       if (columnCount != constituentCount) {
-        DIAG(inst->words.size() - 1)
+        DIAG(inst->words().size() - 1)
             << "OpSpecConstantComposite Constituent <id> count does not match "
                "Result Type <id> '"
             << resultType->id() << "'s matrix column count.";
@@ -1019,9 +1020,9 @@ bool idUsage::isValid<SpvOpSpecConstantComposite>(const spv_instruction_t* inst,
       auto componentType = module_.FindDef(columnType->words()[2]);
       assert(componentType);
 
-      for (size_t constituentIndex = 3; constituentIndex < inst->words.size();
+      for (size_t constituentIndex = 3; constituentIndex < inst->words().size();
            constituentIndex++) {
-        auto constituent = module_.FindDef(inst->words[constituentIndex]);
+        auto constituent = module_.FindDef(inst->word(constituentIndex));
         auto constituentOpCode = constituent->opcode();
         if (!constituent || !(SpvOpSpecConstantComposite == constituentOpCode ||
                               SpvOpConstantComposite == constituentOpCode ||
@@ -1029,7 +1030,7 @@ bool idUsage::isValid<SpvOpSpecConstantComposite>(const spv_instruction_t* inst,
           // The message says "... or undef" because the spec does not say
           // undef is a constant.
           DIAG(constituentIndex) << "OpSpecConstantComposite Constituent <id> '"
-                                 << inst->words[constituentIndex]
+                                 << inst->word(constituentIndex)
                                  << "' is not a constant composite or undef.";
           return false;
         }
@@ -1038,7 +1039,7 @@ bool idUsage::isValid<SpvOpSpecConstantComposite>(const spv_instruction_t* inst,
         if (columnType->opcode() != vector->opcode()) {
           DIAG(constituentIndex)
               << "OpSpecConstantComposite Constituent <id> '"
-              << inst->words[constituentIndex]
+              << inst->word(constituentIndex)
               << "' type does not match Result Type <id> '" << resultType->id()
               << "'s matrix column type.";
           return false;
@@ -1048,7 +1049,7 @@ bool idUsage::isValid<SpvOpSpecConstantComposite>(const spv_instruction_t* inst,
         if (componentType->id() != vectorComponentType->id()) {
           DIAG(constituentIndex)
               << "OpSpecConstantComposite Constituent <id> '"
-              << inst->words[constituentIndex]
+              << inst->word(constituentIndex)
               << "' component type does not match Result Type <id> '"
               << resultType->id() << "'s matrix column component type.";
           return false;
@@ -1056,7 +1057,7 @@ bool idUsage::isValid<SpvOpSpecConstantComposite>(const spv_instruction_t* inst,
         if (componentCount != vector->words()[3]) {
           DIAG(constituentIndex)
               << "OpSpecConstantComposite Constituent <id> '"
-              << inst->words[constituentIndex]
+              << inst->word(constituentIndex)
               << "' vector component count does not match Result Type <id> '"
               << resultType->id() << "'s vector component count.";
           return false;
@@ -1070,19 +1071,19 @@ bool idUsage::isValid<SpvOpSpecConstantComposite>(const spv_instruction_t* inst,
       auto length = module_.FindDef(resultType->words()[3]);
       assert(length);
       if (length->words()[3] != constituentCount) {
-        DIAG(inst->words.size() - 1)
+        DIAG(inst->words().size() - 1)
             << "OpSpecConstantComposite Constituent count does not match "
                "Result Type <id> '"
             << resultType->id() << "'s array length.";
         return false;
       }
-      for (size_t constituentIndex = 3; constituentIndex < inst->words.size();
+      for (size_t constituentIndex = 3; constituentIndex < inst->words().size();
            constituentIndex++) {
-        auto constituent = module_.FindDef(inst->words[constituentIndex]);
+        auto constituent = module_.FindDef(inst->word(constituentIndex));
         if (!constituent ||
             !spvOpcodeIsConstantOrUndef(constituent->opcode())) {
           DIAG(constituentIndex) << "OpSpecConstantComposite Constituent <id> '"
-                                 << inst->words[constituentIndex]
+                                 << inst->word(constituentIndex)
                                  << "' is not a constant or undef.";
           return false;
         }
@@ -1091,7 +1092,7 @@ bool idUsage::isValid<SpvOpSpecConstantComposite>(const spv_instruction_t* inst,
         if (elementType->id() != constituentType->id()) {
           DIAG(constituentIndex)
               << "OpSpecConstantComposite Constituent <id> '"
-              << inst->words[constituentIndex]
+              << inst->word(constituentIndex)
               << "'s type does not match Result Type <id> '" << resultType->id()
               << "'s array element type.";
           return false;
@@ -1103,19 +1104,19 @@ bool idUsage::isValid<SpvOpSpecConstantComposite>(const spv_instruction_t* inst,
       auto memberCount = resultType->words().size() - 2;
       if (memberCount != constituentCount) {
         DIAG(resultTypeIndex) << "OpSpecConstantComposite Constituent <id> '"
-                              << inst->words[resultTypeIndex]
+                              << inst->word(resultTypeIndex)
                               << "' count does not match Result Type <id> '"
                               << resultType->id() << "'s struct member count.";
         return false;
       }
       for (uint32_t constituentIndex = 3, memberIndex = 2;
-           constituentIndex < inst->words.size();
+           constituentIndex < inst->words().size();
            constituentIndex++, memberIndex++) {
-        auto constituent = module_.FindDef(inst->words[constituentIndex]);
+        auto constituent = module_.FindDef(inst->word(constituentIndex));
         if (!constituent ||
             !spvOpcodeIsConstantOrUndef(constituent->opcode())) {
           DIAG(constituentIndex) << "OpSpecConstantComposite Constituent <id> '"
-                                 << inst->words[constituentIndex]
+                                 << inst->word(constituentIndex)
                                  << "' is not a constant or undef.";
           return false;
         }
@@ -1127,7 +1128,7 @@ bool idUsage::isValid<SpvOpSpecConstantComposite>(const spv_instruction_t* inst,
         if (memberType->id() != constituentType->id()) {
           DIAG(constituentIndex)
               << "OpSpecConstantComposite Constituent <id> '"
-              << inst->words[constituentIndex]
+              << inst->word(constituentIndex)
               << "' type does not match the Result Type <id> '"
               << resultType->id() << "'s member type.";
           return false;
@@ -1142,23 +1143,23 @@ bool idUsage::isValid<SpvOpSpecConstantComposite>(const spv_instruction_t* inst,
 
 #if 0
 template <>
-bool idUsage::isValid<SpvOpSpecConstantOp>(const spv_instruction_t *inst) {}
+bool idUsage::isValid<SpvOpSpecConstantOp>(const Instruction* inst) {}
 #endif
 
 template <>
-bool idUsage::isValid<SpvOpVariable>(const spv_instruction_t* inst,
+bool idUsage::isValid<SpvOpVariable>(const Instruction* inst,
                                      const spv_opcode_desc) {
   auto resultTypeIndex = 1;
-  auto resultType = module_.FindDef(inst->words[resultTypeIndex]);
+  auto resultType = module_.FindDef(inst->word(resultTypeIndex));
   if (!resultType || SpvOpTypePointer != resultType->opcode()) {
     DIAG(resultTypeIndex) << "OpVariable Result Type <id> '"
-                          << inst->words[resultTypeIndex]
+                          << inst->word(resultTypeIndex)
                           << "' is not a pointer type.";
     return false;
   }
   const auto initialiserIndex = 4;
-  if (initialiserIndex < inst->words.size()) {
-    const auto initialiser = module_.FindDef(inst->words[initialiserIndex]);
+  if (initialiserIndex < inst->words().size()) {
+    const auto initialiser = module_.FindDef(inst->word(initialiserIndex));
     const auto storageClassIndex = 3;
     const auto is_module_scope_var =
         initialiser && (initialiser->opcode() == SpvOpVariable) &&
@@ -1167,7 +1168,7 @@ bool idUsage::isValid<SpvOpVariable>(const spv_instruction_t* inst,
         initialiser && spvOpcodeIsConstant(initialiser->opcode());
     if (!initialiser || !(is_constant || is_module_scope_var)) {
       DIAG(initialiserIndex)
-          << "OpVariable Initializer <id> '" << inst->words[initialiserIndex]
+          << "OpVariable Initializer <id> '" << inst->word(initialiserIndex)
           << "' is not a constant or module-scope variable.";
       return false;
     }
@@ -1176,41 +1177,41 @@ bool idUsage::isValid<SpvOpVariable>(const spv_instruction_t* inst,
 }
 
 template <>
-bool idUsage::isValid<SpvOpLoad>(const spv_instruction_t* inst,
+bool idUsage::isValid<SpvOpLoad>(const Instruction* inst,
                                  const spv_opcode_desc) {
   auto resultTypeIndex = 1;
-  auto resultType = module_.FindDef(inst->words[resultTypeIndex]);
+  auto resultType = module_.FindDef(inst->word(resultTypeIndex));
   if (!resultType) {
     DIAG(resultTypeIndex) << "OpLoad Result Type <id> '"
-                          << inst->words[resultTypeIndex] << "' is not defind.";
+                          << inst->word(resultTypeIndex) << "' is not defind.";
     return false;
   }
   const bool uses_variable_pointer =
       module_.features().variable_pointers ||
       module_.features().variable_pointers_storage_buffer;
   auto pointerIndex = 3;
-  auto pointer = module_.FindDef(inst->words[pointerIndex]);
+  auto pointer = module_.FindDef(inst->word(pointerIndex));
   if (!pointer ||
       (addressingModel == SpvAddressingModelLogical &&
        ((!uses_variable_pointer &&
          !spvOpcodeReturnsLogicalPointer(pointer->opcode())) ||
         (uses_variable_pointer &&
          !spvOpcodeReturnsLogicalVariablePointer(pointer->opcode()))))) {
-    DIAG(pointerIndex) << "OpLoad Pointer <id> '" << inst->words[pointerIndex]
+    DIAG(pointerIndex) << "OpLoad Pointer <id> '" << inst->word(pointerIndex)
                        << "' is not a logical pointer.";
     return false;
   }
   auto pointerType = module_.FindDef(pointer->type_id());
   if (!pointerType || pointerType->opcode() != SpvOpTypePointer) {
     DIAG(pointerIndex) << "OpLoad type for pointer <id> '"
-                       << inst->words[pointerIndex]
+                       << inst->word(pointerIndex)
                        << "' is not a pointer type.";
     return false;
   }
   auto pointeeType = module_.FindDef(pointerType->words()[3]);
   if (!pointeeType || resultType->id() != pointeeType->id()) {
     DIAG(resultTypeIndex) << "OpLoad Result Type <id> '"
-                          << inst->words[resultTypeIndex]
+                          << inst->word(resultTypeIndex)
                           << "' does not match Pointer <id> '" << pointer->id()
                           << "'s type.";
     return false;
@@ -1219,34 +1220,34 @@ bool idUsage::isValid<SpvOpLoad>(const spv_instruction_t* inst,
 }
 
 template <>
-bool idUsage::isValid<SpvOpStore>(const spv_instruction_t* inst,
+bool idUsage::isValid<SpvOpStore>(const Instruction* inst,
                                   const spv_opcode_desc) {
   const bool uses_variable_pointer =
       module_.features().variable_pointers ||
       module_.features().variable_pointers_storage_buffer;
   const auto pointerIndex = 1;
-  auto pointer = module_.FindDef(inst->words[pointerIndex]);
+  auto pointer = module_.FindDef(inst->word(pointerIndex));
   if (!pointer ||
       (addressingModel == SpvAddressingModelLogical &&
        ((!uses_variable_pointer &&
          !spvOpcodeReturnsLogicalPointer(pointer->opcode())) ||
         (uses_variable_pointer &&
          !spvOpcodeReturnsLogicalVariablePointer(pointer->opcode()))))) {
-    DIAG(pointerIndex) << "OpStore Pointer <id> '" << inst->words[pointerIndex]
+    DIAG(pointerIndex) << "OpStore Pointer <id> '" << inst->word(pointerIndex)
                        << "' is not a logical pointer.";
     return false;
   }
   auto pointerType = module_.FindDef(pointer->type_id());
   if (!pointer || pointerType->opcode() != SpvOpTypePointer) {
     DIAG(pointerIndex) << "OpStore type for pointer <id> '"
-                       << inst->words[pointerIndex]
+                       << inst->word(pointerIndex)
                        << "' is not a pointer type.";
     return false;
   }
   auto type = module_.FindDef(pointerType->words()[3]);
   assert(type);
   if (SpvOpTypeVoid == type->opcode()) {
-    DIAG(pointerIndex) << "OpStore Pointer <id> '" << inst->words[pointerIndex]
+    DIAG(pointerIndex) << "OpStore Pointer <id> '" << inst->word(pointerIndex)
                        << "'s type is void.";
     return false;
   }
@@ -1258,7 +1259,7 @@ bool idUsage::isValid<SpvOpStore>(const spv_instruction_t* inst,
     if (!module_.GetPointerTypeInfo(pointerType->id(), &dataType,
                                     &storageClass)) {
       DIAG(pointerIndex) << "OpStore Pointer <id> '"
-                         << inst->words[pointerIndex]
+                         << inst->word(pointerIndex)
                          << "' is not pointer type";
       return false;
     }
@@ -1267,23 +1268,23 @@ bool idUsage::isValid<SpvOpStore>(const spv_instruction_t* inst,
         storageClass == SpvStorageClassInput ||
         storageClass == SpvStorageClassPushConstant) {
       DIAG(pointerIndex) << "OpStore Pointer <id> '"
-                         << inst->words[pointerIndex]
+                         << inst->word(pointerIndex)
                          << "' storage class is read-only";
       return false;
     }
   }
 
   auto objectIndex = 2;
-  auto object = module_.FindDef(inst->words[objectIndex]);
+  auto object = module_.FindDef(inst->word(objectIndex));
   if (!object || !object->type_id()) {
-    DIAG(objectIndex) << "OpStore Object <id> '" << inst->words[objectIndex]
+    DIAG(objectIndex) << "OpStore Object <id> '" << inst->word(objectIndex)
                       << "' is not an object.";
     return false;
   }
   auto objectType = module_.FindDef(object->type_id());
   assert(objectType);
   if (SpvOpTypeVoid == objectType->opcode()) {
-    DIAG(objectIndex) << "OpStore Object <id> '" << inst->words[objectIndex]
+    DIAG(objectIndex) << "OpStore Object <id> '" << inst->word(objectIndex)
                       << "'s type is void.";
     return false;
   }
@@ -1293,7 +1294,7 @@ bool idUsage::isValid<SpvOpStore>(const spv_instruction_t* inst,
         type->opcode() != SpvOpTypeStruct ||
         objectType->opcode() != SpvOpTypeStruct) {
       DIAG(pointerIndex) << "OpStore Pointer <id> '"
-                         << inst->words[pointerIndex]
+                         << inst->word(pointerIndex)
                          << "'s type does not match Object <id> '"
                          << object->id() << "'s type.";
       return false;
@@ -1302,7 +1303,7 @@ bool idUsage::isValid<SpvOpStore>(const spv_instruction_t* inst,
     // TODO: Check for layout compatible matricies and arrays as well.
     if (!AreLayoutCompatibleStructs(type, objectType)) {
       DIAG(pointerIndex) << "OpStore Pointer <id> '"
-                         << inst->words[pointerIndex]
+                         << inst->word(pointerIndex)
                          << "'s layout does not match Object <id> '"
                          << object->id() << "'s layout.";
       return false;
@@ -1312,13 +1313,13 @@ bool idUsage::isValid<SpvOpStore>(const spv_instruction_t* inst,
 }
 
 template <>
-bool idUsage::isValid<SpvOpCopyMemory>(const spv_instruction_t* inst,
+bool idUsage::isValid<SpvOpCopyMemory>(const Instruction* inst,
                                        const spv_opcode_desc) {
   auto targetIndex = 1;
-  auto target = module_.FindDef(inst->words[targetIndex]);
+  auto target = module_.FindDef(inst->word(targetIndex));
   if (!target) return false;
   auto sourceIndex = 2;
-  auto source = module_.FindDef(inst->words[sourceIndex]);
+  auto source = module_.FindDef(inst->word(sourceIndex));
   if (!source) return false;
   auto targetPointerType = module_.FindDef(target->type_id());
   assert(targetPointerType);
@@ -1330,7 +1331,7 @@ bool idUsage::isValid<SpvOpCopyMemory>(const spv_instruction_t* inst,
   assert(sourceType);
   if (targetType->id() != sourceType->id()) {
     DIAG(sourceIndex) << "OpCopyMemory Target <id> '"
-                      << inst->words[sourceIndex]
+                      << inst->word(sourceIndex)
                       << "'s type does not match Source <id> '"
                       << sourceType->id() << "'s type.";
     return false;
@@ -1339,27 +1340,27 @@ bool idUsage::isValid<SpvOpCopyMemory>(const spv_instruction_t* inst,
 }
 
 template <>
-bool idUsage::isValid<SpvOpCopyMemorySized>(const spv_instruction_t* inst,
+bool idUsage::isValid<SpvOpCopyMemorySized>(const Instruction* inst,
                                             const spv_opcode_desc) {
   auto targetIndex = 1;
-  auto target = module_.FindDef(inst->words[targetIndex]);
+  auto target = module_.FindDef(inst->word(targetIndex));
   if (!target) return false;
   auto sourceIndex = 2;
-  auto source = module_.FindDef(inst->words[sourceIndex]);
+  auto source = module_.FindDef(inst->word(sourceIndex));
   if (!source) return false;
   auto sizeIndex = 3;
-  auto size = module_.FindDef(inst->words[sizeIndex]);
+  auto size = module_.FindDef(inst->word(sizeIndex));
   if (!size) return false;
   auto targetPointerType = module_.FindDef(target->type_id());
   if (!targetPointerType || SpvOpTypePointer != targetPointerType->opcode()) {
     DIAG(targetIndex) << "OpCopyMemorySized Target <id> '"
-                      << inst->words[targetIndex] << "' is not a pointer.";
+                      << inst->word(targetIndex) << "' is not a pointer.";
     return false;
   }
   auto sourcePointerType = module_.FindDef(source->type_id());
   if (!sourcePointerType || SpvOpTypePointer != sourcePointerType->opcode()) {
     DIAG(sourceIndex) << "OpCopyMemorySized Source <id> '"
-                      << inst->words[sourceIndex] << "' is not a pointer.";
+                      << inst->word(sourceIndex) << "' is not a pointer.";
     return false;
   }
   switch (size->opcode()) {
@@ -1372,7 +1373,7 @@ bool idUsage::isValid<SpvOpCopyMemorySized>(const spv_instruction_t* inst,
       assert(sizeType);
       if (SpvOpTypeInt != sizeType->opcode()) {
         DIAG(sizeIndex) << "OpCopyMemorySized Size <id> '"
-                        << inst->words[sizeIndex]
+                        << inst->word(sizeIndex)
                         << "'s type is not an integer type.";
         return false;
       }
@@ -1383,14 +1384,14 @@ bool idUsage::isValid<SpvOpCopyMemorySized>(const spv_instruction_t* inst,
       auto sizeType = module_.FindDef(pointerType->type_id());
       if (!sizeType || SpvOpTypeInt != sizeType->opcode()) {
         DIAG(sizeIndex) << "OpCopyMemorySized Size <id> '"
-                        << inst->words[sizeIndex]
+                        << inst->word(sizeIndex)
                         << "'s variable type is not an integer type.";
         return false;
       }
     } break;
     default:
       DIAG(sizeIndex) << "OpCopyMemorySized Size <id> '"
-                      << inst->words[sizeIndex]
+                      << inst->word(sizeIndex)
                       << "' is not a constant or variable.";
       return false;
   }
@@ -1399,18 +1400,17 @@ bool idUsage::isValid<SpvOpCopyMemorySized>(const spv_instruction_t* inst,
   return true;
 }
 
-template <>
-bool idUsage::isValid<SpvOpAccessChain>(const spv_instruction_t* inst,
-                                        const spv_opcode_desc) {
+bool idUsage::isValidAccessChain(const Instruction* inst,
+                                 size_t first_index_word) {
   std::string instr_name =
-      "Op" + std::string(spvOpcodeString(static_cast<SpvOp>(inst->opcode)));
+      "Op" + std::string(spvOpcodeString(static_cast<SpvOp>(inst->opcode())));
 
   // The result type must be OpTypePointer. Result Type is at word 1.
   auto resultTypeIndex = 1;
-  auto resultTypeInstr = module_.FindDef(inst->words[resultTypeIndex]);
+  auto resultTypeInstr = module_.FindDef(inst->word(resultTypeIndex));
   if (SpvOpTypePointer != resultTypeInstr->opcode()) {
     DIAG(resultTypeIndex) << "The Result Type of " << instr_name << " <id> '"
-                          << inst->words[2]
+                          << inst->word(2)
                           << "' must be OpTypePointer. Found Op"
                           << spvOpcodeString(
                                  static_cast<SpvOp>(resultTypeInstr->opcode()))
@@ -1425,10 +1425,10 @@ bool idUsage::isValid<SpvOpAccessChain>(const spv_instruction_t* inst,
 
   // Base must be a pointer, pointing to the base of a composite object.
   auto baseIdIndex = 3;
-  auto baseInstr = module_.FindDef(inst->words[baseIdIndex]);
+  auto baseInstr = module_.FindDef(inst->word(baseIdIndex));
   auto baseTypeInstr = module_.FindDef(baseInstr->type_id());
   if (!baseTypeInstr || SpvOpTypePointer != baseTypeInstr->opcode()) {
-    DIAG(baseIdIndex) << "The Base <id> '" << inst->words[baseIdIndex]
+    DIAG(baseIdIndex) << "The Base <id> '" << inst->word(baseIdIndex)
                       << "' in " << instr_name
                       << " instruction must be a pointer.";
     return false;
@@ -1451,7 +1451,7 @@ bool idUsage::isValid<SpvOpAccessChain>(const spv_instruction_t* inst,
   // Check Universal Limit (SPIR-V Spec. Section 2.17).
   // The number of indexes passed to OpAccessChain may not exceed 255
   // The instruction includes 4 words + N words (for N indexes)
-  const size_t num_indexes = inst->words.size() - 4;
+  const size_t num_indexes = inst->words().size() - first_index_word;
   const size_t num_indexes_limit =
       module_.options()->universal_limits_.max_access_chain_indexes;
   if (num_indexes > num_indexes_limit) {
@@ -1467,8 +1467,8 @@ bool idUsage::isValid<SpvOpAccessChain>(const spv_instruction_t* inst,
   // instruction. The second index will apply similarly to that result, and so
   // on. Once any non-composite type is reached, there must be no remaining
   // (unused) indexes.
-  for (size_t i = 4; i < inst->words.size(); ++i) {
-    const uint32_t cur_word = inst->words[i];
+  for (size_t i = first_index_word; i < inst->words().size(); ++i) {
+    const uint32_t cur_word = inst->word(i);
     // Earlier ID checks ensure that cur_word definition exists.
     auto cur_word_instr = module_.FindDef(cur_word);
     // The index must be a scalar integer type (See OpAccessChain in the Spec.)
@@ -1545,63 +1545,66 @@ bool idUsage::isValid<SpvOpAccessChain>(const spv_instruction_t* inst,
   return true;
 }
 
+template <>
+bool idUsage::isValid<SpvOpAccessChain>(const Instruction* inst,
+                                        const spv_opcode_desc) {
+  return isValidAccessChain(inst, 4);
+}
+
 template <>
 bool idUsage::isValid<SpvOpInBoundsAccessChain>(
-    const spv_instruction_t* inst, const spv_opcode_desc opcodeEntry) {
+    const Instruction* inst, const spv_opcode_desc opcodeEntry) {
   return isValid<SpvOpAccessChain>(inst, opcodeEntry);
 }
 
 template <>
-bool idUsage::isValid<SpvOpPtrAccessChain>(const spv_instruction_t* inst,
-                                           const spv_opcode_desc opcodeEntry) {
+bool idUsage::isValid<SpvOpPtrAccessChain>(const Instruction* inst,
+                                           const spv_opcode_desc) {
   // OpPtrAccessChain's validation rules are similar to OpAccessChain, with one
   // difference: word 4 must be id of an integer (Element <id>).
   // The grammar guarantees that there are at least 5 words in the instruction
   // (i.e. if there are fewer than 5 words, the SPIR-V code will not compile.)
-  int elem_index = 4;
-  // We can remove the Element <id> from the instruction words, and simply call
-  // the validation code of OpAccessChain.
-  spv_instruction_t new_inst = *inst;
-  new_inst.words.erase(new_inst.words.begin() + elem_index);
-  return isValid<SpvOpAccessChain>(&new_inst, opcodeEntry);
+  // We skip over the Element <id> and run the validation code of
+  // OpAccessChain on the remaining indexes.
+  return isValidAccessChain(inst, 5);
 }
 
 template <>
 bool idUsage::isValid<SpvOpInBoundsPtrAccessChain>(
-    const spv_instruction_t* inst, const spv_opcode_desc opcodeEntry) {
+    const Instruction* inst, const spv_opcode_desc opcodeEntry) {
   // Has the same validation rules as OpPtrAccessChain
   return isValid<SpvOpPtrAccessChain>(inst, opcodeEntry);
 }
 
 #if 0
 template <>
-bool idUsage::isValid<SpvOpArrayLength>(const spv_instruction_t *inst,
+bool idUsage::isValid<SpvOpArrayLength>(const Instruction* inst,
                                         const spv_opcode_desc opcodeEntry) {}
 #endif
 
 #if 0
 template <>
-bool idUsage::isValid<SpvOpImagePointer>(const spv_instruction_t *inst,
+bool idUsage::isValid<SpvOpImagePointer>(const Instruction* inst,
                                          const spv_opcode_desc opcodeEntry) {}
 #endif
 
 #if 0
 template <>
 bool idUsage::isValid<SpvOpGenericPtrMemSemantics>(
-    const spv_instruction_t *inst, const spv_opcode_desc opcodeEntry) {}
+    const Instruction* inst, const spv_opcode_desc opcodeEntry) {}
 #endif
 
 template <>
-bool idUsage::isValid<SpvOpFunction>(const spv_instruction_t* inst,
+bool idUsage::isValid<SpvOpFunction>(const Instruction* inst,
                                      const spv_opcode_desc) {
   auto resultTypeIndex = 1;
-  auto resultType = module_.FindDef(inst->words[resultTypeIndex]);
+  auto resultType = module_.FindDef(inst->word(resultTypeIndex));
   if (!resultType) return false;
   auto functionTypeIndex = 4;
-  auto functionType = module_.FindDef(inst->words[functionTypeIndex]);
+  auto functionType = module_.FindDef(inst->word(functionTypeIndex));
   if (!functionType || SpvOpTypeFunction != functionType->opcode()) {
     DIAG(functionTypeIndex)
-        << "OpFunction Function Type <id> '" << inst->words[functionTypeIndex]
+        << "OpFunction Function Type <id> '" << inst->word(functionTypeIndex)
         << "' is not a function type.";
     return false;
   }
@@ -1609,7 +1612,7 @@ bool idUsage::isValid<SpvOpFunction>(const spv_instruction_t* inst,
   assert(returnType);
   if (returnType->id() != resultType->id()) {
     DIAG(resultTypeIndex) << "OpFunction Result Type <id> '"
-                          << inst->words[resultTypeIndex]
+                          << inst->word(resultTypeIndex)
                           << "' does not match the Function Type <id> '"
                           << resultType->id() << "'s return type.";
     return false;
@@ -1618,25 +1621,22 @@ bool idUsage::isValid<SpvOpFunction>(const spv_instruction_t* inst,
 }
 
 template <>
-bool idUsage::isValid<SpvOpFunctionParameter>(const spv_instruction_t* inst,
+bool idUsage::isValid<SpvOpFunctionParameter>(const Instruction* inst,
                                               const spv_opcode_desc) {
   auto resultTypeIndex = 1;
-  auto resultType = module_.FindDef(inst->words[resultTypeIndex]);
+  auto resultType = module_.FindDef(inst->word(resultTypeIndex));
   if (!resultType) return false;
-  // NOTE: Find OpFunction & ensure OpFunctionParameter is not out of place.
-  size_t paramIndex = 0;
-  assert(firstInst < inst && "Invalid instruction pointer");
-  while (firstInst != --inst) {
-    if (SpvOpFunction == inst->opcode) {
-      break;
-    } else if (SpvOpFunctionParameter == inst->opcode) {
-      paramIndex++;
-    }
-  }
-  auto functionType = module_.FindDef(inst->words[4]);
+  // NOTE: The layout checks ensure OpFunctionParameter is not out of place.
+  const Function* function = inst->function();
+  assert(function && "Invalid instruction pointer");
+  const auto& parameter_ids = function->parameter_ids();
+  const size_t paramIndex = static_cast<size_t>(
+      std::find(parameter_ids.begin(), parameter_ids.end(), inst->id()) -
+      parameter_ids.begin());
+  auto functionType = module_.FindDef(function->function_type_id());
   assert(functionType);
   if (paramIndex >= functionType->words().size() - 3) {
-    DIAG(0) << "Too many OpFunctionParameters for " << inst->words[2]
+    DIAG(0) << "Too many OpFunctionParameters for " << function->id()
             << ": expected " << functionType->words().size() - 3
             << " based on the function's type";
     return false;
@@ -1645,7 +1645,7 @@ bool idUsage::isValid<SpvOpFunctionParameter>(const spv_instruction_t* inst,
   assert(paramType);
   if (resultType->id() != paramType->id()) {
     DIAG(resultTypeIndex) << "OpFunctionParameter Result Type <id> '"
-                          << inst->words[resultTypeIndex]
+                          << inst->word(resultTypeIndex)
                           << "' does not match the OpTypeFunction parameter "
                              "type of the same index.";
     return false;
@@ -1654,40 +1654,40 @@ bool idUsage::isValid<SpvOpFunctionParameter>(const spv_instruction_t* inst,
 }
 
 template <>
-bool idUsage::isValid<SpvOpFunctionCall>(const spv_instruction_t* inst,
+bool idUsage::isValid<SpvOpFunctionCall>(const Instruction* inst,
                                          const spv_opcode_desc) {
   auto resultTypeIndex = 1;
-  auto resultType = module_.FindDef(inst->words[resultTypeIndex]);
+  auto resultType = module_.FindDef(inst->word(resultTypeIndex));
   if (!resultType) return false;
   auto functionIndex = 3;
-  auto function = module_.FindDef(inst->words[functionIndex]);
+  auto function = module_.FindDef(inst->word(functionIndex));
   if (!function || SpvOpFunction != function->opcode()) {
     DIAG(functionIndex) << "OpFunctionCall Function <id> '"
-                        << inst->words[functionIndex] << "' is not a function.";
+                        << inst->word(functionIndex) << "' is not a function.";
     return false;
   }
   auto returnType = module_.FindDef(function->type_id());
   assert(returnType);
   if (returnType->id() != resultType->id()) {
     DIAG(resultTypeIndex) << "OpFunctionCall Result Type <id> '"
-                          << inst->words[resultTypeIndex]
+                          << inst->word(resultTypeIndex)
                           << "'s type does not match Function <id> '"
                           << returnType->id() << "'s return type.";
     return false;
   }
   auto functionType = module_.FindDef(function->words()[4]);
   assert(functionType);
-  auto functionCallArgCount = inst->words.size() - 4;
+  auto functionCallArgCount = inst->words().size() - 4;
   auto functionParamCount = functionType->words().size() - 3;
   if (functionParamCount != functionCallArgCount) {
-    DIAG(inst->words.size() - 1)
+    DIAG(inst->words().size() - 1)
         << "OpFunctionCall Function <id>'s parameter count does not match "
            "the argument count.";
     return false;
   }
   for (size_t argumentIndex = 4, paramIndex = 3;
-       argumentIndex < inst->words.size(); argumentIndex++, paramIndex++) {
-    auto argument = module_.FindDef(inst->words[argumentIndex]);
+       argumentIndex < inst->words().size(); argumentIndex++, paramIndex++) {
+    auto argument = module_.FindDef(inst->word(argumentIndex));
     if (!argument) return false;
     auto argumentType = module_.FindDef(argument->type_id());
     assert(argumentType);
@@ -1695,7 +1695,7 @@ bool idUsage::isValid<SpvOpFunctionCall>(const spv_instruction_t* inst,
     assert(parameterType);
     if (argumentType->id() != parameterType->id()) {
       DIAG(argumentIndex) << "OpFunctionCall Argument <id> '"
-                          << inst->words[argumentIndex]
+                          << inst->word(argumentIndex)
                           << "'s type does not match Function <id> '"
                           << parameterType->id() << "'s parameter type.";
       return false;
@@ -1705,17 +1705,17 @@ bool idUsage::isValid<SpvOpFunctionCall>(const spv_instruction_t* inst,
 }
 
 template <>
-bool idUsage::isValid<SpvOpVectorShuffle>(const spv_instruction_t* inst,
+bool idUsage::isValid<SpvOpVectorShuffle>(const Instruction* inst,
                                           const spv_opcode_desc) {
   auto instr_name = [&inst]() {
     std::string name =
-        "Op" + std::string(spvOpcodeString(static_cast<SpvOp>(inst->opcode)));
+        "Op" + std::string(spvOpcodeString(static_cast<SpvOp>(inst->opcode())));
     return name;
   };
 
   // Result Type must be an OpTypeVector.
   auto resultTypeIndex = 1;
-  auto resultType = module_.FindDef(inst->words[resultTypeIndex]);
+  auto resultType = module_.FindDef(inst->word(resultTypeIndex));
   if (!resultType || resultType->opcode() != SpvOpTypeVector) {
     DIAG(resultTypeIndex) << "The Result Type of " << instr_name()
                           << " must be OpTypeVector. Found Op"
@@ -1727,11 +1727,11 @@ bool idUsage::isValid<SpvOpVectorShuffle>(const spv_instruction_t* inst,
 
   // The number of components in Result Type must be the same as the number of
   // Component operands.
-  auto componentCount = inst->words.size() - 5;
+  auto componentCount = inst->words().size() - 5;
   auto vectorComponentCountIndex = 3;
   auto resultVectorDimension = resultType->words()[vectorComponentCountIndex];
   if (componentCount != resultVectorDimension) {
-    DIAG(inst->words.size() - 1)
+    DIAG(inst->words().size() - 1)
         << instr_name()
         << " component literals count does not match "
            "Result Type <id> '"
@@ -1742,10 +1742,10 @@ bool idUsage::isValid<SpvOpVectorShuffle>(const spv_instruction_t* inst,
   // Vector 1 and Vector 2 must both have vector types, with the same Component
   // Type as Result Type.
   auto vector1Index = 3;
-  auto vector1Object = module_.FindDef(inst->words[vector1Index]);
+  auto vector1Object = module_.FindDef(inst->word(vector1Index));
   auto vector1Type = module_.FindDef(vector1Object->type_id());
   auto vector2Index = 4;
-  auto vector2Object = module_.FindDef(inst->words[vector2Index]);
+  auto vector2Object = module_.FindDef(inst->word(vector2Index));
   auto vector2Type = module_.FindDef(vector2Object->type_id());
   if (!vector1Type || vector1Type->opcode() != SpvOpTypeVector) {
     DIAG(vector1Index) << "The type of Vector 1 must be OpTypeVector.";
@@ -1775,8 +1775,8 @@ bool idUsage::isValid<SpvOpVectorShuffle>(const spv_instruction_t* inst,
   auto vector2ComponentCount = vector2Type->words()[vectorComponentCountIndex];
   auto N = vector1ComponentCount + vector2ComponentCount;
   auto firstLiteralIndex = 5;
-  for (size_t i = firstLiteralIndex; i < inst->words.size(); ++i) {
-    auto literal = inst->words[i];
+  for (size_t i = firstLiteralIndex; i < inst->words().size(); ++i) {
+    auto literal = inst->word(i);
     if (literal != 0xFFFFFFFF && literal >= N) {
       DIAG(i) << "Component literal value " << literal << " is greater than "
               << N - 1 << ".";
@@ -1789,32 +1789,32 @@ bool idUsage::isValid<SpvOpVectorShuffle>(const spv_instruction_t* inst,
 
 #if 0
 template <>
-bool idUsage::isValid<OpPhi>(const spv_instruction_t *inst,
+bool idUsage::isValid<OpPhi>(const Instruction* inst,
                              const spv_opcode_desc opcodeEntry) {}
 #endif
 
 #if 0
 template <>
-bool idUsage::isValid<OpLoopMerge>(const spv_instruction_t *inst,
+bool idUsage::isValid<OpLoopMerge>(const Instruction* inst,
                                    const spv_opcode_desc opcodeEntry) {}
 #endif
 
 #if 0
 template <>
 bool idUsage::isValid<OpSelectionMerge>(
-    const spv_instruction_t *inst, const spv_opcode_desc opcodeEntry) {}
+    const Instruction* inst, const spv_opcode_desc opcodeEntry) {}
 #endif
 
 #if 0
 template <>
-bool idUsage::isValid<OpBranch>(const spv_instruction_t *inst,
+bool idUsage::isValid<OpBranch>(const Instruction* inst,
                                 const spv_opcode_desc opcodeEntry) {}
 #endif
 
 template <>
-bool idUsage::isValid<SpvOpBranchConditional>(const spv_instruction_t* inst,
+bool idUsage::isValid<SpvOpBranchConditional>(const Instruction* inst,
                                               const spv_opcode_desc) {
-  const size_t numOperands = inst->words.size() - 1;
+  const size_t numOperands = inst->words().size() - 1;
   const size_t condOperandIndex = 1;
   const size_t targetTrueIndex = 2;
   const size_t targetFalseIndex = 3;
@@ -1829,7 +1829,7 @@ bool idUsage::isValid<SpvOpBranchConditional>(const spv_instruction_t* inst,
   bool ret = true;
 
   // grab the condition operand and check that it is a bool
-  const auto condOp = module_.FindDef(inst->words[condOperandIndex]);
+  const auto condOp = module_.FindDef(inst->word(condOperandIndex));
   if (!condOp || !module_.IsBoolScalarType(condOp->type_id())) {
     DIAG(0)
         << "Condition operand for OpBranchConditional must be of boolean type";
@@ -1840,14 +1840,14 @@ bool idUsage::isValid<SpvOpBranchConditional>(const spv_instruction_t* inst,
   // note that we don't need to check that the target labels are in the same
   // function,
   // PerformCfgChecks already checks for that
-  const auto targetOpTrue = module_.FindDef(inst->words[targetTrueIndex]);
+  const auto targetOpTrue = module_.FindDef(inst->word(targetTrueIndex));
   if (!targetOpTrue || SpvOpLabel != targetOpTrue->opcode()) {
     DIAG(0) << "The 'True Label' operand for OpBranchConditional must be the "
                "ID of an OpLabel instruction";
     ret = false;
   }
 
-  const auto targetOpFalse = module_.FindDef(inst->words[targetFalseIndex]);
+  const auto targetOpFalse = module_.FindDef(inst->word(targetFalseIndex));
   if (!targetOpFalse || SpvOpLabel != targetOpFalse->opcode()) {
     DIAG(0) << "The 'False Label' operand for OpBranchConditional must be the "
                "ID of an OpLabel instruction";
@@ -1859,17 +1859,17 @@ bool idUsage::isValid<SpvOpBranchConditional>(const spv_instruction_t* inst,
 
 #if 0
 template <>
-bool idUsage::isValid<OpSwitch>(const spv_instruction_t *inst,
+bool idUsage::isValid<OpSwitch>(const Instruction* inst,
                                 const spv_opcode_desc opcodeEntry) {}
 #endif
 
 template <>
-bool idUsage::isValid<SpvOpReturnValue>(const spv_instruction_t* inst,
+bool idUsage::isValid<SpvOpReturnValue>(const Instruction* inst,
                                         const spv_opcode_desc) {
   auto valueIndex = 1;
-  auto value = module_.FindDef(inst->words[valueIndex]);
+  auto value = module_.FindDef(inst->word(valueIndex));
   if (!value || !value->type_id()) {
-    DIAG(valueIndex) << "OpReturnValue Value <id> '" << inst->words[valueIndex]
+    DIAG(valueIndex) << "OpReturnValue Value <id> '" << inst->word(valueIndex)
                      << "' does not represent a value.";
     return false;
   }
@@ -1894,18 +1894,14 @@ bool idUsage::isValid<SpvOpReturnValue>(const spv_instruction_t* inst,
   }
 
   // NOTE: Find OpFunction
-  const spv_instruction_t* function = inst - 1;
-  while (firstInst != function) {
-    if (SpvOpFunction == function->opcode) break;
-    function--;
-  }
-  if (SpvOpFunction != function->opcode) {
+  const Function* function = inst->function();
+  if (!function) {
     DIAG(valueIndex) << "OpReturnValue is not in a basic block.";
     return false;
   }
-  auto returnType = module_.FindDef(function->words[1]);
+  auto returnType = module_.FindDef(function->GetResultTypeId());
   if (!returnType || returnType->id() != valueType->id()) {
-    DIAG(valueIndex) << "OpReturnValue Value <id> '" << inst->words[valueIndex]
+    DIAG(valueIndex) << "OpReturnValue Value <id> '" << inst->word(valueIndex)
                      << "'s type does not match OpFunction's return type.";
     return false;
   }
@@ -1914,219 +1910,219 @@ bool idUsage::isValid<SpvOpReturnValue>(const spv_instruction_t* inst,
 
 #if 0
 template <>
-bool idUsage::isValid<OpLifetimeStart>(const spv_instruction_t *inst,
+bool idUsage::isValid<OpLifetimeStart>(const Instruction* inst,
                                        const spv_opcode_desc opcodeEntry) {
 }
 #endif
 
 #if 0
 template <>
-bool idUsage::isValid<OpLifetimeStop>(const spv_instruction_t *inst,
+bool idUsage::isValid<OpLifetimeStop>(const Instruction* inst,
                                       const spv_opcode_desc opcodeEntry) {}
 #endif
 
 #if 0
 template <>
-bool idUsage::isValid<OpAtomicInit>(const spv_instruction_t *inst,
+bool idUsage::isValid<OpAtomicInit>(const Instruction* inst,
                                     const spv_opcode_desc opcodeEntry) {}
 #endif
 
 #if 0
 template <>
-bool idUsage::isValid<OpAtomicLoad>(const spv_instruction_t *inst,
+bool idUsage::isValid<OpAtomicLoad>(const Instruction* inst,
                                     const spv_opcode_desc opcodeEntry) {}
 #endif
 
 #if 0
 template <>
-bool idUsage::isValid<OpAtomicStore>(const spv_instruction_t *inst,
+bool idUsage::isValid<OpAtomicStore>(const Instruction* inst,
                                      const spv_opcode_desc opcodeEntry) {}
 #endif
 
 #if 0
 template <>
 bool idUsage::isValid<OpAtomicExchange>(
-    const spv_instruction_t *inst, const spv_opcode_desc opcodeEntry) {}
+    const Instruction* inst, const spv_opcode_desc opcodeEntry) {}
 #endif
 
 #if 0
 template <>
 bool idUsage::isValid<OpAtomicCompareExchange>(
-    const spv_instruction_t *inst, const spv_opcode_desc opcodeEntry) {}
+    const Instruction* inst, const spv_opcode_desc opcodeEntry) {}
 #endif
 
 #if 0
 template <>
 bool idUsage::isValid<OpAtomicCompareExchangeWeak>(
-    const spv_instruction_t *inst, const spv_opcode_desc opcodeEntry) {}
+    const Instruction* inst, const spv_opcode_desc opcodeEntry) {}
 #endif
 
 #if 0
 template <>
 bool idUsage::isValid<OpAtomicIIncrement>(
-    const spv_instruction_t *inst, const spv_opcode_desc opcodeEntry) {}
+    const Instruction* inst, const spv_opcode_desc opcodeEntry) {}
 #endif
 
 #if 0
 template <>
 bool idUsage::isValid<OpAtomicIDecrement>(
-    const spv_instruction_t *inst, const spv_opcode_desc opcodeEntry) {}
+    const Instruction* inst, const spv_opcode_desc opcodeEntry) {}
 #endif
 
 #if 0
 template <>
-bool idUsage::isValid<OpAtomicIAdd>(const spv_instruction_t *inst,
+bool idUsage::isValid<OpAtomicIAdd>(const Instruction* inst,
                                     const spv_opcode_desc opcodeEntry) {}
 #endif
 
 #if 0
 template <>
-bool idUsage::isValid<OpAtomicISub>(const spv_instruction_t *inst,
+bool idUsage::isValid<OpAtomicISub>(const Instruction* inst,
                                     const spv_opcode_desc opcodeEntry) {}
 #endif
 
 #if 0
 template <>
-bool idUsage::isValid<OpAtomicUMin>(const spv_instruction_t *inst,
+bool idUsage::isValid<OpAtomicUMin>(const Instruction* inst,
                                     const spv_opcode_desc opcodeEntry) {}
 #endif
 
 #if 0
 template <>
-bool idUsage::isValid<OpAtomicUMax>(const spv_instruction_t *inst,
+bool idUsage::isValid<OpAtomicUMax>(const Instruction* inst,
                                     const spv_opcode_desc opcodeEntry) {}
 #endif
 
 #if 0
 template <>
-bool idUsage::isValid<OpAtomicAnd>(const spv_instruction_t *inst,
+bool idUsage::isValid<OpAtomicAnd>(const Instruction* inst,
                                    const spv_opcode_desc opcodeEntry) {}
 #endif
 
 #if 0
 template <>
-bool idUsage::isValid<OpAtomicOr>(const spv_instruction_t *inst,
+bool idUsage::isValid<OpAtomicOr>(const Instruction* inst,
                                   const spv_opcode_desc opcodeEntry) {}
 #endif
 
 #if 0
 template <>
-bool idUsage::isValid<OpAtomicXor>(const spv_instruction_t *inst,
+bool idUsage::isValid<OpAtomicXor>(const Instruction* inst,
                                    const spv_opcode_desc opcodeEntry) {}
 #endif
 
 #if 0
 template <>
-bool idUsage::isValid<OpAtomicIMin>(const spv_instruction_t *inst,
+bool idUsage::isValid<OpAtomicIMin>(const Instruction* inst,
                                     const spv_opcode_desc opcodeEntry) {}
 #endif
 
 #if 0
 template <>
-bool idUsage::isValid<OpAtomicIMax>(const spv_instruction_t *inst,
+bool idUsage::isValid<OpAtomicIMax>(const Instruction* inst,
                                     const spv_opcode_desc opcodeEntry) {}
 #endif
 
 #if 0
 template <>
 bool idUsage::isValid<OpEmitStreamVertex>(
-    const spv_instruction_t *inst, const spv_opcode_desc opcodeEntry) {}
+    const Instruction* inst, const spv_opcode_desc opcodeEntry) {}
 #endif
 
 #if 0
 template <>
 bool idUsage::isValid<OpEndStreamPrimitive>(
-    const spv_instruction_t *inst, const spv_opcode_desc opcodeEntry) {}
+    const Instruction* inst, const spv_opcode_desc opcodeEntry) {}
 #endif
 
 #if 0
 template <>
 bool idUsage::isValid<OpGroupAsyncCopy>(
-    const spv_instruction_t *inst, const spv_opcode_desc opcodeEntry) {}
+    const Instruction* inst, const spv_opcode_desc opcodeEntry) {}
 #endif
 
 #if 0
 template <>
 bool idUsage::isValid<OpGroupWaitEvents>(
-    const spv_instruction_t *inst, const spv_opcode_desc opcodeEntry) {}
+    const Instruction* inst, const spv_opcode_desc opcodeEntry) {}
 #endif
 
 #if 0
 template <>
-bool idUsage::isValid<OpGroupAll>(const spv_instruction_t *inst,
+bool idUsage::isValid<OpGroupAll>(const Instruction* inst,
                                   const spv_opcode_desc opcodeEntry) {}
 #endif
 
 #if 0
 template <>
-bool idUsage::isValid<OpGroupAny>(const spv_instruction_t *inst,
+bool idUsage::isValid<OpGroupAny>(const Instruction* inst,
                                   const spv_opcode_desc opcodeEntry) {}
 #endif
 
 #if 0
 template <>
 bool idUsage::isValid<OpGroupBroadcast>(
-    const spv_instruction_t *inst, const spv_opcode_desc opcodeEntry) {}
+    const Instruction* inst, const spv_opcode_desc opcodeEntry) {}
 #endif
 
 #if 0
 template <>
-bool idUsage::isValid<OpGroupIAdd>(const spv_instruction_t *inst,
+bool idUsage::isValid<OpGroupIAdd>(const Instruction* inst,
                                    const spv_opcode_desc opcodeEntry) {}
 #endif
 
 #if 0
 template <>
-bool idUsage::isValid<OpGroupFAdd>(const spv_instruction_t *inst,
+bool idUsage::isValid<OpGroupFAdd>(const Instruction* inst,
                                    const spv_opcode_desc opcodeEntry) {}
 #endif
 
 #if 0
 template <>
-bool idUsage::isValid<OpGroupFMin>(const spv_instruction_t *inst,
+bool idUsage::isValid<OpGroupFMin>(const Instruction* inst,
                                    const spv_opcode_desc opcodeEntry) {}
 #endif
 
 #if 0
 template <>
-bool idUsage::isValid<OpGroupUMin>(const spv_instruction_t *inst,
+bool idUsage::isValid<OpGroupUMin>(const Instruction* inst,
                                    const spv_opcode_desc opcodeEntry) {}
 #endif
 
 #if 0
 template <>
-bool idUsage::isValid<OpGroupSMin>(const spv_instruction_t *inst,
+bool idUsage::isValid<OpGroupSMin>(const Instruction* inst,
                                    const spv_opcode_desc opcodeEntry) {}
 #endif
 
 #if 0
 template <>
-bool idUsage::isValid<OpGroupFMax>(const spv_instruction_t *inst,
+bool idUsage::isValid<OpGroupFMax>(const Instruction* inst,
                                    const spv_opcode_desc opcodeEntry) {}
 #endif
 
 #if 0
 template <>
-bool idUsage::isValid<OpGroupUMax>(const spv_instruction_t *inst,
+bool idUsage::isValid<OpGroupUMax>(const Instruction* inst,
                                    const spv_opcode_desc opcodeEntry) {}
 #endif
 
 #if 0
 template <>
-bool idUsage::isValid<OpGroupSMax>(const spv_instruction_t *inst,
+bool idUsage::isValid<OpGroupSMax>(const Instruction* inst,
                                    const spv_opcode_desc opcodeEntry) {}
 #endif
 
 #if 0
 template <>
-bool idUsage::isValid<OpEnqueueMarker>(const spv_instruction_t *inst,
+bool idUsage::isValid<OpEnqueueMarker>(const Instruction* inst,
                                        const spv_opcode_desc opcodeEntry) {
 }
 #endif
 
 #if 0
 template <>
-bool idUsage::isValid<OpEnqueueKernel>(const spv_instruction_t *inst,
+bool idUsage::isValid<OpEnqueueKernel>(const Instruction* inst,
                                        const spv_opcode_desc opcodeEntry) {
 }
 #endif
@@ -2134,170 +2130,170 @@ bool idUsage::isValid<OpEnqueueKernel>(const spv_instruction_t *inst,
 #if 0
 template <>
 bool idUsage::isValid<OpGetKernelNDrangeSubGroupCount>(
-    const spv_instruction_t *inst, const spv_opcode_desc opcodeEntry) {}
+    const Instruction* inst, const spv_opcode_desc opcodeEntry) {}
 #endif
 
 #if 0
 template <>
 bool idUsage::isValid<OpGetKernelNDrangeMaxSubGroupSize>(
-    const spv_instruction_t *inst, const spv_opcode_desc opcodeEntry) {}
+    const Instruction* inst, const spv_opcode_desc opcodeEntry) {}
 #endif
 
 #if 0
 template <>
 bool idUsage::isValid<OpGetKernelWorkGroupSize>(
-    const spv_instruction_t *inst, const spv_opcode_desc opcodeEntry) {}
+    const Instruction* inst, const spv_opcode_desc opcodeEntry) {}
 #endif
 
 #if 0
 template <>
 bool idUsage::isValid<OpGetKernelPreferredWorkGroupSizeMultiple>(
-    const spv_instruction_t *inst, const spv_opcode_desc opcodeEntry) {}
+    const Instruction* inst, const spv_opcode_desc opcodeEntry) {}
 #endif
 
 #if 0
 template <>
-bool idUsage::isValid<OpRetainEvent>(const spv_instruction_t *inst,
+bool idUsage::isValid<OpRetainEvent>(const Instruction* inst,
                                      const spv_opcode_desc opcodeEntry) {}
 #endif
 
 #if 0
 template <>
-bool idUsage::isValid<OpReleaseEvent>(const spv_instruction_t *inst,
+bool idUsage::isValid<OpReleaseEvent>(const Instruction* inst,
                                       const spv_opcode_desc opcodeEntry) {}
 #endif
 
 #if 0
 template <>
 bool idUsage::isValid<OpCreateUserEvent>(
-    const spv_instruction_t *inst, const spv_opcode_desc opcodeEntry) {}
+    const Instruction* inst, const spv_opcode_desc opcodeEntry) {}
 #endif
 
 #if 0
 template <>
-bool idUsage::isValid<OpIsValidEvent>(const spv_instruction_t *inst,
+bool idUsage::isValid<OpIsValidEvent>(const Instruction* inst,
                                       const spv_opcode_desc opcodeEntry) {}
 #endif
 
 #if 0
 template <>
 bool idUsage::isValid<OpSetUserEventStatus>(
-    const spv_instruction_t *inst, const spv_opcode_desc opcodeEntry) {}
+    const Instruction* inst, const spv_opcode_desc opcodeEntry) {}
 #endif
 
 #if 0
 template <>
 bool idUsage::isValid<OpCaptureEventProfilingInfo>(
-    const spv_instruction_t *inst, const spv_opcode_desc opcodeEntry) {}
+    const Instruction* inst, const spv_opcode_desc opcodeEntry) {}
 #endif
 
 #if 0
 template <>
 bool idUsage::isValid<OpGetDefaultQueue>(
-    const spv_instruction_t *inst, const spv_opcode_desc opcodeEntry) {}
+    const Instruction* inst, const spv_opcode_desc opcodeEntry) {}
 #endif
 
 #if 0
 template <>
-bool idUsage::isValid<OpBuildNDRange>(const spv_instruction_t *inst,
+bool idUsage::isValid<OpBuildNDRange>(const Instruction* inst,
                                       const spv_opcode_desc opcodeEntry) {}
 #endif
 
 #if 0
 template <>
-bool idUsage::isValid<OpReadPipe>(const spv_instruction_t *inst,
+bool idUsage::isValid<OpReadPipe>(const Instruction* inst,
                                   const spv_opcode_desc opcodeEntry) {}
 #endif
 
 #if 0
 template <>
-bool idUsage::isValid<OpWritePipe>(const spv_instruction_t *inst,
+bool idUsage::isValid<OpWritePipe>(const Instruction* inst,
                                    const spv_opcode_desc opcodeEntry) {}
 #endif
 
 #if 0
 template <>
 bool idUsage::isValid<OpReservedReadPipe>(
-    const spv_instruction_t *inst, const spv_opcode_desc opcodeEntry) {}
+    const Instruction* inst, const spv_opcode_desc opcodeEntry) {}
 #endif
 
 #if 0
 template <>
 bool idUsage::isValid<OpReservedWritePipe>(
-    const spv_instruction_t *inst, const spv_opcode_desc opcodeEntry) {}
+    const Instruction* inst, const spv_opcode_desc opcodeEntry) {}
 #endif
 
 #if 0
 template <>
 bool idUsage::isValid<OpReserveReadPipePackets>(
-    const spv_instruction_t *inst, const spv_opcode_desc opcodeEntry) {}
+    const Instruction* inst, const spv_opcode_desc opcodeEntry) {}
 #endif
 
 #if 0
 template <>
 bool idUsage::isValid<OpReserveWritePipePackets>(
-    const spv_instruction_t *inst, const spv_opcode_desc opcodeEntry) {}
+    const Instruction* inst, const spv_opcode_desc opcodeEntry) {}
 #endif
 
 #if 0
 template <>
 bool idUsage::isValid<OpCommitReadPipe>(
-    const spv_instruction_t *inst, const spv_opcode_desc opcodeEntry) {}
+    const Instruction* inst, const spv_opcode_desc opcodeEntry) {}
 #endif
 
 #if 0
 template <>
 bool idUsage::isValid<OpCommitWritePipe>(
-    const spv_instruction_t *inst, const spv_opcode_desc opcodeEntry) {}
+    const Instruction* inst, const spv_opcode_desc opcodeEntry) {}
 #endif
 
 #if 0
 template <>
 bool idUsage::isValid<OpIsValidReserveId>(
-    const spv_instruction_t *inst, const spv_opcode_desc opcodeEntry) {}
+    const Instruction* inst, const spv_opcode_desc opcodeEntry) {}
 #endif
 
 #if 0
 template <>
 bool idUsage::isValid<OpGetNumPipePackets>(
-    const spv_instruction_t *inst, const spv_opcode_desc opcodeEntry) {}
+    const Instruction* inst, const spv_opcode_desc opcodeEntry) {}
 #endif
 
 #if 0
 template <>
 bool idUsage::isValid<OpGetMaxPipePackets>(
-    const spv_instruction_t *inst, const spv_opcode_desc opcodeEntry) {}
+    const Instruction* inst, const spv_opcode_desc opcodeEntry) {}
 #endif
 
 #if 0
 template <>
 bool idUsage::isValid<OpGroupReserveReadPipePackets>(
-    const spv_instruction_t *inst, const spv_opcode_desc opcodeEntry) {}
+    const Instruction* inst, const spv_opcode_desc opcodeEntry) {}
 #endif
 
 #if 0
 template <>
 bool idUsage::isValid<OpGroupReserveWritePipePackets>(
-    const spv_instruction_t *inst, const spv_opcode_desc opcodeEntry) {}
+    const Instruction* inst, const spv_opcode_desc opcodeEntry) {}
 #endif
 
 #if 0
 template <>
 bool idUsage::isValid<OpGroupCommitReadPipe>(
-    const spv_instruction_t *inst, const spv_opcode_desc opcodeEntry) {}
+    const Instruction* inst, const spv_opcode_desc opcodeEntry) {}
 #endif
 
 #if 0
 template <>
 bool idUsage::isValid<OpGroupCommitWritePipe>(
-    const spv_instruction_t *inst, const spv_opcode_desc opcodeEntry) {}
+    const Instruction* inst, const spv_opcode_desc opcodeEntry) {}
 #endif
 
 #undef DIAG
 
-bool idUsage::isValid(const spv_instruction_t* inst) {
+bool idUsage::isValid(const Instruction* inst) {
   spv_opcode_desc opcodeEntry = nullptr;
-  if (spvOpcodeTableValueLookup(opcodeTable, inst->opcode, &opcodeEntry))
+  if (spvOpcodeTableValueLookup(opcodeTable, inst->opcode(), &opcodeEntry))
     return false;
 #define CASE(OpCode) \
   case Spv##OpCode:  \
@@ -2305,7 +2301,7 @@ bool idUsage::isValid(const spv_instruction_t* inst) {
 #define TODO(OpCode) \
   case Spv##OpCode:  \
     return true;
-  switch (inst->opcode) {
+  switch (inst->opcode()) {
     TODO(OpUndef)
     CASE(OpMemberName)
     CASE(OpLine)
@@ -2545,57 +2541,107 @@ spv_result_t UpdateIdUse(ValidationState_t& _) {
   return SPV_SUCCESS;
 }
 
+namespace {
+
+// The outcome of checking the uses of a definition made in a function.
+struct DefinitionUseCheck {
+  // The first use that the definition does not dominate, or that is outside
+  // of its function, if any.
+  const Instruction* bad_use = nullptr;
+  // The OpPhi instructions among the uses before |bad_use|.  Their parent
+  // blocks are checked once every definition has been checked.
+  vector<const Instruction*> phis;
+};
+
+// Checks the uses of |definition|, which is made in a function, and records
+// the outcome in |check|.  Only reads the state of the module, so it can be
+// called for different definitions concurrently.
+void CheckDefinitionUses(const Instruction& definition,
+                         DefinitionUseCheck* check) {
+  if (const BasicBlock* block = definition.block()) {
+    if (!block->reachable()) return;
+    // If the Id is defined within a block then make sure all references to
+    // that Id appear in a blocks that are dominated by the defining block
+    for (auto& use_index_pair : definition.uses()) {
+      const Instruction* use = use_index_pair.first;
+      if (const BasicBlock* use_block = use->block()) {
+        if (use_block->reachable() == false) continue;
+        if (use->opcode() == SpvOpPhi) {
+          check->phis.push_back(use);
+        } else if (!block->dominates(*use_block)) {
+          check->bad_use = use;
+          return;
+        }
+      }
+    }
+  } else {
+    // If the Ids defined within a function but not in a block(i.e. function
+    // parameters, block ids), then make sure all references to that Id
+    // appear within the same function
+    for (auto use : definition.uses()) {
+      const Instruction* inst = use.first;
+      if (inst->function() && inst->function() != definition.function()) {
+        check->bad_use = inst;
+        return;
+      }
+    }
+  }
+}
+
+}  // anonymous namespace
+
 /// This function checks all ID definitions dominate their use in the CFG.
 ///
 /// This function will iterate over all ID definitions that are defined in the
 /// functions of a module and make sure that the definitions appear in a
-/// block that dominates their use.
+/// block that dominates their use.  The definitions are checked on up to the
+/// thread count of the validator options, and the first problem in the order
+/// of all_definitions() is reported, whatever the thread count.
 ///
 /// NOTE: This function does NOT check module scoped functions which are
 /// checked during the initial binary parse in the IdPass below
 spv_result_t CheckIdDefinitionDominateUse(const ValidationState_t& _) {
-  unordered_set<const Instruction*> phi_instructions;
+  // Check only those definitions defined in a function
+  // NOTE: Ids defined outside of functions must appear before they are used
+  // This check is being performed in the IdPass function
+  vector<const Instruction*> definitions;
   for (const auto& definition : _.all_definitions()) {
-    // Check only those definitions defined in a function
-    if (const Function* func = definition.second->function()) {
-      if (const BasicBlock* block = definition.second->block()) {
-        if (!block->reachable()) continue;
-        // If the Id is defined within a block then make sure all references to
-        // that Id appear in a blocks that are dominated by the defining block
-        for (auto& use_index_pair : definition.second->uses()) {
-          const Instruction* use = use_index_pair.first;
-          if (const BasicBlock* use_block = use->block()) {
-            if (use_block->reachable() == false) continue;
-            if (use->opcode() == SpvOpPhi) {
-              phi_instructions.insert(use);
-            } else if (!block->dominates(*use->block())) {
-              return _.diag(SPV_ERROR_INVALID_ID)
-                     << "ID " << _.getIdName(definition.first)
-                     << " defined in block " << _.getIdName(block->id())
-                     << " does not dominate its use in block "
-                     << _.getIdName(use_block->id());
-            }
-          }
+    if (definition.second->function()) definitions.push_back(definition.second);
+  }
+
+  // The definitions are handed out to the threads in chunks, since checking
+  // a single one is cheap.
+  const size_t kChunkSize = 256;
+  vector<DefinitionUseCheck> checks(definitions.size());
+  _.thread_pool().ParallelFor(
+      (definitions.size() + kChunkSize - 1) / kChunkSize,
+      [&definitions, &checks](size_t chunk) {
+        const size_t end =
+            std::min(definitions.size(), (chunk + 1) * kChunkSize);
+        for (size_t i = chunk * kChunkSize; i < end; ++i) {
+          CheckDefinitionUses(*definitions[i], &checks[i]);
         }
-      } else {
-        // If the Ids defined within a function but not in a block(i.e. function
-        // parameters, block ids), then make sure all references to that Id
-        // appear within the same function
-        for (auto use : definition.second->uses()) {
-          const Instruction* inst = use.first;
-          if (inst->function() && inst->function() != func) {
-            return _.diag(SPV_ERROR_INVALID_ID)
-                   << "ID " << _.getIdName(definition.first)
-                   << " used in function "
-                   << _.getIdName(inst->function()->id())
-                   << " is used outside of it's defining function "
-                   << _.getIdName(func->id());
-          }
-        }
-      }
+      });
+
+  unordered_set<const Instruction*> phi_instructions;
+  for (size_t i = 0; i < definitions.size(); ++i) {
+    const Instruction* definition = definitions[i];
+    const DefinitionUseCheck& check = checks[i];
+    phi_instructions.insert(check.phis.begin(), check.phis.end());
+    const Instruction* use = check.bad_use;
+    if (!use) continue;
+    if (const BasicBlock* block = definition->block()) {
+      return _.diag(SPV_ERROR_INVALID_ID)
+             << "ID " << _.getIdName(definition->id()) << " defined in block "
+             << _.getIdName(block->id())
+             << " does not dominate its use in block "
+             << _.getIdName(use->block()->id());
     }
-    // NOTE: Ids defined outside of functions must appear before they are used
-    // This check is being performed in the IdPass function
+    return _.diag(SPV_ERROR_INVALID_ID)
+           << "ID " << _.getIdName(definition->id()) << " used in function "
+           << _.getIdName(use->function()->id())
+           << " is used outside of it's defining function "
+           << _.getIdName(definition->function()->id());
   }
 
   // Check all OpPhi parent blocks are dominated by the variable's defining
@@ -2685,19 +2731,82 @@ spv_result_t IdPass(ValidationState_t& _,
 }
 }  // namespace libspirv
 
-spv_result_t spvValidateInstructionIDs(const spv_instruction_t* pInsts,
-                                       const uint64_t instCount,
-                                       const spv_opcode_table opcodeTable,
+spv_result_t spvValidateInstructionIDs(const spv_opcode_table opcodeTable,
                                        const spv_operand_table operandTable,
                                        const spv_ext_inst_table extInstTable,
                                        const libspirv::ValidationState_t& state,
                                        spv_position position) {
-  idUsage idUsage(opcodeTable, operandTable, extInstTable, pInsts, instCount,
+  const auto& instructions = state.ordered_instructions();
+
+  // The instructions are checked in ranges: the global section, then each
+  // function.  The checks of the global section may update the decorations
+  // recorded in |state|, so it is checked on its own, reporting its first
+  // problem directly.  The checks of a function only read |state|, so the
+  // functions are then checked quietly, possibly on several threads.
+  vector<size_t> range_starts(1, 0);
+  vector<size_t> range_offsets(1, position->index);
+  size_t offset = position->index;
+  for (size_t i = 0; i < instructions.size(); ++i) {
+    if (instructions[i].opcode() == SpvOpFunction && i != 0) {
+      range_starts.push_back(i);
+      range_offsets.push_back(offset);
+    }
+    offset += instructions[i].words().size();
+  }
+  range_starts.push_back(instructions.size());
+  const size_t num_ranges = range_starts.size() - 1;
+
+  // Checks the instructions of range |r|, reporting to |consumer| from
+  // |range_position|.  Returns the index of the first invalid instruction, or
+  // the end of the range.
+  auto check_range = [&](size_t r, const spvtools::MessageConsumer& consumer,
+                         spv_position_t* range_position) {
+    idUsage idUsage(opcodeTable, operandTable, extInstTable,
+                    state.memory_model(), state.addressing_model(), state,
+                    state.entry_points(), range_position, consumer);
+    for (size_t i = range_starts[r]; i < range_starts[r + 1]; ++i) {
+      if (!idUsage.isValid(&instructions[i])) return i;
+      range_position->index += instructions[i].words().size();
+    }
+    return range_starts[r + 1];
+  };
+
+  if (check_range(0, state.context()->consumer, position) != range_starts[1]) {
+    return SPV_ERROR_INVALID_ID;
+  }
+
+  // The first invalid instruction of each function range, and the first
+  // range known to have one, past which the ranges need not be checked.
+  const spvtools::MessageConsumer quiet_consumer;
+  vector<size_t> first_invalid(range_starts.begin() + 1, range_starts.end());
+  std::atomic<size_t> first_bad_range(num_ranges);
+  state.thread_pool().ParallelFor(num_ranges - 1, [&](size_t i) {
+    const size_t r = i + 1;
+    if (r > first_bad_range) return;
+    spv_position_t range_position = *position;
+    range_position.index = range_offsets[r];
+    first_invalid[r] = check_range(r, quiet_consumer, &range_position);
+    if (first_invalid[r] == range_starts[r + 1]) return;
+    size_t bad_range = first_bad_range;
+    while (r < bad_range &&
+           !first_bad_range.compare_exchange_weak(bad_range, r)) {
+    }
+  });
+
+  if (first_bad_range == num_ranges) {
+    position->index = offset;
+    return SPV_SUCCESS;
+  }
+
+  // Check the first invalid instruction in module order again, to report it.
+  const size_t r = first_bad_range;
+  position->index = range_offsets[r];
+  for (size_t i = range_starts[r]; i < first_invalid[r]; ++i) {
+    position->index += instructions[i].words().size();
+  }
+  idUsage idUsage(opcodeTable, operandTable, extInstTable,
                   state.memory_model(), state.addressing_model(), state,
                   state.entry_points(), position, state.context()->consumer);
-  for (uint64_t instIndex = 0; instIndex < instCount; ++instIndex) {
-    if (!idUsage.isValid(&pInsts[instIndex])) return SPV_ERROR_INVALID_ID;
-    position->index += pInsts[instIndex].words.size();
-  }
-  return SPV_SUCCESS;
+  idUsage.isValid(&instructions[first_invalid[r]]);
+  return SPV_ERROR_INVALID_ID;
 }
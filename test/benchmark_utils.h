@@ -0,0 +1,106 @@
+// Copyright (c) 2018 Google LLC
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#ifndef LIBSPIRV_TEST_BENCHMARK_UTILS_H_
+#define LIBSPIRV_TEST_BENCHMARK_UTILS_H_
+
+// Helpers for the *_benchmark_test.cpp tests.  They are only built with
+// SPIRV_BUILD_BENCHMARKS, and are not run by ctest.  Their measurements are
+// recorded as test properties, which show up with --gtest_output=xml, and a
+// slow run never fails.  The large module sizes are instantiated with a
+// DISABLED_ prefix, so they only run with --gtest_also_run_disabled_tests.
+
+#include <chrono>
+#include <functional>
+#include <sstream>
+#include <string>
+#include <vector>
+
+#include "gmock/gmock.h"
+#include "test_fixture.h"
+
+namespace spvtest {
+
+// Returns the mode setting instructions of a module with a single fragment
+// shader entry point, %main, whose interface is |interface|.  |imports| go
+// before the memory model.
+inline std::string ShaderHeader(const std::string& interface = "",
+                                const std::string& imports = "") {
+  std::string header = "OpCapability Shader\n" + imports +
+                       "OpMemoryModel Logical GLSL450\n"
+                       "OpEntryPoint Fragment %main \"main\"";
+  if (!interface.empty()) header += " " + interface;
+  return header + "\nOpExecutionMode %main OriginUpperLeft\n";
+}
+
+// Returns the end of a block followed by |num_blocks| blocks that branch to
+// one another, %block0 to %block<num_blocks>.  The body of block |i| is
+// |body(i)|, except for the last one, which is left open.
+inline std::string BlockChain(int num_blocks,
+                              const std::function<std::string(int)>& body) {
+  std::ostringstream ss;
+  ss << "OpBranch %block0\n";
+  for (int i = 0; i < num_blocks; ++i) {
+    ss << "%block" << i << " = OpLabel\n"
+       << body(i) << "OpBranch %block" << i + 1 << "\n";
+  }
+  ss << "%block" << num_blocks << " = OpLabel\n";
+  return ss.str();
+}
+
+// Assembles |text| for |env|, adding a test failure if that fails.
+inline std::vector<uint32_t> Assemble(
+    const std::string& text, spv_target_env env = SPV_ENV_UNIVERSAL_1_0) {
+  ScopedContext context(env);
+  spv_binary binary = nullptr;
+  spv_diagnostic diagnostic = nullptr;
+  EXPECT_EQ(SPV_SUCCESS, spvTextToBinary(context.context, text.c_str(),
+                                         text.size(), &binary, &diagnostic));
+  if (diagnostic) {
+    ADD_FAILURE() << diagnostic->error;
+    spvDiagnosticDestroy(diagnostic);
+  }
+  std::vector<uint32_t> words;
+  if (binary) {
+    words.assign(binary->code, binary->code + binary->wordCount);
+    spvBinaryDestroy(binary);
+  }
+  return words;
+}
+
+// Returns the number of seconds it takes to call |fn| |iterations| times.
+template <class Fn>
+double SecondsToRun(int iterations, Fn fn) {
+  const auto start = std::chrono::steady_clock::now();
+  for (int i = 0; i < iterations; ++i) fn();
+  const std::chrono::duration<double> elapsed =
+      std::chrono::steady_clock::now() - start;
+  return elapsed.count();
+}
+
+// Records |amount| per second, done in |seconds|, as the test property |name|.
+inline void RecordRate(const std::string& name, double amount,
+                       double seconds) {
+  ::testing::Test::RecordProperty(
+      name, seconds > 0 ? static_cast<int>(amount / seconds) : 0);
+}
+
+// Records |seconds| in milliseconds as the test property |name|.
+inline void RecordMilliseconds(const std::string& name, double seconds) {
+  ::testing::Test::RecordProperty(name, static_cast<int>(1000 * seconds));
+}
+
+}  // namespace spvtest
+
+#endif  // LIBSPIRV_TEST_BENCHMARK_UTILS_H_
@@ -0,0 +1,132 @@
+// Copyright (c) 2018 Google LLC
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+// Measures the throughput of spvBinaryParse, and checks that both parse paths
+// see the same instructions.
+
+#include <algorithm>
+#include <sstream>
+#include <string>
+#include <vector>
+
+#include "benchmark_utils.h"
+#include "gmock/gmock.h"
+#include "test_fixture.h"
+#include "unit_spirv.h"
+
+namespace {
+
+using spvtest::Assemble;
+using spvtest::ScopedContext;
+
+// The number of times each module is parsed.
+const int kIterations = 20;
+
+// Returns the assembly for a module with |num_blocks| blocks of arithmetic in
+// a single function.  The instructions are mostly Ids and literal numbers,
+// which is the common shape of real modules.
+std::string MakeLargeModule(int num_blocks) {
+  std::string text = spvtest::ShaderHeader() + R"(OpName %main "main"
+%void = OpTypeVoid
+%voidfn = OpTypeFunction %void
+%int = OpTypeInt 32 1
+%ptr = OpTypePointer Function %int
+%one = OpConstant %int 1
+%main = OpFunction %void None %voidfn
+%entry = OpLabel
+%var = OpVariable %ptr Function
+)";
+  text += spvtest::BlockChain(num_blocks, [](int i) {
+    std::ostringstream ss;
+    ss << "%load" << i << " = OpLoad %int %var\n"
+       << "%add" << i << " = OpIAdd %int %load" << i << " %one\n"
+       << "%mul" << i << " = OpIMul %int %add" << i << " %add" << i << "\n"
+       << "%copy" << i << " = OpCopyObject %int %mul" << i << "\n"
+       << "OpStore %var %copy" << i << "\n";
+    return ss.str();
+  });
+  return text + "OpReturn\nOpFunctionEnd\n";
+}
+
+// Returns |words| with every word byte-swapped.
+std::vector<uint32_t> FlipEndianness(std::vector<uint32_t> words) {
+  std::transform(words.begin(), words.end(), words.begin(),
+                 [](const uint32_t raw_word) {
+                   return spvFixWord(raw_word, I32_ENDIAN_HOST == I32_ENDIAN_BIG
+                                                   ? SPV_ENDIANNESS_LITTLE
+                                                   : SPV_ENDIANNESS_BIG);
+                 });
+  return words;
+}
+
+// Counts what the parser hands out, so the callback can't be optimized away.
+struct ParseCounts {
+  size_t instructions = 0;
+  size_t operands = 0;
+};
+
+spv_result_t CountInstruction(void* user_data,
+                              const spv_parsed_instruction_t* inst) {
+  auto* counts = static_cast<ParseCounts*>(user_data);
+  ++counts->instructions;
+  counts->operands += inst->num_operands;
+  return SPV_SUCCESS;
+}
+
+// Parses |words| kIterations times.  Returns the counts from a single parse,
+// and sets |seconds| to the time it took.
+ParseCounts ParseRepeatedly(const std::vector<uint32_t>& words,
+                            double* seconds) {
+  ScopedContext context;
+  ParseCounts counts;
+  *seconds = spvtest::SecondsToRun(kIterations, [&]() {
+    counts = ParseCounts();
+    EXPECT_EQ(SPV_SUCCESS,
+              spvBinaryParse(context.context, &counts, words.data(),
+                             words.size(), nullptr, CountInstruction, nullptr));
+  });
+  return counts;
+}
+
+class BinaryParseBenchmark : public ::testing::TestWithParam<int> {};
+
+TEST_P(BinaryParseBenchmark, Throughput) {
+  const std::vector<uint32_t> native = Assemble(MakeLargeModule(GetParam()));
+  ASSERT_FALSE(native.empty());
+  const std::vector<uint32_t> flipped = FlipEndianness(native);
+
+  double native_seconds = 0;
+  double flipped_seconds = 0;
+  const ParseCounts native_counts = ParseRepeatedly(native, &native_seconds);
+  const ParseCounts flipped_counts =
+      ParseRepeatedly(flipped, &flipped_seconds);
+
+  EXPECT_EQ(native_counts.instructions, flipped_counts.instructions);
+  EXPECT_EQ(native_counts.operands, flipped_counts.operands);
+  EXPECT_LT(6u * GetParam(), native_counts.instructions);
+
+  const double words = static_cast<double>(native.size()) * kIterations;
+  RecordProperty("module_words", static_cast<int>(native.size()));
+  spvtest::RecordRate("native_endian_words_per_second", words,
+                      native_seconds);
+  spvtest::RecordRate("flipped_endian_words_per_second", words,
+                      flipped_seconds);
+}
+
+INSTANTIATE_TEST_CASE_P(ModuleSizes, BinaryParseBenchmark,
+                        ::testing::Values(100));
+INSTANTIATE_TEST_CASE_P(DISABLED_LargeModuleSizes, BinaryParseBenchmark,
+                        ::testing::Values(10000));
+
+}  // anonymous namespace
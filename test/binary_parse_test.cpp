@@ -515,6 +515,51 @@ TEST_F(BinaryParseTest, InstructionWithStringOperand) {
   EXPECT_EQ(nullptr, diagnostic_);
 }
 
+// Returns a ParsedInstruction for an OpTypeStruct instruction that generates
+// the given result Id, with |num_members| members of type |member_type|.
+ParsedInstruction MakeParsedStructTypeInstruction(
+    uint32_t result_id, uint32_t member_type, uint16_t num_members,
+    std::vector<uint32_t>* words) {
+  *words = MakeInstruction(SpvOpTypeStruct, {result_id},
+                           std::vector<uint32_t>(num_members, member_type));
+  std::vector<spv_parsed_operand_t> operands = {
+      MakeSimpleOperand(1, SPV_OPERAND_TYPE_RESULT_ID)};
+  for (uint16_t i = 0; i < num_members; ++i) {
+    operands.push_back(MakeSimpleOperand(i + 2, SPV_OPERAND_TYPE_ID));
+  }
+  return ParsedInstruction(spv_parsed_instruction_t{
+      words->data(), static_cast<uint16_t>(words->size()), SpvOpTypeStruct,
+      SPV_EXT_INST_TYPE_NONE, 0 /*type id*/, result_id, operands.data(),
+      static_cast<uint16_t>(operands.size())});
+}
+
+// The operand layouts used to parse instructions are shared by every parse.
+// An instruction with more operands than they spell out must not change
+// them, on this parse or on the next one.
+TEST_F(BinaryParseTest, LongInstructionsKeepSharedOperandsIntact) {
+  std::vector<uint32_t> long_struct, short_struct;
+  const ParsedInstruction parsed_long_struct =
+      MakeParsedStructTypeInstruction(2, 1, 100, &long_struct);
+  const ParsedInstruction parsed_short_struct =
+      MakeParsedStructTypeInstruction(3, 1, 2, &short_struct);
+  const auto words =
+      Concatenate({ExpectedHeaderForBound(4),
+                   MakeInstruction(SpvOpTypeInt, {1, 32, 1}), long_struct,
+                   short_struct});
+  for (int parse = 0; parse < 2; ++parse) {
+    InSequence calls_expected_in_specific_order;
+    EXPECT_HEADER(4).WillOnce(Return(SPV_SUCCESS));
+    EXPECT_CALL(client_, Instruction(MakeParsedInt32TypeInstruction(1)))
+        .WillOnce(Return(SPV_SUCCESS));
+    EXPECT_CALL(client_, Instruction(parsed_long_struct))
+        .WillOnce(Return(SPV_SUCCESS));
+    EXPECT_CALL(client_, Instruction(parsed_short_struct))
+        .WillOnce(Return(SPV_SUCCESS));
+    Parse(words, SPV_SUCCESS, false);
+    EXPECT_EQ(nullptr, diagnostic_);
+  }
+}
+
 // Checks for non-zero values for the result_id and ext_inst_type members
 // spv_parsed_instruction_t.
 TEST_F(BinaryParseTest, ExtendedInstruction) {
@@ -0,0 +1,128 @@
+// Copyright (c) 2018 Google LLC
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+// Measures the throughput of spvBinaryToText, and checks that the text
+// assembles back to the same binary.
+
+#include <sstream>
+#include <string>
+#include <vector>
+
+#include "benchmark_utils.h"
+#include "gmock/gmock.h"
+#include "test_fixture.h"
+#include "unit_spirv.h"
+
+namespace {
+
+using spvtest::Assemble;
+using spvtest::ScopedContext;
+
+// The number of times each module is disassembled.
+const int kIterations = 10;
+
+// Returns the assembly for a module with |num_blocks| blocks in a single
+// function.  Every id has a debug name, and the constants cover negative
+// integers and floating point numbers.
+std::string MakeLargeModule(int num_blocks) {
+  std::ostringstream ss;
+  ss << spvtest::ShaderHeader() << R"(OpName %main "main"
+OpName %var "var"
+OpName %fvar "fvar"
+)";
+  for (int i = 0; i < num_blocks; ++i) {
+    ss << "OpName %add" << i << " \"add" << i << "\"\n"
+       << "OpName %fmul" << i << " \"fmul" << i << "\"\n";
+  }
+  ss << R"(%void = OpTypeVoid
+%voidfn = OpTypeFunction %void
+%int = OpTypeInt 32 1
+%float = OpTypeFloat 32
+%ptr = OpTypePointer Function %int
+%fptr = OpTypePointer Function %float
+%minus_seven = OpConstant %int -7
+%half = OpConstant %float 0.5
+%main = OpFunction %void None %voidfn
+%entry = OpLabel
+%var = OpVariable %ptr Function
+%fvar = OpVariable %fptr Function
+)";
+  ss << spvtest::BlockChain(num_blocks, [](int i) {
+    std::ostringstream block;
+    block << "%load" << i << " = OpLoad %int %var\n"
+          << "%add" << i << " = OpIAdd %int %load" << i << " %minus_seven\n"
+          << "OpStore %var %add" << i << "\n"
+          << "%fload" << i << " = OpLoad %float %fvar\n"
+          << "%fmul" << i << " = OpFMul %float %fload" << i << " %half\n"
+          << "OpStore %fvar %fmul" << i << " Aligned 4\n";
+    return block.str();
+  });
+  ss << "OpReturn\nOpFunctionEnd\n";
+  return ss.str();
+}
+
+// Disassembles |words| with |options| kIterations times.  Returns the text,
+// and records the rate at which it is produced as the test property |name|.
+std::string DisassembleRepeatedly(const std::string& name,
+                                  const std::vector<uint32_t>& words,
+                                  uint32_t options) {
+  ScopedContext context;
+  std::string result;
+  const double seconds = spvtest::SecondsToRun(kIterations, [&]() {
+    spv_text text = nullptr;
+    EXPECT_EQ(SPV_SUCCESS, spvBinaryToText(context.context, words.data(),
+                                           words.size(), options, &text,
+                                           nullptr));
+    if (text) result.assign(text->str, text->length);
+    spvTextDestroy(text);
+  });
+  spvtest::RecordRate(name, static_cast<double>(result.size()) * kIterations,
+                      seconds);
+  return result;
+}
+
+class BinaryToTextBenchmark : public ::testing::TestWithParam<int> {};
+
+TEST_P(BinaryToTextBenchmark, Throughput) {
+  const std::vector<uint32_t> words = Assemble(MakeLargeModule(GetParam()));
+  ASSERT_FALSE(words.empty());
+
+  const std::string raw = DisassembleRepeatedly(
+      "raw_bytes_per_second", words, SPV_BINARY_TO_TEXT_OPTION_NONE);
+  const std::string friendly =
+      DisassembleRepeatedly("friendly_bytes_per_second", words,
+                            SPV_BINARY_TO_TEXT_OPTION_FRIENDLY_NAMES);
+  const std::string pretty = DisassembleRepeatedly(
+      "pretty_bytes_per_second", words,
+      SPV_BINARY_TO_TEXT_OPTION_FRIENDLY_NAMES |
+          SPV_BINARY_TO_TEXT_OPTION_INDENT |
+          SPV_BINARY_TO_TEXT_OPTION_SHOW_BYTE_OFFSET);
+
+  EXPECT_EQ(words, Assemble(raw));
+  EXPECT_EQ(words, Assemble(friendly));
+  EXPECT_EQ(words, Assemble(pretty));
+  EXPECT_THAT(friendly, ::testing::HasSubstr("%add0 = OpIAdd %int %"));
+  EXPECT_THAT(friendly, ::testing::HasSubstr("%int_n7 = OpConstant %int -7"));
+  EXPECT_THAT(pretty, ::testing::HasSubstr(" ; 0x"));
+
+  RecordProperty("module_words", static_cast<int>(words.size()));
+  RecordProperty("text_bytes", static_cast<int>(friendly.size()));
+}
+
+INSTANTIATE_TEST_CASE_P(ModuleSizes, BinaryToTextBenchmark,
+                        ::testing::Values(100));
+INSTANTIATE_TEST_CASE_P(DISABLED_LargeModuleSizes, BinaryToTextBenchmark,
+                        ::testing::Values(10000));
+
+}  // anonymous namespace
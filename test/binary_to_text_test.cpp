@@ -15,6 +15,7 @@
 #include "unit_spirv.h"
 
 #include <sstream>
+#include <vector>
 
 #include "gmock/gmock.h"
 
@@ -485,6 +486,158 @@ OpMemoryModel Logical GLSL450 ; 0x0000001c
               expected);
 }
 
+using ThreadedDisassemblyTest = spvtest::TextToBinaryTest;
+
+// Returns the disassembly of |words| with |thread_count| threads, or the
+// error message if it fails.
+std::string DisassembleWithThreads(const std::vector<uint32_t>& words,
+                                   uint32_t options, uint32_t thread_count) {
+  spv_text text = nullptr;
+  spv_diagnostic diagnostic = nullptr;
+  std::string result;
+  if (spvBinaryToTextWithThreadCount(ScopedContext().context, words.data(),
+                                     words.size(), options, thread_count,
+                                     &text, &diagnostic) == SPV_SUCCESS) {
+    result.assign(text->str, text->length);
+  } else if (diagnostic) {
+    result = diagnostic->error;
+  }
+  spvTextDestroy(text);
+  spvDiagnosticDestroy(diagnostic);
+  return result;
+}
+
+TEST_F(ThreadedDisassemblyTest, SameTextAsSerial) {
+  std::ostringstream input;
+  input << R"(OpCapability Shader
+%ext = OpExtInstImport "GLSL.std.450"
+OpMemoryModel Logical GLSL450
+OpEntryPoint Fragment %main "main"
+OpExecutionMode %main OriginUpperLeft
+OpName %main "main"
+%void = OpTypeVoid
+%voidfn = OpTypeFunction %void
+%long = OpTypeInt 64 1
+%float = OpTypeFloat 32
+%floatfn = OpTypeFunction %float %float
+%big = OpConstant %long -5000000000
+%main = OpFunction %void None %voidfn
+%main_entry = OpLabel
+OpReturn
+OpFunctionEnd
+)";
+  for (int i = 0; i < 20; ++i) {
+    input << "%f" << i << " = OpFunction %float None %floatfn\n"
+          << "%p" << i << " = OpFunctionParameter %float\n"
+          << "%e" << i << " = OpLabel\n"
+          << "%s" << i << " = OpExtInst %float %ext Sqrt %p" << i << "\n"
+          << "%sel" << i << " = OpCopyObject %long %big\n"
+          << "OpSelectionMerge %m" << i << " None\n"
+          << "OpSwitch %sel" << i << " %m" << i << " -5000000000 %c" << i
+          << "\n"
+          << "%c" << i << " = OpLabel\n"
+          << "OpBranch %m" << i << "\n"
+          << "%m" << i << " = OpLabel\n"
+          << "OpReturnValue %s" << i << "\n"
+          << "OpFunctionEnd\n";
+  }
+  const SpirvVector words = CompileSuccessfully(input.str());
+
+  for (uint32_t options :
+       {uint32_t(SPV_BINARY_TO_TEXT_OPTION_NONE),
+        uint32_t(SPV_BINARY_TO_TEXT_OPTION_FRIENDLY_NAMES |
+                 SPV_BINARY_TO_TEXT_OPTION_INDENT |
+                 SPV_BINARY_TO_TEXT_OPTION_SHOW_BYTE_OFFSET |
+                 SPV_BINARY_TO_TEXT_OPTION_COLOR)}) {
+    const std::string serial = DisassembleWithThreads(words, options, 1);
+    EXPECT_THAT(serial, HasSubstr("OpSwitch"));
+    for (uint32_t thread_count : {2u, 3u, 8u, 64u}) {
+      EXPECT_EQ(serial, DisassembleWithThreads(words, options, thread_count))
+          << thread_count << " threads";
+    }
+  }
+}
+
+TEST_F(ThreadedDisassemblyTest, IdDefinedInTwoFunctionsFailsAsSerial) {
+  const std::string input = R"(OpCapability Shader
+OpMemoryModel Logical GLSL450
+%void = OpTypeVoid
+%voidfn = OpTypeFunction %void
+%f = OpFunction %void None %voidfn
+%label = OpLabel
+OpReturn
+OpFunctionEnd
+%g = OpFunction %void None %voidfn
+%entry = OpLabel
+OpReturn
+OpFunctionEnd
+)";
+  SpirvVector words = CompileSuccessfully(input);
+  // Make the label of %g reuse the id of the label of %f.
+  const uint32_t label_word = (2u << 16) | SpvOpLabel;
+  std::vector<size_t> labels;
+  for (size_t i = SPV_INDEX_INSTRUCTION; i < words.size();
+       i += words[i] >> 16) {
+    if (words[i] == label_word) labels.push_back(i);
+  }
+  ASSERT_EQ(2u, labels.size());
+  words[labels[1] + 1] = words[labels[0] + 1];
+
+  const std::string serial =
+      DisassembleWithThreads(words, SPV_BINARY_TO_TEXT_OPTION_NONE, 1);
+  EXPECT_THAT(serial, HasSubstr("is defined more than once"));
+  EXPECT_EQ(serial,
+            DisassembleWithThreads(words, SPV_BINARY_TO_TEXT_OPTION_NONE, 4));
+}
+
+// The text of every disassembly style assembles back to the same binary,
+// including the friendly names of negative and floating point constants.
+TEST_F(TextToBinaryTest, EveryTextStyleAssemblesToSameBinary) {
+  const std::string input = R"(OpCapability Shader
+OpMemoryModel Logical GLSL450
+OpEntryPoint Fragment %main "main"
+OpExecutionMode %main OriginUpperLeft
+OpName %main "main"
+OpName %var "var"
+OpName %add "add"
+%void = OpTypeVoid
+%voidfn = OpTypeFunction %void
+%int = OpTypeInt 32 1
+%float = OpTypeFloat 32
+%ptr = OpTypePointer Function %int
+%fptr = OpTypePointer Function %float
+%minus_seven = OpConstant %int -7
+%half = OpConstant %float 0.5
+%main = OpFunction %void None %voidfn
+%entry = OpLabel
+%var = OpVariable %ptr Function
+%fvar = OpVariable %fptr Function
+%load = OpLoad %int %var
+%add = OpIAdd %int %load %minus_seven
+OpStore %var %add
+%fload = OpLoad %float %fvar
+%fmul = OpFMul %float %fload %half
+OpStore %fvar %fmul Aligned 4
+OpReturn
+OpFunctionEnd
+)";
+  const SpirvVector words = CompileSuccessfully(input);
+
+  for (uint32_t options :
+       {uint32_t(SPV_BINARY_TO_TEXT_OPTION_NONE),
+        uint32_t(SPV_BINARY_TO_TEXT_OPTION_FRIENDLY_NAMES),
+        uint32_t(SPV_BINARY_TO_TEXT_OPTION_FRIENDLY_NAMES |
+                 SPV_BINARY_TO_TEXT_OPTION_INDENT |
+                 SPV_BINARY_TO_TEXT_OPTION_SHOW_BYTE_OFFSET)}) {
+    const std::string text = DisassembleWithThreads(words, options, 1);
+    EXPECT_EQ(words, CompileSuccessfully(text)) << text;
+  }
+  const std::string friendly = DisassembleWithThreads(
+      words, SPV_BINARY_TO_TEXT_OPTION_FRIENDLY_NAMES, 1);
+  EXPECT_THAT(friendly, HasSubstr("%int_n7 = OpConstant %int -7"));
+  EXPECT_THAT(friendly, HasSubstr("%add = OpIAdd %int %"));
+}
+
 // Test version string.
 TEST_F(TextToBinaryTest, VersionString) {
   auto words = CompileSuccessfully("");
@@ -16,6 +16,7 @@
 
 #include <functional>
 #include <memory>
+#include <sstream>
 #include <string>
 
 #include "gmock/gmock.h"
@@ -520,6 +521,33 @@ OpFunctionEnd
 )");
 }
 
+TEST_P(MarkvTest, LongBlockChain) {
+  // Many blocks, each using the values of the one before it, so that the
+  // move-to-front sequences of the codec grow long.
+  std::ostringstream body;
+  body << "\nOpBranch %block0\n";
+  std::string vec = "%f32vec4_0123";
+  std::string count = "%s32_4";
+  for (int i = 0; i < 100; ++i) {
+    const std::string n = std::to_string(i);
+    body << "%block" << n << " = OpLabel\n"
+         << "%x" << n << " = OpCompositeExtract %f32 " << vec << " 1\n"
+         << "%s" << n << " = OpExtInst %f32 %ext_inst Sqrt %x" << n << "\n"
+         << "%m" << n << " = OpFMul %f32 %s" << n << " %f32_pi\n"
+         << "%c" << n << " = OpIAdd %s32 " << count << " %s32_m1\n"
+         << "%cmp" << n << " = OpSLessThan %bool %c" << n << " %s32_1\n"
+         << "%sel" << n << " = OpSelect %f32 %cmp" << n << " %m" << n
+         << " %x" << n << "\n"
+         << "%v" << n << " = OpCompositeInsert %f32vec4 %sel" << n << " "
+         << vec << " 3\n"
+         << "OpBranch %block" << i + 1 << "\n";
+    vec = "%v" + n;
+    count = "%c" + n;
+  }
+  body << "%block100 = OpLabel";
+  TestEncodeDecodeShaderMainBody(GetParam(), body.str());
+}
+
 TEST_P(MarkvTest, F32Mul) {
   TestEncodeDecodeShaderMainBody(GetParam(), R"(
 %val1 = OpFMul %f32 %f32_0 %f32_1
@@ -0,0 +1,154 @@
+// Copyright (c) 2018 Google LLC
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+// Measures the throughput of the MARK-V decoder with the shader models, and
+// checks that the module is decoded correctly.
+
+#include <memory>
+#include <sstream>
+#include <string>
+#include <vector>
+
+#include "benchmark_utils.h"
+#include "gmock/gmock.h"
+#include "source/comp/markv.h"
+#include "test_fixture.h"
+#include "tools/comp/markv_model_factory.h"
+#include "unit_spirv.h"
+
+namespace {
+
+using spvtest::Assemble;
+using spvtest::ScopedContext;
+using spvtools::MarkvModelType;
+
+// The number of times each module is decoded.
+const int kIterations = 10;
+
+// Adds a test failure for each error reported by the codec.
+void FailOnError(spv_message_level_t level, const char*,
+                 const spv_position_t& position, const char* message) {
+  if (level <= SPV_MSG_ERROR) {
+    ADD_FAILURE() << position.index << ": " << message;
+  }
+}
+
+// Returns the assembly for a shader with |num_blocks| blocks in a single
+// function.  The blocks mix integer and floating point arithmetic, extended
+// instructions, composites and memory accesses, so that most of the codecs of
+// the model are used.
+std::string MakeLargeModule(int num_blocks) {
+  std::ostringstream ss;
+  ss << spvtest::ShaderHeader("%in %out",
+                              "%ext = OpExtInstImport \"GLSL.std.450\"\n")
+     << R"(OpDecorate %in Location 0
+OpDecorate %out Location 0
+%void = OpTypeVoid
+%voidfn = OpTypeFunction %void
+%bool = OpTypeBool
+%int = OpTypeInt 32 1
+%float = OpTypeFloat 32
+%vec4 = OpTypeVector %float 4
+%int_ptr = OpTypePointer Function %int
+%vec4_ptr = OpTypePointer Function %vec4
+%in_ptr = OpTypePointer Input %vec4
+%out_ptr = OpTypePointer Output %vec4
+%in = OpVariable %in_ptr Input
+%out = OpVariable %out_ptr Output
+%int_1 = OpConstant %int 1
+%int_7 = OpConstant %int 7
+%float_half = OpConstant %float 0.5
+%main = OpFunction %void None %voidfn
+%entry = OpLabel
+%counter = OpVariable %int_ptr Function
+%color = OpVariable %vec4_ptr Function
+%input = OpLoad %vec4 %in
+OpStore %color %input
+OpStore %counter %int_1
+)";
+  ss << spvtest::BlockChain(num_blocks, [](int i) {
+    std::ostringstream block;
+    block << "%c" << i << " = OpLoad %int %counter\n"
+          << "%c_next" << i << " = OpIAdd %int %c" << i << " %int_7\n"
+          << "%cmp" << i << " = OpSLessThan %bool %c_next" << i
+          << " %int_1\n"
+          << "OpStore %counter %c_next" << i << "\n"
+          << "%v" << i << " = OpLoad %vec4 %color\n"
+          << "%x" << i << " = OpCompositeExtract %float %v" << i << " 0\n"
+          << "%s" << i << " = OpExtInst %float %ext Sqrt %x" << i << "\n"
+          << "%m" << i << " = OpFMul %float %s" << i << " %float_half\n"
+          << "%w" << i << " = OpCompositeInsert %vec4 %m" << i << " %v" << i
+          << " 3\n"
+          << "%sel" << i << " = OpSelect %vec4 %cmp" << i << " %w" << i
+          << " %v" << i << "\n"
+          << "OpStore %color %sel" << i << "\n";
+    return block.str();
+  });
+  ss << R"(%result = OpLoad %vec4 %color
+OpStore %out %result
+OpReturn
+OpFunctionEnd
+)";
+  return ss.str();
+}
+
+class MarkvDecodeBenchmark : public ::testing::TestWithParam<int> {};
+
+TEST_P(MarkvDecodeBenchmark, ShaderModelThroughput) {
+  ScopedContext context(SPV_ENV_UNIVERSAL_1_2);
+  const std::vector<uint32_t> spirv =
+      Assemble(MakeLargeModule(GetParam()), SPV_ENV_UNIVERSAL_1_2);
+  ASSERT_FALSE(spirv.empty());
+
+  for (MarkvModelType model_type :
+       {spvtools::kMarkvModelShaderLite, spvtools::kMarkvModelShaderMid,
+        spvtools::kMarkvModelShaderMax}) {
+    std::unique_ptr<spvtools::MarkvModel> model =
+        spvtools::CreateMarkvModel(model_type);
+    const spvtools::MarkvCodecOptions options;
+
+    std::vector<uint8_t> markv;
+    ASSERT_EQ(SPV_SUCCESS,
+              spvtools::SpirvToMarkv(context.context, spirv, options, *model,
+                                     FailOnError, spvtools::MarkvLogConsumer(),
+                                     spvtools::MarkvDebugConsumer(), &markv));
+
+    std::vector<uint32_t> decoded;
+    const double seconds = spvtest::SecondsToRun(kIterations, [&]() {
+      decoded.clear();
+      EXPECT_EQ(SPV_SUCCESS,
+                spvtools::MarkvToSpirv(
+                    context.context, markv, options, *model, FailOnError,
+                    spvtools::MarkvLogConsumer(),
+                    spvtools::MarkvDebugConsumer(), &decoded));
+    });
+    EXPECT_EQ(spirv, decoded) << "model " << model_type;
+
+    std::ostringstream name;
+    name << "model" << model_type;
+    RecordProperty(name.str() + "_markv_bytes",
+                   static_cast<int>(markv.size()));
+    spvtest::RecordRate(name.str() + "_words_per_second",
+                        static_cast<double>(spirv.size()) * kIterations,
+                        seconds);
+  }
+  RecordProperty("spirv_words", static_cast<int>(spirv.size()));
+}
+
+INSTANTIATE_TEST_CASE_P(ModuleSizes, MarkvDecodeBenchmark,
+                        ::testing::Values(100));
+INSTANTIATE_TEST_CASE_P(DISABLED_LargeModuleSizes, MarkvDecodeBenchmark,
+                        ::testing::Values(2000));
+
+}  // anonymous namespace
@@ -18,6 +18,7 @@
 #include <sstream>
 #include <string>
 #include <unordered_map>
+#include <vector>
 
 #include "gmock/gmock.h"
 #include "util/bit_stream.h"
@@ -25,7 +26,9 @@
 
 namespace {
 
+using spvutils::BitReaderWord64;
 using spvutils::BitsToStream;
+using spvutils::BitWriterWord64;
 using spvutils::HuffmanCodec;
 
 const std::map<std::string, uint32_t>& GetTestSet() {
@@ -312,4 +315,56 @@ TEST(Huffman, CreateFromTextU64) {
   EXPECT_EQ("00", BitsToStream(bits, num_bits));
 }
 
+TEST(Huffman, DecodeFromBitReaderWithLongCodes) {
+  // Fibonacci weights make a tree with codes much longer than the decoding
+  // table, and with short codes next to them.
+  std::map<uint32_t, uint32_t> hist;
+  uint32_t weight = 1;
+  uint32_t next_weight = 1;
+  for (uint32_t val = 0; val < 20; ++val) {
+    hist[val] = weight;
+    next_weight += weight;
+    weight = next_weight - weight;
+  }
+  HuffmanCodec<uint32_t> huffman(hist);
+
+  std::vector<uint32_t> vals;
+  for (uint32_t i = 0; i < 200; ++i) vals.push_back((i * 7) % 20);
+
+  BitWriterWord64 writer;
+  for (uint32_t val : vals) {
+    uint64_t bits = 0;
+    size_t num_bits = 0;
+    ASSERT_TRUE(huffman.Encode(val, &bits, &num_bits));
+    writer.WriteBits(bits, num_bits);
+  }
+
+  BitReaderWord64 reader(writer.GetDataCopy());
+  BitReaderWord64 bit_reader(writer.GetDataCopy());
+  auto read_bit = [&bit_reader](bool* bit) {
+    uint64_t bits = 0;
+    if (!bit_reader.ReadBits(&bits, 1)) return false;
+    *bit = bits != 0;
+    return true;
+  };
+
+  for (uint32_t val : vals) {
+    uint32_t decoded = 0;
+    ASSERT_TRUE(huffman.DecodeFromStream(&reader, &decoded));
+    EXPECT_EQ(val, decoded);
+    ASSERT_TRUE(huffman.DecodeFromStream(read_bit, &decoded));
+    EXPECT_EQ(val, decoded);
+    EXPECT_EQ(bit_reader.GetNumReadBits(), reader.GetNumReadBits());
+  }
+  EXPECT_EQ(writer.GetNumBits(), reader.GetNumReadBits());
+}
+
+TEST(Huffman, DecodeFromEmptyBitReader) {
+  HuffmanCodec<uint32_t> huffman(std::map<uint32_t, uint32_t>(
+      {{1, 10}, {2, 5}, {3, 15}}));
+  BitReaderWord64 reader(std::vector<uint64_t>{});
+  uint32_t decoded = 0;
+  EXPECT_FALSE(huffman.DecodeFromStream(&reader, &decoded));
+}
+
 }  // anonymous namespace
@@ -0,0 +1,80 @@
+// Copyright (c) 2018 Google LLC
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+// Compares the speed of MultiMoveToFront with a set of MoveToFront trees, one
+// per sequence, on the workloads of move_to_front_workloads.h.  That both give
+// the same ranks and values is checked by move_to_front_test.cpp, and again
+// here at the benchmark sizes.
+
+#include <string>
+
+#include "benchmark_utils.h"
+#include "gmock/gmock.h"
+#include "move_to_front_workloads.h"
+
+namespace {
+
+using spvtest::Results;
+using spvtest::RunManySequences;
+using spvtest::RunSingleSequence;
+using spvtest::TreeMultiMoveToFront;
+using spvutils::MultiMoveToFront;
+
+// Runs |workload| with |Mtf|, stores the results in |results| and records
+// the time it took as the test property |name|.
+template <class Mtf, class Workload>
+void TimeWorkload(const std::string& name, Workload workload,
+                  uint32_t num_values, Results* results) {
+  Mtf mtf;
+  const double seconds = spvtest::SecondsToRun(
+      1, [&]() { workload(num_values, &mtf, results); });
+  spvtest::RecordMilliseconds(name, seconds);
+}
+
+class MoveToFrontBenchmark : public ::testing::TestWithParam<int> {};
+
+TEST_P(MoveToFrontBenchmark, SingleSequence) {
+  const uint32_t num_values = GetParam();
+  Results tree_results;
+  Results flat_results;
+  TimeWorkload<TreeMultiMoveToFront>("tree_milliseconds",
+                                     RunSingleSequence<TreeMultiMoveToFront>,
+                                     num_values, &tree_results);
+  TimeWorkload<MultiMoveToFront<uint32_t>>(
+      "flat_milliseconds", RunSingleSequence<MultiMoveToFront<uint32_t>>,
+      num_values, &flat_results);
+  EXPECT_EQ(tree_results.ranks, flat_results.ranks);
+  EXPECT_EQ(tree_results.values, flat_results.values);
+}
+
+TEST_P(MoveToFrontBenchmark, ManySequences) {
+  const uint32_t num_values = GetParam();
+  Results tree_results;
+  Results flat_results;
+  TimeWorkload<TreeMultiMoveToFront>("tree_milliseconds",
+                                     RunManySequences<TreeMultiMoveToFront>,
+                                     num_values, &tree_results);
+  TimeWorkload<MultiMoveToFront<uint32_t>>(
+      "flat_milliseconds", RunManySequences<MultiMoveToFront<uint32_t>>,
+      num_values, &flat_results);
+  EXPECT_EQ(tree_results.ranks, flat_results.ranks);
+  EXPECT_EQ(tree_results.values, flat_results.values);
+}
+
+INSTANTIATE_TEST_CASE_P(ModuleSizes, MoveToFrontBenchmark,
+                        ::testing::Values(1000));
+INSTANTIATE_TEST_CASE_P(DISABLED_LargeModuleSizes, MoveToFrontBenchmark,
+                        ::testing::Values(100000));
+
+}  // anonymous namespace
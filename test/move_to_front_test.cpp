@@ -17,6 +17,7 @@
 #include <set>
 
 #include "gmock/gmock.h"
+#include "move_to_front_workloads.h"
 #include "util/move_to_front.h"
 
 namespace {
@@ -938,4 +939,27 @@ TEST(MultiMoveToFront, TwoSequences) {
   EXPECT_EQ(1u, rank);
 }
 
+TEST(MultiMoveToFront, SingleSequenceMatchesTrees) {
+  spvtest::TreeMultiMoveToFront tree_mtf;
+  MultiMoveToFront<uint32_t> flat_mtf;
+  spvtest::Results tree_results;
+  spvtest::Results flat_results;
+  spvtest::RunSingleSequence(1000, &tree_mtf, &tree_results);
+  spvtest::RunSingleSequence(1000, &flat_mtf, &flat_results);
+  EXPECT_EQ(tree_results.ranks, flat_results.ranks);
+  EXPECT_EQ(tree_results.values, flat_results.values);
+}
+
+TEST(MultiMoveToFront, ManySequencesMatchesTrees) {
+  // Long enough for ids to be removed at the end of a few functions.
+  spvtest::TreeMultiMoveToFront tree_mtf;
+  MultiMoveToFront<uint32_t> flat_mtf;
+  spvtest::Results tree_results;
+  spvtest::Results flat_results;
+  spvtest::RunManySequences(3500, &tree_mtf, &tree_results);
+  spvtest::RunManySequences(3500, &flat_mtf, &flat_results);
+  EXPECT_EQ(tree_results.ranks, flat_results.ranks);
+  EXPECT_EQ(tree_results.values, flat_results.values);
+}
+
 }  // anonymous namespace
@@ -0,0 +1,131 @@
+// Copyright (c) 2018 Google LLC
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#ifndef LIBSPIRV_TEST_MOVE_TO_FRONT_WORKLOADS_H_
+#define LIBSPIRV_TEST_MOVE_TO_FRONT_WORKLOADS_H_
+
+// Workloads for MultiMoveToFront, and the reference implementation their
+// results are compared with.  Used by move_to_front_test.cpp and
+// move_to_front_benchmark_test.cpp.
+
+#include <cstdint>
+#include <map>
+#include <set>
+#include <unordered_map>
+#include <vector>
+
+#include "util/move_to_front.h"
+
+namespace spvtest {
+
+// Keeps one MoveToFront tree per sequence.  This is the reference for the
+// ranks of MultiMoveToFront.
+class TreeMultiMoveToFront {
+ public:
+  bool Insert(uint64_t mtf, uint32_t value) {
+    if (!mtfs_[mtf].Insert(value)) return false;
+    val_to_mtfs_[value].insert(mtf);
+    return true;
+  }
+
+  void RemoveFromAll(uint32_t value) {
+    for (uint64_t mtf : val_to_mtfs_[value]) mtfs_[mtf].Remove(value);
+    val_to_mtfs_.erase(value);
+  }
+
+  bool RankFromValue(uint64_t mtf, uint32_t value, uint32_t* rank) {
+    return mtfs_[mtf].RankFromValue(value, rank);
+  }
+
+  bool ValueFromRank(uint64_t mtf, uint32_t rank, uint32_t* value) {
+    return mtfs_[mtf].ValueFromRank(rank, value);
+  }
+
+  uint32_t GetSize(uint64_t mtf) { return mtfs_[mtf].GetSize(); }
+
+  void Promote(uint32_t value) {
+    for (uint64_t mtf : val_to_mtfs_[value]) mtfs_[mtf].Promote(value);
+  }
+
+ private:
+  std::map<uint64_t, spvutils::MoveToFront<uint32_t>> mtfs_;
+  std::unordered_map<uint32_t, std::set<uint64_t>> val_to_mtfs_;
+};
+
+// The results of a workload.  Equal for both implementations.
+struct Results {
+  std::vector<uint32_t> ranks;
+  std::vector<uint32_t> values;
+};
+
+// Like the LargerScale test: fills a single sequence with |num_values|
+// values, then looks them up from the back, the middle and the front.
+template <class Mtf>
+void RunSingleSequence(uint32_t num_values, Mtf* mtf, Results* results) {
+  uint32_t rank = 0;
+  uint32_t value = 0;
+  for (uint32_t i = 1; i <= num_values; ++i) {
+    mtf->Insert(1, i);
+    mtf->RankFromValue(1, i, &rank);
+    results->ranks.push_back(rank);
+  }
+  for (uint32_t i = 1; i <= num_values; ++i) {
+    mtf->ValueFromRank(1, num_values - i % 7, &value);
+    results->values.push_back(value);
+    mtf->ValueFromRank(1, 1 + num_values / 2, &value);
+    results->values.push_back(value);
+    mtf->RankFromValue(1, i, &rank);
+    results->ranks.push_back(rank);
+  }
+}
+
+// Like the MARK-V encoder: every new id goes to the sequence of all ids and
+// to one of a few typed sequences, ids are promoted when they are used, and
+// ranks are looked up in the typed sequences.  Every so often a function
+// ends, and its ids are removed from all sequences.
+template <class Mtf>
+void RunManySequences(uint32_t num_values, Mtf* mtf, Results* results) {
+  const uint64_t kAll = 1;
+  const uint64_t kTypedBegin = 0x10000;
+  const uint32_t kNumTypes = 20;
+  uint32_t rank = 0;
+  uint32_t value = 0;
+  uint32_t function_begin = 1;
+  for (uint32_t id = 1; id <= num_values; ++id) {
+    const uint64_t typed = kTypedBegin + id % kNumTypes;
+    mtf->Insert(kAll, id);
+    mtf->Insert(typed, id);
+
+    const uint32_t used =
+        function_begin + (id * 7919) % (id - function_begin + 1);
+    mtf->Promote(used);
+    mtf->RankFromValue(kTypedBegin + used % kNumTypes, used, &rank);
+    results->ranks.push_back(rank);
+    if (mtf->ValueFromRank(typed, 1 + id % 5, &value)) {
+      results->values.push_back(value);
+    }
+
+    if (id % 1000 == 0) {
+      for (uint32_t local = function_begin + 100; local <= id; ++local) {
+        mtf->RemoveFromAll(local);
+      }
+      function_begin = id + 1;
+    }
+  }
+  results->ranks.push_back(mtf->GetSize(kAll));
+}
+
+}  // namespace spvtest
+
+#endif  // LIBSPIRV_TEST_MOVE_TO_FRONT_WORKLOADS_H_
@@ -343,4 +343,22 @@ INSTANTIATE_TEST_CASE_P(
         {"%1 = OpTypeBool\n%2 = OpConstantFalse %1", 2, "false"},
     }), );
 
+using FriendlyNameMapperTest = spvtest::TextToBinaryTest;
+
+TEST_F(FriendlyNameMapperTest, FindNameForId) {
+  ScopedContext context(SPV_ENV_UNIVERSAL_1_1);
+  auto words = CompileSuccessfully(
+      "OpName %2 \"two\"\n%1 = OpTypeVoid\n%2 = OpTypeFunction %1",
+      SPV_ENV_UNIVERSAL_1_1);
+  FriendlyNameMapper friendly_mapper(context.context, words.data(),
+                                     words.size());
+  const std::string* name = friendly_mapper.FindNameForId(2);
+  ASSERT_NE(nullptr, name);
+  EXPECT_EQ("two", *name);
+  EXPECT_EQ(friendly_mapper.FindNameForId(2), friendly_mapper.FindNameForId(2));
+  EXPECT_EQ(nullptr, friendly_mapper.FindNameForId(3));
+  EXPECT_EQ(nullptr, friendly_mapper.FindNameForId(1000000));
+  EXPECT_EQ("3", friendly_mapper.NameForId(3));
+}
+
 }  // anonymous namespace
@@ -5344,6 +5344,135 @@ OpFunctionEnd
   SinglePassRunAndCheck<opt::AggressiveDCEPass>(text, text, true, true);
 }
 
+TEST_F(AggressiveDCETest, MultipleEntryPointsSharingCallee) {
+  // All the entry point call trees are processed with one worklist.  The
+  // callee is live through the first entry point only, and every function
+  // has dead code.
+  const std::string predefs = R"(OpCapability Shader
+OpMemoryModel Logical GLSL450
+OpEntryPoint Vertex %1 "main1" %2 %3
+OpEntryPoint Vertex %4 "main2" %2 %3
+%void = OpTypeVoid
+%6 = OpTypeFunction %void
+%float = OpTypeFloat 32
+%8 = OpTypeFunction %float
+%_ptr_Output_float = OpTypePointer Output %float
+%_ptr_Input_float = OpTypePointer Input %float
+%2 = OpVariable %_ptr_Output_float Output
+%3 = OpVariable %_ptr_Input_float Input
+)";
+
+  const std::string before = R"(%1 = OpFunction %void None %6
+%11 = OpLabel
+%12 = OpFunctionCall %float %13
+%14 = OpFAdd %float %12 %12
+OpStore %2 %12
+OpReturn
+OpFunctionEnd
+%4 = OpFunction %void None %6
+%15 = OpLabel
+%16 = OpLoad %float %3
+%17 = OpFMul %float %16 %16
+OpReturn
+OpFunctionEnd
+%13 = OpFunction %float None %8
+%18 = OpLabel
+%19 = OpLoad %float %3
+%20 = OpFNegate %float %19
+OpReturnValue %19
+OpFunctionEnd
+)";
+
+  const std::string after = R"(%1 = OpFunction %void None %6
+%11 = OpLabel
+%12 = OpFunctionCall %float %13
+OpStore %2 %12
+OpReturn
+OpFunctionEnd
+%4 = OpFunction %void None %6
+%15 = OpLabel
+OpReturn
+OpFunctionEnd
+%13 = OpFunction %float None %8
+%18 = OpLabel
+%19 = OpLoad %float %3
+OpReturnValue %19
+OpFunctionEnd
+)";
+
+  SetAssembleOptions(SPV_TEXT_TO_BINARY_OPTION_PRESERVE_NUMERIC_IDS);
+  SinglePassRunAndCheck<opt::AggressiveDCEPass>(predefs + before,
+                                                predefs + after, true, true);
+}
+
+TEST_F(AggressiveDCETest, StoreInOtherEntryPointKeepsItsSelection) {
+  // Both entry points have no calls, so their private variables are
+  // optimized like locals.  The load of %9 in %1 makes the store to %9 in
+  // %4 live while %1 is processed.  That store is inside a selection, so the
+  // selection's branch and merge in %4 must be kept too.
+  const std::string predefs = R"(OpCapability Shader
+OpMemoryModel Logical GLSL450
+OpEntryPoint Vertex %1 "main1" %2 %3
+OpEntryPoint Vertex %4 "main2" %2 %3
+%void = OpTypeVoid
+%6 = OpTypeFunction %void
+%float = OpTypeFloat 32
+%bool = OpTypeBool
+%float_0 = OpConstant %float 0
+%_ptr_Output_float = OpTypePointer Output %float
+%_ptr_Input_float = OpTypePointer Input %float
+%_ptr_Private_float = OpTypePointer Private %float
+%2 = OpVariable %_ptr_Output_float Output
+%3 = OpVariable %_ptr_Input_float Input
+%9 = OpVariable %_ptr_Private_float Private
+)";
+
+  const std::string before = R"(%1 = OpFunction %void None %6
+%11 = OpLabel
+%12 = OpLoad %float %9
+OpStore %2 %12
+OpReturn
+OpFunctionEnd
+%4 = OpFunction %void None %6
+%13 = OpLabel
+%14 = OpLoad %float %3
+%15 = OpFMul %float %14 %14
+%16 = OpFOrdLessThan %bool %14 %float_0
+OpSelectionMerge %17 None
+OpBranchConditional %16 %18 %17
+%18 = OpLabel
+OpStore %9 %14
+OpBranch %17
+%17 = OpLabel
+OpReturn
+OpFunctionEnd
+)";
+
+  const std::string after = R"(%1 = OpFunction %void None %6
+%11 = OpLabel
+%12 = OpLoad %float %9
+OpStore %2 %12
+OpReturn
+OpFunctionEnd
+%4 = OpFunction %void None %6
+%13 = OpLabel
+%14 = OpLoad %float %3
+%16 = OpFOrdLessThan %bool %14 %float_0
+OpSelectionMerge %17 None
+OpBranchConditional %16 %18 %17
+%18 = OpLabel
+OpStore %9 %14
+OpBranch %17
+%17 = OpLabel
+OpReturn
+OpFunctionEnd
+)";
+
+  SetAssembleOptions(SPV_TEXT_TO_BINARY_OPTION_PRESERVE_NUMERIC_IDS);
+  SinglePassRunAndCheck<opt::AggressiveDCEPass>(predefs + before,
+                                                predefs + after, true, true);
+}
+
 // TODO(greg-lunarg): Add tests to verify handling of these cases:
 //
 //    Check that logical addressing required
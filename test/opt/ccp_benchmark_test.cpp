@@ -0,0 +1,115 @@
+// Copyright (c) 2018 Google LLC
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+// Measures the time CCPPass takes to propagate constants through a large
+// function with many branches, and checks that the value reaching the end of
+// the function is found to be constant.
+
+#include <memory>
+#include <sstream>
+#include <string>
+
+#include <gmock/gmock.h>
+
+#include "benchmark_utils.h"
+#include "opt/build_module.h"
+#include "opt/ccp_pass.h"
+#include "opt/ir_context.h"
+
+namespace {
+
+using namespace spvtools;
+
+// Returns the assembly for a function with a chain of |num_selections|
+// if-then-else constructs.  Each of them increments a counter, and only takes
+// its then branch, because the counter stays below a constant limit.  The
+// else branches load a varying value, which CCP must ignore because they are
+// never executed.  The last value of the counter is stored to %out.
+std::string MakeLargeModule(int num_selections) {
+  std::ostringstream ss;
+  ss << spvtest::ShaderHeader("%in %out") << R"(%void = OpTypeVoid
+%voidfn = OpTypeFunction %void
+%bool = OpTypeBool
+%int = OpTypeInt 32 1
+%in_ptr = OpTypePointer Input %int
+%out_ptr = OpTypePointer Output %int
+%in = OpVariable %in_ptr Input
+%out = OpVariable %out_ptr Output
+%zero = OpConstant %int 0
+%one = OpConstant %int 1
+%limit = OpConstant %int 1000000
+%main = OpFunction %void None %voidfn
+%entry = OpLabel
+OpBranch %sel0
+%sel0 = OpLabel
+%v0 = OpPhi %int %zero %entry
+)";
+  for (int i = 0; i < num_selections; ++i) {
+    ss << "%a" << i << " = OpIAdd %int %v" << i << " %one\n"
+       << "%c" << i << " = OpSLessThan %bool %a" << i << " %limit\n"
+       << "OpSelectionMerge %sel" << i + 1 << " None\n"
+       << "OpBranchConditional %c" << i << " %then" << i << " %else" << i
+       << "\n"
+       << "%then" << i << " = OpLabel\n"
+       << "%t" << i << " = OpIMul %int %a" << i << " %one\n"
+       << "OpBranch %sel" << i + 1 << "\n"
+       << "%else" << i << " = OpLabel\n"
+       << "%e" << i << " = OpLoad %int %in\n"
+       << "OpBranch %sel" << i + 1 << "\n"
+       << "%sel" << i + 1 << " = OpLabel\n"
+       << "%v" << i + 1 << " = OpPhi %int %t" << i << " %then" << i << " %e"
+       << i << " %else" << i << "\n";
+  }
+  ss << R"(OpStore %out %v)" << num_selections << R"(
+OpReturn
+OpFunctionEnd
+)";
+  return ss.str();
+}
+
+class CCPBenchmark : public ::testing::TestWithParam<int> {};
+
+TEST_P(CCPBenchmark, PropagateThroughLargeFunction) {
+  const int num_selections = GetParam();
+  std::unique_ptr<ir::IRContext> context = BuildModule(
+      SPV_ENV_UNIVERSAL_1_1, nullptr, MakeLargeModule(num_selections));
+  ASSERT_NE(nullptr, context);
+
+  opt::CCPPass pass;
+  const double seconds = spvtest::SecondsToRun(1, [&pass, &context]() {
+    EXPECT_EQ(opt::Pass::Status::SuccessWithChange, pass.Run(context.get()));
+  });
+
+  // The store to %out now stores the constant |num_selections|.
+  const ir::Instruction* stored = nullptr;
+  context->module()->ForEachInst([&](const ir::Instruction* inst) {
+    if (inst->opcode() == SpvOpStore) {
+      stored = context->get_def_use_mgr()->GetDef(
+          inst->GetSingleWordInOperand(1));
+    }
+  });
+  ASSERT_NE(nullptr, stored);
+  ASSERT_EQ(SpvOpConstant, stored->opcode());
+  EXPECT_EQ(static_cast<uint32_t>(num_selections),
+            stored->GetSingleWordInOperand(0));
+
+  RecordProperty("selections", num_selections);
+  spvtest::RecordMilliseconds("milliseconds", seconds);
+}
+
+INSTANTIATE_TEST_CASE_P(ModuleSizes, CCPBenchmark, ::testing::Values(100));
+INSTANTIATE_TEST_CASE_P(DISABLED_LargeModuleSizes, CCPBenchmark,
+                        ::testing::Values(10000));
+
+}  // anonymous namespace
@@ -0,0 +1,139 @@
+// Copyright (c) 2018 Google LLC
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+// Measures how well a large module compresses after its ids are compacted in
+// first-seen order and in locality order.  The compressed size is estimated
+// as the number of bytes the words of the module take in a variable-length
+// encoding with 7 bits per byte, which favors small ids the same way general
+// purpose compressors do.  The tests check that both orders produce gapless
+// ids.
+
+#include <memory>
+#include <sstream>
+#include <string>
+#include <vector>
+
+#include <gmock/gmock.h>
+
+#include "benchmark_utils.h"
+#include "opt/build_module.h"
+#include "opt/compact_ids_pass.h"
+#include "opt/ir_context.h"
+
+namespace {
+
+using namespace spvtools;
+
+// The number of distinct constants used by the functions.
+const int kNumConstants = 64;
+
+// Returns the assembly for a module whose entry point calls |num_functions|
+// functions.  Each of them does some arithmetic with a few of the module's
+// constants.  The names of the functions come first, so the first-seen order
+// gives them the smallest ids.
+std::string MakeLargeModule(int num_functions) {
+  std::ostringstream ss;
+  ss << spvtest::ShaderHeader() << "OpName %main \"main\"\n";
+  for (int i = 0; i < num_functions; ++i) {
+    ss << "OpName %f" << i << " \"f" << i << "\"\n";
+  }
+  ss << R"(%void = OpTypeVoid
+%voidfn = OpTypeFunction %void
+%float = OpTypeFloat 32
+%floatfn = OpTypeFunction %float %float
+)";
+  for (int c = 0; c < kNumConstants; ++c) {
+    ss << "%c" << c << " = OpConstant %float " << c << "\n";
+  }
+  ss << "%main = OpFunction %void None %voidfn\n%entry = OpLabel\n";
+  for (int i = 0; i < num_functions; ++i) {
+    ss << "%r" << i << " = OpFunctionCall %float %f" << i << " %c0\n";
+  }
+  ss << "OpReturn\nOpFunctionEnd\n";
+  for (int i = 0; i < num_functions; ++i) {
+    ss << "%f" << i << " = OpFunction %float None %floatfn\n"
+       << "%p" << i << " = OpFunctionParameter %float\n"
+       << "%e" << i << " = OpLabel\n"
+       << "%a" << i << " = OpFAdd %float %p" << i << " %c"
+       << i % kNumConstants << "\n"
+       << "%b" << i << " = OpFMul %float %a" << i << " %c"
+       << (i * 7) % kNumConstants << "\n"
+       << "%d" << i << " = OpFAdd %float %b" << i << " %a" << i << "\n"
+       << "OpReturnValue %d" << i << "\n"
+       << "OpFunctionEnd\n";
+  }
+  return ss.str();
+}
+
+// Returns the number of bytes |binary| takes when every word is written with
+// 7 bits per byte.
+size_t VarintSize(const std::vector<uint32_t>& binary) {
+  size_t size = 0;
+  for (uint32_t word : binary) {
+    do {
+      ++size;
+      word >>= 7;
+    } while (word != 0);
+  }
+  return size;
+}
+
+// Runs CompactIdsPass with |order| on |text|.  Returns the resulting binary.
+std::vector<uint32_t> CompactIds(const std::string& text,
+                                 opt::CompactIdsPass::Order order) {
+  std::vector<uint32_t> binary;
+  std::unique_ptr<ir::IRContext> context =
+      BuildModule(SPV_ENV_UNIVERSAL_1_1, nullptr, text);
+  EXPECT_NE(nullptr, context);
+  if (context == nullptr) return binary;
+  opt::CompactIdsPass pass(order);
+  pass.Run(context.get());
+  context->module()->ToBinary(&binary, /* skip_nop = */ false);
+  return binary;
+}
+
+class CompactIdsBenchmark : public ::testing::TestWithParam<int> {};
+
+TEST_P(CompactIdsBenchmark, CompressedSize) {
+  const std::string text = MakeLargeModule(GetParam());
+  std::unique_ptr<ir::IRContext> context =
+      BuildModule(SPV_ENV_UNIVERSAL_1_1, nullptr, text);
+  ASSERT_NE(nullptr, context);
+  std::vector<uint32_t> original;
+  context->module()->ToBinary(&original, /* skip_nop = */ false);
+
+  const std::vector<uint32_t> first_seen =
+      CompactIds(text, opt::CompactIdsPass::Order::kFirstSeen);
+  const std::vector<uint32_t> locality =
+      CompactIds(text, opt::CompactIdsPass::Order::kLocality);
+
+  // Both orders give out the same ids, so they end up with the same bound.
+  const uint32_t kBoundIndex = 3;
+  ASSERT_EQ(original.size(), first_seen.size());
+  ASSERT_EQ(original.size(), locality.size());
+  EXPECT_EQ(original[kBoundIndex], first_seen[kBoundIndex]);
+  EXPECT_EQ(original[kBoundIndex], locality[kBoundIndex]);
+
+  RecordProperty("bound", static_cast<int>(original[kBoundIndex]));
+  RecordProperty("original_bytes", static_cast<int>(VarintSize(original)));
+  RecordProperty("first_seen_bytes", static_cast<int>(VarintSize(first_seen)));
+  RecordProperty("locality_bytes", static_cast<int>(VarintSize(locality)));
+}
+
+INSTANTIATE_TEST_CASE_P(ModuleSizes, CompactIdsBenchmark,
+                        ::testing::Values(100));
+INSTANTIATE_TEST_CASE_P(DISABLED_LargeModuleSizes, CompactIdsBenchmark,
+                        ::testing::Values(10000));
+
+}  // anonymous namespace
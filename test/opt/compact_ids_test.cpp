@@ -90,6 +90,48 @@ OpFunctionEnd
   SinglePassRunAndCheck<opt::CompactIdsPass>(before, after, false, false);
 }
 
+TEST_F(CompactIdsTest, LocalityOrder) {
+  const std::string before =
+      R"(OpCapability Shader
+OpMemoryModel Logical GLSL450
+OpEntryPoint Fragment %10 "main"
+OpExecutionMode %10 OriginUpperLeft
+%20 = OpTypeVoid
+%21 = OpTypeFunction %20
+%22 = OpTypeFloat 32
+%23 = OpConstant %22 1
+%10 = OpFunction %20 None %21
+%30 = OpLabel
+%31 = OpFAdd %22 %23 %23
+%32 = OpFMul %22 %31 %23
+OpReturn
+OpFunctionEnd
+)";
+
+  // %22 and %23 are used three times, %20 twice and %21 once.
+  const std::string after =
+      R"(OpCapability Shader
+OpMemoryModel Logical GLSL450
+OpEntryPoint Fragment %5 "main"
+OpExecutionMode %5 OriginUpperLeft
+%3 = OpTypeVoid
+%4 = OpTypeFunction %3
+%1 = OpTypeFloat 32
+%2 = OpConstant %1 1
+%5 = OpFunction %3 None %4
+%6 = OpLabel
+%7 = OpFAdd %1 %2 %2
+%8 = OpFMul %1 %7 %2
+OpReturn
+OpFunctionEnd
+)";
+
+  SetAssembleOptions(SPV_TEXT_TO_BINARY_OPTION_PRESERVE_NUMERIC_IDS);
+  SetDisassembleOptions(SPV_BINARY_TO_TEXT_OPTION_NO_HEADER);
+  SinglePassRunAndCheck<opt::CompactIdsPass>(
+      before, after, false, false, opt::CompactIdsPass::Order::kLocality);
+}
+
 TEST(CompactIds, InstructionResultIsUpdated) {
   // For https://github.com/KhronosGroup/SPIRV-Tools/issues/827
   // In that bug, the compact Ids pass was directly updating the result Id
@@ -192,4 +234,33 @@ OpFunctionEnd
   EXPECT_THAT(disassembly, ::testing::Eq(expected));
 }
 
+TEST(CompactIds, BoundIsMinimized) {
+  const std::string input(R"(OpCapability Shader
+OpMemoryModel Logical Simple
+OpEntryPoint GLCompute %1 "main"
+%2 = OpTypeVoid
+%3 = OpTypeFunction %2
+%1 = OpFunction %2 None %3
+%4 = OpLabel
+OpReturn
+OpFunctionEnd
+)");
+
+  std::vector<uint32_t> binary;
+  const spv_target_env env = SPV_ENV_UNIVERSAL_1_0;
+  spvtools::SpirvTools tools(env);
+  auto assembled = tools.Assemble(
+      input, &binary, SPV_TEXT_TO_BINARY_OPTION_PRESERVE_NUMERIC_IDS);
+  EXPECT_TRUE(assembled);
+
+  // The ids are already compact, but the bound is too large.
+  const uint32_t kBoundIndex = 3;
+  binary[kBoundIndex] = 100;
+
+  spvtools::Optimizer optimizer(env);
+  optimizer.RegisterPass(CreateCompactIdsPass());
+  optimizer.Run(binary.data(), binary.size(), &binary);
+  EXPECT_EQ(5u, binary[kBoundIndex]);
+}
+
 }  // anonymous namespace
@@ -0,0 +1,104 @@
+// Copyright (c) 2018 Google LLC
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+// Measures how fast the DefUseManager is built, updated and queried on large
+// modules, and checks that the updated manager matches a freshly built one.
+
+#include <memory>
+#include <sstream>
+#include <string>
+#include <vector>
+
+#include <gmock/gmock.h>
+
+#include "benchmark_utils.h"
+#include "opt/build_module.h"
+#include "opt/def_use_manager.h"
+#include "opt/ir_context.h"
+
+namespace {
+
+using namespace spvtools;
+using opt::analysis::DefUseManager;
+
+// The number of times each measured operation is repeated.
+const int kIterations = 10;
+
+// Returns the assembly for a module with |num_blocks| blocks of arithmetic in
+// a single function.  The constant %one and the variable %var have a user in
+// every block.
+std::string MakeLargeModule(int num_blocks) {
+  std::string text = spvtest::ShaderHeader() + R"(%void = OpTypeVoid
+%voidfn = OpTypeFunction %void
+%int = OpTypeInt 32 1
+%ptr = OpTypePointer Function %int
+%one = OpConstant %int 1
+%main = OpFunction %void None %voidfn
+%entry = OpLabel
+%var = OpVariable %ptr Function
+)";
+  text += spvtest::BlockChain(num_blocks, [](int i) {
+    std::ostringstream ss;
+    ss << "%load" << i << " = OpLoad %int %var\n"
+       << "%add" << i << " = OpIAdd %int %load" << i << " %one\n"
+       << "%mul" << i << " = OpIMul %int %add" << i << " %add" << i << "\n"
+       << "OpStore %var %mul" << i << "\n";
+    return ss.str();
+  });
+  return text + "OpReturn\nOpFunctionEnd\n";
+}
+
+class DefUseBenchmark : public ::testing::TestWithParam<int> {};
+
+TEST_P(DefUseBenchmark, BuildUpdateAndQuery) {
+  std::unique_ptr<ir::IRContext> context =
+      BuildModule(SPV_ENV_UNIVERSAL_1_1, nullptr, MakeLargeModule(GetParam()));
+  ASSERT_NE(nullptr, context);
+  ir::Module* module = context->module();
+  std::vector<ir::Instruction*> insts;
+  module->ForEachInst(
+      [&insts](ir::Instruction* inst) { insts.push_back(inst); });
+
+  const double build_seconds = spvtest::SecondsToRun(
+      kIterations, [module]() { DefUseManager manager(module); });
+
+  // Reanalyzing the uses of every instruction exercises the removal and
+  // insertion of use records.
+  DefUseManager manager(module);
+  const double update_seconds =
+      spvtest::SecondsToRun(kIterations, [&manager, &insts]() {
+        for (ir::Instruction* inst : insts) manager.AnalyzeInstUse(inst);
+      });
+  EXPECT_TRUE(manager == DefUseManager(module));
+
+  uint32_t num_uses = 0;
+  const double query_seconds = spvtest::SecondsToRun(kIterations, [&]() {
+    num_uses = 0;
+    for (uint32_t id = 1; id < module->IdBound(); ++id) {
+      if (manager.GetDef(id)) num_uses += manager.NumUses(id);
+    }
+  });
+  EXPECT_LT(5u * GetParam(), num_uses);
+
+  RecordProperty("instructions", static_cast<int>(insts.size()));
+  spvtest::RecordRate("builds_per_second", kIterations, build_seconds);
+  spvtest::RecordRate("full_updates_per_second", kIterations, update_seconds);
+  spvtest::RecordRate("full_queries_per_second", kIterations, query_seconds);
+}
+
+INSTANTIATE_TEST_CASE_P(ModuleSizes, DefUseBenchmark, ::testing::Values(100));
+INSTANTIATE_TEST_CASE_P(DISABLED_LargeModuleSizes, DefUseBenchmark,
+                        ::testing::Values(10000));
+
+}  // anonymous namespace
@@ -12,8 +12,10 @@
 // See the License for the specific language governing permissions and
 // limitations under the License.
 
+#include <algorithm>
 #include <memory>
 #include <unordered_set>
+#include <vector>
 
 #include <gmock/gmock.h>
 #include <gtest/gtest.h>
@@ -86,17 +88,21 @@ struct InstDefUse {
 // Checks that the |actual_defs| and |actual_uses| are in accord with
 // |expected_defs_uses|.
 void CheckDef(const InstDefUse& expected_defs_uses,
-              const DefUseManager::IdToDefMap& actual_defs) {
+              const DefUseManager::IdToDefTable& actual_defs) {
   // Check defs.
-  ASSERT_EQ(expected_defs_uses.defs.size(), actual_defs.size());
+  const size_t num_actual_defs =
+      std::count_if(actual_defs.begin(), actual_defs.end(),
+                    [](const ir::Instruction* def) { return def != nullptr; });
+  ASSERT_EQ(expected_defs_uses.defs.size(), num_actual_defs);
   for (uint32_t i = 0; i < expected_defs_uses.defs.size(); ++i) {
     const auto id = expected_defs_uses.defs[i].first;
     const auto expected_def = expected_defs_uses.defs[i].second;
-    ASSERT_EQ(1u, actual_defs.count(id)) << "expected to def id [" << id << "]";
-    auto def = actual_defs.at(id);
+    ASSERT_TRUE(id < actual_defs.size() && actual_defs[id])
+        << "expected to def id [" << id << "]";
+    auto def = actual_defs[id];
     if (def->opcode() != SpvOpConstant) {
       // Constants don't disassemble properly without a full context.
-      EXPECT_EQ(expected_def, DisassembleInst(actual_defs.at(id)));
+      EXPECT_EQ(expected_def, DisassembleInst(def));
     }
   }
 }
@@ -1424,6 +1430,73 @@ TEST(AnalyzeInstDefUse, AddNewInstruction) {
   CheckUse(expected, &manager, context->module()->IdBound());
 }
 
+TEST(AnalyzeInstDefUse, ForEachUserVisitsEveryUserWhenOneIsCleared) {
+  const std::string input =
+      "%1 = OpTypeBool "
+      "%2 = OpConstantTrue %1 "
+      "%3 = OpConstantFalse %1 "
+      "%4 = OpConstantTrue %1";
+
+  // Build module.
+  std::unique_ptr<ir::IRContext> context =
+      BuildModule(SPV_ENV_UNIVERSAL_1_1, nullptr, input);
+  ASSERT_NE(nullptr, context);
+
+  // Analyze the instructions.
+  opt::analysis::DefUseManager manager(context->module());
+
+  std::vector<uint32_t> visited;
+  manager.ForEachUser(1, [&manager, &visited](ir::Instruction* user) {
+    visited.push_back(user->result_id());
+    manager.ClearInst(user);
+  });
+  EXPECT_THAT(visited, ::testing::ElementsAre(2, 3, 4));
+  EXPECT_EQ(0u, manager.NumUsers(1));
+}
+
+TEST(AnalyzeInstDefUse, SpreadOutUniqueIds) {
+  const std::string input = "%1 = OpTypeBool";
+
+  // Build module.
+  std::unique_ptr<ir::IRContext> context =
+      BuildModule(SPV_ENV_UNIVERSAL_1_1, nullptr, input);
+  ASSERT_NE(nullptr, context);
+
+  // Take many unique ids before adding an instruction to the module, the way
+  // passes do when they replace instructions.
+  for (int i = 0; i < 100; ++i) {
+    ir::Instruction discarded(context.get(), SpvOpNop);
+  }
+  context->module()->AddGlobalValue(std::unique_ptr<ir::Instruction>(
+      new ir::Instruction(context.get(), SpvOpConstantTrue, 1, 2, {})));
+  context->module()->SetIdBound(3);
+
+  // Analyze the instructions, and add one more.
+  opt::analysis::DefUseManager manager(context->module());
+  ir::Instruction newInst(context.get(), SpvOpConstantFalse, 1, 3, {});
+  manager.AnalyzeInstDefUse(&newInst);
+  context->module()->SetIdBound(4);
+
+  InstDefUse expected = {
+      {
+          // defs
+          {1, "%1 = OpTypeBool"},
+          {2, "%2 = OpConstantTrue %1"},
+          {3, "%3 = OpConstantFalse %1"},
+      },
+      {
+          // uses
+          {1, {"%2 = OpConstantTrue %1", "%3 = OpConstantFalse %1"}},
+      },
+  };
+
+  CheckDef(expected, manager.id_to_defs());
+  CheckUse(expected, &manager, context->module()->IdBound());
+
+  manager.ClearInst(&newInst);
+  EXPECT_EQ(1u, manager.NumUsers(1));
+}
+
 struct KillInstTestCase {
   const char* before;
   std::unordered_set<uint32_t> indices_for_inst_to_kill;
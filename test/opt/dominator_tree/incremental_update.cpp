@@ -0,0 +1,188 @@
+// Copyright (c) 2018 Google LLC
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include <memory>
+#include <string>
+#include <vector>
+
+#include <gmock/gmock.h>
+
+#include "../assembly_builder.h"
+#include "../function_utils.h"
+#include "../pass_fixture.h"
+#include "../pass_utils.h"
+#include "opt/block_merge_pass.h"
+#include "opt/dominator_analysis.h"
+#include "opt/pass.h"
+
+namespace {
+
+using namespace spvtools;
+
+using PassClassTest = PassTest<::testing::Test>;
+
+// A selection whose branches join in %8, followed by the straight line
+// %8 -> %9 -> %10.  %6 branches twice to %8, so that one of its targets can
+// be redirected without removing the edge to %8.
+const std::string kText = R"(
+               OpCapability Shader
+               OpMemoryModel Logical GLSL450
+               OpEntryPoint Fragment %4 "main"
+               OpExecutionMode %4 OriginUpperLeft
+          %2 = OpTypeVoid
+          %3 = OpTypeFunction %2
+          %1 = OpTypeBool
+         %11 = OpConstantTrue %1
+          %4 = OpFunction %2 None %3
+          %5 = OpLabel
+               OpSelectionMerge %10 None
+               OpBranchConditional %11 %6 %7
+          %6 = OpLabel
+               OpBranchConditional %11 %8 %8
+          %7 = OpLabel
+               OpBranch %8
+          %8 = OpLabel
+               OpBranch %9
+          %9 = OpLabel
+               OpBranch %10
+         %10 = OpLabel
+               OpReturn
+               OpFunctionEnd
+)";
+
+uint32_t IdOrZero(const ir::BasicBlock* bb) { return bb ? bb->id() : 0; }
+
+// Checks that |tree| matches a tree built from scratch for |f|.
+void ExpectSameAsRebuilt(const opt::DominatorTree& tree, const ir::Function* f,
+                         const ir::CFG& cfg) {
+  opt::DominatorTree fresh(tree.IsPostDominator());
+  fresh.InitializeTree(f, cfg);
+  for (const ir::BasicBlock& a : *f) {
+    EXPECT_EQ(IdOrZero(fresh.ImmediateDominator(a.id())),
+              IdOrZero(tree.ImmediateDominator(a.id())))
+        << "idom of block " << a.id();
+    for (const ir::BasicBlock& b : *f) {
+      EXPECT_EQ(fresh.Dominates(a.id(), b.id()), tree.Dominates(a.id(), b.id()))
+          << "dominance of " << a.id() << " over " << b.id();
+    }
+  }
+}
+
+TEST_F(PassClassTest, InsertAndDeleteEdge) {
+  std::unique_ptr<ir::IRContext> context =
+      BuildModule(SPV_ENV_UNIVERSAL_1_1, nullptr, kText,
+                  SPV_TEXT_TO_BINARY_OPTION_PRESERVE_NUMERIC_IDS);
+  ir::Module* module = context->module();
+  const ir::Function* f = spvtest::GetFunction(module, 4);
+  ir::CFG cfg(module);
+  opt::DominatorTree& tree =
+      context->GetDominatorAnalysis(f, cfg)->GetDomTree();
+  EXPECT_EQ(8u, IdOrZero(tree.ImmediateDominator(9)));
+
+  // %6 -> %9 makes %5 the immediate dominator of %9.
+  ir::Instruction* branch = &*cfg.block(6)->tail();
+  branch->SetInOperand(2, {9});
+  tree.InsertEdge(6, 9);
+  EXPECT_EQ(5u, IdOrZero(tree.ImmediateDominator(9)));
+  ExpectSameAsRebuilt(tree, f, cfg);
+
+  branch->SetInOperand(2, {8});
+  tree.DeleteEdge(6, 9);
+  EXPECT_EQ(8u, IdOrZero(tree.ImmediateDominator(9)));
+  ExpectSameAsRebuilt(tree, f, cfg);
+
+  // Removing %5 -> %7 leaves %7 unreachable.
+  ir::Instruction* entry_branch = &*cfg.block(5)->tail();
+  entry_branch->SetInOperand(2, {6});
+  tree.DeleteEdge(5, 7);
+  EXPECT_FALSE(tree.ReachableFromRoots(7));
+  EXPECT_EQ(6u, IdOrZero(tree.ImmediateDominator(8)));
+  ExpectSameAsRebuilt(tree, f, cfg);
+}
+
+TEST_F(PassClassTest, InsertEdgeInPostDominatorTree) {
+  std::unique_ptr<ir::IRContext> context =
+      BuildModule(SPV_ENV_UNIVERSAL_1_1, nullptr, kText,
+                  SPV_TEXT_TO_BINARY_OPTION_PRESERVE_NUMERIC_IDS);
+  ir::Module* module = context->module();
+  const ir::Function* f = spvtest::GetFunction(module, 4);
+  ir::CFG cfg(module);
+  opt::DominatorTree& tree =
+      context->GetPostDominatorAnalysis(f, cfg)->GetDomTree();
+  EXPECT_EQ(8u, IdOrZero(tree.ImmediateDominator(6)));
+
+  cfg.block(6)->tail()->SetInOperand(2, {9});
+  tree.InsertEdge(6, 9);
+  EXPECT_EQ(9u, IdOrZero(tree.ImmediateDominator(6)));
+  ExpectSameAsRebuilt(tree, f, cfg);
+}
+
+TEST_F(PassClassTest, SplitBlock) {
+  std::unique_ptr<ir::IRContext> context =
+      BuildModule(SPV_ENV_UNIVERSAL_1_1, nullptr, kText,
+                  SPV_TEXT_TO_BINARY_OPTION_PRESERVE_NUMERIC_IDS);
+  ir::Module* module = context->module();
+  ir::Function* f = spvtest::GetFunction(module, 4);
+  ir::CFG cfg(module);
+  opt::DominatorTree& dom_tree =
+      context->GetDominatorAnalysis(f, cfg)->GetDomTree();
+  opt::DominatorTree& post_tree =
+      context->GetPostDominatorAnalysis(f, cfg)->GetDomTree();
+
+  // Split %8 into %8 -> %20, moving its branch to %9 into %20.
+  ir::BasicBlock* block = cfg.block(8);
+  std::unique_ptr<ir::BasicBlock> new_block(
+      new ir::BasicBlock(std::unique_ptr<ir::Instruction>(new ir::Instruction(
+          context.get(), SpvOpLabel, 0, 20, std::vector<ir::Operand>{}))));
+  new_block->AddInstruction(
+      std::unique_ptr<ir::Instruction>(block->tail()->Clone(context.get())));
+  block->tail()->SetInOperand(0, {20});
+  ir::BasicBlock* split = new_block.get();
+  f->AddBasicBlock(std::move(new_block));
+
+  dom_tree.SplitBlock(block, split);
+  post_tree.SplitBlock(block, split);
+  EXPECT_EQ(20u, IdOrZero(dom_tree.ImmediateDominator(9)));
+  EXPECT_EQ(8u, IdOrZero(dom_tree.ImmediateDominator(20)));
+  EXPECT_EQ(20u, IdOrZero(post_tree.ImmediateDominator(8)));
+  EXPECT_EQ(9u, IdOrZero(post_tree.ImmediateDominator(20)));
+  ExpectSameAsRebuilt(dom_tree, f, cfg);
+  ExpectSameAsRebuilt(post_tree, f, cfg);
+}
+
+TEST_F(PassClassTest, BlockMergeKeepsDominatorTrees) {
+  std::unique_ptr<ir::IRContext> context =
+      BuildModule(SPV_ENV_UNIVERSAL_1_1, nullptr, kText,
+                  SPV_TEXT_TO_BINARY_OPTION_PRESERVE_NUMERIC_IDS);
+  ir::Module* module = context->module();
+  const ir::Function* f = spvtest::GetFunction(module, 4);
+  opt::DominatorAnalysis* dom_analysis =
+      context->GetDominatorAnalysis(f, *context->cfg());
+  opt::PostDominatorAnalysis* post_analysis =
+      context->GetPostDominatorAnalysis(f, *context->cfg());
+
+  opt::BlockMergePass pass;
+  EXPECT_EQ(opt::Pass::Status::SuccessWithChange, pass.Run(context.get()));
+  EXPECT_TRUE(context->AreAnalysesValid(
+      ir::IRContext::kAnalysisCFG | ir::IRContext::kAnalysisDominatorAnalysis));
+  // %9 and %10 are merged into %8.
+  EXPECT_EQ(nullptr, dom_analysis->GetDomTree().GetTreeNode(9));
+  EXPECT_EQ(nullptr, post_analysis->GetDomTree().GetTreeNode(10));
+  EXPECT_EQ(5u, IdOrZero(dom_analysis->ImmediateDominator(8)));
+
+  ExpectSameAsRebuilt(dom_analysis->GetDomTree(), f, *context->cfg());
+  ExpectSameAsRebuilt(post_analysis->GetDomTree(), f, *context->cfg());
+}
+
+}  // anonymous namespace
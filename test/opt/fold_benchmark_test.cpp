@@ -0,0 +1,142 @@
+// Copyright (c) 2018 Google LLC
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+// Measures the throughput of the instruction folder on a large module full of
+// constant arithmetic, and checks that the instructions fold the way they
+// should.
+
+#include <memory>
+#include <sstream>
+#include <string>
+#include <vector>
+
+#include <gmock/gmock.h>
+
+#include "benchmark_utils.h"
+#include "opt/build_module.h"
+#include "opt/fold.h"
+#include "opt/ir_context.h"
+
+namespace {
+
+using namespace spvtools;
+
+// The number of times each measured operation is repeated.
+const int kIterations = 10;
+
+// Returns the assembly for a function with |num_groups| groups of
+// instructions.  In each group, the first five instructions fold to
+// constants: a scalar and a vector float operation, a vector comparison and
+// extracts from a constant and a null vector.  The last two operate on a
+// loaded value, so they have folding rules but can't be folded.
+std::string MakeLargeModule(int num_groups) {
+  std::ostringstream ss;
+  ss << spvtest::ShaderHeader() << R"(%void = OpTypeVoid
+%voidfn = OpTypeFunction %void
+%bool = OpTypeBool
+%float = OpTypeFloat 32
+%v4bool = OpTypeVector %bool 4
+%v4float = OpTypeVector %float 4
+%ptr = OpTypePointer Function %float
+%float_2 = OpConstant %float 2
+%float_3 = OpConstant %float 3
+%v4_a = OpConstantComposite %v4float %float_2 %float_3 %float_2 %float_3
+%v4_b = OpConstantComposite %v4float %float_3 %float_3 %float_2 %float_2
+%v4_null = OpConstantNull %v4float
+%main = OpFunction %void None %voidfn
+%entry = OpLabel
+%var = OpVariable %ptr Function
+%load = OpLoad %float %var
+)";
+  for (int i = 0; i < num_groups; ++i) {
+    ss << "%fadd" << i << " = OpFAdd %float %float_2 %float_3\n"
+       << "%vmul" << i << " = OpFMul %v4float %v4_a %v4_b\n"
+       << "%vcmp" << i << " = OpFOrdLessThan %v4bool %v4_a %v4_null\n"
+       << "%ext" << i << " = OpCompositeExtract %float %v4_a 1\n"
+       << "%next" << i << " = OpCompositeExtract %float %v4_null 2\n"
+       << "%fmul" << i << " = OpFMul %float %load %float_3\n"
+       << "%fsub" << i << " = OpFSub %float %load %float_2\n";
+  }
+  ss << R"(OpReturn
+OpFunctionEnd
+)";
+  return ss.str();
+}
+
+// Runs |fn| on every instruction in |insts| kIterations times, and records
+// the number of instructions processed per second as the test property
+// |name|.
+template <class Fn>
+void RecordInstructionsPerSecond(const std::string& name,
+                                 const std::vector<ir::Instruction*>& insts,
+                                 Fn fn) {
+  const double seconds = spvtest::SecondsToRun(kIterations, [&]() {
+    for (ir::Instruction* inst : insts) fn(inst);
+  });
+  spvtest::RecordRate(name, static_cast<double>(insts.size()) * kIterations,
+                      seconds);
+}
+
+class FoldBenchmark : public ::testing::TestWithParam<int> {};
+
+TEST_P(FoldBenchmark, Throughput) {
+  std::unique_ptr<ir::IRContext> context =
+      BuildModule(SPV_ENV_UNIVERSAL_1_1, nullptr, MakeLargeModule(GetParam()));
+  ASSERT_NE(nullptr, context);
+  std::vector<ir::Instruction*> insts;
+  for (ir::Instruction& inst : *context->module()->begin()->begin()) {
+    if (inst.opcode() != SpvOpVariable && inst.opcode() != SpvOpLoad &&
+        inst.opcode() != SpvOpReturn) {
+      insts.push_back(&inst);
+    }
+  }
+  ASSERT_EQ(7u * GetParam(), insts.size());
+  // The last two instructions of each group can't be folded.
+  std::vector<ir::Instruction*> unfoldable;
+  for (size_t i = 0; i < insts.size(); ++i) {
+    if (i % 7 >= 5) unfoldable.push_back(insts[i]);
+  }
+
+  // The constants made by the first folds are reused by the later ones, so
+  // this mostly measures the dispatch and the folding itself.  The
+  // instructions are left as they are.
+  RecordProperty("instructions", static_cast<int>(insts.size()));
+  int num_folded = 0;
+  RecordInstructionsPerSecond(
+      "folds_to_constant_per_second", insts,
+      [&num_folded](ir::Instruction* inst) {
+        if (opt::FoldInstructionToConstant(inst,
+                                           [](uint32_t id) { return id; })) {
+          ++num_folded;
+        }
+      });
+  EXPECT_EQ(5 * GetParam() * kIterations, num_folded);
+
+  // FoldInstruction rewrites the instructions it folds, so it is only run on
+  // the ones that go through every rule without being changed.
+  int num_simplified = 0;
+  RecordInstructionsPerSecond("failed_folds_per_second", unfoldable,
+                              [&num_simplified](ir::Instruction* inst) {
+                                if (opt::FoldInstruction(inst)) {
+                                  ++num_simplified;
+                                }
+                              });
+  EXPECT_EQ(0, num_simplified);
+}
+
+INSTANTIATE_TEST_CASE_P(ModuleSizes, FoldBenchmark, ::testing::Values(100));
+INSTANTIATE_TEST_CASE_P(DISABLED_LargeModuleSizes, FoldBenchmark,
+                        ::testing::Values(10000));
+
+}  // anonymous namespace
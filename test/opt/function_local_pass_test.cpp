@@ -0,0 +1,249 @@
+// Copyright (c) 2018 Google LLC
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+// Checks that the function-local passes produce the same module whether they
+// process the functions one after the other or in parallel.
+
+#include <atomic>
+#include <memory>
+#include <sstream>
+#include <string>
+#include <vector>
+
+#include <gmock/gmock.h>
+
+#include "opt/build_module.h"
+#include "opt/ir_context.h"
+#include "opt/local_redundancy_elimination.h"
+#include "opt/local_single_block_elim_pass.h"
+#include "opt/local_ssa_elim_pass.h"
+#include "opt/redundancy_elimination.h"
+#include "opt/strength_reduction_pass.h"
+
+namespace {
+
+using namespace spvtools;
+
+// Returns the assembly for a module whose entry point calls |num_functions|
+// functions of the same shape.  Each of them has a forwardable load, a
+// redundant add, multiplications by powers of 2, and a variable that is only
+// stored on one path.  The module has no unsigned type, so the strength
+// reduction creates the same type and constants in every function.
+std::string MakeModule(int num_functions) {
+  std::ostringstream ss;
+  ss << R"(OpCapability Shader
+OpMemoryModel Logical GLSL450
+OpEntryPoint Fragment %main "main"
+OpExecutionMode %main OriginUpperLeft
+OpName %main "main"
+)";
+  for (int i = 0; i < num_functions; ++i) {
+    ss << "OpName %f" << i << " \"f" << i << "\"\n"
+       << "OpName %v" << i << " \"v" << i << "\"\n"
+       << "OpName %w" << i << " \"w" << i << "\"\n";
+  }
+  ss << R"(%void = OpTypeVoid
+%voidfn = OpTypeFunction %void
+%bool = OpTypeBool
+%int = OpTypeInt 32 1
+%intfn = OpTypeFunction %int %int
+%ptr = OpTypePointer Function %int
+%one = OpConstant %int 1
+%int_4 = OpConstant %int 4
+%int_8 = OpConstant %int 8
+%main = OpFunction %void None %voidfn
+%main_entry = OpLabel
+)";
+  for (int i = 0; i < num_functions; ++i) {
+    ss << "%r" << i << " = OpFunctionCall %int %f" << i << " %one\n";
+  }
+  ss << "OpReturn\nOpFunctionEnd\n";
+  for (int i = 0; i < num_functions; ++i) {
+    ss << "%f" << i << " = OpFunction %int None %intfn\n"
+       << "%p" << i << " = OpFunctionParameter %int\n"
+       << "%e" << i << " = OpLabel\n"
+       << "%v" << i << " = OpVariable %ptr Function\n"
+       << "%w" << i << " = OpVariable %ptr Function\n"
+       << "OpStore %v" << i << " %p" << i << "\n"
+       << "%a" << i << " = OpIAdd %int %p" << i << " %one\n"
+       << "%b" << i << " = OpIAdd %int %p" << i << " %one\n"
+       << "%c" << i << " = OpIMul %int %a" << i << " %int_4\n"
+       << "%d" << i << " = OpIMul %int %b" << i << " %int_8\n"
+       << "%l" << i << " = OpLoad %int %v" << i << "\n"
+       << "%cond" << i << " = OpSLessThan %bool %l" << i << " %c" << i << "\n"
+       << "OpSelectionMerge %m" << i << " None\n"
+       << "OpBranchConditional %cond" << i << " %t" << i << " %m" << i << "\n"
+       << "%t" << i << " = OpLabel\n"
+       << "OpStore %w" << i << " %d" << i << "\n"
+       << "OpBranch %m" << i << "\n"
+       << "%m" << i << " = OpLabel\n"
+       << "%x" << i << " = OpLoad %int %w" << i << "\n"
+       << "OpReturnValue %x" << i << "\n"
+       << "OpFunctionEnd\n";
+  }
+  return ss.str();
+}
+
+// Runs a new instance of |PassT| on |text| with |thread_count| threads, and
+// returns the resulting binary.  Sets |status| to the status of the pass.
+template <class PassT>
+std::vector<uint32_t> RunPass(const std::string& text, uint32_t thread_count,
+                              opt::Pass::Status* status) {
+  std::unique_ptr<ir::IRContext> context =
+      BuildModule(SPV_ENV_UNIVERSAL_1_2, nullptr, text,
+                  SPV_TEXT_TO_BINARY_OPTION_PRESERVE_NUMERIC_IDS);
+  std::vector<uint32_t> binary;
+  EXPECT_NE(nullptr, context);
+  if (context == nullptr) return binary;
+  context->SetThreadCount(thread_count);
+  PassT pass;
+  *status = pass.Run(context.get());
+  context->module()->ToBinary(&binary, /* skip_nop = */ false);
+  return binary;
+}
+
+template <class PassT>
+void ExpectSameInParallel() {
+  const std::string text = MakeModule(9);
+  opt::Pass::Status serial_status = opt::Pass::Status::Failure;
+  const std::vector<uint32_t> serial =
+      RunPass<PassT>(text, 1, &serial_status);
+  EXPECT_EQ(opt::Pass::Status::SuccessWithChange, serial_status);
+  for (uint32_t thread_count : {2u, 4u, 16u}) {
+    opt::Pass::Status status = opt::Pass::Status::Failure;
+    EXPECT_EQ(serial, RunPass<PassT>(text, thread_count, &status))
+        << thread_count << " threads";
+    EXPECT_EQ(serial_status, status) << thread_count << " threads";
+  }
+}
+
+TEST(FunctionLocalPassTest, LocalSingleBlockLoadStoreElim) {
+  ExpectSameInParallel<opt::LocalSingleBlockLoadStoreElimPass>();
+}
+
+TEST(FunctionLocalPassTest, LocalMultiStoreElim) {
+  ExpectSameInParallel<opt::LocalMultiStoreElimPass>();
+}
+
+TEST(FunctionLocalPassTest, LocalRedundancyElimination) {
+  ExpectSameInParallel<opt::LocalRedundancyEliminationPass>();
+}
+
+TEST(FunctionLocalPassTest, RedundancyElimination) {
+  ExpectSameInParallel<opt::RedundancyEliminationPass>();
+}
+
+TEST(FunctionLocalPassTest, StrengthReduction) {
+  ExpectSameInParallel<opt::StrengthReductionPass>();
+}
+
+// %main loads %g on both sides of a call to %set, which stores to %g.  With
+// two threads, %main and %set are processed in different copies of the module,
+// and the copy with %main has no store to %g.
+const char kLoadsAroundCall[] = R"(OpCapability Shader
+OpMemoryModel Logical GLSL450
+OpEntryPoint Fragment %main "main"
+OpExecutionMode %main OriginUpperLeft
+%void = OpTypeVoid
+%voidfn = OpTypeFunction %void
+%int = OpTypeInt 32 1
+%ptr = OpTypePointer Private %int
+%one = OpConstant %int 1
+%g = OpVariable %ptr Private
+%main = OpFunction %void None %voidfn
+%main_entry = OpLabel
+%l1 = OpLoad %int %g
+%call = OpFunctionCall %void %set
+%l2 = OpLoad %int %g
+%sum = OpIAdd %int %l1 %l2
+OpReturn
+OpFunctionEnd
+%set = OpFunction %void None %voidfn
+%set_entry = OpLabel
+OpStore %g %one
+OpReturn
+OpFunctionEnd
+)";
+
+template <class PassT>
+void ExpectLoadsAroundCallKept() {
+  for (uint32_t thread_count : {1u, 2u}) {
+    opt::Pass::Status status = opt::Pass::Status::Failure;
+    RunPass<PassT>(kLoadsAroundCall, thread_count, &status);
+    EXPECT_EQ(opt::Pass::Status::SuccessWithoutChange, status)
+        << thread_count << " threads";
+  }
+}
+
+TEST(FunctionLocalPassTest, LocalRedundancyEliminationKeepsLoadsAroundCall) {
+  ExpectLoadsAroundCallKept<opt::LocalRedundancyEliminationPass>();
+}
+
+TEST(FunctionLocalPassTest, RedundancyEliminationKeepsLoadsAroundCall) {
+  ExpectLoadsAroundCallKept<opt::RedundancyEliminationPass>();
+}
+
+// A function-local pass that turns the OpCopyObject instructions into OpNop,
+// and only applies to modules that have all their functions.  It counts the
+// contexts it was offered that did not, which are processed in parallel.
+class WholeModulePass : public opt::Pass {
+ public:
+  explicit WholeModulePass(std::atomic<int>* partial_contexts)
+      : partial_contexts_(partial_contexts) {}
+
+  const char* name() const override { return "whole-module"; }
+  Status Process(ir::IRContext* c) override {
+    return ProcessFunctionLocalPass(c);
+  }
+
+ protected:
+  std::unique_ptr<opt::Pass> CloneFunctionLocal() const override {
+    return std::unique_ptr<opt::Pass>(new WholeModulePass(partial_contexts_));
+  }
+  bool InitializeFunctionLocal(ir::IRContext* c) override {
+    InitializeProcessing(c);
+    if (c->has_all_functions()) return true;
+    ++*partial_contexts_;
+    return false;
+  }
+  bool ProcessFunctionLocal(ir::Function* func) override {
+    EXPECT_TRUE(context()->has_all_functions());
+    bool modified = false;
+    func->ForEachInst([&modified](ir::Instruction* inst) {
+      if (inst->opcode() == SpvOpCopyObject) {
+        inst->ToNop();
+        modified = true;
+      }
+    });
+    return modified;
+  }
+
+ private:
+  std::atomic<int>* partial_contexts_;
+};
+
+TEST(FunctionLocalPassTest, PassesCanRequireAllFunctions) {
+  std::unique_ptr<ir::IRContext> context =
+      BuildModule(SPV_ENV_UNIVERSAL_1_2, nullptr, MakeModule(4),
+                  SPV_TEXT_TO_BINARY_OPTION_PRESERVE_NUMERIC_IDS);
+  ASSERT_NE(nullptr, context);
+  context->SetThreadCount(2);
+  std::atomic<int> partial_contexts(0);
+  WholeModulePass pass(&partial_contexts);
+  // The module has no copies, so the pass applies but doesn't change it.
+  EXPECT_EQ(opt::Pass::Status::SuccessWithoutChange, pass.Run(context.get()));
+  EXPECT_EQ(2, partial_contexts.load());
+}
+
+}  // anonymous namespace
@@ -13,6 +13,12 @@
 // See the License for the specific language governing permissions and
 // limitations under the License.
 
+#include <memory>
+#include <string>
+#include <vector>
+
+#include <gmock/gmock.h>
+
 #include "pass_fixture.h"
 #include "pass_utils.h"
 
@@ -20,6 +26,7 @@ namespace {
 
 using namespace spvtools;
 
+using ::testing::HasSubstr;
 using InlineTest = PassTest<::testing::Test>;
 
 TEST_F(InlineTest, Simple) {
@@ -2587,6 +2594,96 @@ TEST_F(InlineTest, SetParent) {
   }
 }
 
+// %main calls %small and %big, and %big calls %small as well.  Once
+// inlined, %small adds 1 instruction to its caller, and %big adds 6.
+const std::string kBudgetText = R"(
+OpCapability Shader
+OpMemoryModel Logical GLSL450
+OpEntryPoint Fragment %main "main"
+OpExecutionMode %main OriginUpperLeft
+%void = OpTypeVoid
+%voidfn = OpTypeFunction %void
+%float = OpTypeFloat 32
+%floatfn = OpTypeFunction %float
+%one = OpConstant %float 1
+%main = OpFunction %void None %voidfn
+%entry = OpLabel
+%c1 = OpFunctionCall %float %small
+%c2 = OpFunctionCall %float %big
+OpReturn
+OpFunctionEnd
+%small = OpFunction %float None %floatfn
+%small_entry = OpLabel
+%s1 = OpFAdd %float %one %one
+OpReturnValue %s1
+OpFunctionEnd
+%big = OpFunction %float None %floatfn
+%big_entry = OpLabel
+%b1 = OpFunctionCall %float %small
+%b2 = OpFAdd %float %b1 %one
+%b3 = OpFAdd %float %b2 %one
+%b4 = OpFAdd %float %b3 %one
+%b5 = OpFAdd %float %b4 %one
+OpReturnValue %b5
+OpFunctionEnd
+)";
+
+// Returns the number of calls in each function of |module|, in order.
+std::vector<int> CountCalls(ir::Module* module) {
+  std::vector<int> counts;
+  for (ir::Function& func : *module) {
+    counts.push_back(0);
+    func.ForEachInst([&counts](const ir::Instruction* inst) {
+      if (inst->opcode() == SpvOpFunctionCall) ++counts.back();
+    });
+  }
+  return counts;
+}
+
+TEST_F(InlineTest, NoBudgetInlinesEveryCall) {
+  std::unique_ptr<ir::IRContext> context =
+      BuildModule(SPV_ENV_UNIVERSAL_1_2, nullptr, kBudgetText);
+  opt::InlineExhaustivePass pass;
+  EXPECT_EQ(opt::Pass::Status::SuccessWithChange, pass.Run(context.get()));
+  // %big is not processed, since %main no longer calls it.
+  EXPECT_EQ((std::vector<int>{0, 0, 1}), CountCalls(context->module()));
+  EXPECT_EQ(3u, pass.inline_stats().calls_inlined);
+  EXPECT_EQ(0u, pass.inline_stats().calls_over_budget);
+  EXPECT_LT(0u, pass.inline_stats().instructions_inlined);
+}
+
+TEST_F(InlineTest, BudgetLeavesLargeCallsInPlace) {
+  std::unique_ptr<ir::IRContext> context =
+      BuildModule(SPV_ENV_UNIVERSAL_1_2, nullptr, kBudgetText);
+  std::vector<std::string> messages;
+  opt::InlineExhaustivePass pass(3);
+  pass.SetMessageConsumer([&messages](spv_message_level_t, const char*,
+                                      const spv_position_t&,
+                                      const char* message) {
+    messages.push_back(message);
+  });
+  EXPECT_EQ(opt::Pass::Status::SuccessWithChange, pass.Run(context.get()));
+  // The call to %small in %main fits, and leaves 2 instructions for the call
+  // to %big, which needs 6.  %big is then processed, and the call to %small
+  // it has fits.
+  EXPECT_EQ((std::vector<int>{1, 0, 0}), CountCalls(context->module()));
+  EXPECT_EQ(2u, pass.inline_stats().calls_inlined);
+  EXPECT_EQ(1u, pass.inline_stats().calls_over_budget);
+  ASSERT_EQ(1u, messages.size());
+  EXPECT_THAT(messages[0], HasSubstr("inlined 2 calls"));
+  EXPECT_THAT(messages[0], HasSubstr("1 calls over budget"));
+}
+
+TEST_F(InlineTest, BudgetCoversNestedCalls) {
+  std::unique_ptr<ir::IRContext> context =
+      BuildModule(SPV_ENV_UNIVERSAL_1_2, nullptr, kBudgetText);
+  opt::InlineExhaustivePass pass(7);
+  EXPECT_EQ(opt::Pass::Status::SuccessWithChange, pass.Run(context.get()));
+  EXPECT_EQ((std::vector<int>{0, 0, 1}), CountCalls(context->module()));
+  EXPECT_EQ(3u, pass.inline_stats().calls_inlined);
+  EXPECT_EQ(0u, pass.inline_stats().calls_over_budget);
+}
+
 // TODO(greg-lunarg): Add tests to verify handling of these cases:
 //
 //    Empty modules
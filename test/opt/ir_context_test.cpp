@@ -16,6 +16,7 @@
 #include <gtest/gtest.h>
 #include <algorithm>
 
+#include "opt/constants.h"
 #include "opt/ir_context.h"
 #include "opt/pass.h"
 #include "pass_fixture.h"
@@ -205,6 +206,96 @@ TEST_F(IRContextTest, KillMemberName) {
   }
 }
 
+TEST_F(IRContextTest, ConstantManagerMapsIdsOnDemand) {
+  const std::string text = R"(
+               OpCapability Shader
+               OpMemoryModel Logical GLSL450
+               OpEntryPoint Fragment %1 "main"
+               OpExecutionMode %1 OriginUpperLeft
+          %2 = OpTypeVoid
+          %3 = OpTypeFunction %2
+          %4 = OpTypeInt 32 1
+          %5 = OpTypeVector %4 2
+          %6 = OpConstant %4 1
+          %7 = OpConstant %4 2
+          %8 = OpConstantComposite %5 %6 %7
+          %9 = OpConstant %4 1
+          %1 = OpFunction %2 None %3
+         %10 = OpLabel
+               OpReturn
+               OpFunctionEnd
+)";
+
+  std::unique_ptr<ir::IRContext> context =
+      BuildModule(SPV_ENV_UNIVERSAL_1_2, nullptr, text);
+  opt::analysis::ConstantManager* const_mgr = context->get_constant_mgr();
+
+  // The components of %8 are mapped along with it.
+  const opt::analysis::Constant* composite = const_mgr->FindDeclaredConstant(8);
+  ASSERT_NE(nullptr, composite);
+  ASSERT_NE(nullptr, composite->AsVectorConstant());
+  EXPECT_EQ(const_mgr->FindDeclaredConstant(6),
+            composite->AsVectorConstant()->GetComponents()[0]);
+  EXPECT_EQ(const_mgr->FindDeclaredConstant(7),
+            composite->AsVectorConstant()->GetComponents()[1]);
+  EXPECT_EQ(nullptr, const_mgr->FindDeclaredConstant(4));
+  EXPECT_EQ(nullptr, const_mgr->FindDeclaredConstant(10));
+
+  // %6 and %9 declare the same value, and the last declaration is found.
+  const opt::analysis::Constant* one = const_mgr->FindDeclaredConstant(6);
+  EXPECT_EQ(one, const_mgr->FindDeclaredConstant(9));
+  EXPECT_EQ(9u, const_mgr->FindDeclaredConstant(one));
+  EXPECT_EQ(8u, const_mgr->FindDeclaredConstant(composite));
+
+  context->KillDef(8);
+  EXPECT_EQ(nullptr, const_mgr->FindDeclaredConstant(8));
+  EXPECT_EQ(0u, const_mgr->FindDeclaredConstant(composite));
+}
+
+TEST_F(IRContextTest, TreesAreCountedWhenTheyAreConstructed) {
+  const std::string text = R"(
+               OpCapability Shader
+               OpMemoryModel Logical GLSL450
+               OpEntryPoint Fragment %1 "main"
+               OpExecutionMode %1 OriginUpperLeft
+          %2 = OpTypeVoid
+          %3 = OpTypeFunction %2
+          %1 = OpFunction %2 None %3
+          %4 = OpLabel
+               OpReturn
+               OpFunctionEnd
+)";
+
+  std::unique_ptr<ir::IRContext> context =
+      BuildModule(SPV_ENV_UNIVERSAL_1_2, nullptr, text);
+  const uint32_t kDominators = 5;
+  const uint32_t kLoops = 6;
+  ASSERT_EQ(uint32_t(IRContext::kAnalysisDominatorAnalysis), 1u << kDominators);
+  ASSERT_EQ(uint32_t(IRContext::kAnalysisLoopAnalysis), 1u << kLoops);
+
+  // Resetting the caches makes them valid but constructs nothing.
+  context->BuildInvalidAnalyses(IRContext::kAnalysisDominatorAnalysis |
+                                IRContext::kAnalysisLoopAnalysis);
+  EXPECT_EQ(0u, context->analysis_counts().built[kDominators]);
+  EXPECT_EQ(0u, context->analysis_counts().built[kLoops]);
+
+  const ir::Function* function = &*context->module()->begin();
+  context->GetDominatorAnalysis(function, *context->cfg());
+  context->GetDominatorAnalysis(function, *context->cfg());
+  EXPECT_EQ(1u, context->analysis_counts().built[kDominators]);
+  context->GetPostDominatorAnalysis(function, *context->cfg());
+  EXPECT_EQ(2u, context->analysis_counts().built[kDominators]);
+
+  context->GetLoopDescriptor(function);
+  context->GetLoopDescriptor(function);
+  EXPECT_EQ(1u, context->analysis_counts().built[kLoops]);
+
+  // Invalidating and asking again constructs the trees from scratch.
+  context->InvalidateAnalyses(IRContext::kAnalysisDominatorAnalysis);
+  context->GetDominatorAnalysis(function, *context->cfg());
+  EXPECT_EQ(3u, context->analysis_counts().built[kDominators]);
+}
+
 TEST_F(IRContextTest, TakeNextUniqueIdIncrementing) {
   const uint32_t NUM_TESTS = 1000;
   IRContext localContext(SPV_ENV_UNIVERSAL_1_2, nullptr);
@@ -0,0 +1,140 @@
+// Copyright (c) 2018 Google LLC
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+// Measures the time and memory LocalMultiStoreElimPass takes to rewrite a
+// large function with many local variables, and checks that every local
+// variable is rewritten.
+
+#include <memory>
+#include <sstream>
+#include <string>
+
+#include <gmock/gmock.h>
+
+#include "benchmark_utils.h"
+#include "opt/build_module.h"
+#include "opt/ir_context.h"
+#include "opt/local_ssa_elim_pass.h"
+#include "util/timer.h"
+
+namespace {
+
+using namespace spvtools;
+
+// Returns the assembly for a function with |num_vars| pairs of local
+// variables, and a loop whose body is a chain of |num_selections| if-then-else
+// constructs.  Each of them updates one variable through a temporary in the
+// then branch, and overwrites another in the else branch.  Only the first
+// variable is used after the loop, and the temporaries are dead outside of
+// the blocks that store them.
+std::string MakeLargeModule(int num_vars, int num_selections) {
+  std::ostringstream ss;
+  ss << spvtest::ShaderHeader("%in %out") << R"(%void = OpTypeVoid
+%voidfn = OpTypeFunction %void
+%bool = OpTypeBool
+%float = OpTypeFloat 32
+%ptr = OpTypePointer Function %float
+%in_ptr = OpTypePointer Input %float
+%out_ptr = OpTypePointer Output %float
+%in = OpVariable %in_ptr Input
+%out = OpVariable %out_ptr Output
+%zero = OpConstant %float 0
+%one = OpConstant %float 1
+%main = OpFunction %void None %voidfn
+%entry = OpLabel
+)";
+  for (int i = 0; i < num_vars; ++i) {
+    ss << "%var" << i << " = OpVariable %ptr Function\n"
+       << "%tmp" << i << " = OpVariable %ptr Function\n";
+  }
+  for (int i = 0; i < num_vars; ++i) ss << "OpStore %var" << i << " %zero\n";
+  ss << R"(%x = OpLoad %float %in
+%cond = OpFOrdLessThan %bool %x %one
+OpBranch %header
+%header = OpLabel
+OpLoopMerge %exit %latch None
+OpBranch %sel0
+)";
+  for (int i = 0; i < num_selections; ++i) {
+    const int a = i % num_vars;
+    const int b = (i + 1) % num_vars;
+    ss << "%sel" << i << " = OpLabel\n"
+       << "OpSelectionMerge %sel" << i + 1 << " None\n"
+       << "OpBranchConditional %cond %then" << i << " %else" << i << "\n"
+       << "%then" << i << " = OpLabel\n"
+       << "%a" << i << " = OpLoad %float %var" << a << "\n"
+       << "%s" << i << " = OpFAdd %float %a" << i << " %one\n"
+       << "OpStore %tmp" << a << " %s" << i << "\n"
+       << "%u" << i << " = OpLoad %float %tmp" << a << "\n"
+       << "OpStore %var" << a << " %u" << i << "\n"
+       << "OpBranch %sel" << i + 1 << "\n"
+       << "%else" << i << " = OpLabel\n"
+       << "OpStore %var" << b << " %x\n"
+       << "OpBranch %sel" << i + 1 << "\n";
+  }
+  ss << "%sel" << num_selections << R"( = OpLabel
+OpBranch %latch
+%latch = OpLabel
+OpBranchConditional %cond %header %exit
+%exit = OpLabel
+%r = OpLoad %float %var0
+OpStore %out %r
+OpReturn
+OpFunctionEnd
+)";
+  return ss.str();
+}
+
+class LocalSSAElimBenchmark : public ::testing::TestWithParam<int> {};
+
+TEST_P(LocalSSAElimBenchmark, RewriteLargeFunction) {
+  const int num_selections = GetParam();
+  const int num_vars = num_selections / 8;
+  std::unique_ptr<ir::IRContext> context =
+      BuildModule(SPV_ENV_UNIVERSAL_1_1, nullptr,
+                  MakeLargeModule(num_vars, num_selections));
+  ASSERT_NE(nullptr, context);
+
+  opt::LocalMultiStoreElimPass pass;
+  const spvutils::ResourceUsage before = spvutils::GetResourceUsage();
+  EXPECT_EQ(opt::Pass::Status::SuccessWithChange, pass.Run(context.get()));
+  const spvutils::ResourceUsage after = spvutils::GetResourceUsage();
+
+  // Only the load of the input and the store of the output are left.
+  int num_loads = 0;
+  int num_stores = 0;
+  int num_phis = 0;
+  context->module()->ForEachInst([&](const ir::Instruction* inst) {
+    if (inst->opcode() == SpvOpLoad) ++num_loads;
+    if (inst->opcode() == SpvOpStore) ++num_stores;
+    if (inst->opcode() == SpvOpPhi) ++num_phis;
+  });
+  EXPECT_EQ(1, num_loads);
+  EXPECT_EQ(1, num_stores);
+
+  RecordProperty("selections", num_selections);
+  RecordProperty("variables", 2 * num_vars);
+  RecordProperty("phis", num_phis);
+  spvtest::RecordMilliseconds("milliseconds",
+                              after.wall_seconds - before.wall_seconds);
+  RecordProperty("peak_rss_growth_kb",
+                 static_cast<int>(after.peak_rss_kb - before.peak_rss_kb));
+}
+
+INSTANTIATE_TEST_CASE_P(ModuleSizes, LocalSSAElimBenchmark,
+                        ::testing::Values(100));
+INSTANTIATE_TEST_CASE_P(DISABLED_LargeModuleSizes, LocalSSAElimBenchmark,
+                        ::testing::Values(2000));
+
+}  // anonymous namespace
@@ -254,14 +254,12 @@ OpFunctionEnd
 )";
 
   const std::string after =
-      R"(%46 = OpUndef %float
-%main = OpFunction %void None %9
+      R"(%main = OpFunction %void None %9
 %23 = OpLabel
 OpBranch %24
 %24 = OpLabel
-%44 = OpPhi %float %float_0 %23 %48 %26
+%44 = OpPhi %float %float_0 %23 %46 %26
 %45 = OpPhi %int %int_0 %23 %42 %26
-%47 = OpPhi %float %46 %23 %33 %26
 OpLoopMerge %25 %26 None
 OpBranch %27
 %27 = OpLabel
@@ -279,7 +277,7 @@ OpBranch %26
 %40 = OpFAdd %float %44 %33
 OpBranch %26
 %26 = OpLabel
-%48 = OpPhi %float %44 %37 %40 %36
+%46 = OpPhi %float %44 %37 %40 %36
 %42 = OpIAdd %int %45 %int_1
 OpBranch %24
 %25 = OpLabel
@@ -402,14 +400,12 @@ OpFunctionEnd
 )";
 
   const std::string after =
-      R"(%47 = OpUndef %float
-%main = OpFunction %void None %9
+      R"(%main = OpFunction %void None %9
 %24 = OpLabel
 OpBranch %25
 %25 = OpLabel
 %45 = OpPhi %float %float_0 %24 %36 %27
 %46 = OpPhi %int %int_0 %24 %43 %27
-%48 = OpPhi %float %47 %24 %36 %27
 OpLoopMerge %26 %27 None
 OpBranch %28
 %28 = OpLabel
@@ -430,7 +426,6 @@ OpBranch %27
 %43 = OpIAdd %int %46 %int_1
 OpBranch %25
 %26 = OpLabel
-%49 = OpPhi %float %48 %28 %36 %40
 OpStore %fo %45
 OpReturn
 OpFunctionEnd
@@ -548,8 +543,7 @@ OpFunctionEnd
 )";
 
   const std::string after =
-      R"(%43 = OpUndef %float
-%main = OpFunction %void None %11
+      R"(%main = OpFunction %void None %11
 %23 = OpLabel
 %24 = OpLoad %float %fe
 %25 = OpConvertFToS %int %24
@@ -558,7 +552,6 @@ OpBranch %26
 %40 = OpPhi %float %float_0 %23 %41 %28
 %41 = OpPhi %float %float_1 %23 %40 %28
 %42 = OpPhi %int %int_0 %23 %38 %28
-%44 = OpPhi %float %43 %23 %40 %28
 OpLoopMerge %27 %28 None
 OpBranch %29
 %29 = OpLabel
@@ -718,9 +711,8 @@ OpBranch %27
 %43 = OpIAdd %int %46 %int_1
 OpBranch %25
 %26 = OpLabel
-%49 = OpPhi %float %45 %28 %37 %41
-%50 = OpPhi %float %48 %28 %45 %41
-OpStore %fo %50
+%49 = OpPhi %float %48 %28 %45 %41
+OpStore %fo %49
 OpReturn
 OpFunctionEnd
 )";
@@ -1704,6 +1696,150 @@ OpFunctionEnd
   EXPECT_TRUE(status == opt::Pass::Status::SuccessWithChange);
 }
 
+#ifdef SPIRV_EFFCEE
+TEST_F(LocalSSAElimTest, NoPhiForVariableDeadAtMerge) {
+  // v is stored and loaded in each branch, but not after the selection, so
+  // the merge block needs no phi for it.
+  const std::string text = R"(
+; CHECK: OpSelectionMerge [[merge:%\w+]] None
+; CHECK: [[val1:%\w+]] = OpVectorTimesScalar
+; CHECK-NEXT: OpStore %gl_FragColor [[val1]]
+; CHECK: [[val2:%\w+]] = OpLoad %v4float %BaseColor
+; CHECK-NEXT: OpStore %gl_FragColor [[val2]]
+; CHECK: [[merge]] = OpLabel
+; CHECK-NEXT: OpReturn
+OpCapability Shader
+%1 = OpExtInstImport "GLSL.std.450"
+OpMemoryModel Logical GLSL450
+OpEntryPoint Fragment %main "main" %f %BaseColor %gl_FragColor
+OpExecutionMode %main OriginUpperLeft
+OpName %main "main"
+OpName %f "f"
+OpName %v "v"
+OpName %BaseColor "BaseColor"
+OpName %gl_FragColor "gl_FragColor"
+%void = OpTypeVoid
+%8 = OpTypeFunction %void
+%float = OpTypeFloat 32
+%_ptr_Input_float = OpTypePointer Input %float
+%f = OpVariable %_ptr_Input_float Input
+%float_0 = OpConstant %float 0
+%bool = OpTypeBool
+%v4float = OpTypeVector %float 4
+%_ptr_Function_v4float = OpTypePointer Function %v4float
+%_ptr_Input_v4float = OpTypePointer Input %v4float
+%BaseColor = OpVariable %_ptr_Input_v4float Input
+%float_0_5 = OpConstant %float 0.5
+%_ptr_Output_v4float = OpTypePointer Output %v4float
+%gl_FragColor = OpVariable %_ptr_Output_v4float Output
+%main = OpFunction %void None %8
+%20 = OpLabel
+%v = OpVariable %_ptr_Function_v4float Function
+%21 = OpLoad %float %f
+%22 = OpFOrdGreaterThanEqual %bool %21 %float_0
+OpSelectionMerge %23 None
+OpBranchConditional %22 %24 %25
+%24 = OpLabel
+%26 = OpLoad %v4float %BaseColor
+%27 = OpVectorTimesScalar %v4float %26 %float_0_5
+OpStore %v %27
+%28 = OpLoad %v4float %v
+OpStore %gl_FragColor %28
+OpBranch %23
+%25 = OpLabel
+%29 = OpLoad %v4float %BaseColor
+OpStore %v %29
+%30 = OpLoad %v4float %v
+OpStore %gl_FragColor %30
+OpBranch %23
+%23 = OpLabel
+OpReturn
+OpFunctionEnd
+)";
+
+  SinglePassRunAndMatch<opt::LocalMultiStoreElimPass>(text, true);
+}
+
+TEST_F(LocalSSAElimTest, NoLoopHeaderPhiForVariableStoredBeforeUse) {
+  // t is stored before it is loaded in every iteration, so only f and i need
+  // a phi in the loop header, and no undef is created for t.
+  const std::string text = R"(
+; CHECK-NOT: OpUndef
+; CHECK: %main = OpFunction
+; CHECK: OpBranch [[header:%\w+]]
+; CHECK-NEXT: [[header]] = OpLabel
+; CHECK-NEXT: [[f:%\w+]] = OpPhi %float %float_0
+; CHECK-NEXT: [[i:%\w+]] = OpPhi %int %int_0
+; CHECK-NEXT: OpLoopMerge
+; CHECK: OpSLessThan %bool [[i]] %int_4
+; CHECK: OpFAdd %float [[f]]
+; CHECK: OpStore %fo [[f]]
+OpCapability Shader
+%1 = OpExtInstImport "GLSL.std.450"
+OpMemoryModel Logical GLSL450
+OpEntryPoint Fragment %main "main" %BC %fo
+OpExecutionMode %main OriginUpperLeft
+OpName %main "main"
+OpName %BC "BC"
+OpName %fo "fo"
+%void = OpTypeVoid
+%voidfn = OpTypeFunction %void
+%float = OpTypeFloat 32
+%_ptr_Function_float = OpTypePointer Function %float
+%float_0 = OpConstant %float 0
+%int = OpTypeInt 32 1
+%_ptr_Function_int = OpTypePointer Function %int
+%int_0 = OpConstant %int 0
+%int_4 = OpConstant %int 4
+%int_1 = OpConstant %int 1
+%bool = OpTypeBool
+%v4float = OpTypeVector %float 4
+%_ptr_Input_v4float = OpTypePointer Input %v4float
+%BC = OpVariable %_ptr_Input_v4float Input
+%_ptr_Input_float = OpTypePointer Input %float
+%_ptr_Output_float = OpTypePointer Output %float
+%fo = OpVariable %_ptr_Output_float Output
+%main = OpFunction %void None %voidfn
+%entry = OpLabel
+%f = OpVariable %_ptr_Function_float Function
+%i = OpVariable %_ptr_Function_int Function
+%t = OpVariable %_ptr_Function_float Function
+OpStore %f %float_0
+OpStore %i %int_0
+OpBranch %header
+%header = OpLabel
+OpLoopMerge %merge %continue None
+OpBranch %cond
+%cond = OpLabel
+%i0 = OpLoad %int %i
+%lt = OpSLessThan %bool %i0 %int_4
+OpBranchConditional %lt %body %merge
+%body = OpLabel
+%i1 = OpLoad %int %i
+%ptr = OpAccessChain %_ptr_Input_float %BC %i1
+%bc = OpLoad %float %ptr
+OpStore %t %bc
+%t0 = OpLoad %float %t
+%f0 = OpLoad %float %f
+%sum = OpFAdd %float %f0 %t0
+OpStore %f %sum
+OpBranch %continue
+%continue = OpLabel
+%i2 = OpLoad %int %i
+%inc = OpIAdd %int %i2 %int_1
+OpStore %i %inc
+OpBranch %header
+%merge = OpLabel
+%f1 = OpLoad %float %f
+OpStore %fo %f1
+OpReturn
+OpFunctionEnd
+)";
+
+  SinglePassRunAndMatch<opt::LocalMultiStoreElimPass>(text, true);
+}
+#endif  // SPIRV_EFFCEE
+
 // TODO(greg-lunarg): Add tests to verify handling of these cases:
 //
 //    No optimization in the presence of
@@ -0,0 +1,317 @@
+// Copyright (c) 2018 Google LLC.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include <string>
+
+#include <gmock/gmock.h>
+
+#include "../pass_fixture.h"
+#include "opt/licm_pass.h"
+
+namespace {
+
+using namespace spvtools;
+
+using PassClassTest = PassTest<::testing::Test>;
+
+#ifdef SPIRV_EFFCEE
+/*
+  Loads from a uniform buffer are hoisted with their access chain.  Loads
+  from a storage buffer, volatile loads and loads from function variables
+  stay in the loop.  The loads are in the block that tests the loop
+  condition, which runs whenever the loop does.
+*/
+TEST_F(PassClassTest, HoistUniformLoad) {
+  const std::string text = R"(
+; CHECK: %entry = OpLabel
+; CHECK: OpStore %sum %float_0
+; CHECK-NEXT: %ubo_ptr = OpAccessChain %_ptr_Uniform_float %ubo %int_0
+; CHECK-NEXT: %ubo_val = OpLoad %float %ubo_ptr
+; CHECK-NEXT: %ssbo_ptr = OpAccessChain %_ptr_Uniform_float %ssbo %int_0
+; CHECK-NEXT: OpBranch %header
+; CHECK: %cond_block = OpLabel
+; CHECK-NEXT: %vol_val = OpLoad %float %ubo_ptr Volatile
+; CHECK-NEXT: %ssbo_val = OpLoad %float %ssbo_ptr
+; CHECK-NEXT: %cond = OpSLessThan %bool %i %int_10
+; CHECK: %body = OpLabel
+; CHECK-NEXT: %old = OpLoad %float %sum
+OpCapability Shader
+OpMemoryModel Logical GLSL450
+OpEntryPoint Fragment %main "main"
+OpExecutionMode %main OriginUpperLeft
+OpName %main "main"
+OpName %UBO "UBO"
+OpName %SSBO "SSBO"
+OpName %ubo "ubo"
+OpName %ssbo "ssbo"
+OpName %sum "sum"
+OpName %entry "entry"
+OpName %header "header"
+OpName %body "body"
+OpName %ubo_ptr "ubo_ptr"
+OpName %ubo_val "ubo_val"
+OpName %vol_val "vol_val"
+OpName %ssbo_ptr "ssbo_ptr"
+OpName %ssbo_val "ssbo_val"
+OpName %old "old"
+OpDecorate %UBO Block
+OpMemberDecorate %UBO 0 Offset 0
+OpDecorate %ubo DescriptorSet 0
+OpDecorate %ubo Binding 0
+OpDecorate %SSBO BufferBlock
+OpMemberDecorate %SSBO 0 Offset 0
+OpDecorate %ssbo DescriptorSet 0
+OpDecorate %ssbo Binding 1
+%void = OpTypeVoid
+%voidfn = OpTypeFunction %void
+%bool = OpTypeBool
+%int = OpTypeInt 32 1
+%float = OpTypeFloat 32
+%UBO = OpTypeStruct %float
+%SSBO = OpTypeStruct %float
+%_ptr_Uniform_UBO = OpTypePointer Uniform %UBO
+%_ptr_Uniform_SSBO = OpTypePointer Uniform %SSBO
+%_ptr_Uniform_float = OpTypePointer Uniform %float
+%_ptr_Function_float = OpTypePointer Function %float
+%ubo = OpVariable %_ptr_Uniform_UBO Uniform
+%ssbo = OpVariable %_ptr_Uniform_SSBO Uniform
+%int_0 = OpConstant %int 0
+%int_1 = OpConstant %int 1
+%int_10 = OpConstant %int 10
+%float_0 = OpConstant %float 0
+%main = OpFunction %void None %voidfn
+%entry = OpLabel
+%sum = OpVariable %_ptr_Function_float Function
+OpStore %sum %float_0
+OpBranch %header
+%header = OpLabel
+%i = OpPhi %int %int_0 %entry %i_next %latch
+OpLoopMerge %merge %latch None
+OpBranch %cond_block
+%cond_block = OpLabel
+%ubo_ptr = OpAccessChain %_ptr_Uniform_float %ubo %int_0
+%ubo_val = OpLoad %float %ubo_ptr
+%vol_val = OpLoad %float %ubo_ptr Volatile
+%ssbo_ptr = OpAccessChain %_ptr_Uniform_float %ssbo %int_0
+%ssbo_val = OpLoad %float %ssbo_ptr
+%cond = OpSLessThan %bool %i %int_10
+OpBranchConditional %cond %body %merge
+%body = OpLabel
+%old = OpLoad %float %sum
+%a = OpFAdd %float %old %ubo_val
+%b = OpFAdd %float %a %vol_val
+%c = OpFAdd %float %b %ssbo_val
+OpStore %sum %c
+OpBranch %latch
+%latch = OpLabel
+%i_next = OpIAdd %int %i %int_1
+OpBranch %header
+%merge = OpLabel
+OpReturn
+OpFunctionEnd
+)";
+
+  SinglePassRunAndMatch<opt::LICMPass>(text, false);
+}
+
+/*
+  A load from a push constant in an inner loop is hoisted out of both loops.
+  It is first hoisted to the block before the inner loop, and from there to
+  the block before the outer loop.  The outer loop exits from its latch, so
+  the inner loop runs whenever the outer one does.
+*/
+TEST_F(PassClassTest, HoistPushConstantLoadFromNestedLoops) {
+  const std::string text = R"(
+; CHECK: %entry = OpLabel
+; CHECK: OpStore %sum %float_0
+; CHECK-NEXT: %pc_ptr = OpAccessChain %_ptr_PushConstant_float %pc %int_0
+; CHECK-NEXT: %pc_val = OpLoad %float %pc_ptr
+; CHECK-NEXT: OpBranch %outer_header
+; CHECK: %outer_body = OpLabel
+; CHECK-NEXT: OpBranch %inner_header
+; CHECK: %inner_cond = OpLabel
+; CHECK-NEXT: %inner_test = OpSLessThan %bool %j %int_10
+; CHECK: %inner_body = OpLabel
+; CHECK-NEXT: %old = OpLoad %float %sum
+; CHECK-NEXT: {{%\w+}} = OpFAdd %float %old %pc_val
+OpCapability Shader
+OpMemoryModel Logical GLSL450
+OpEntryPoint Fragment %main "main"
+OpExecutionMode %main OriginUpperLeft
+OpName %main "main"
+OpName %PC "PC"
+OpName %pc "pc"
+OpName %sum "sum"
+OpName %entry "entry"
+OpName %outer_header "outer_header"
+OpName %outer_body "outer_body"
+OpName %inner_header "inner_header"
+OpName %inner_cond "inner_cond"
+OpName %inner_test "inner_test"
+OpName %inner_body "inner_body"
+OpName %j "j"
+OpName %pc_ptr "pc_ptr"
+OpName %pc_val "pc_val"
+OpName %old "old"
+OpDecorate %PC Block
+OpMemberDecorate %PC 0 Offset 0
+%void = OpTypeVoid
+%voidfn = OpTypeFunction %void
+%bool = OpTypeBool
+%int = OpTypeInt 32 1
+%float = OpTypeFloat 32
+%PC = OpTypeStruct %float
+%_ptr_PushConstant_PC = OpTypePointer PushConstant %PC
+%_ptr_PushConstant_float = OpTypePointer PushConstant %float
+%_ptr_Function_float = OpTypePointer Function %float
+%pc = OpVariable %_ptr_PushConstant_PC PushConstant
+%int_0 = OpConstant %int 0
+%int_1 = OpConstant %int 1
+%int_10 = OpConstant %int 10
+%float_0 = OpConstant %float 0
+%main = OpFunction %void None %voidfn
+%entry = OpLabel
+%sum = OpVariable %_ptr_Function_float Function
+OpStore %sum %float_0
+OpBranch %outer_header
+%outer_header = OpLabel
+%i = OpPhi %int %int_0 %entry %i_next %outer_latch
+OpLoopMerge %outer_merge %outer_latch None
+OpBranch %outer_body
+%outer_body = OpLabel
+OpBranch %inner_header
+%inner_header = OpLabel
+%j = OpPhi %int %int_0 %outer_body %j_next %inner_latch
+OpLoopMerge %inner_merge %inner_latch None
+OpBranch %inner_cond
+%inner_cond = OpLabel
+%pc_ptr = OpAccessChain %_ptr_PushConstant_float %pc %int_0
+%pc_val = OpLoad %float %pc_ptr
+%inner_test = OpSLessThan %bool %j %int_10
+OpBranchConditional %inner_test %inner_body %inner_merge
+%inner_body = OpLabel
+%old = OpLoad %float %sum
+%new = OpFAdd %float %old %pc_val
+OpStore %sum %new
+OpBranch %inner_latch
+%inner_latch = OpLabel
+%j_next = OpIAdd %int %j %int_1
+OpBranch %inner_header
+%inner_merge = OpLabel
+OpBranch %outer_latch
+%outer_latch = OpLabel
+%i_next = OpIAdd %int %i %int_1
+%outer_test = OpSLessThan %bool %i_next %int_10
+OpBranchConditional %outer_test %outer_header %outer_merge
+%outer_merge = OpLabel
+OpReturn
+OpFunctionEnd
+)";
+
+  SinglePassRunAndMatch<opt::LICMPass>(text, false);
+}
+
+/*
+  A load from a uniform array whose index is checked in the loop is not
+  hoisted, since the access would then happen for indices that fail the
+  check.  The access chain does not move either, but the check itself is
+  hoisted.
+*/
+TEST_F(PassClassTest, DoNotHoistGuardedLoad) {
+  const std::string text = R"(
+; CHECK: %entry = OpLabel
+; CHECK-NEXT: %sum = OpVariable
+; CHECK-NEXT: %idx = OpLoad %int %index
+; CHECK-NEXT: OpStore %sum %float_0
+; CHECK-NEXT: %in_bounds = OpSLessThan %bool %idx %int_4
+; CHECK-NEXT: OpBranch %header
+; CHECK: %guarded = OpLabel
+; CHECK-NEXT: %ubo_ptr = OpAccessChain %_ptr_Uniform_float %ubo %int_0 %idx
+; CHECK-NEXT: %ubo_val = OpLoad %float %ubo_ptr
+OpCapability Shader
+OpMemoryModel Logical GLSL450
+OpEntryPoint Fragment %main "main"
+OpExecutionMode %main OriginUpperLeft
+OpName %main "main"
+OpName %UBO "UBO"
+OpName %ubo "ubo"
+OpName %sum "sum"
+OpName %idx "idx"
+OpName %index "index"
+OpName %entry "entry"
+OpName %header "header"
+OpName %guarded "guarded"
+OpName %in_bounds "in_bounds"
+OpName %ubo_ptr "ubo_ptr"
+OpName %ubo_val "ubo_val"
+OpDecorate %_arr_float_int_4 ArrayStride 4
+OpDecorate %UBO Block
+OpMemberDecorate %UBO 0 Offset 0
+OpDecorate %ubo DescriptorSet 0
+OpDecorate %ubo Binding 0
+%void = OpTypeVoid
+%voidfn = OpTypeFunction %void
+%bool = OpTypeBool
+%int = OpTypeInt 32 1
+%float = OpTypeFloat 32
+%int_0 = OpConstant %int 0
+%int_1 = OpConstant %int 1
+%int_4 = OpConstant %int 4
+%int_10 = OpConstant %int 10
+%float_0 = OpConstant %float 0
+%_arr_float_int_4 = OpTypeArray %float %int_4
+%UBO = OpTypeStruct %_arr_float_int_4
+%_ptr_Uniform_UBO = OpTypePointer Uniform %UBO
+%_ptr_Uniform_float = OpTypePointer Uniform %float
+%_ptr_Function_float = OpTypePointer Function %float
+%_ptr_Private_int = OpTypePointer Private %int
+%ubo = OpVariable %_ptr_Uniform_UBO Uniform
+%index = OpVariable %_ptr_Private_int Private
+%main = OpFunction %void None %voidfn
+%entry = OpLabel
+%sum = OpVariable %_ptr_Function_float Function
+%idx = OpLoad %int %index
+OpStore %sum %float_0
+OpBranch %header
+%header = OpLabel
+%i = OpPhi %int %int_0 %entry %i_next %latch
+OpLoopMerge %merge %latch None
+OpBranch %cond_block
+%cond_block = OpLabel
+%cond = OpSLessThan %bool %i %int_10
+OpBranchConditional %cond %body %merge
+%body = OpLabel
+%in_bounds = OpSLessThan %bool %idx %int_4
+OpSelectionMerge %latch None
+OpBranchConditional %in_bounds %guarded %latch
+%guarded = OpLabel
+%ubo_ptr = OpAccessChain %_ptr_Uniform_float %ubo %int_0 %idx
+%ubo_val = OpLoad %float %ubo_ptr
+%old = OpLoad %float %sum
+%new = OpFAdd %float %old %ubo_val
+OpStore %sum %new
+OpBranch %latch
+%latch = OpLabel
+%i_next = OpIAdd %int %i %int_1
+OpBranch %header
+%merge = OpLabel
+OpReturn
+OpFunctionEnd
+)";
+
+  SinglePassRunAndMatch<opt::LICMPass>(text, false);
+}
+#endif  // SPIRV_EFFCEE
+
+}  // namespace
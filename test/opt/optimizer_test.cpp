@@ -14,6 +14,9 @@
 
 #include <gmock/gmock.h>
 
+#include <string>
+#include <vector>
+
 #include "spirv-tools/libspirv.hpp"
 #include "spirv-tools/optimizer.hpp"
 
@@ -106,4 +109,100 @@ TEST(Optimizer, CanRunTransformingPassWithAliasedVectors) {
   EXPECT_THAT(disassembly, Eq("%void = OpTypeVoid\n"));
 }
 
+TEST(Optimizer, RunBatchMatchesRunOnEachModule) {
+  SpirvTools tools(SPV_ENV_UNIVERSAL_1_0);
+  std::vector<std::vector<uint32_t>> binaries(8);
+  for (size_t i = 0; i < binaries.size(); ++i) {
+    tools.Assemble("OpName %foo \"foo" + std::to_string(i) +
+                       "\"\n%foo = OpTypeVoid",
+                   &binaries[i]);
+  }
+
+  Optimizer opt(SPV_ENV_UNIVERSAL_1_0);
+  opt.RegisterPass(CreateStripDebugInfoPass());
+  std::vector<std::vector<uint32_t>> optimized;
+  EXPECT_TRUE(opt.RunBatch(binaries, &optimized, 4));
+  ASSERT_THAT(optimized.size(), Eq(binaries.size()));
+
+  for (const auto& binary : optimized) {
+    std::string disassembly;
+    tools.Disassemble(binary.data(), binary.size(), &disassembly);
+    EXPECT_THAT(disassembly, Eq("%void = OpTypeVoid\n"));
+  }
+
+  // The optimizer can still run the same passes on another batch, in place.
+  EXPECT_TRUE(opt.RunBatch(binaries, &binaries, 1));
+  EXPECT_THAT(binaries, Eq(optimized));
+}
+
+TEST(Optimizer, RunBatchClearsModulesThatFail) {
+  SpirvTools tools(SPV_ENV_UNIVERSAL_1_0);
+  std::vector<std::vector<uint32_t>> binaries(2);
+  tools.Assemble("OpName %foo \"foo\"\n%foo = OpTypeVoid", &binaries[0]);
+  // Not a SPIR-V module.
+  binaries[1] = {1, 2, 3};
+
+  Optimizer opt(SPV_ENV_UNIVERSAL_1_0);
+  opt.RegisterPass(CreateNullPass());
+  std::vector<std::vector<uint32_t>> optimized;
+  EXPECT_FALSE(opt.RunBatch(binaries, &optimized, 2));
+  ASSERT_THAT(optimized.size(), Eq(2u));
+  EXPECT_THAT(optimized[0], Eq(binaries[0]));
+  EXPECT_TRUE(optimized[1].empty());
+}
+
+TEST(Optimizer, RunWithWriterMatchesRun) {
+  SpirvTools tools(SPV_ENV_UNIVERSAL_1_0);
+  // Enough instructions to be written out in more than one piece.
+  std::string text = "OpName %foo \"foo\"\n%foo = OpTypeVoid\n";
+  for (int i = 0; i < 2000; ++i) {
+    text += "OpName %foo \"foo" + std::to_string(i) + "\"\n";
+  }
+  text += "OpNop\n";
+  std::vector<uint32_t> binary;
+  tools.Assemble(text, &binary);
+
+  Optimizer opt(SPV_ENV_UNIVERSAL_1_0);
+  opt.RegisterPass(CreateNullPass());
+  std::vector<uint32_t> expected;
+  EXPECT_TRUE(opt.Run(binary.data(), binary.size(), &expected));
+
+  std::vector<uint32_t> written;
+  int num_pieces = 0;
+  EXPECT_TRUE(opt.Run(binary.data(), binary.size(),
+                      [&written, &num_pieces](const uint32_t* words,
+                                              size_t count) {
+                        written.insert(written.end(), words, words + count);
+                        ++num_pieces;
+                        return true;
+                      }));
+  EXPECT_THAT(written, Eq(expected));
+  EXPECT_GT(num_pieces, 1);
+}
+
+TEST(Optimizer, RunWithWriterStopsWhenWriteFails) {
+  SpirvTools tools(SPV_ENV_UNIVERSAL_1_0);
+  std::vector<uint32_t> binary;
+  tools.Assemble("OpName %foo \"foo\"\n%foo = OpTypeVoid", &binary);
+
+  Optimizer opt(SPV_ENV_UNIVERSAL_1_0);
+  opt.RegisterPass(CreateNullPass());
+  int num_calls = 0;
+  EXPECT_FALSE(opt.Run(binary.data(), binary.size(),
+                       [&num_calls](const uint32_t*, size_t) {
+                         ++num_calls;
+                         return false;
+                       }));
+  EXPECT_THAT(num_calls, Eq(1));
+
+  // Nothing is written for a module that fails to build.
+  const std::vector<uint32_t> not_a_module = {1, 2, 3};
+  EXPECT_FALSE(opt.Run(not_a_module.data(), not_a_module.size(),
+                       [&num_calls](const uint32_t*, size_t) {
+                         ++num_calls;
+                         return true;
+                       }));
+  EXPECT_THAT(num_calls, Eq(1));
+}
+
 }  // namespace
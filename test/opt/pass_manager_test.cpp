@@ -14,9 +14,14 @@
 
 #include "gmock/gmock.h"
 
+#include <algorithm>
 #include <initializer_list>
+#include <sstream>
+#include <unordered_set>
+#include <vector>
 
 #include "module_utils.h"
+#include "opt/aggressive_dead_code_elim_pass.h"
 #include "opt/make_unique.h"
 #include "pass_fixture.h"
 
@@ -25,6 +30,8 @@ namespace {
 using namespace spvtools;
 using spvtest::GetIdBound;
 using ::testing::Eq;
+using ::testing::HasSubstr;
+using ::testing::StartsWith;
 
 // A null pass whose construtors accept arguments
 class NullPassWithArgs : public opt::NullPass {
@@ -183,4 +190,315 @@ TEST(PassManager, RecomputeIdBoundAutomatically) {
   EXPECT_THAT(GetIdBound(*context.module()), Eq(201u));
 }
 
+TEST(PassManager, TimeReportText) {
+  opt::PassManager manager;
+  std::unique_ptr<ir::Module> module(new ir::Module());
+  ir::IRContext context(SPV_ENV_UNIVERSAL_1_2, std::move(module),
+                        manager.consumer());
+  std::ostringstream report;
+  manager.SetTimeReport(&report, Optimizer::TimeReportFormat::kText);
+  manager.AddPass<AppendOpNopPass>();
+  manager.AddPass(MakeUnique<AppendTypeVoidInstPass>(100));
+  manager.Run(&context);
+
+  EXPECT_THAT(report.str(), HasSubstr("Pass AppendOpNop:\n"));
+  EXPECT_THAT(report.str(), HasSubstr("  instructions: 0 -> 1\n"));
+  EXPECT_THAT(report.str(), HasSubstr("Pass AppendTypeVoidInstPass:\n"));
+  EXPECT_THAT(report.str(), HasSubstr("  id bound: 1 -> 101\n"));
+  EXPECT_THAT(report.str(), HasSubstr("Total for 2 passes"));
+}
+
+TEST(PassManager, TimeReportCsv) {
+  opt::PassManager manager;
+  std::unique_ptr<ir::Module> module(new ir::Module());
+  ir::IRContext context(SPV_ENV_UNIVERSAL_1_2, std::move(module),
+                        manager.consumer());
+  std::ostringstream report;
+  manager.SetTimeReport(&report, Optimizer::TimeReportFormat::kCsv);
+  manager.AddPass<AppendOpNopPass>();
+  manager.Run(&context);
+
+  std::istringstream lines(report.str());
+  std::string header, row, extra;
+  ASSERT_TRUE(std::getline(lines, header));
+  ASSERT_TRUE(std::getline(lines, row));
+  EXPECT_FALSE(std::getline(lines, extra));
+  EXPECT_THAT(header, StartsWith("pass,wall_seconds,cpu_seconds,"));
+  EXPECT_THAT(header, HasSubstr(",built_DefUse,"));
+  EXPECT_THAT(header, HasSubstr(",invalidated_NameMap"));
+  EXPECT_THAT(row, StartsWith("AppendOpNop,"));
+  EXPECT_EQ(std::count(header.begin(), header.end(), ','),
+            std::count(row.begin(), row.end(), ','));
+}
+
+// A pass that removes the OpNop instructions from the functions it processes,
+// and records their ids.
+class RemoveNopsPass : public opt::Pass {
+ public:
+  explicit RemoveNopsPass(std::vector<uint32_t>* visited) : visited_(visited) {}
+
+  const char* name() const override { return "RemoveNops"; }
+  Status Process(ir::IRContext* irContext) override {
+    ProcessFunction pfn = FilterFunctions([this](ir::Function* func) {
+      visited_->push_back(func->result_id());
+      bool modified = false;
+      for (auto& block : *func) {
+        for (auto inst = block.begin(); inst != block.end();) {
+          if (inst->opcode() == SpvOpNop) {
+            inst = inst.Erase();
+            modified = true;
+          } else {
+            ++inst;
+          }
+        }
+      }
+      return modified;
+    });
+    return ProcessEntryPointCallTree(pfn, irContext->module())
+               ? Status::SuccessWithChange
+               : Status::SuccessWithoutChange;
+  }
+
+ private:
+  std::vector<uint32_t>* visited_;
+};
+
+// A pass that turns the OpCopyObject instructions in the functions it
+// processes into OpNop, and records their ids.
+class CopiesToNopsPass : public opt::Pass {
+ public:
+  explicit CopiesToNopsPass(std::vector<uint32_t>* visited)
+      : visited_(visited) {}
+
+  const char* name() const override { return "CopiesToNops"; }
+  Status Process(ir::IRContext* irContext) override {
+    ProcessFunction pfn = FilterFunctions([this](ir::Function* func) {
+      visited_->push_back(func->result_id());
+      bool modified = false;
+      func->ForEachInst([&modified](ir::Instruction* inst) {
+        if (inst->opcode() == SpvOpCopyObject) {
+          inst->ToNop();
+          modified = true;
+        }
+      });
+      return modified;
+    });
+    return ProcessEntryPointCallTree(pfn, irContext->module())
+               ? Status::SuccessWithChange
+               : Status::SuccessWithoutChange;
+  }
+
+ private:
+  std::vector<uint32_t>* visited_;
+};
+
+// A pass that adds an unused copy of %9 to the start of %1, the first
+// |num_copies| times it processes %1.
+class AddDeadCopyPass : public opt::Pass {
+ public:
+  explicit AddDeadCopyPass(int num_copies) : copies_left_(num_copies) {}
+
+  const char* name() const override { return "AddDeadCopy"; }
+  Status Process(ir::IRContext* irContext) override {
+    ProcessFunction pfn =
+        FilterFunctions([this, irContext](ir::Function* func) {
+          if (func->result_id() != 1 || copies_left_ == 0) return false;
+          --copies_left_;
+          func->begin()->begin().InsertBefore(MakeUnique<ir::Instruction>(
+              irContext, SpvOpCopyObject, 8, irContext->TakeNextId(),
+              std::vector<ir::Operand>{{SPV_OPERAND_TYPE_ID, {9}}}));
+          return true;
+        });
+    return ProcessEntryPointCallTree(pfn, irContext->module())
+               ? Status::SuccessWithChange
+               : Status::SuccessWithoutChange;
+  }
+
+ private:
+  int copies_left_;
+};
+
+// Two entry points, where only %1 has something for the passes above to do.
+const char kTwoFunctions[] = R"(OpCapability Shader
+OpMemoryModel Logical GLSL450
+OpEntryPoint Fragment %1 "f1"
+OpEntryPoint Fragment %2 "f2"
+OpExecutionMode %1 OriginUpperLeft
+OpExecutionMode %2 OriginUpperLeft
+%6 = OpTypeVoid
+%7 = OpTypeFunction %6
+%8 = OpTypeInt 32 1
+%9 = OpConstant %8 1
+%1 = OpFunction %6 None %7
+%3 = OpLabel
+%4 = OpCopyObject %8 %9
+OpReturn
+OpFunctionEnd
+%2 = OpFunction %6 None %7
+%5 = OpLabel
+OpReturn
+OpFunctionEnd
+)";
+
+// Two entry points that each store a constant to an output.  %9 stays live, so
+// AddDeadCopyPass can copy it after ADCE ran.
+const char kTwoEntryPointStores[] = R"(OpCapability Shader
+OpMemoryModel Logical GLSL450
+OpEntryPoint Fragment %1 "f1" %11
+OpEntryPoint Fragment %2 "f2" %12
+OpExecutionMode %1 OriginUpperLeft
+OpExecutionMode %2 OriginUpperLeft
+%6 = OpTypeVoid
+%7 = OpTypeFunction %6
+%8 = OpTypeFloat 32
+%9 = OpConstant %8 1
+%10 = OpTypePointer Output %8
+%11 = OpVariable %10 Output
+%12 = OpVariable %10 Output
+%13 = OpConstant %8 2
+%1 = OpFunction %6 None %7
+%3 = OpLabel
+OpStore %11 %9
+OpReturn
+OpFunctionEnd
+%2 = OpFunction %6 None %7
+%5 = OpLabel
+OpStore %12 %13
+OpReturn
+OpFunctionEnd
+)";
+
+// Returns the number of instructions with opcode |opcode| in |module|.
+int CountOpcode(ir::Module* module, SpvOp opcode) {
+  int count = 0;
+  module->ForEachInst([&count, opcode](const ir::Instruction* inst) {
+    if (inst->opcode() == opcode) ++count;
+  });
+  return count;
+}
+
+TEST(PassManager, SingleIterationRunsEachPassOnce) {
+  std::unique_ptr<ir::IRContext> context =
+      BuildModule(SPV_ENV_UNIVERSAL_1_2, nullptr, kTwoFunctions,
+                  SPV_TEXT_TO_BINARY_OPTION_PRESERVE_NUMERIC_IDS);
+  ASSERT_NE(nullptr, context);
+  std::vector<uint32_t> remove_visits, copy_visits;
+  opt::PassManager manager;
+  manager.AddPass<RemoveNopsPass>(&remove_visits);
+  manager.AddPass<CopiesToNopsPass>(&copy_visits);
+
+  EXPECT_EQ(opt::Pass::Status::SuccessWithChange, manager.Run(context.get()));
+  EXPECT_THAT(remove_visits, Eq(std::vector<uint32_t>{1, 2}));
+  EXPECT_THAT(copy_visits, Eq(std::vector<uint32_t>{1, 2}));
+  EXPECT_EQ(1, CountOpcode(context->module(), SpvOpNop));
+  EXPECT_EQ(1u, manager.iteration_stats().iterations);
+  EXPECT_EQ(2u, manager.iteration_stats().pass_runs);
+}
+
+TEST(PassManager, IteratesOnChangedFunctionsUntilConverged) {
+  std::unique_ptr<ir::IRContext> context =
+      BuildModule(SPV_ENV_UNIVERSAL_1_2, nullptr, kTwoFunctions,
+                  SPV_TEXT_TO_BINARY_OPTION_PRESERVE_NUMERIC_IDS);
+  ASSERT_NE(nullptr, context);
+  std::vector<uint32_t> remove_visits, copy_visits;
+  opt::PassManager manager;
+  std::ostringstream report;
+  manager.SetMaxIterations(5);
+  manager.SetTimeReport(&report, Optimizer::TimeReportFormat::kText);
+  manager.AddPass<RemoveNopsPass>(&remove_visits);
+  manager.AddPass<CopiesToNopsPass>(&copy_visits);
+
+  EXPECT_EQ(opt::Pass::Status::SuccessWithChange, manager.Run(context.get()));
+  // Only %1 is changed, so only %1 is visited again.
+  EXPECT_THAT(remove_visits, Eq(std::vector<uint32_t>{1, 2, 1}));
+  EXPECT_THAT(copy_visits, Eq(std::vector<uint32_t>{1, 2, 1}));
+  EXPECT_EQ(0, CountOpcode(context->module(), SpvOpNop));
+  EXPECT_EQ(0, CountOpcode(context->module(), SpvOpCopyObject));
+
+  const opt::PassManager::IterationStats& stats = manager.iteration_stats();
+  EXPECT_EQ(2u, stats.iterations);
+  EXPECT_EQ(4u, stats.pass_runs);
+  EXPECT_EQ(0u, stats.skipped_pass_runs);
+  EXPECT_TRUE(stats.converged);
+  EXPECT_THAT(report.str(),
+              HasSubstr("Iterations: 2, passes run: 4, passes skipped: 0, "
+                        "converged\n"));
+}
+
+TEST(PassManager, FilteredRunsKeepUnchangedEntryPoints) {
+  std::unique_ptr<ir::IRContext> context =
+      BuildModule(SPV_ENV_UNIVERSAL_1_2, nullptr, kTwoEntryPointStores,
+                  SPV_TEXT_TO_BINARY_OPTION_PRESERVE_NUMERIC_IDS);
+  ASSERT_NE(nullptr, context);
+  opt::PassManager manager;
+  manager.SetMaxIterations(5);
+  manager.AddPass<AddDeadCopyPass>(2);
+  manager.AddPass<opt::AggressiveDCEPass>();
+
+  EXPECT_EQ(opt::Pass::Status::SuccessWithChange, manager.Run(context.get()));
+  // The second iteration runs ADCE on %1 only, which must not make it think
+  // that %2 is dead.
+  EXPECT_LE(2u, manager.iteration_stats().iterations);
+  std::vector<uint32_t> functions;
+  for (auto& func : *context->module()) functions.push_back(func.result_id());
+  EXPECT_THAT(functions, Eq(std::vector<uint32_t>{1, 2}));
+  EXPECT_EQ(2, CountOpcode(context->module(), SpvOpEntryPoint));
+  EXPECT_EQ(2, CountOpcode(context->module(), SpvOpStore));
+  EXPECT_EQ(0, CountOpcode(context->module(), SpvOpCopyObject));
+}
+
+TEST(PassManager, FilteredRunsKeepGlobalsOfUnchangedFunctions) {
+  std::unique_ptr<ir::IRContext> context =
+      BuildModule(SPV_ENV_UNIVERSAL_1_2, nullptr, kTwoEntryPointStores,
+                  SPV_TEXT_TO_BINARY_OPTION_PRESERVE_NUMERIC_IDS);
+  ASSERT_NE(nullptr, context);
+  opt::PassManager manager;
+  manager.SetMaxIterations(5);
+  manager.AddPass<AddDeadCopyPass>(2);
+  manager.AddPass<opt::AggressiveDCEPass>();
+  manager.Run(context.get());
+
+  // %12 and %13 are only used by %2, which the second run of ADCE is not
+  // asked to look at.
+  std::vector<uint32_t> globals;
+  for (auto& inst : context->module()->types_values()) {
+    globals.push_back(inst.result_id());
+  }
+  EXPECT_THAT(globals, Eq(std::vector<uint32_t>{6, 7, 8, 9, 10, 11, 12, 13}));
+}
+
+TEST(PassManager, PassesReportTheFunctionsTheyChange) {
+  std::unique_ptr<ir::IRContext> context =
+      BuildModule(SPV_ENV_UNIVERSAL_1_2, nullptr, kTwoFunctions,
+                  SPV_TEXT_TO_BINARY_OPTION_PRESERVE_NUMERIC_IDS);
+  ASSERT_NE(nullptr, context);
+  std::vector<uint32_t> visits;
+  CopiesToNopsPass pass(&visits);
+  EXPECT_EQ(opt::Pass::Status::SuccessWithChange, pass.Run(context.get()));
+  ASSERT_NE(nullptr, pass.changed_functions());
+  EXPECT_EQ(std::unordered_set<uint32_t>{1}, *pass.changed_functions());
+
+  AppendOpNopPass untracked;
+  untracked.Run(context.get());
+  EXPECT_EQ(nullptr, untracked.changed_functions());
+}
+
+TEST(PassManager, StopsIteratingAtTheLimit) {
+  std::unique_ptr<ir::IRContext> context =
+      BuildModule(SPV_ENV_UNIVERSAL_1_2, nullptr, kTwoFunctions,
+                  SPV_TEXT_TO_BINARY_OPTION_PRESERVE_NUMERIC_IDS);
+  ASSERT_NE(nullptr, context);
+  opt::PassManager manager;
+  manager.SetMaxIterations(2);
+  // Each pass adds a global the other one has to look at.
+  manager.AddPass<AppendOpNopPass>();
+  manager.AddPass<AppendOpNopPass>();
+
+  manager.Run(context.get());
+  const opt::PassManager::IterationStats& stats = manager.iteration_stats();
+  EXPECT_EQ(2u, stats.iterations);
+  EXPECT_EQ(4u, stats.pass_runs);
+  EXPECT_FALSE(stats.converged);
+}
+
 }  // anonymous namespace
@@ -159,6 +159,52 @@ TEST_F(RedundancyEliminationTest, RemoveRedundantAddInSideNode) {
   SinglePassRunAndMatch<opt::RedundancyEliminationPass>(text, false);
 }
 
+// Remove a load that reads memory nothing has written to since a dominating
+// load, and the add of its operands in the other order.
+TEST_F(RedundancyEliminationTest, RemoveRedundantLoadAndCommutedAdd) {
+  const std::string text = R"(
+               OpCapability Shader
+          %1 = OpExtInstImport "GLSL.std.450"
+               OpMemoryModel Logical GLSL450
+               OpEntryPoint Fragment %2 "main"
+               OpExecutionMode %2 OriginUpperLeft
+               OpSource GLSL 430
+          %3 = OpTypeVoid
+          %4 = OpTypeFunction %3
+          %5 = OpTypeFloat 32
+          %6 = OpTypePointer Function %5
+          %7 = OpTypeBool
+          %8 = OpConstantTrue %7
+         %17 = OpConstant %5 1
+          %2 = OpFunction %3 None %4
+          %9 = OpLabel
+         %10 = OpVariable %6 Function
+; CHECK: [[ld:%\w+]] = OpLoad
+         %11 = OpLoad %5 %10
+; CHECK: OpFAdd {{%\w+}} [[ld]] {{%\w+}}
+         %12 = OpFAdd %5 %11 %17
+               OpSelectionMerge %15 None
+               OpBranchConditional %8 %13 %14
+         %13 = OpLabel
+; CHECK-NOT: OpLoad
+         %16 = OpLoad %5 %10
+; CHECK-NOT: OpFAdd
+         %18 = OpFAdd %5 %17 %16
+               OpBranch %15
+         %14 = OpLabel
+; CHECK: OpStore
+               OpStore %10 %17
+               OpBranch %15
+         %15 = OpLabel
+; CHECK: OpLoad
+         %19 = OpLoad %5 %10
+               OpReturn
+               OpFunctionEnd
+
+  )";
+  SinglePassRunAndMatch<opt::RedundancyEliminationPass>(text, false);
+}
+
 // Remove a redundant add whose value is in the result of a phi node.
 TEST_F(RedundancyEliminationTest, RemoveRedundantAddWithPhi) {
   const std::string text = R"(
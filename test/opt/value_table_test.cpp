@@ -196,7 +196,7 @@ TEST_F(ValueTableTest, SameLoad) {
 }
 
 // Two different loads, even from the same memory, must given different value
-// numbers if the memory is not read-only.
+// numbers if the memory may have been written to between them.
 TEST_F(ValueTableTest, DifferentFunctionLoad) {
   const std::string text = R"(
                OpCapability Shader
@@ -209,10 +209,12 @@ TEST_F(ValueTableTest, DifferentFunctionLoad) {
           %4 = OpTypeFunction %3
           %5 = OpTypeFloat 32
           %6 = OpTypePointer Function %5
+         %11 = OpConstant %5 1
           %2 = OpFunction %3 None %4
           %7 = OpLabel
           %8 = OpVariable %6 Function
           %9 = OpLoad %5 %8
+               OpStore %8 %11
           %10 = OpLoad %5 %8
                OpReturn
                OpFunctionEnd
@@ -224,6 +226,144 @@ TEST_F(ValueTableTest, DifferentFunctionLoad) {
   EXPECT_NE(vtable.GetValueNumber(inst1), vtable.GetValueNumber(inst2));
 }
 
+// Loads from a function variable get the same value number if nothing can
+// write to memory between them, even in different blocks.
+TEST_F(ValueTableTest, SameFunctionLoadWithoutStore) {
+  const std::string text = R"(
+               OpCapability Shader
+          %1 = OpExtInstImport "GLSL.std.450"
+               OpMemoryModel Logical GLSL450
+               OpEntryPoint Fragment %2 "main"
+               OpExecutionMode %2 OriginUpperLeft
+               OpSource GLSL 430
+          %3 = OpTypeVoid
+          %4 = OpTypeFunction %3
+          %5 = OpTypeFloat 32
+          %6 = OpTypePointer Function %5
+          %7 = OpConstant %5 1
+          %2 = OpFunction %3 None %4
+          %8 = OpLabel
+          %9 = OpVariable %6 Function
+               OpStore %9 %7
+         %10 = OpLoad %5 %9
+               OpBranch %11
+         %11 = OpLabel
+         %12 = OpLoad %5 %9
+               OpReturn
+               OpFunctionEnd
+  )";
+  auto context = BuildModule(SPV_ENV_UNIVERSAL_1_2, nullptr, text);
+  opt::ValueNumberTable vtable(context.get());
+  ir::Instruction* inst1 = context->get_def_use_mgr()->GetDef(10);
+  ir::Instruction* inst2 = context->get_def_use_mgr()->GetDef(12);
+  EXPECT_EQ(vtable.GetValueNumber(inst1), vtable.GetValueNumber(inst2));
+}
+
+// A store on one of the paths to a load makes it load a new value.
+TEST_F(ValueTableTest, FunctionLoadAfterStoreOnOnePath) {
+  const std::string text = R"(
+               OpCapability Shader
+          %1 = OpExtInstImport "GLSL.std.450"
+               OpMemoryModel Logical GLSL450
+               OpEntryPoint Fragment %2 "main"
+               OpExecutionMode %2 OriginUpperLeft
+               OpSource GLSL 430
+          %3 = OpTypeVoid
+          %4 = OpTypeFunction %3
+          %5 = OpTypeFloat 32
+          %6 = OpTypePointer Function %5
+          %7 = OpConstant %5 1
+          %8 = OpTypeBool
+          %9 = OpConstantTrue %8
+          %2 = OpFunction %3 None %4
+         %10 = OpLabel
+         %11 = OpVariable %6 Function
+         %12 = OpLoad %5 %11
+               OpSelectionMerge %14 None
+               OpBranchConditional %9 %13 %14
+         %13 = OpLabel
+               OpStore %11 %7
+               OpBranch %14
+         %14 = OpLabel
+         %15 = OpLoad %5 %11
+               OpReturn
+               OpFunctionEnd
+  )";
+  auto context = BuildModule(SPV_ENV_UNIVERSAL_1_2, nullptr, text);
+  opt::ValueNumberTable vtable(context.get());
+  ir::Instruction* inst1 = context->get_def_use_mgr()->GetDef(12);
+  ir::Instruction* inst2 = context->get_def_use_mgr()->GetDef(15);
+  EXPECT_NE(vtable.GetValueNumber(inst1), vtable.GetValueNumber(inst2));
+}
+
+// Loads from a function variable that is never written to always get the
+// same value number.
+TEST_F(ValueTableTest, UnmodifiedFunctionLoad) {
+  const std::string text = R"(
+               OpCapability Shader
+          %1 = OpExtInstImport "GLSL.std.450"
+               OpMemoryModel Logical GLSL450
+               OpEntryPoint Fragment %2 "main"
+               OpExecutionMode %2 OriginUpperLeft
+               OpSource GLSL 430
+          %3 = OpTypeVoid
+          %4 = OpTypeFunction %3
+          %5 = OpTypeFloat 32
+          %7 = OpTypePointer Function %5
+          %8 = OpConstant %5 1
+          %2 = OpFunction %3 None %4
+         %10 = OpLabel
+          %9 = OpVariable %7 Function %8
+         %11 = OpVariable %7 Function
+         %12 = OpLoad %5 %9
+               OpStore %11 %12
+         %13 = OpLoad %5 %9
+               OpReturn
+               OpFunctionEnd
+  )";
+  auto context = BuildModule(SPV_ENV_UNIVERSAL_1_2, nullptr, text);
+  opt::ValueNumberTable vtable(context.get());
+  ir::Instruction* inst1 = context->get_def_use_mgr()->GetDef(12);
+  ir::Instruction* inst2 = context->get_def_use_mgr()->GetDef(13);
+  EXPECT_EQ(vtable.GetValueNumber(inst1), vtable.GetValueNumber(inst2));
+}
+
+// A private variable can be written to by functions that are not in the
+// module being numbered, so loads from it depend on the memory version even if
+// nothing in the module writes to it.
+TEST_F(ValueTableTest, PrivateLoadAroundCall) {
+  const std::string text = R"(
+               OpCapability Shader
+          %1 = OpExtInstImport "GLSL.std.450"
+               OpMemoryModel Logical GLSL450
+               OpEntryPoint Fragment %2 "main"
+               OpExecutionMode %2 OriginUpperLeft
+               OpSource GLSL 430
+          %3 = OpTypeVoid
+          %4 = OpTypeFunction %3
+          %5 = OpTypeFloat 32
+          %6 = OpTypePointer Private %5
+          %8 = OpConstant %5 1
+          %9 = OpVariable %6 Private %8
+          %2 = OpFunction %3 None %4
+         %10 = OpLabel
+         %12 = OpLoad %5 %9
+         %11 = OpFunctionCall %3 %14
+         %13 = OpLoad %5 %9
+               OpReturn
+               OpFunctionEnd
+         %14 = OpFunction %3 None %4
+         %15 = OpLabel
+               OpReturn
+               OpFunctionEnd
+  )";
+  auto context = BuildModule(SPV_ENV_UNIVERSAL_1_2, nullptr, text);
+  opt::ValueNumberTable vtable(context.get());
+  ir::Instruction* inst1 = context->get_def_use_mgr()->GetDef(12);
+  ir::Instruction* inst2 = context->get_def_use_mgr()->GetDef(13);
+  EXPECT_NE(vtable.GetValueNumber(inst1), vtable.GetValueNumber(inst2));
+}
+
 TEST_F(ValueTableTest, DifferentUniformLoad) {
   const std::string text = R"(
                OpCapability Shader
@@ -428,6 +568,37 @@ TEST_F(ValueTableTest, DifferentTypes) {
   EXPECT_NE(vtable.GetValueNumber(inst1), vtable.GetValueNumber(inst2));
 }
 
+// The operands of commutative operations can come in any order.
+TEST_F(ValueTableTest, CommutativeOperands) {
+  const std::string text = R"(
+               OpCapability Shader
+          %1 = OpExtInstImport "GLSL.std.450"
+               OpMemoryModel Logical GLSL450
+               OpEntryPoint Fragment %2 "main"
+               OpExecutionMode %2 OriginUpperLeft
+               OpSource GLSL 430
+          %3 = OpTypeVoid
+          %4 = OpTypeFunction %3
+          %5 = OpTypeFloat 32
+          %6 = OpTypePointer Uniform %5
+          %7 = OpVariable %6 Uniform
+          %8 = OpConstant %5 1
+          %2 = OpFunction %3 None %4
+          %9 = OpLabel
+         %10 = OpLoad %5 %7
+         %11 = OpFAdd %5 %10 %8
+         %12 = OpFAdd %5 %8 %10
+         %13 = OpFSub %5 %10 %8
+         %14 = OpFSub %5 %8 %10
+               OpReturn
+               OpFunctionEnd
+  )";
+  auto context = BuildModule(SPV_ENV_UNIVERSAL_1_2, nullptr, text);
+  opt::ValueNumberTable vtable(context.get());
+  EXPECT_EQ(vtable.GetValueNumber(11), vtable.GetValueNumber(12));
+  EXPECT_NE(vtable.GetValueNumber(13), vtable.GetValueNumber(14));
+}
+
 TEST_F(ValueTableTest, CopyObject) {
   const std::string text = R"(
                OpCapability Shader
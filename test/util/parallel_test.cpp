@@ -0,0 +1,82 @@
+// Copyright (c) 2018 Google LLC
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include <atomic>
+#include <vector>
+
+#include "gmock/gmock.h"
+
+#include "util/parallel.h"
+
+namespace {
+
+using spvutils::ParallelFor;
+using spvutils::ThreadPool;
+using ::testing::Each;
+using ::testing::ElementsAre;
+
+TEST(ParallelForTest, SingleThreadRunsInOrder) {
+  std::vector<size_t> order;
+  ParallelFor(5, 1, [&order](size_t i) { order.push_back(i); });
+  EXPECT_THAT(order, ElementsAre(0, 1, 2, 3, 4));
+}
+
+TEST(ParallelForTest, ZeroThreadsRunsOnCallingThread) {
+  std::vector<size_t> order;
+  ParallelFor(3, 0, [&order](size_t i) { order.push_back(i); });
+  EXPECT_THAT(order, ElementsAre(0, 1, 2));
+}
+
+TEST(ParallelForTest, EmptyRange) {
+  bool called = false;
+  ParallelFor(0, 4, [&called](size_t) { called = true; });
+  EXPECT_FALSE(called);
+}
+
+TEST(ParallelForTest, EachIndexVisitedOnce) {
+  std::vector<std::atomic<int>> visits(1000);
+  for (auto& v : visits) v = 0;
+  ParallelFor(visits.size(), 8, [&visits](size_t i) { ++visits[i]; });
+  std::vector<int> counts(visits.begin(), visits.end());
+  EXPECT_THAT(counts, Each(1));
+}
+
+TEST(ThreadPoolTest, SingleThreadRunsInOrder) {
+  ThreadPool pool(1);
+  EXPECT_EQ(1u, pool.thread_count());
+  std::vector<size_t> order;
+  pool.ParallelFor(5, [&order](size_t i) { order.push_back(i); });
+  EXPECT_THAT(order, ElementsAre(0, 1, 2, 3, 4));
+}
+
+TEST(ThreadPoolTest, ZeroThreadsRunsOnCallingThread) {
+  ThreadPool pool(0);
+  EXPECT_EQ(1u, pool.thread_count());
+  std::vector<size_t> order;
+  pool.ParallelFor(3, [&order](size_t i) { order.push_back(i); });
+  EXPECT_THAT(order, ElementsAre(0, 1, 2));
+}
+
+TEST(ThreadPoolTest, EachIndexVisitedOnceOverManyLoops) {
+  ThreadPool pool(8);
+  for (size_t count : {0, 1, 2, 7, 1000, 3}) {
+    std::vector<std::atomic<int>> visits(count);
+    for (auto& v : visits) v = 0;
+    pool.ParallelFor(visits.size(), [&visits](size_t i) { ++visits[i]; });
+    std::vector<int> counts(visits.begin(), visits.end());
+    EXPECT_THAT(counts, Each(1));
+  }
+}
+
+}  // anonymous namespace
@@ -0,0 +1,140 @@
+// Copyright (c) 2018 Google LLC
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include <memory>
+#include <string>
+#include <type_traits>
+#include <vector>
+
+#include "gmock/gmock.h"
+
+#include "util/small_vector.h"
+
+namespace {
+
+using spvtools::utils::SmallVector;
+using ::testing::ElementsAre;
+using ::testing::Eq;
+
+TEST(SmallVectorTest, StartsEmptyWithInlineCapacity) {
+  SmallVector<uint32_t, 2> vec;
+  EXPECT_TRUE(vec.empty());
+  EXPECT_EQ(0u, vec.size());
+  EXPECT_EQ(2u, vec.capacity());
+}
+
+TEST(SmallVectorTest, PushBackPastInlineCapacity) {
+  SmallVector<uint32_t, 2> vec;
+  for (uint32_t i = 0; i < 10; ++i) vec.push_back(i);
+  EXPECT_EQ(10u, vec.size());
+  EXPECT_LE(10u, vec.capacity());
+  EXPECT_THAT(vec, ElementsAre(0, 1, 2, 3, 4, 5, 6, 7, 8, 9));
+}
+
+TEST(SmallVectorTest, PushBackOfOwnElementWhileGrowing) {
+  SmallVector<std::string, 1> vec = {"a"};
+  vec.push_back(vec.front());
+  vec.push_back(vec.back());
+  EXPECT_THAT(vec, ElementsAre("a", "a", "a"));
+}
+
+TEST(SmallVectorTest, ComparesWithStdVector) {
+  SmallVector<uint32_t, 2> vec = {1, 2, 3};
+  EXPECT_THAT(vec, Eq(std::vector<uint32_t>{1, 2, 3}));
+  EXPECT_TRUE(std::vector<uint32_t>({1, 2, 3}) == vec);
+  EXPECT_TRUE(vec != std::vector<uint32_t>({1, 2}));
+  EXPECT_TRUE(vec != (SmallVector<uint32_t, 2>{1, 2, 4}));
+}
+
+TEST(SmallVectorTest, CopyInlineAndHeap) {
+  SmallVector<std::string, 2> small = {"a"};
+  SmallVector<std::string, 2> large = {"a", "b", "c"};
+  SmallVector<std::string, 2> small_copy(small);
+  SmallVector<std::string, 2> large_copy(large);
+  EXPECT_EQ(small, small_copy);
+  EXPECT_EQ(large, large_copy);
+  small_copy = large;
+  EXPECT_EQ(large, small_copy);
+  large_copy = small;
+  EXPECT_EQ(small, large_copy);
+}
+
+TEST(SmallVectorTest, MoveInlineAndHeap) {
+  SmallVector<std::unique_ptr<int>, 2> small;
+  small.push_back(std::unique_ptr<int>(new int(1)));
+  SmallVector<std::unique_ptr<int>, 2> large;
+  for (int i = 0; i < 3; ++i) large.push_back(std::unique_ptr<int>(new int(i)));
+  const int* large_data = large.data()->get();
+
+  SmallVector<std::unique_ptr<int>, 2> moved_small(std::move(small));
+  SmallVector<std::unique_ptr<int>, 2> moved_large(std::move(large));
+  EXPECT_TRUE(small.empty());
+  EXPECT_TRUE(large.empty());
+  ASSERT_EQ(1u, moved_small.size());
+  EXPECT_EQ(1, *moved_small[0]);
+  ASSERT_EQ(3u, moved_large.size());
+  EXPECT_EQ(large_data, moved_large[0].get());
+
+  moved_small = std::move(moved_large);
+  EXPECT_EQ(3u, moved_small.size());
+  EXPECT_TRUE(moved_large.empty());
+}
+
+TEST(SmallVectorTest, MoveIsNoexcept) {
+  static_assert(
+      std::is_nothrow_move_constructible<SmallVector<uint32_t, 2>>::value,
+      "SmallVector should be nothrow move constructible");
+  static_assert(
+      std::is_nothrow_move_assignable<SmallVector<std::string, 2>>::value,
+      "SmallVector should be nothrow move assignable");
+
+  // std::vector moves its elements when it grows only if that can't throw.
+  std::vector<SmallVector<uint32_t, 2>> vecs(1);
+  vecs[0] = {1, 2, 3};
+  const uint32_t* data = vecs[0].data();
+  vecs.resize(vecs.capacity() + 1);
+  EXPECT_EQ(data, vecs[0].data());
+  EXPECT_THAT(vecs[0], ElementsAre(1, 2, 3));
+}
+
+TEST(SmallVectorTest, InsertInTheMiddle) {
+  SmallVector<uint32_t, 2> vec = {1, 5};
+  const std::vector<uint32_t> middle = {2, 3, 4};
+  auto it = vec.insert(vec.begin() + 1, middle.begin(), middle.end());
+  EXPECT_EQ(2u, *it);
+  EXPECT_THAT(vec, ElementsAre(1, 2, 3, 4, 5));
+}
+
+TEST(SmallVectorTest, EraseRangeAndSingle) {
+  SmallVector<std::string, 2> vec = {"a", "b", "c", "d", "e"};
+  auto it = vec.erase(vec.begin() + 1, vec.begin() + 3);
+  EXPECT_EQ("d", *it);
+  EXPECT_THAT(vec, ElementsAre("a", "d", "e"));
+  vec.erase(vec.begin());
+  EXPECT_THAT(vec, ElementsAre("d", "e"));
+  vec.erase(vec.end() - 1);
+  EXPECT_THAT(vec, ElementsAre("d"));
+}
+
+TEST(SmallVectorTest, ConstructFromRangeAndClear) {
+  const uint32_t words[] = {7, 8, 9};
+  SmallVector<uint32_t, 2> vec(words, words + 3);
+  EXPECT_THAT(vec, ElementsAre(7, 8, 9));
+  vec.clear();
+  EXPECT_TRUE(vec.empty());
+  vec = {4};
+  EXPECT_THAT(vec, ElementsAre(4));
+}
+
+}  // anonymous namespace
@@ -14,6 +14,7 @@
 
 // Validation tests for Control Flow Graph
 
+#include <algorithm>
 #include <array>
 #include <functional>
 #include <iterator>
@@ -1399,6 +1400,54 @@ TEST_F(ValidateCFG, OpReturnInNonVoidFunc) {
           "OpReturn can only be called from a function with void return type"));
 }
 
+// Returns a module with |count| functions, each with a selection construct.
+// In the functions whose index is in |bad_functions| the "cont" block appears
+// in the binary before its dominator.
+string MultipleFunctions(SpvCapability cap, int count,
+                         std::vector<int> bad_functions) {
+  string str = header(cap) +
+               nameOps("cont1", "branch1", "cont2", "branch2") +
+               types_consts() + "%cond    = OpConstantFalse %boolt\n";
+  for (int i = 0; i < count; ++i) {
+    const string suffix = std::to_string(i);
+    Block entry("entry" + suffix);
+    Block cont("cont" + suffix);
+    Block branch("branch" + suffix, SpvOpBranchConditional);
+    Block merge("merge" + suffix, SpvOpReturn);
+    if (cap == SpvCapabilityShader)
+      branch.SetBody("OpSelectionMerge %merge" + suffix + " None\n");
+
+    str += "%func" + suffix + " = OpFunction %voidt None %funct\n";
+    str += entry >> branch;
+    if (std::find(bad_functions.begin(), bad_functions.end(), i) !=
+        bad_functions.end()) {
+      str += cont >> merge;
+      str += branch >> vector<Block>({cont, merge});
+    } else {
+      str += branch >> vector<Block>({cont, merge});
+      str += cont >> merge;
+    }
+    str += merge;
+    str += "OpFunctionEnd\n";
+  }
+  return str;
+}
+
+TEST_P(ValidateCFG, MultipleFunctionsWithThreadsGood) {
+  CompileSuccessfully(MultipleFunctions(GetParam(), 8, {}));
+  spvValidatorOptionsSetThreadCount(options_, 4);
+  EXPECT_EQ(SPV_SUCCESS, ValidateInstructions());
+}
+
+TEST_P(ValidateCFG, MultipleFunctionsWithThreadsReportsFirstErrorInOrder) {
+  CompileSuccessfully(MultipleFunctions(GetParam(), 8, {1, 2}));
+  spvValidatorOptionsSetThreadCount(options_, 4);
+  ASSERT_EQ(SPV_ERROR_INVALID_CFG, ValidateInstructions());
+  EXPECT_THAT(getDiagnosticString(),
+              MatchesRegex("Block .\\[cont1\\] appears in the binary "
+                           "before its dominator .\\[branch1\\]"));
+}
+
 /// TODO(umar): Switch instructions
 /// TODO(umar): Nested CFG constructs
 }  // namespace
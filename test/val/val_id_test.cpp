@@ -2041,6 +2041,33 @@ TEST_F(ValidateIdWithMessage, OpLoadResultTypeBad) {
                         "<id> '5's type."));
 }
 
+TEST_F(ValidateIdWithMessage, OpLoadResultTypeWithThreadsBad) {
+  // Enough functions to be checked on several threads, with bad loads in two
+  // of them.  The first one in module order is reported.
+  string spirv = kGLSL450MemoryModel + R"(
+%1 = OpTypeVoid
+%2 = OpTypeInt 32 0
+%3 = OpTypePointer UniformConstant %2
+%4 = OpTypeFunction %1
+%5 = OpVariable %3 UniformConstant
+%6 = OpVariable %3 UniformConstant
+)";
+  for (int i = 0; i < 100; ++i) {
+    const string n = std::to_string(i);
+    const string load = i == 40 ? "OpLoad %3 %5"
+                                : i == 70 ? "OpLoad %3 %6" : "OpLoad %2 %5";
+    spirv += "%func" + n + " = OpFunction %1 None %4\n" + "%entry" + n +
+             " = OpLabel\n" + "%load" + n + " = " + load + "\n" +
+             "OpReturn\n" + "OpFunctionEnd\n";
+  }
+  CompileSuccessfully(spirv.c_str());
+  spvValidatorOptionsSetThreadCount(options_, 4);
+  EXPECT_EQ(SPV_ERROR_INVALID_ID, ValidateInstructions());
+  EXPECT_THAT(getDiagnosticString(),
+              HasSubstr("OpLoad Result Type <id> '3' does not match Pointer "
+                        "<id> '5's type."));
+}
+
 TEST_F(ValidateIdWithMessage, OpLoadPointerBad) {
   string spirv = kGLSL450MemoryModel + R"(
 %1 = OpTypeVoid
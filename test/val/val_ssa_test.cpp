@@ -1130,6 +1130,42 @@ TEST_F(ValidateSSA, IdDoesNotDominateItsUseBad) {
                    "not dominate its use in block .\\[false_block\\]"));
 }
 
+TEST_F(ValidateSSA, IdDoesNotDominateItsUseWithThreadsBad) {
+  // Enough functions for the definitions to be checked in several chunks,
+  // with the bad use in one of them.
+  string str = kHeader +
+               "OpName %eleven50 \"eleven50\"\n"
+               "OpName %true_block50 \"true_block50\"\n"
+               "OpName %false_block50 \"false_block50\"" +
+               kBasicTypes;
+  for (int i = 0; i < 100; ++i) {
+    const string n = std::to_string(i);
+    const string use = i == 50 ? "%eleven" + n : "%one";
+    str += "%func" + n + " = OpFunction %voidt None %vfunct\n" +
+           "%entry" + n + " = OpLabel\n" +
+           "%cond" + n + " = OpSLessThan %boolt %one %ten\n" +
+           "OpSelectionMerge %merge" + n + " None\n" +
+           "OpBranchConditional %cond" + n + " %true_block" + n +
+           " %false_block" + n + "\n" +
+           "%true_block" + n + " = OpLabel\n" +
+           "%eleven" + n + " = OpIAdd %uintt %one %ten\n" +
+           "OpBranch %merge" + n + "\n" +
+           "%false_block" + n + " = OpLabel\n" +
+           "%twentytwo" + n + " = OpIAdd %uintt " + use + " %ten\n" +
+           "OpBranch %merge" + n + "\n" +
+           "%merge" + n + " = OpLabel\n" +
+           "OpReturn\n" +
+           "OpFunctionEnd\n";
+  }
+  CompileSuccessfully(str);
+  spvValidatorOptionsSetThreadCount(options_, 4);
+  ASSERT_EQ(SPV_ERROR_INVALID_ID, ValidateInstructions());
+  EXPECT_THAT(getDiagnosticString(),
+              MatchesRegex("ID .\\[eleven50\\] defined in block "
+                           ".\\[true_block50\\] does not dominate its use "
+                           "in block .\\[false_block50\\]"));
+}
+
 TEST_F(ValidateSSA, PhiUseDoesntDominateDefinitionGood) {
   string str = kHeader + kBasicTypes +
                R"(
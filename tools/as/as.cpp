@@ -127,8 +127,8 @@ int main(int argc, char** argv) {
     outFile = "out.spv";
   }
 
-  std::vector<char> contents;
-  if (!ReadFile<char>(inFile, "r", &contents)) return 1;
+  InputFile<char> contents;
+  if (!contents.Open(inFile, "r")) return 1;
 
   spv_binary binary;
   spv_diagnostic diagnostic = nullptr;
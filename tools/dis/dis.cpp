@@ -19,6 +19,8 @@
 
 #include <cstdio>
 #include <cstring>
+#include <fstream>
+#include <iostream>
 #include <string>
 #include <vector>
 
@@ -56,6 +58,11 @@ Options:
   --raw-id        Show raw Id values instead of friendly names.
 
   --offsets       Show byte offsets for each instruction.
+
+  --threads <count>
+                  Disassemble the functions of the module in chunks, using up
+                  to <count> threads.  The output does not depend on <count>.
+                  The default is 1.
 )",
       argv0, argv0);
 }
@@ -79,6 +86,7 @@ int main(int argc, char** argv) {
   bool show_byte_offsets = false;
   bool no_header = false;
   bool friendly_names = true;
+  uint32_t thread_count = 1;
 
   for (int argi = 1; argi < argc; ++argi) {
     if ('-' == argv[argi][0]) {
@@ -110,6 +118,16 @@ int main(int argc, char** argv) {
             no_header = true;
           } else if (0 == strcmp(argv[argi], "--raw-id")) {
             friendly_names = false;
+          } else if (0 == strcmp(argv[argi], "--threads")) {
+            if (argi + 1 < argc) {
+              if (sscanf(argv[++argi], "%u", &thread_count) != 1) {
+                fprintf(stderr, "error: invalid argument to --threads\n");
+                return 1;
+              }
+            } else {
+              fprintf(stderr, "error: Missing argument to --threads\n");
+              return 1;
+            }
           } else if (0 == strcmp(argv[argi], "--help")) {
             print_usage(argv[0]);
             return 0;
@@ -172,38 +190,71 @@ int main(int argc, char** argv) {
   }
 
   // Read the input binary.
-  std::vector<uint32_t> contents;
-  if (!ReadFile<uint32_t>(inFile, "rb", &contents)) return 1;
-
-  // If printing to standard output, then spvBinaryToText should
-  // do the printing.  In particular, colour printing on Windows is
-  // controlled by modifying console objects synchronously while
-  // outputting to the stream rather than by injecting escape codes
-  // into the output stream.
-  // If the printing option is off, then save the text in memory, so
-  // it can be emitted later in this function.
+  InputFile<uint32_t> contents;
+  if (!contents.Open(inFile, "rb")) return 1;
+
+  // spvBinaryToText always does the printing.  In particular, colour printing
+  // on Windows is controlled by modifying console objects synchronously while
+  // outputting to the stream rather than by injecting escape codes into the
+  // output stream.
+  // When writing to a file, the standard output stream is pointed at a
+  // temporary file next to it for the duration of the call, so the text is
+  // streamed rather than built in memory first.  The temporary file only
+  // replaces the output file once the disassembly succeeds, so a failure
+  // leaves no truncated output behind.
   const bool print_to_stdout = SPV_BINARY_TO_TEXT_OPTION_PRINT & options;
-  spv_text text = nullptr;
-  spv_text* textOrNull = print_to_stdout ? nullptr : &text;
+  const std::string temp_file =
+      print_to_stdout ? std::string() : std::string(outFile) + ".tmp";
+  std::ofstream out_stream;
+  std::streambuf* stdout_buf = nullptr;
+  if (!print_to_stdout) {
+    out_stream.open(temp_file.c_str());
+    if (!out_stream) {
+      fprintf(stderr, "error: could not open file '%s'\n", temp_file.c_str());
+      return 1;
+    }
+    stdout_buf = std::cout.rdbuf(out_stream.rdbuf());
+    options |= SPV_BINARY_TO_TEXT_OPTION_PRINT;
+  }
+
   spv_diagnostic diagnostic = nullptr;
   spv_context context = spvContextCreate(kDefaultEnvironment);
-  spv_result_t error =
-      spvBinaryToText(context, contents.data(), contents.size(), options,
-                      textOrNull, &diagnostic);
+  spv_result_t error = spvBinaryToTextWithThreadCount(
+      context, contents.data(), contents.size(), options, thread_count,
+      nullptr, &diagnostic);
   spvContextDestroy(context);
+  // Writes through std::cout fail on its state, not on that of |out_stream|.
+  bool write_failed = false;
+  if (!print_to_stdout) {
+    write_failed = !std::cout;
+    std::cout.rdbuf(stdout_buf);
+    std::cout.clear();
+    out_stream.close();
+    write_failed = write_failed || !out_stream;
+  }
   if (error) {
+    if (!print_to_stdout) std::remove(temp_file.c_str());
     spvDiagnosticPrint(diagnostic);
     spvDiagnosticDestroy(diagnostic);
     return error;
   }
 
   if (!print_to_stdout) {
-    if (!WriteFile<char>(outFile, "w", text->str, text->length)) {
-      spvTextDestroy(text);
+    if (write_failed) {
+      fprintf(stderr, "error: could not write to file '%s'\n",
+              temp_file.c_str());
+      std::remove(temp_file.c_str());
+      return 1;
+    }
+    // Renaming onto an existing file fails on some platforms.
+    if (std::rename(temp_file.c_str(), outFile) != 0 &&
+        (std::remove(outFile) != 0 ||
+         std::rename(temp_file.c_str(), outFile) != 0)) {
+      fprintf(stderr, "error: could not write to file '%s'\n", outFile);
+      std::remove(temp_file.c_str());
       return 1;
     }
   }
-  spvTextDestroy(text);
 
   return 0;
 }
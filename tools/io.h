@@ -17,8 +17,18 @@
 
 #include <cstdint>
 #include <cstdio>
+#include <cstring>
 #include <vector>
 
+#if defined(SPIRV_ANDROID) || defined(SPIRV_LINUX) || defined(SPIRV_MAC) || \
+    defined(SPIRV_FREEBSD)
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#define SPIRV_TOOLS_IO_MMAP 1
+#endif
+
 // Appends the content from the file named as |filename| to |data|, assuming
 // each element in the file is of type |T|. The file is opened with the given
 // |mode|. If |filename| is nullptr or "-", reads from the standard input. If
@@ -51,6 +61,88 @@ bool ReadFile(const char* filename, const char* mode, std::vector<T>* data) {
   return true;
 }
 
+// The contents of an input file, viewed as an array of elements of type |T|.
+//
+// Where the platform supports it, a regular file is mapped into memory rather
+// than read, so the tools can hand its contents straight to the library
+// without copying them.  The standard input, and files that can't be mapped,
+// are read with ReadFile instead.
+template <typename T>
+class InputFile {
+ public:
+  InputFile() : mapping_(nullptr), mapping_size_(0) {}
+  InputFile(const InputFile&) = delete;
+  InputFile& operator=(const InputFile&) = delete;
+  ~InputFile() { Close(); }
+
+  // Opens the file named as |filename| with the given |mode|, dropping the
+  // contents of a file opened before.  If |filename| is nullptr or "-", reads
+  // from the standard input. If any error occurs, writes error messages to
+  // standard error and returns false.
+  bool Open(const char* filename, const char* mode) {
+    Close();
+#if defined(SPIRV_TOOLS_IO_MMAP)
+    if (Map(filename)) return true;
+#endif
+    return ReadFile(filename, mode, &buffer_);
+  }
+
+  // Returns the contents of the file.
+  const T* data() const {
+    return mapping_ ? static_cast<const T*>(mapping_) : buffer_.data();
+  }
+
+  // Returns the number of elements in the file.
+  size_t size() const {
+    return mapping_ ? mapping_size_ / sizeof(T) : buffer_.size();
+  }
+
+  // Releases the contents of the file.
+  void Close() {
+#if defined(SPIRV_TOOLS_IO_MMAP)
+    if (mapping_) munmap(mapping_, mapping_size_);
+#endif
+    mapping_ = nullptr;
+    mapping_size_ = 0;
+    std::vector<T>().swap(buffer_);
+  }
+
+  // Returns a copy of the contents of the file.
+  std::vector<T> ToVector() const {
+    return std::vector<T>(data(), data() + size());
+  }
+
+ private:
+
+#if defined(SPIRV_TOOLS_IO_MMAP)
+  // Maps the regular file named as |filename| into memory.  Returns false,
+  // without writing an error, if it isn't one or can't be mapped.  Also
+  // returns false if the file is not a whole number of elements, leaving the
+  // error to ReadFile.
+  bool Map(const char* filename) {
+    if (!filename || !strcmp("-", filename)) return false;
+    const int fd = open(filename, O_RDONLY);
+    if (fd == -1) return false;
+    struct stat st;
+    if (fstat(fd, &st) == 0 && S_ISREG(st.st_mode) && st.st_size > 0 &&
+        st.st_size % sizeof(T) == 0) {
+      void* mapping = mmap(nullptr, static_cast<size_t>(st.st_size),
+                           PROT_READ, MAP_PRIVATE, fd, 0);
+      if (mapping != MAP_FAILED) {
+        mapping_ = mapping;
+        mapping_size_ = static_cast<size_t>(st.st_size);
+      }
+    }
+    close(fd);
+    return mapping_ != nullptr;
+  }
+#endif
+
+  void* mapping_;          // The mapped file, or null if it was read.
+  size_t mapping_size_;    // The size of the mapping in bytes.
+  std::vector<T> buffer_;  // The contents of a file that was read.
+};
+
 // Writes the given |data| into the file named as |filename| using the given
 // |mode|, assuming |data| is an array of |count| elements of type |T|. If
 // |filename| is nullptr or "-", writes to standard output. If any error occurs,
@@ -22,6 +22,7 @@
 #include <sstream>
 #include <vector>
 
+#include "opt/inline_exhaustive_pass.h"
 #include "opt/set_spec_constant_default_value_pass.h"
 #include "spirv-tools/optimizer.hpp"
 
@@ -72,12 +73,16 @@ void PrintUsage(const char* program) {
       R"(%s - Optimize a SPIR-V binary file.
 
 USAGE: %s [options] [<input>] -o <output>
+       %s [options] <input>... -o <output-directory>
 
 The SPIR-V binary is read from <input>. If no file is specified,
 or if <input> is "-", then the binary is read from standard input.
 if <output> is "-", then the optimized output is written to
 standard output.
 
+If more than one <input> is given, each of them is optimized separately
+and written to the file with the same name in <output-directory>.
+
 NOTE: The optimizer is a work in progress.
 
 Options (in lexicographical order):
@@ -94,6 +99,11 @@ Options (in lexicographical order):
   --compact-ids
                Remap result ids to a compact range starting from %%1 and without
                any gaps.
+  --compact-ids-for-locality
+               Like --compact-ids, but number the ids defined outside of
+               functions first, the most used ones first, followed by the ids
+               of each function in the order they are defined.  This makes
+               the module compress better.
   --convert-local-access-chains
                Convert constant index access chain loads/stores into
                equivalent load/stores with inserts and extracts. Performed
@@ -154,10 +164,25 @@ Options (in lexicographical order):
                values.
   --if-conversion
                Convert if-then-else like assignments into OpSelect.
+  --inline-budget=<count>
+               Limit the inlining done by the --inline-entry-points-exhaustive,
+               -O, -Os and --legalize-hlsl flags that follow to adding <count>
+               instructions to the module.  A call is only inlined if its
+               callee fits, with the calls in the callee inlined as well.
+               Calls with opaque arguments or return type are always inlined.
+               The number of calls and instructions inlined, and of the calls
+               left in place, is printed to standard error output.  By default
+               there is no limit.
   --inline-entry-points-exhaustive
                Exhaustively inline all function calls in entry point call tree
                functions. Currently does not inline calls to functions with
                early return in a loop.
+  -j <count>
+               Use up to <count> threads: to optimize several input files at
+               the same time, or the functions of a single input file, and to
+               validate each of them.  The output does not depend on <count>.
+               The default is 1.  --print-all and --time-report only apply when
+               there is a single input file.
   --legalize-hlsl
                Runs a series of optimizations that attempts to take SPIR-V
                generated by and HLSL front-end and generate legal Vulkan SPIR-V.
@@ -169,6 +194,12 @@ Options (in lexicographical order):
   --local-redundancy-elimination
                Looks for instructions in the same basic block that compute the
                same value, and deletes the redundant ones.
+  --max-iterations=<count>
+               Run the passes, e.g. those of -O or -Os, up to <count> times.
+               After the first round, a pass only runs again on the functions
+               that other passes changed since it last ran, and this stops as
+               soon as no pass has changes to look at.  The default is 1.
+               --time-report also prints how many rounds were needed.
   --merge-blocks
                Join two blocks into a single block if the second has the
                first as its only predecessor. Performed only on entry point
@@ -266,6 +297,11 @@ Options (in lexicographical order):
                Replaces instructions with equivalent and less expensive ones.
   --strip-debug
                Remove all debug instructions.
+  --time-report[=csv]
+               Print the wall time, CPU time, peak memory growth, module size
+               and analyses built or invalidated by each pass to standard
+               error output after the last pass.  With =csv, print them as
+               comma separated values with a header row instead.
   --workaround-1209
                Rewrites instructions for which there are known driver bugs to
                avoid triggering those bugs.
@@ -277,7 +313,7 @@ Options (in lexicographical order):
   --version
                Display optimizer version information.
 )",
-      program, program, GetLegalizationPasses().c_str(),
+      program, program, program, GetLegalizationPasses().c_str(),
       GetOptimizationPasses().c_str(), GetSizePasses().c_str());
 }
 
@@ -316,18 +352,22 @@ bool ReadFlagsFromFile(const char* oconfig_flag,
 }
 
 OptStatus ParseFlags(int argc, const char** argv, Optimizer* optimizer,
-                     const char** in_file, const char** out_file,
+                     std::vector<const char*>* in_files, const char** out_file,
+                     uint32_t* thread_count, uint32_t* inline_budget,
                      spv_validator_options options, bool* skip_validator);
 
 // Parses and handles the -Oconfig flag. |prog_name| contains the name of
 // the spirv-opt binary (used to build a new argv vector for the recursive
 // invocation to ParseFlags). |opt_flag| contains the -Oconfig=FILENAME flag.
-// |optimizer|, |in_file| and |out_file| are as in ParseFlags.
+// |optimizer|, |in_files|, |out_file|, |thread_count| and |inline_budget| are
+// as in ParseFlags.
 //
 // This returns the same OptStatus instance returned by ParseFlags.
 OptStatus ParseOconfigFlag(const char* prog_name, const char* opt_flag,
-                           Optimizer* optimizer, const char** in_file,
-                           const char** out_file) {
+                           Optimizer* optimizer,
+                           std::vector<const char*>* in_files,
+                           const char** out_file, uint32_t* thread_count,
+                           uint32_t* inline_budget) {
   std::vector<std::string> flags;
   flags.push_back(prog_name);
 
@@ -352,19 +392,23 @@ OptStatus ParseOconfigFlag(const char* prog_name, const char* opt_flag,
 
   bool skip_validator = false;
   return ParseFlags(static_cast<int>(flags.size()), new_argv, optimizer,
-                    in_file, out_file, nullptr, &skip_validator);
+                    in_files, out_file, thread_count, inline_budget, nullptr,
+                    &skip_validator);
 }
 
 // Parses command-line flags. |argc| contains the number of command-line flags.
 // |argv| points to an array of strings holding the flags. |optimizer| is the
 // Optimizer instance used to optimize the program.
 //
-// On return, this function stores the name of the input program in |in_file|.
-// The name of the output file in |out_file|. The return value indicates whether
-// optimization should continue and a status code indicating an error or
-// success.
+// On return, this function appends the names of the input programs to
+// |in_files|, stores the name of the output file in |out_file|, and the
+// number of threads to optimize with in |thread_count|. |inline_budget| holds
+// the budget of the inline passes registered by the flags that follow. The
+// return value indicates whether optimization should continue and a status
+// code indicating an error or success.
 OptStatus ParseFlags(int argc, const char** argv, Optimizer* optimizer,
-                     const char** in_file, const char** out_file,
+                     std::vector<const char*>* in_files, const char** out_file,
+                     uint32_t* thread_count, uint32_t* inline_budget,
                      spv_validator_options options, bool* skip_validator) {
   for (int argi = 1; argi < argc; ++argi) {
     const char* cur_arg = argv[argi];
@@ -409,7 +453,7 @@ OptStatus ParseFlags(int argc, const char** argv, Optimizer* optimizer,
       } else if (0 == strcmp(cur_arg, "--freeze-spec-const")) {
         optimizer->RegisterPass(CreateFreezeSpecConstantValuePass());
       } else if (0 == strcmp(cur_arg, "--inline-entry-points-exhaustive")) {
-        optimizer->RegisterPass(CreateInlineExhaustivePass());
+        optimizer->RegisterPass(CreateInlineExhaustivePass(*inline_budget));
       } else if (0 == strcmp(cur_arg, "--inline-entry-points-opaque")) {
         optimizer->RegisterPass(CreateInlineOpaquePass());
       } else if (0 == strcmp(cur_arg, "--convert-local-access-chains")) {
@@ -452,6 +496,8 @@ OptStatus ParseFlags(int argc, const char** argv, Optimizer* optimizer,
         optimizer->RegisterPass(CreateFlattenDecorationPass());
       } else if (0 == strcmp(cur_arg, "--compact-ids")) {
         optimizer->RegisterPass(CreateCompactIdsPass());
+      } else if (0 == strcmp(cur_arg, "--compact-ids-for-locality")) {
+        optimizer->RegisterPass(CreateCompactIdsForLocalityPass());
       } else if (0 == strcmp(cur_arg, "--cfg-cleanup")) {
         optimizer->RegisterPass(CreateCFGCleanupPass());
       } else if (0 == strcmp(cur_arg, "--local-redundancy-elimination")) {
@@ -485,7 +531,8 @@ OptStatus ParseFlags(int argc, const char** argv, Optimizer* optimizer,
         optimizer->RegisterLegalizationPasses();
       } else if (0 == strncmp(cur_arg, "-Oconfig=", sizeof("-Oconfig=") - 1)) {
         OptStatus status =
-            ParseOconfigFlag(argv[0], cur_arg, optimizer, in_file, out_file);
+            ParseOconfigFlag(argv[0], cur_arg, optimizer, in_files, out_file,
+                             thread_count, inline_budget);
         if (status.action != OPT_CONTINUE) {
           return status;
         }
@@ -493,14 +540,42 @@ OptStatus ParseFlags(int argc, const char** argv, Optimizer* optimizer,
         optimizer->RegisterPass(CreateCCPPass());
       } else if (0 == strcmp(cur_arg, "--print-all")) {
         optimizer->SetPrintAll(&std::cerr);
-      } else if ('\0' == cur_arg[1]) {
-        // Setting a filename of "-" to indicate stdin.
-        if (!*in_file) {
-          *in_file = cur_arg;
+      } else if (0 == strcmp(cur_arg, "--time-report")) {
+        optimizer->SetTimeReport(&std::cerr);
+      } else if (0 == strcmp(cur_arg, "--time-report=csv")) {
+        optimizer->SetTimeReport(&std::cerr,
+                                 spvtools::Optimizer::TimeReportFormat::kCsv);
+      } else if (0 == strncmp(cur_arg, "--max-iterations=",
+                              sizeof("--max-iterations=") - 1)) {
+        uint32_t max_iterations = 0;
+        if (sscanf(cur_arg + sizeof("--max-iterations=") - 1, "%u",
+                   &max_iterations) != 1 ||
+            max_iterations == 0) {
+          fprintf(stderr, "error: invalid argument to --max-iterations\n");
+          return {OPT_STOP, 1};
+        }
+        optimizer->SetMaxIterations(max_iterations);
+      } else if (0 == strncmp(cur_arg, "--inline-budget=",
+                              sizeof("--inline-budget=") - 1)) {
+        if (sscanf(cur_arg + sizeof("--inline-budget=") - 1, "%u",
+                   inline_budget) != 1) {
+          fprintf(stderr, "error: invalid argument to --inline-budget\n");
+          return {OPT_STOP, 1};
+        }
+        optimizer->SetInlineBudget(*inline_budget);
+      } else if (0 == strcmp(cur_arg, "-j")) {
+        if (argi + 1 < argc) {
+          if (sscanf(argv[++argi], "%u", thread_count) != 1) {
+            fprintf(stderr, "error: invalid argument to -j\n");
+            return {OPT_STOP, 1};
+          }
         } else {
-          fprintf(stderr, "error: More than one input file specified\n");
+          fprintf(stderr, "error: Missing argument to -j\n");
           return {OPT_STOP, 1};
         }
+      } else if ('\0' == cur_arg[1]) {
+        // Setting a filename of "-" to indicate stdin.
+        in_files->push_back(cur_arg);
       } else {
         fprintf(
             stderr,
@@ -509,23 +584,33 @@ OptStatus ParseFlags(int argc, const char** argv, Optimizer* optimizer,
         return {OPT_STOP, 1};
       }
     } else {
-      if (!*in_file) {
-        *in_file = cur_arg;
-      } else {
-        fprintf(stderr, "error: More than one input file specified\n");
-        return {OPT_STOP, 1};
-      }
+      in_files->push_back(cur_arg);
     }
   }
 
   return {OPT_CONTINUE, 0};
 }
 
+// Returns the path of the file with the same name as |in_file| in the
+// directory |out_dir|.
+std::string GetBatchOutputPath(const char* out_dir, const char* in_file) {
+  std::string name(in_file);
+  const size_t slash = name.find_last_of("/\\");
+  if (slash != std::string::npos) name.erase(0, slash + 1);
+  std::string path(out_dir);
+  if (!path.empty() && path.back() != '/' && path.back() != '\\') {
+    path += '/';
+  }
+  return path + name;
+}
+
 }  // namespace
 
 int main(int argc, const char** argv) {
-  const char* in_file = nullptr;
+  std::vector<const char*> in_files;
   const char* out_file = nullptr;
+  uint32_t thread_count = 1;
+  uint32_t inline_budget = opt::InlineExhaustivePass::kNoBudget;
   bool skip_validator = false;
 
   spv_target_env target_env = SPV_ENV_UNIVERSAL_1_2;
@@ -539,8 +624,9 @@ int main(int argc, const char** argv) {
               << std::endl;
   });
 
-  OptStatus status = ParseFlags(argc, argv, &optimizer, &in_file, &out_file,
-                                options, &skip_validator);
+  OptStatus status =
+      ParseFlags(argc, argv, &optimizer, &in_files, &out_file, &thread_count,
+                 &inline_budget, options, &skip_validator);
 
   if (status.action == OPT_STOP) {
     return status.code;
@@ -551,36 +637,103 @@ int main(int argc, const char** argv) {
     return 1;
   }
 
-  std::vector<uint32_t> binary;
-  if (!ReadFile<uint32_t>(in_file, "rb", &binary)) {
-    return 1;
+  // With no input file, the binary is read from standard input.
+  if (in_files.empty()) in_files.push_back(nullptr);
+  const bool batch = in_files.size() > 1;
+  if (batch) {
+    for (const char* in_file : in_files) {
+      if (0 == strcmp(in_file, "-")) {
+        fprintf(stderr,
+                "error: Standard input can't be read with other input "
+                "files\n");
+        return 1;
+      }
+    }
+    if (0 == strcmp(out_file, "-")) {
+      fprintf(stderr,
+              "error: -o must name a directory when there is more than one "
+              "input file\n");
+      return 1;
+    }
+  }
+
+  std::vector<InputFile<uint32_t>> inputs(in_files.size());
+  for (size_t i = 0; i < in_files.size(); ++i) {
+    if (!inputs[i].Open(in_files[i], "rb")) {
+      return 1;
+    }
   }
 
   if (!skip_validator) {
     // Let's do validation first.
+    spvValidatorOptionsSetThreadCount(options, thread_count);
     spv_context context = spvContextCreate(target_env);
-    spv_diagnostic diagnostic = nullptr;
-    spv_const_binary_t binary_struct = {binary.data(), binary.size()};
-    spv_result_t error =
-        spvValidateWithOptions(context, options, &binary_struct, &diagnostic);
-    if (error) {
-      spvDiagnosticPrint(diagnostic);
+    for (const auto& input : inputs) {
+      spv_diagnostic diagnostic = nullptr;
+      spv_const_binary_t binary_struct = {input.data(), input.size()};
+      spv_result_t error =
+          spvValidateWithOptions(context, options, &binary_struct, &diagnostic);
+      if (error) {
+        spvDiagnosticPrint(diagnostic);
+        spvDiagnosticDestroy(diagnostic);
+        spvValidatorOptionsDestroy(options);
+        spvContextDestroy(context);
+        return error;
+      }
       spvDiagnosticDestroy(diagnostic);
-      spvValidatorOptionsDestroy(options);
-      spvContextDestroy(context);
-      return error;
     }
-    spvDiagnosticDestroy(diagnostic);
     spvValidatorOptionsDestroy(options);
     spvContextDestroy(context);
   }
 
-  // By using the same vector as input and output, we save time in the case
-  // that there was no change.
-  bool ok = optimizer.Run(binary.data(), binary.size(), &binary);
+  if (!batch) {
+    // The input is passed to the optimizer without copying it, and the
+    // optimized binary is written out as it is serialized.  The output file
+    // is only opened once the passes have succeeded.
+    const bool use_stdout = 0 == strcmp(out_file, "-");
+    FILE* out = nullptr;
+    auto write = [out_file, use_stdout, &out](const uint32_t* words,
+                                              size_t count) {
+      if (!out) out = use_stdout ? stdout : fopen(out_file, "wb");
+      if (!out) {
+        fprintf(stderr, "error: could not open file '%s'\n", out_file);
+        return false;
+      }
+      if (fwrite(words, sizeof(uint32_t), count, out) != count) {
+        fprintf(stderr, "error: could not write to file '%s'\n", out_file);
+        return false;
+      }
+      return true;
+    };
+    optimizer.SetThreadCount(thread_count);
+    bool ok = optimizer.Run(inputs.front().data(), inputs.front().size(),
+                            write);
+    if (out && !use_stdout && fclose(out) != 0 && ok) {
+      fprintf(stderr, "error: could not write to file '%s'\n", out_file);
+      ok = false;
+    }
 
-  if (!WriteFile<uint32_t>(out_file, "wb", binary.data(), binary.size())) {
-    return 1;
+    return ok ? 0 : 1;
+  }
+
+  // Modules that fail to optimize come back empty, and are not written.
+  std::vector<std::vector<uint32_t>> binaries;
+  binaries.reserve(inputs.size());
+  for (auto& input : inputs) {
+    binaries.push_back(input.ToVector());
+    input.Close();
+  }
+  bool ok = optimizer.RunBatch(binaries, &binaries, thread_count);
+  for (size_t i = 0; i < in_files.size(); ++i) {
+    if (binaries[i].empty()) {
+      fprintf(stderr, "error: Failed to optimize '%s'\n", in_files[i]);
+      continue;
+    }
+    const std::string path = GetBatchOutputPath(out_file, in_files[i]);
+    if (!WriteFile<uint32_t>(path.c_str(), "wb", binaries[i].data(),
+                             binaries[i].size())) {
+      return 1;
+    }
   }
 
   return ok ? 0 : 1;
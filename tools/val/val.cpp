@@ -49,6 +49,8 @@ Options:
   --relax-struct-store             Allow store from one struct type to a
                                    different type with compatible layout and
                                    members.
+  --threads                        <number of threads used for the checks which
+                                   run per function after parsing>
   --version                        Display validator version information.
   --target-env                     {vulkan1.0|spv1.0|spv1.1|spv1.2}
                                    Use Vulkan1.0/SPIR-V1.0/SPIR-V1.1/SPIR-V1.2 validation rules.
@@ -114,6 +116,21 @@ int main(int argc, char** argv) {
           continue_processing = false;
           return_code = 1;
         }
+      } else if (0 == strcmp(cur_arg, "--threads")) {
+        if (argi + 1 < argc) {
+          uint32_t thread_count = 0;
+          if (sscanf(argv[++argi], "%u", &thread_count) == 1) {
+            options.SetThreadCount(thread_count);
+          } else {
+            fprintf(stderr, "error: invalid argument to --threads\n");
+            continue_processing = false;
+            return_code = 1;
+          }
+        } else {
+          fprintf(stderr, "error: Missing argument to --threads\n");
+          continue_processing = false;
+          return_code = 1;
+        }
       } else if (0 == strcmp(cur_arg, "--relax-logical-pointer")) {
         options.SetRelaxLogicalPointer(true);
       } else if (0 == strcmp(cur_arg, "--relax-struct-store")) {
@@ -148,8 +165,8 @@ int main(int argc, char** argv) {
     return return_code;
   }
 
-  std::vector<uint32_t> contents;
-  if (!ReadFile<uint32_t>(inFile, "rb", &contents)) return 1;
+  InputFile<uint32_t> contents;
+  if (!contents.Open(inFile, "rb")) return 1;
 
   spvtools::SpirvTools tools(target_env);
   tools.SetMessageConsumer([](spv_message_level_t level, const char*,
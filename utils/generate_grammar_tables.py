@@ -299,6 +299,66 @@ class ExtInstInitializer(object):
             operands=', '.join(self.operands))
 
 
+# Marks an empty slot in the generated name and value indexes. Must match
+# kSpvTableIndexEmpty in source/table.h.
+TABLE_INDEX_EMPTY = 0xffff
+
+
+def table_name_hash(name):
+    """Returns the 32-bit FNV-1a hash of the given name.
+
+    Must match spvTableNameHash in source/table.h.
+    """
+    h = 2166136261
+    for c in bytearray(name.encode('utf-8')):
+        h = ((h ^ c) * 16777619) & 0xffffffff
+    return h
+
+
+def table_value_hash(value):
+    """Returns the hash of the given 32-bit enumerant value.
+
+    Must match spvTableValueHash in source/table.h.
+    """
+    h = value & 0xffffffff
+    h = ((h ^ (h >> 16)) * 0x45d9f3b) & 0xffffffff
+    h = ((h ^ (h >> 16)) * 0x45d9f3b) & 0xffffffff
+    return h ^ (h >> 16)
+
+
+def table_index_size(count):
+    """Returns the number of slots of an index over |count| entries: the
+    smallest power of two which keeps the index at most half full."""
+    size = 1
+    while size < 2 * count:
+        size *= 2
+    return size
+
+
+def generate_table_index(keys, hash_function, variable_name):
+    """Returns the C definition of an open-addressed hash index.
+
+    Slot i of the index holds the position in the table of the entry whose key
+    hashes to i, or the next free slot after it (linear probing). Entries
+    sharing a key are found in table order.
+
+    Arguments:
+      - keys: the key of each table entry, in table order
+      - hash_function: maps a key to a 32-bit hash
+      - variable_name: the name of the generated array
+    """
+    assert len(keys) < TABLE_INDEX_EMPTY
+    size = table_index_size(len(keys))
+    slots = [TABLE_INDEX_EMPTY] * size
+    for index, key in enumerate(keys):
+        slot = hash_function(key) & (size - 1)
+        while slots[slot] != TABLE_INDEX_EMPTY:
+            slot = (slot + 1) & (size - 1)
+        slots[slot] = index
+    return 'static const uint16_t {}[] = {{{}}};'.format(
+        variable_name, ', '.join(['0x{:x}'.format(s) for s in slots]))
+
+
 def generate_instruction(inst, version, is_ext_inst):
     """Returns the C initializer for the given SPIR-V instruction.
 
@@ -327,7 +387,8 @@ def generate_instruction(inst, version, is_ext_inst):
 
 def generate_instruction_table(inst_table, version):
     """Returns the info table containing all SPIR-V instructions,
-    sorted by opcode, and prefixed by capability arrays.
+    sorted by opcode, and prefixed by capability arrays. The table is
+    followed by an index from opcode names to table entries.
 
     Note:
       - the built-in sorted() function is guaranteed to be stable.
@@ -343,8 +404,12 @@ def generate_instruction_table(inst_table, version):
     insts = [generate_instruction(inst, version, False) for inst in inst_table]
     insts = ['static const spv_opcode_desc_t kOpcodeTableEntries_{}[] = {{\n'
              '  {}\n}};'.format(version, ',\n  '.join(insts))]
+    # Entry names are stored without the "Op" prefix.
+    name_index = generate_table_index(
+        [inst['opname'][2:] for inst in inst_table], table_name_hash,
+        'kOpcodeNameIndex_{}'.format(version))
 
-    return '{}\n\n{}'.format(caps_arrays, '\n'.join(insts))
+    return '{}\n\n{}\n\n{}'.format(caps_arrays, '\n'.join(insts), name_index)
 
 
 def generate_extended_instruction_table(inst_table, set_name, version):
@@ -438,6 +503,15 @@ def generate_enum_operand_kind(enum, version):
         name=name,
         entries=',\n'.join(entries))
 
+    enumerants = enum.get('enumerants', [])
+    name_index = generate_table_index(
+        [e.get('enumerant') for e in enumerants], table_name_hash,
+        name + 'NameIndex')
+    value_index = generate_table_index(
+        [int(str(e.get('value')), 0) for e in enumerants], table_value_hash,
+        name + 'ValueIndex')
+    entries = '\n\n'.join([entries, name_index, value_index])
+
     return kind, name, entries
 
 
@@ -470,9 +544,11 @@ def generate_operand_kind_table(enums, version):
     enum_entries = enum_entries[:-3]
     enum_kinds = [convert_operand_kind(e)
                   for e in zip(enum_kinds, enum_quantifiers)]
-    table_entries = zip(enum_kinds, enum_names, enum_names)
-    table_entries = ['  {{{}, ARRAY_SIZE({}), {}}}'.format(*e)
-                     for e in table_entries]
+    table_entries = zip(enum_kinds, enum_names)
+    table_entries = ['  {{{kind}, ARRAY_SIZE({name}), {name}, '
+                     'ARRAY_SIZE({name}NameIndex), {name}NameIndex, '
+                     '{name}ValueIndex}}'.format(kind=k, name=n)
+                     for k, n in table_entries]
 
     template = [
         'static const spv_operand_desc_group_t {p}_OperandInfoTable_{v}[] = {{',